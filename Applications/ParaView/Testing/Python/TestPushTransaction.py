@@ -0,0 +1,128 @@
+import json
+import os
+import tempfile
+import time
+
+from paraview import servermanager
+from paraview import benchmark
+import paraview.simple as smp
+
+
+# Make sure the test driver know that process has properly started
+print "Process started"
+
+
+def getHost(url):
+   return url.split(':')[1][2:]
+
+
+def getPort(url):
+   return int(url.split(':')[2])
+
+
+def countPushMessages():
+    """Returns the number of single and batched push messages sent by the
+    client since the last call."""
+    trace = benchmark.get_trace(reset=True)
+    handle, filename = tempfile.mkstemp(suffix='.json')
+    os.close(handle)
+    try:
+        assert trace.WriteChromeTrace(filename)
+        events = json.load(open(filename))['traceEvents']
+    finally:
+        os.remove(filename)
+    names = [event['name'] for event in events
+             if event.get('cat') == 'message']
+    return names.count('Send PushState'), names.count('Send PushState batch')
+
+
+def setResolutions(spheres, resolution):
+    for cc, sphere in enumerate(spheres):
+        sphere.ThetaResolution = resolution + cc
+        sphere.PhiResolution = resolution + cc
+        sphere.Radius = 1 + cc
+
+
+def getNumberOfPoints(sphere):
+    sphere.UpdatePipeline()
+    return sphere.GetDataInformation().GetNumberOfPoints()
+
+
+def checkSpheres(spheres, references):
+    """Checks that the server side spheres have the same number of points as
+    the references, whose properties were pushed one proxy at a time."""
+    for sphere, reference in zip(spheres, references):
+        for name in ('ThetaResolution', 'PhiResolution', 'Radius'):
+            assert sphere.GetPropertyValue(name) == \
+                reference.GetPropertyValue(name)
+        assert getNumberOfPoints(sphere) == getNumberOfPoints(reference)
+
+
+def runTest():
+
+    options = servermanager.vtkProcessModule.GetProcessModule().GetOptions()
+    url = options.GetServerURL()
+
+    smp.Connect(getHost(url), getPort(url))
+    pxm = servermanager.ProxyManager()
+
+    # Undo/redo restores the full state of the proxies, record it for the
+    # spheres from their creation on.
+    undoStack = servermanager.vtkSMUndoStack()
+    builder = servermanager.vtkSMUndoStackBuilder()
+    builder.SetUndoStack(undoStack)
+    servermanager.vtkSMProxyManager.GetProxyManager().SetUndoStackBuilder(
+        builder)
+
+    numberOfSpheres = 20
+    spheres = [smp.Sphere() for cc in range(numberOfSpheres)]
+    references = [smp.Sphere() for cc in range(numberOfSpheres)]
+    benchmark.enable_trace()
+    countPushMessages()
+
+    start = time.time()
+    setResolutions(references, 16)
+    referenceTime = time.time() - start
+    referenceMessages = countPushMessages()
+
+    builder.Begin('Resolutions')
+    start = time.time()
+    with pxm.PushTransaction():
+        setResolutions(spheres, 16)
+    transactionTime = time.time() - start
+    builder.End()
+    builder.PushToStack()
+    transactionMessages = countPushMessages()
+
+    print 'Without transaction: %d messages, %d batches, %g s' % \
+        (referenceMessages + (referenceTime,))
+    print 'With transaction: %d messages, %d batches, %g s' % \
+        (transactionMessages + (transactionTime,))
+    assert referenceMessages[0] >= 3 * numberOfSpheres
+    assert referenceMessages[1] == 0
+    assert transactionMessages[0] == 0
+    assert 1 <= transactionMessages[1] < referenceMessages[0]
+
+    checkSpheres(spheres, references)
+
+    # Undo and redo load the full states of the proxies recorded when the
+    # properties were pushed inside the transaction.
+    default = smp.Sphere()
+    assert undoStack.CanUndo()
+    undoStack.Undo()
+    for sphere in spheres:
+        sphere.SMProxy.UpdateVTKObjects()
+    checkSpheres(spheres, [default] * numberOfSpheres)
+
+    assert undoStack.CanRedo()
+    undoStack.Redo()
+    for sphere in spheres:
+        sphere.SMProxy.UpdateVTKObjects()
+    checkSpheres(spheres, references)
+
+    servermanager.vtkSMProxyManager.GetProxyManager().SetUndoStackBuilder(
+        None)
+    smp.Disconnect()
+
+
+runTest()
@@ -1,4 +1,5 @@
 #include "vtkCTHDataArray.h"
+#include "vtkCPInputDataDescription.h"
 #include "vtkObjectFactory.h"
 #include "vtkIdList.h"
 #include "vtkArrayIteratorTemplate.h"
@@ -15,10 +16,12 @@ vtkCTHDataArray::vtkCTHDataArray()
 
   this->Data = 0;
   this->CopiedData = 0;
+  this->CopiedSize = 0;
   this->Tuple = 0;
   this->TupleSize = 0;
 
-  this->Fallback = vtkDoubleArray::New ();
+  // Only built when a filter needs a writeable array.
+  this->Fallback = 0;
 }
 
 vtkCTHDataArray::~vtkCTHDataArray ()
@@ -219,6 +222,8 @@ double* vtkCTHDataArray::GetPointer (vtkIdType id)
       }
     this->ExportToVoidPointer (this->CopiedData);
     this->PointerTime = this->GetMTime ();
+    vtkCPInputDataDescription::AddFallbackCopy (
+      static_cast<vtkIdType>(size * sizeof(double)));
     }
   return this->CopiedData + id;
 }
@@ -385,13 +390,16 @@ void vtkCTHDataArray::BuildFallback ()
   if (!Fallback)
     {
     vtkDoubleArray *da = vtkDoubleArray::New ();
-    da->SetNumberOfTuples (this->GetNumberOfTuples ());
+    vtkIdType numTuples = this->GetNumberOfTuples ();
     da->SetNumberOfComponents (this->GetNumberOfComponents ());
+    da->SetNumberOfTuples (numTuples);
     // Avoid calling GetPointer so that we don't make an unnecessary copy.
-    for (vtkIdType i = 0; i < this->Size; i ++)
+    for (vtkIdType i = 0; i < numTuples; i ++)
       {
       da->SetTupleValue (i, this->GetTuple (i));
       }
     this->Fallback = da;
+    vtkCPInputDataDescription::AddFallbackCopy (
+      static_cast<vtkIdType>(da->GetSize () * sizeof(double)));
     }
 }
@@ -271,6 +271,8 @@ protected:
   double *Tuple;
   int TupleSize;
 
+  // Copies the values into Fallback, the copy is reported with
+  // vtkCPInputDataDescription::AddFallbackCopy like the one GetPointer makes.
   void BuildFallback ();
   // A writeable version of this array, delegated.
   vtkDoubleArray *Fallback;
@@ -0,0 +1,232 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    AsyncCoProcessing.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Runs a slow pipeline in asynchronous mode while the "simulation" overwrites
+// its field right after each call to CoProcess(), checks that the pipeline
+// saw the values of every step, in order, and only the field it asked for,
+// and reports the snapshot, wait and analysis times. Also checks that the
+// simulation only waits for the pipeline when the queue is full. Then checks
+// that a pipeline that cannot run on the helper thread makes the steps run
+// on the simulation thread.
+
+#include "vtkCPDataDescription.h"
+#include "vtkCPInputDataDescription.h"
+#include "vtkCPPipeline.h"
+#include "vtkCPProcessor.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkTimerLog.h"
+
+#include <iostream>
+#include <vector>
+
+namespace
+{
+  const vtkIdType NUMBER_OF_STEPS = 10;
+  const double ANALYSIS_TIME = 0.02;
+
+  class SlowPipeline : public vtkCPPipeline
+  {
+  public:
+    static SlowPipeline* New();
+    vtkTypeMacro(SlowPipeline, vtkCPPipeline);
+
+    virtual int RequestDataDescription(vtkCPDataDescription* dataDescription)
+      {
+      dataDescription->GetInputDescriptionByName("input")->AddPointField(
+        "pressure");
+      return 1;
+      }
+
+    virtual int CoProcess(vtkCPDataDescription* dataDescription)
+      {
+      double start = vtkTimerLog::GetUniversalTime();
+      while (vtkTimerLog::GetUniversalTime() - start < ANALYSIS_TIME)
+        {
+        }
+      vtkImageData* grid = vtkImageData::SafeDownCast(
+        dataDescription->GetInputDescriptionByName("input")->GetGrid());
+      vtkDataArray* pressure =
+        grid ? grid->GetPointData()->GetArray("pressure") : NULL;
+      if (!pressure || grid->GetPointData()->GetArray("temperature"))
+        {
+        std::cerr << "ERROR: wrong fields at step "
+          << dataDescription->GetTimeStep() << std::endl;
+        return 0;
+        }
+      this->TimeSteps.push_back(dataDescription->GetTimeStep());
+      this->Values.push_back(
+        pressure->GetTuple1(pressure->GetNumberOfTuples() - 1));
+      return 1;
+      }
+
+    std::vector<vtkIdType> TimeSteps;
+    std::vector<double> Values;
+
+  protected:
+    SlowPipeline() {}
+  };
+
+  vtkStandardNewMacro(SlowPipeline);
+
+  class MainThreadPipeline : public vtkCPPipeline
+  {
+  public:
+    static MainThreadPipeline* New();
+    vtkTypeMacro(MainThreadPipeline, vtkCPPipeline);
+
+    virtual int RequestDataDescription(vtkCPDataDescription*)
+      {
+      return 1;
+      }
+
+    virtual int CoProcess(vtkCPDataDescription*)
+      {
+      this->ThreadIds.push_back(vtkMultiThreader::GetCurrentThreadID());
+      return 1;
+      }
+
+    virtual bool CanCoProcessAsynchronously()
+      {
+      return false;
+      }
+
+    std::vector<vtkMultiThreaderIDType> ThreadIds;
+
+  protected:
+    MainThreadPipeline() {}
+  };
+
+  vtkStandardNewMacro(MainThreadPipeline);
+}
+
+int AsyncCoProcessing(int, char*[])
+{
+  vtkNew<vtkImageData> grid;
+  grid->SetDimensions(50, 50, 50);
+  vtkNew<vtkDoubleArray> pressure;
+  pressure->SetName("pressure");
+  pressure->SetNumberOfTuples(grid->GetNumberOfPoints());
+  grid->GetPointData()->AddArray(pressure.GetPointer());
+  vtkNew<vtkDoubleArray> temperature;
+  temperature->SetName("temperature");
+  temperature->SetNumberOfTuples(grid->GetNumberOfPoints());
+  grid->GetPointData()->AddArray(temperature.GetPointer());
+
+  vtkNew<SlowPipeline> pipeline;
+  vtkNew<vtkCPProcessor> processor;
+  processor->AddPipeline(pipeline.GetPointer());
+  processor->SetAsynchronous(true);
+  processor->SetMaximumNumberOfQueuedSteps(2);
+
+  vtkNew<vtkCPDataDescription> dataDescription;
+  dataDescription->AddInput("input");
+  int success = 1;
+  double snapshotTime = 0, waitTime = 0;
+  double start = vtkTimerLog::GetUniversalTime();
+  for (vtkIdType step = 0; step < NUMBER_OF_STEPS; step++)
+    {
+    pressure->FillComponent(0, static_cast<double>(step));
+    dataDescription->SetTimeData(static_cast<double>(step), step);
+    if (processor->RequestDataDescription(dataDescription.GetPointer()))
+      {
+      dataDescription->GetInputDescriptionByName("input")->SetGrid(
+        grid.GetPointer());
+      success = processor->CoProcess(dataDescription.GetPointer()) && success;
+      snapshotTime += processor->GetLastSnapshotTime();
+      waitTime += processor->GetLastWaitTime();
+      }
+    // The simulation moves on and overwrites its field.
+    pressure->FillComponent(0, -1.0);
+    }
+  double loopTime = vtkTimerLog::GetUniversalTime() - start;
+  success = processor->Flush() && success;
+
+  // With 2 queued steps the simulation gets 3 steps ahead and then waits
+  // for room in the queue, which takes about (NUMBER_OF_STEPS - 3) analysis
+  // times in all. Any other wait for the pipeline, e.g. in
+  // RequestDataDescription(), would make the loop take NUMBER_OF_STEPS
+  // analysis times and not be counted as wait time.
+  if (loopTime >= NUMBER_OF_STEPS * ANALYSIS_TIME ||
+    loopTime - waitTime >= 0.5 * NUMBER_OF_STEPS * ANALYSIS_TIME)
+    {
+    std::cerr << "ERROR: the simulation loop took " << 1000.0 * loopTime
+      << " ms and waited " << 1000.0 * waitTime << " ms for "
+      << NUMBER_OF_STEPS << " steps of " << 1000.0 * ANALYSIS_TIME
+      << " ms." << std::endl;
+    return 1;
+    }
+
+  if (!success || processor->GetLastProcessedTimeStep() != NUMBER_OF_STEPS - 1 ||
+    pipeline->TimeSteps.size() != static_cast<size_t>(NUMBER_OF_STEPS))
+    {
+    std::cerr << "ERROR: " << pipeline->TimeSteps.size() << " of "
+      << NUMBER_OF_STEPS << " steps were processed." << std::endl;
+    return 1;
+    }
+  for (vtkIdType step = 0; step < NUMBER_OF_STEPS; step++)
+    {
+    if (pipeline->TimeSteps[step] != step || pipeline->Values[step] != step)
+      {
+      std::cerr << "ERROR: step " << step << " processed step "
+        << pipeline->TimeSteps[step] << " with value "
+        << pipeline->Values[step] << std::endl;
+      return 1;
+      }
+    }
+
+  // The next step runs on this thread, for both pipelines.
+  vtkNew<MainThreadPipeline> mainThreadPipeline;
+  processor->AddPipeline(mainThreadPipeline.GetPointer());
+  vtkNew<vtkImageData> pressureGrid;
+  pressureGrid->SetDimensions(2, 2, 2);
+  vtkNew<vtkDoubleArray> lastPressure;
+  lastPressure->SetName("pressure");
+  lastPressure->SetNumberOfTuples(pressureGrid->GetNumberOfPoints());
+  lastPressure->FillComponent(0, static_cast<double>(NUMBER_OF_STEPS));
+  pressureGrid->GetPointData()->AddArray(lastPressure.GetPointer());
+  dataDescription->SetTimeData(
+    static_cast<double>(NUMBER_OF_STEPS), NUMBER_OF_STEPS);
+  processor->RequestDataDescription(dataDescription.GetPointer());
+  dataDescription->GetInputDescriptionByName("input")->SetGrid(
+    pressureGrid.GetPointer());
+  if (!processor->CoProcess(dataDescription.GetPointer()) ||
+    processor->GetLastSnapshotTime() != 0 ||
+    processor->GetLastProcessedTimeStep() != NUMBER_OF_STEPS ||
+    pipeline->Values.size() != static_cast<size_t>(NUMBER_OF_STEPS + 1) ||
+    pipeline->Values.back() != NUMBER_OF_STEPS ||
+    mainThreadPipeline->ThreadIds.size() != 1 ||
+    !vtkMultiThreader::ThreadsEqual(mainThreadPipeline->ThreadIds[0],
+      vtkMultiThreader::GetCurrentThreadID()))
+    {
+    std::cerr << "ERROR: the last step did not run on the simulation thread."
+      << std::endl;
+    return 1;
+    }
+
+  std::cout << "Steps: " << NUMBER_OF_STEPS
+    << " simulation time: " << 1000.0 * loopTime << " ms"
+    << " snapshot time: " << 1000.0 * snapshotTime << " ms"
+    << " wait time: " << 1000.0 * waitTime << " ms"
+    << " last analysis time: " << 1000.0 * processor->GetLastAnalysisTime()
+    << " ms" << std::endl;
+
+  processor->Finalize();
+  return 0;
+}
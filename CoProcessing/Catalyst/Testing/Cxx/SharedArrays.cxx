@@ -0,0 +1,128 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    SharedArrays.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Shares packed, strided and per component simulation arrays with
+// vtkCPInputDataDescription, checks their values and that only the arrays
+// that are not packed are copied, once, when a pointer to their values is
+// requested.
+
+#include "vtkCPInputDataDescription.h"
+#include "vtkDataArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+
+#include <iostream>
+#include <vector>
+
+namespace
+{
+  const vtkIdType NUMBER_OF_TUPLES = 1000;
+
+  struct Particle
+    {
+    double Velocity[3];
+    int Id;
+    };
+
+  bool CheckValues(vtkDataArray* array, const char* name,
+    const std::vector<Particle>& particles)
+    {
+    if (!array || array->GetNumberOfTuples() != NUMBER_OF_TUPLES ||
+      array->GetNumberOfComponents() != 3)
+      {
+      std::cerr << "ERROR: wrong shape for " << name << std::endl;
+      return false;
+      }
+    for (vtkIdType i = 0; i < NUMBER_OF_TUPLES; i++)
+      {
+      for (int c = 0; c < 3; c++)
+        {
+        if (array->GetComponent(i, c) != particles[i].Velocity[c])
+          {
+          std::cerr << "ERROR: wrong value in " << name << " at " << i
+            << ", " << c << std::endl;
+          return false;
+          }
+        }
+      }
+    return true;
+    }
+}
+
+int SharedArrays(int, char*[])
+{
+  std::vector<Particle> particles(NUMBER_OF_TUPLES);
+  std::vector<double> packed(3 * NUMBER_OF_TUPLES);
+  std::vector<double> x(NUMBER_OF_TUPLES), y(NUMBER_OF_TUPLES),
+    z(NUMBER_OF_TUPLES);
+  for (vtkIdType i = 0; i < NUMBER_OF_TUPLES; i++)
+    {
+    particles[i].Velocity[0] = packed[3 * i] = x[i] = i;
+    particles[i].Velocity[1] = packed[3 * i + 1] = y[i] = -2.0 * i;
+    particles[i].Velocity[2] = packed[3 * i + 2] = z[i] = 0.5 * i;
+    particles[i].Id = static_cast<int>(i);
+    }
+
+  vtkNew<vtkCPInputDataDescription> description;
+  vtkNew<vtkPointData> pointData;
+  vtkDataArray* aos = description->AddSharedArray(pointData.GetPointer(),
+    "aos", VTK_DOUBLE, &packed[0], NUMBER_OF_TUPLES, 3);
+  vtkDataArray* strided = description->AddSharedArray(pointData.GetPointer(),
+    "strided", VTK_DOUBLE, particles[0].Velocity, NUMBER_OF_TUPLES, 3,
+    sizeof(Particle) / sizeof(double));
+  void* components[3] = { &x[0], &y[0], &z[0] };
+  vtkDataArray* soa = description->AddSharedComponentArrays(
+    pointData.GetPointer(), "soa", VTK_DOUBLE, components, NUMBER_OF_TUPLES,
+    3);
+  if (pointData->GetNumberOfArrays() != 3 ||
+    !CheckValues(aos, "aos", particles) ||
+    !CheckValues(strided, "strided", particles) ||
+    !CheckValues(soa, "soa", particles))
+    {
+    return 1;
+    }
+
+  vtkCPInputDataDescription::ResetFallbackCopies();
+  if (aos->GetVoidPointer(0) != &packed[0] ||
+    vtkCPInputDataDescription::GetNumberOfFallbackCopies() != 0)
+    {
+    std::cerr << "ERROR: packed values were copied." << std::endl;
+    return 1;
+    }
+
+  // The copy is made once until the array is modified.
+  double* values = static_cast<double*>(soa->GetVoidPointer(0));
+  soa->GetVoidPointer(0);
+  strided->GetVoidPointer(0);
+  const vtkIdType bytes = 3 * NUMBER_OF_TUPLES * sizeof(double);
+  if (vtkCPInputDataDescription::GetNumberOfFallbackCopies() != 2 ||
+    vtkCPInputDataDescription::GetNumberOfFallbackCopyBytes() != 2 * bytes ||
+    values[3] != x[1] || values[4] != y[1] || values[5] != z[1])
+    {
+    std::cerr << "ERROR: unexpected copies "
+      << vtkCPInputDataDescription::GetNumberOfFallbackCopies() << " of "
+      << vtkCPInputDataDescription::GetNumberOfFallbackCopyBytes()
+      << " bytes." << std::endl;
+    return 1;
+    }
+  soa->Modified();
+  soa->GetVoidPointer(0);
+  if (vtkCPInputDataDescription::GetNumberOfFallbackCopies() != 3)
+    {
+    std::cerr << "ERROR: modified values were not copied again." << std::endl;
+    return 1;
+    }
+
+  return 0;
+}
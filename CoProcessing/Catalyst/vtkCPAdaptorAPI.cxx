@@ -165,3 +165,13 @@ void vtkCPAdaptorAPI::CoProcess()
   // Reset time data.
   vtkCPAdaptorAPI::IsTimeDataSet = false;
 }
+
+//-----------------------------------------------------------------------------
+void vtkCPAdaptorAPI::GetFallbackCopies(int* numberOfCopies,
+  double* numberOfBytes)
+{
+  *numberOfCopies = static_cast<int>(
+    vtkCPInputDataDescription::GetNumberOfFallbackCopies());
+  *numberOfBytes = static_cast<double>(
+    vtkCPInputDataDescription::GetNumberOfFallbackCopyBytes());
+}
@@ -49,6 +49,11 @@ public:
   /// has been filled in elsewhere.
   static void CoProcess();
 
+  /// returns the number of copies of arrays sharing simulation memory and
+  /// the number of bytes copied for the last step processed, see
+  /// vtkCPInputDataDescription::AddFallbackCopy().
+  static void GetFallbackCopies(int* numberOfCopies, double* numberOfBytes);
+
   /// provides access to the vtkCPDataDescription instance.
   static vtkCPDataDescription* GetCoProcessorData()
     { return vtkCPAdaptorAPI::CoProcessorData; }
@@ -17,14 +17,40 @@
 #include "vtkCellData.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkCPStridedArrayTemplate.h"
+#include "vtkDataArray.h"
 #include "vtkDataSet.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSimpleCriticalSection.h"
 
 #include <vector>
 #include <string>
 #include <algorithm>
 
+namespace
+{
+  // Copies made by the arrays sharing simulation memory, GetVoidPointer()
+  // may be called from several threads and the counts read by another one.
+  vtkSimpleCriticalSection FallbackCopiesLock;
+  vtkIdType NumberOfFallbackCopies = 0;
+  vtkIdType NumberOfFallbackCopyBytes = 0;
+
+  template <class T>
+  vtkDataArray* vtkCPNewStridedArray(T*, void** components, int numComp,
+    vtkIdType numTuples, vtkIdType stride)
+    {
+    std::vector<T*> typedComponents(numComp);
+    for (int c = 0; c < numComp; c++)
+      {
+      typedComponents[c] = static_cast<T*>(components[c]);
+      }
+    vtkCPStridedArrayTemplate<T>* array = vtkCPStridedArrayTemplate<T>::New();
+    array->SetComponentArrays(&typedComponents[0], numComp, numTuples, stride);
+    return array;
+    }
+}
+
 class vtkCPInputDataDescription::vtkInternals
 {
 public:
@@ -215,6 +241,112 @@ bool vtkCPInputDataDescription::DoesGridContainNeededFields(vtkDataSet* dataSet)
   return true;
 }
 
+//----------------------------------------------------------------------------
+vtkDataArray* vtkCPInputDataDescription::AddSharedArray(vtkFieldData* field,
+  const char* name, int dataType, void* data, vtkIdType numTuples,
+  int numComp, vtkIdType tupleStride)
+{
+  if (!field || !data || numComp < 1)
+    {
+    vtkErrorMacro("Need a field, memory and at least one component.");
+    return NULL;
+    }
+  if (tupleStride == 0 || tupleStride == numComp)
+    {
+    vtkDataArray* array = vtkDataArray::CreateDataArray(dataType);
+    if (!array)
+      {
+      vtkErrorMacro("Unsupported data type " << dataType);
+      return NULL;
+      }
+    array->SetName(name);
+    array->SetNumberOfComponents(numComp);
+    // save=1 so that the array never frees the simulation memory.
+    array->SetVoidArray(data, numTuples * numComp, 1);
+    field->AddArray(array);
+    array->Delete();
+    return array;
+    }
+
+  // Component c starts c values after the start of the tuple.
+  int typeSize = vtkDataArray::GetDataTypeSize(dataType);
+  std::vector<void*> components(numComp);
+  for (int c = 0; c < numComp; c++)
+    {
+    components[c] = static_cast<char*>(data) + c * typeSize;
+    }
+  return this->AddSharedComponentArrays(field, name, dataType,
+    &components[0], numTuples, numComp, tupleStride);
+}
+
+//----------------------------------------------------------------------------
+vtkDataArray* vtkCPInputDataDescription::AddSharedComponentArrays(
+  vtkFieldData* field, const char* name, int dataType, void** components,
+  vtkIdType numTuples, int numComp, vtkIdType stride)
+{
+  if (!field || !components || numComp < 1)
+    {
+    vtkErrorMacro("Need a field, memory and at least one component.");
+    return NULL;
+    }
+  if (numComp == 1 && stride == 1)
+    {
+    // Contiguous values, no need for a mapped array.
+    return this->AddSharedArray(
+      field, name, dataType, components[0], numTuples, 1);
+    }
+
+  vtkDataArray* array = NULL;
+  switch (dataType)
+    {
+    vtkTemplateMacro(array = vtkCPNewStridedArray(static_cast<VTK_TT*>(0),
+        components, numComp, numTuples, stride));
+    default:
+      vtkErrorMacro("Unsupported data type " << dataType);
+      return NULL;
+    }
+  array->SetName(name);
+  field->AddArray(array);
+  array->Delete();
+  return array;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPInputDataDescription::AddFallbackCopy(vtkIdType numberOfBytes)
+{
+  FallbackCopiesLock.Lock();
+  NumberOfFallbackCopies++;
+  NumberOfFallbackCopyBytes += numberOfBytes;
+  FallbackCopiesLock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkCPInputDataDescription::ResetFallbackCopies()
+{
+  FallbackCopiesLock.Lock();
+  NumberOfFallbackCopies = 0;
+  NumberOfFallbackCopyBytes = 0;
+  FallbackCopiesLock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCPInputDataDescription::GetNumberOfFallbackCopies()
+{
+  FallbackCopiesLock.Lock();
+  vtkIdType count = NumberOfFallbackCopies;
+  FallbackCopiesLock.Unlock();
+  return count;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCPInputDataDescription::GetNumberOfFallbackCopyBytes()
+{
+  FallbackCopiesLock.Lock();
+  vtkIdType count = NumberOfFallbackCopyBytes;
+  FallbackCopiesLock.Unlock();
+  return count;
+}
+
 //----------------------------------------------------------------------------
 bool vtkCPInputDataDescription::GetIfGridIsNecessary()
 {
@@ -240,4 +372,7 @@ void vtkCPInputDataDescription::PrintSelf(ostream& os, vtkIndent indent)
      << this->WholeExtent[1] << " " << this->WholeExtent[2] << " "
      << this->WholeExtent[3] << " " << this->WholeExtent[4] << " "
      << this->WholeExtent[5] << "\n";
+  os << indent << "NumberOfFallbackCopies: " << NumberOfFallbackCopies << "\n";
+  os << indent << "NumberOfFallbackCopyBytes: " << NumberOfFallbackCopyBytes
+     << "\n";
 }
@@ -15,6 +15,7 @@
 #ifndef __vtkCPInputDataDescription_h
 #define __vtkCPInputDataDescription_h
 
+class vtkDataArray;
 class vtkDataObject;
 class vtkDataSet;
 class vtkFieldData;
@@ -95,6 +96,42 @@ public:
   vtkSetVector6Macro(WholeExtent, int);
   vtkGetVector6Macro(WholeExtent, int);
 
+  // Description:
+  // Add to field a read-only array named name that uses simulation memory
+  // in place instead of copying it. The array has numTuples tuples of numComp
+  // values of type dataType (VTK_DOUBLE, VTK_FLOAT, VTK_INT...) and tuple i
+  // starts at value i * tupleStride of data. A tupleStride of 0 means
+  // numComp, i.e. packed tuples (an array of structures). Packed values
+  // give a regular VTK array which is never copied, other strides give a
+  // vtkCPStridedArrayTemplate. The memory must stay valid while the
+  // coprocessing pipelines use the array and the adaptor must not let
+  // filters write to it. Returns the array, which is owned by field.
+  vtkDataArray* AddSharedArray(vtkFieldData* field, const char* name,
+    int dataType, void* data, vtkIdType numTuples, int numComp,
+    vtkIdType tupleStride=0);
+
+  // Description:
+  // Same as AddSharedArray() for simulation memory storing each component
+  // in its own array (a structure of arrays): component c of tuple i is the
+  // value at components[c] + i * stride.
+  vtkDataArray* AddSharedComponentArrays(vtkFieldData* field,
+    const char* name, int dataType, void** components, vtkIdType numTuples,
+    int numComp, vtkIdType stride=1);
+
+  // Description:
+  // Arrays that share simulation memory report here each time a filter
+  // needed a contiguous copy of their values. vtkCPProcessor resets the
+  // counts each time it runs the pipelines on a step so that they give the
+  // number of copies and of bytes copied for the last step processed. In
+  // synchronous mode that is the step of the last call to CoProcess(). In
+  // asynchronous mode the steps are processed on the helper thread and the
+  // counts are those of vtkCPProcessor::GetLastProcessedTimeStep(), stable
+  // after vtkCPProcessor::Flush(). The counts are global to the process.
+  static void AddFallbackCopy(vtkIdType numberOfBytes);
+  static void ResetFallbackCopies();
+  static vtkIdType GetNumberOfFallbackCopies();
+  static vtkIdType GetNumberOfFallbackCopyBytes();
+
 //BTX
 protected:
   vtkCPInputDataDescription();
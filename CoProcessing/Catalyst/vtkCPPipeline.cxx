@@ -31,6 +31,12 @@ int vtkCPPipeline::Finalize()
   return 1;
 }
 
+//----------------------------------------------------------------------------
+bool vtkCPPipeline::CanCoProcessAsynchronously()
+{
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void vtkCPPipeline::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -48,6 +48,13 @@ public:
   /// is given. Returns 1 for success and 0 for failure.
   virtual int Finalize();
 
+  /// Returns true when CoProcess() can run on the helper thread of an
+  /// asynchronous vtkCPProcessor. RequestDataDescription() is then called
+  /// from the simulation thread while CoProcess() runs. Otherwise the
+  /// processor runs all the pipelines on the simulation thread. Returns
+  /// true by default.
+  virtual bool CanCoProcessAsynchronously();
+
 protected:
   vtkCPPipeline();
   virtual ~vtkCPPipeline();
@@ -20,36 +20,302 @@
 #include "vtkCPDataDescription.h"
 #include "vtkCPInputDataDescription.h"
 #include "vtkCPPipeline.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkConditionVariable.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkFieldData.h"
 #ifdef PARAVIEW_USE_MPI
 #include "vtkMPI.h"
 #include "vtkMPICommunicator.h"
 #include "vtkMPIController.h"
 #endif
 #include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkSmartPointer.h"
 #include "vtkSMIntVectorProperty.h"
 #include "vtkSMProxy.h"
 #include "vtkSMProxyManager.h"
 #include "vtkSMSessionProxyManager.h"
+#include "vtkTimerLog.h"
 
-
+#include <deque>
 #include <list>
+#include <string.h>
 
 struct vtkCPProcessorInternals
 {
   typedef std::list<vtkSmartPointer<vtkCPPipeline> > PipelineList;
   typedef PipelineList::iterator PipelineListIterator;
   PipelineList Pipelines;
+
+  // Held while the list of pipelines changes and while the helper thread
+  // copies it. The pipelines themselves run without it, so that the
+  // simulation can call RequestDataDescription() in the meantime.
+  vtkNew<vtkMutexLock> PipelinesLock;
+
+  // Asynchronous mode. Lock guards everything below and Condition is
+  // signaled each time a step is queued, a step is taken by the helper
+  // thread, a step is done or the helper thread is asked to stop.
+  vtkCPProcessor* Processor;
+  std::deque<vtkSmartPointer<vtkCPDataDescription> > Queue;
+  vtkNew<vtkMutexLock> Lock;
+  vtkNew<vtkConditionVariable> Condition;
+  vtkNew<vtkMultiThreader> Threader;
+  int ThreadId;
+  bool Stop;
+  bool Busy;
+  int Success;
+  double SnapshotTime;
+  double WaitTime;
+  double AnalysisTime;
+  vtkIdType ProcessedTimeStep;
+
+  // While the helper thread runs, the global controller is HelperController,
+  // which uses a duplicate of the communicator of SimulationController: the
+  // simulation may run collectives on its communicator at the same time as
+  // the pipelines.
+  vtkSmartPointer<vtkMultiProcessController> SimulationController;
+  vtkSmartPointer<vtkMultiProcessController> HelperController;
+
+  vtkCPProcessorInternals(vtkCPProcessor* processor) :
+    Processor(processor), ThreadId(-1), Stop(false), Busy(false), Success(1),
+    SnapshotTime(0), WaitTime(0), AnalysisTime(0), ProcessedTimeStep(-1)
+    {
+    }
+
+  static VTK_THREAD_RETURN_TYPE Run(void* arg)
+    {
+    vtkCPProcessorInternals* self = static_cast<vtkCPProcessorInternals*>(
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg)->UserData);
+    self->Lock->Lock();
+    for(;;)
+      {
+      while(self->Queue.empty() && !self->Stop)
+        {
+        self->Condition->Wait(self->Lock.GetPointer());
+        }
+      if(self->Queue.empty())
+        {
+        break;
+        }
+      vtkSmartPointer<vtkCPDataDescription> step = self->Queue.front();
+      self->Queue.pop_front();
+      self->Busy = true;
+      self->Condition->Broadcast();
+      self->Lock->Unlock();
+
+      double start = vtkTimerLog::GetUniversalTime();
+      int success = self->Processor->RunPipelines(step);
+      double analysisTime = vtkTimerLog::GetUniversalTime() - start;
+      vtkIdType timeStep = step->GetTimeStep();
+      // Release the snapshot before letting the simulation queue another.
+      step = NULL;
+
+      self->Lock->Lock();
+      self->Busy = false;
+      self->Success = self->Success && success;
+      self->AnalysisTime = analysisTime;
+      self->ProcessedTimeStep = timeStep;
+      self->Condition->Broadcast();
+      }
+    self->Lock->Unlock();
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  void StartThread()
+    {
+    if(this->ThreadId < 0)
+      {
+#ifdef PARAVIEW_USE_MPI
+      vtkMPIController* controller = vtkMPIController::SafeDownCast(
+        vtkMultiProcessController::GetGlobalController());
+      vtkMPICommunicator* communicator = controller ?
+        vtkMPICommunicator::SafeDownCast(controller->GetCommunicator()) : NULL;
+      if(communicator)
+        {
+        vtkNew<vtkMPICommunicator> duplicate;
+        duplicate->Duplicate(communicator);
+        vtkMPIController* helperController = vtkMPIController::New();
+        helperController->SetCommunicator(duplicate.GetPointer());
+        this->SimulationController = controller;
+        this->HelperController.TakeReference(helperController);
+        vtkMultiProcessController::SetGlobalController(helperController);
+        }
+#endif
+      this->Stop = false;
+      this->ThreadId = this->Threader->SpawnThread(
+        &vtkCPProcessorInternals::Run, this);
+      }
+    }
+
+  // Waits for the queued steps and returns 1 if they all succeeded.
+  int Flush()
+    {
+    this->Lock->Lock();
+    while(!this->Queue.empty() || this->Busy)
+      {
+      this->Condition->Wait(this->Lock.GetPointer());
+      }
+    int success = this->Success;
+    this->Success = 1;
+    this->Lock->Unlock();
+    return success;
+    }
+
+  // Processes the queued steps and joins the helper thread.
+  void StopThread()
+    {
+    if(this->ThreadId < 0)
+      {
+      return;
+      }
+    this->Lock->Lock();
+    this->Stop = true;
+    this->Condition->Broadcast();
+    this->Lock->Unlock();
+    this->Threader->TerminateThread(this->ThreadId);
+    this->ThreadId = -1;
+    if(this->HelperController)
+      {
+      vtkMultiProcessController::SetGlobalController(
+        this->SimulationController);
+      this->SimulationController = NULL;
+      this->HelperController = NULL;
+      }
+    }
+
+  // Returns a copy of the list of pipelines for the helper thread. The
+  // pipelines stay alive while they run even if they are removed.
+  PipelineList GetPipelines()
+    {
+    this->PipelinesLock->Lock();
+    PipelineList pipelines = this->Pipelines;
+    this->PipelinesLock->Unlock();
+    return pipelines;
+    }
+
+  // Returns false when a pipeline has to run on the simulation thread.
+  bool CanCoProcessAsynchronously()
+    {
+    for(PipelineListIterator iter = this->Pipelines.begin();
+        iter != this->Pipelines.end(); iter++)
+      {
+      if(!iter->GetPointer()->CanCoProcessAsynchronously())
+        {
+        return false;
+        }
+      }
+    return true;
+    }
 };
 
+namespace
+{
+  // Copies the arrays of source that are needed, and the ghost array, into
+  // target. Mapped arrays sharing simulation memory become regular arrays.
+  void vtkCPSnapshotAttributes(vtkDataSetAttributes* source,
+    vtkDataSetAttributes* target, vtkCPInputDataDescription* input,
+    bool allFields)
+    {
+    for(int i = 0; i < source->GetNumberOfArrays(); i++)
+      {
+      vtkAbstractArray* array = source->GetAbstractArray(i);
+      const char* name = array->GetName();
+      if(!allFields && !input->IsFieldNeeded(name) && (!name ||
+          strcmp(name, vtkDataSetAttributes::GhostArrayName()) != 0))
+        {
+        continue;
+        }
+      vtkDataArray* dataArray = vtkDataArray::SafeDownCast(array);
+      vtkAbstractArray* copy;
+      if(dataArray)
+        {
+        vtkDataArray* values =
+          vtkDataArray::CreateDataArray(dataArray->GetDataType());
+        values->SetNumberOfComponents(dataArray->GetNumberOfComponents());
+        values->SetNumberOfTuples(dataArray->GetNumberOfTuples());
+        if(values->GetNumberOfTuples() > 0)
+          {
+          dataArray->ExportToVoidPointer(values->GetVoidPointer(0));
+          }
+        copy = values;
+        }
+      else
+        {
+        copy = array->NewInstance();
+        copy->DeepCopy(array);
+        }
+      copy->SetName(name);
+      target->AddArray(copy);
+      copy->Delete();
+      }
+    for(int attribute = 0; attribute < vtkDataSetAttributes::NUM_ATTRIBUTES;
+        attribute++)
+      {
+      vtkAbstractArray* array = source->GetAbstractAttribute(attribute);
+      if(array && array->GetName() && target->GetAbstractArray(array->GetName()))
+        {
+        target->SetActiveAttribute(array->GetName(), attribute);
+        }
+      }
+    }
+
+  // Returns a new grid sharing the mesh of grid, with copies of the arrays
+  // needed by input.
+  vtkDataObject* vtkCPSnapshotGrid(vtkDataObject* grid,
+    vtkCPInputDataDescription* input, bool allFields)
+    {
+    vtkDataSet* dataSet = vtkDataSet::SafeDownCast(grid);
+    if(dataSet)
+      {
+      vtkDataSet* copy = dataSet->NewInstance();
+      copy->CopyStructure(dataSet);
+      vtkCPSnapshotAttributes(dataSet->GetPointData(), copy->GetPointData(),
+        input, allFields);
+      vtkCPSnapshotAttributes(dataSet->GetCellData(), copy->GetCellData(),
+        input, allFields);
+      copy->GetFieldData()->DeepCopy(dataSet->GetFieldData());
+      return copy;
+      }
+    vtkCompositeDataSet* composite = vtkCompositeDataSet::SafeDownCast(grid);
+    if(composite)
+      {
+      vtkCompositeDataSet* copy = composite->NewInstance();
+      copy->CopyStructure(composite);
+      vtkCompositeDataIterator* iter = composite->NewIterator();
+      for(iter->InitTraversal(); !iter->IsDoneWithTraversal();
+          iter->GoToNextItem())
+        {
+        vtkDataObject* block = vtkCPSnapshotGrid(
+          iter->GetCurrentDataObject(), input, allFields);
+        copy->SetDataSet(iter, block);
+        block->Delete();
+        }
+      iter->Delete();
+      copy->GetFieldData()->DeepCopy(composite->GetFieldData());
+      return copy;
+      }
+    vtkDataObject* copy = grid->NewInstance();
+    copy->DeepCopy(grid);
+    return copy;
+    }
+}
+
 vtkStandardNewMacro(vtkCPProcessor);
 vtkMultiProcessController* vtkCPProcessor::Controller = NULL;
 //----------------------------------------------------------------------------
 vtkCPProcessor::vtkCPProcessor()
 {
-  this->Internal = new vtkCPProcessorInternals;
+  this->Internal = new vtkCPProcessorInternals(this);
   this->InitializationHelper = NULL;
+  this->Asynchronous = false;
+  this->MaximumNumberOfQueuedSteps = 1;
 }
 
 //----------------------------------------------------------------------------
@@ -57,6 +323,7 @@ vtkCPProcessor::~vtkCPProcessor()
 {
   if(this->Internal)
     {
+    this->Internal->StopThread();
     delete this->Internal;
     this->Internal = NULL;
     }
@@ -77,7 +344,9 @@ int vtkCPProcessor::AddPipeline(vtkCPPipeline* pipeline)
     return 0;
     }
 
+  this->Internal->PipelinesLock->Lock();
   this->Internal->Pipelines.push_back(pipeline);
+  this->Internal->PipelinesLock->Unlock();
   return 1;
 }
 
@@ -112,13 +381,17 @@ vtkCPPipeline* vtkCPProcessor::GetPipeline(int which)
 //----------------------------------------------------------------------------
 void vtkCPProcessor::RemovePipeline(vtkCPPipeline* pipeline)
 {
+  this->Internal->PipelinesLock->Lock();
   this->Internal->Pipelines.remove(pipeline);
+  this->Internal->PipelinesLock->Unlock();
 }
 
 //----------------------------------------------------------------------------
 void vtkCPProcessor::RemoveAllPipelines()
 {
+  this->Internal->PipelinesLock->Lock();
   this->Internal->Pipelines.clear();
+  this->Internal->PipelinesLock->Unlock();
 }
 
 //----------------------------------------------------------------------------
@@ -208,6 +481,8 @@ int vtkCPProcessor::RequestDataDescription(
 
   dataDescription->ResetInputDescriptions();
   int doCoProcessing = 0;
+  // Only the simulation thread changes the list of pipelines, the helper
+  // thread may be running them.
   for(vtkCPProcessorInternals::PipelineListIterator iter =
         this->Internal->Pipelines.begin();
       iter!=this->Internal->Pipelines.end();iter++)
@@ -228,10 +503,97 @@ int vtkCPProcessor::CoProcess(vtkCPDataDescription* dataDescription)
     vtkWarningMacro("DataDescription is NULL.");
     return 0;
     }
+  if(!this->Asynchronous || !this->Internal->CanCoProcessAsynchronously())
+    {
+    // Process the steps queued before first.
+    int queued = this->Flush();
+    double start = vtkTimerLog::GetUniversalTime();
+    int success = this->RunPipelines(dataDescription) && queued;
+    this->Internal->SnapshotTime = 0;
+    this->Internal->WaitTime = 0;
+    this->Internal->AnalysisTime = vtkTimerLog::GetUniversalTime() - start;
+    this->Internal->ProcessedTimeStep = dataDescription->GetTimeStep();
+    // we want to reset everything here to make sure that new information
+    // is properly passed in the next time.
+    dataDescription->ResetAll();
+    return success;
+    }
+
+  // Copy what the pipelines asked for so that the simulation can go on.
+  double start = vtkTimerLog::GetUniversalTime();
+  vtkSmartPointer<vtkCPDataDescription> step =
+    vtkSmartPointer<vtkCPDataDescription>::New();
+  step->SetTimeData(dataDescription->GetTime(),
+    dataDescription->GetTimeStep());
+  step->SetForceOutput(dataDescription->GetForceOutput());
+  if(dataDescription->GetUserData())
+    {
+    vtkNew<vtkFieldData> userData;
+    userData->DeepCopy(dataDescription->GetUserData());
+    step->SetUserData(userData.GetPointer());
+    }
+  for(unsigned int i=0;i<dataDescription->GetNumberOfInputDescriptions();i++)
+    {
+    const char* name = dataDescription->GetInputDescriptionName(i);
+    vtkCPInputDataDescription* input = dataDescription->GetInputDescription(i);
+    step->AddInput(name);
+    vtkCPInputDataDescription* copy = step->GetInputDescriptionByName(name);
+    for(unsigned int f=0;f<input->GetNumberOfFields();f++)
+      {
+      const char* field = input->GetFieldName(f);
+      if(input->IsFieldPointData(field))
+        {
+        copy->AddPointField(field);
+        }
+      else
+        {
+        copy->AddCellField(field);
+        }
+      }
+    copy->SetAllFields(input->GetAllFields());
+    copy->SetGenerateMesh(input->GetGenerateMesh());
+    copy->SetWholeExtent(input->GetWholeExtent());
+    bool allFields = dataDescription->GetForceOutput();
+    if(input->GetGrid() && (allFields || input->GetIfGridIsNecessary()))
+      {
+      vtkDataObject* grid = vtkCPSnapshotGrid(input->GetGrid(), input,
+        allFields);
+      copy->SetGrid(grid);
+      grid->Delete();
+      }
+    }
+  double queueStart = vtkTimerLog::GetUniversalTime();
+
+  vtkCPProcessorInternals* internal = this->Internal;
+  internal->StartThread();
+  internal->Lock->Lock();
+  while(static_cast<int>(internal->Queue.size()) >=
+        this->MaximumNumberOfQueuedSteps)
+    {
+    internal->Condition->Wait(internal->Lock.GetPointer());
+    }
+  internal->Queue.push_back(step);
+  internal->Condition->Broadcast();
+  int success = internal->Success;
+  internal->Success = 1;
+  internal->Lock->Unlock();
+
+  internal->SnapshotTime = queueStart - start;
+  internal->WaitTime = vtkTimerLog::GetUniversalTime() - queueStart;
+  dataDescription->ResetAll();
+  return success;
+}
+
+//----------------------------------------------------------------------------
+int vtkCPProcessor::RunPipelines(vtkCPDataDescription* dataDescription)
+{
+  // Count the copies of shared simulation arrays made by this step only.
+  vtkCPInputDataDescription::ResetFallbackCopies();
+  vtkCPProcessorInternals::PipelineList pipelines =
+    this->Internal->GetPipelines();
   int success = 1;
-  for(vtkCPProcessorInternals::PipelineListIterator iter =
-        this->Internal->Pipelines.begin();
-      iter!=this->Internal->Pipelines.end();iter++)
+  for(vtkCPProcessorInternals::PipelineListIterator iter = pipelines.begin();
+      iter!=pipelines.end();iter++)
     {
     if(dataDescription->GetForceOutput() == false)
       {
@@ -253,15 +615,96 @@ int vtkCPProcessor::CoProcess(vtkCPDataDescription* dataDescription)
         }
       }
     }
-  // we want to reset everything here to make sure that new information
-  // is properly passed in the next time.
-  dataDescription->ResetAll();
   return success;
 }
 
+//----------------------------------------------------------------------------
+void vtkCPProcessor::SetAsynchronous(bool asynchronous)
+{
+  if(this->Asynchronous == asynchronous)
+    {
+    return;
+    }
+#ifdef PARAVIEW_USE_MPI
+  int initialized = 0;
+  MPI_Initialized(&initialized);
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  if(asynchronous && initialized && controller &&
+     controller->GetNumberOfProcesses() > 1)
+    {
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&provided);
+    if(provided < MPI_THREAD_MULTIPLE)
+      {
+      vtkWarningMacro("The pipelines can only run on a helper thread when "
+                      "MPI is initialized with MPI_THREAD_MULTIPLE. "
+                      "Staying synchronous.");
+      return;
+      }
+    }
+#endif
+  if(!asynchronous)
+    {
+    this->Internal->StopThread();
+    }
+  this->Asynchronous = asynchronous;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkCPProcessor::Flush()
+{
+  if(this->Internal->ThreadId < 0)
+    {
+    return 1;
+    }
+  return this->Internal->Flush();
+}
+
+//----------------------------------------------------------------------------
+double vtkCPProcessor::GetLastSnapshotTime()
+{
+  return this->Internal->SnapshotTime;
+}
+
+//----------------------------------------------------------------------------
+double vtkCPProcessor::GetLastWaitTime()
+{
+  return this->Internal->WaitTime;
+}
+
+//----------------------------------------------------------------------------
+double vtkCPProcessor::GetLastAnalysisTime()
+{
+  if(this->Internal->ThreadId < 0)
+    {
+    return this->Internal->AnalysisTime;
+    }
+  this->Internal->Lock->Lock();
+  double analysisTime = this->Internal->AnalysisTime;
+  this->Internal->Lock->Unlock();
+  return analysisTime;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCPProcessor::GetLastProcessedTimeStep()
+{
+  if(this->Internal->ThreadId < 0)
+    {
+    return this->Internal->ProcessedTimeStep;
+    }
+  this->Internal->Lock->Lock();
+  vtkIdType timeStep = this->Internal->ProcessedTimeStep;
+  this->Internal->Lock->Unlock();
+  return timeStep;
+}
+
 //----------------------------------------------------------------------------
 int vtkCPProcessor::Finalize()
 {
+  // The queued steps are processed before the pipelines are finalized.
+  this->Internal->StopThread();
   if(this->Controller)
     {
     this->Controller->SetGlobalController(NULL);
@@ -287,4 +730,12 @@ int vtkCPProcessor::Finalize()
 void vtkCPProcessor::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "Asynchronous: " << this->Asynchronous << "\n";
+  os << indent << "MaximumNumberOfQueuedSteps: "
+     << this->MaximumNumberOfQueuedSteps << "\n";
+  os << indent << "LastSnapshotTime: " << this->GetLastSnapshotTime() << "\n";
+  os << indent << "LastWaitTime: " << this->GetLastWaitTime() << "\n";
+  os << indent << "LastAnalysisTime: " << this->GetLastAnalysisTime() << "\n";
+  os << indent << "LastProcessedTimeStep: "
+     << this->GetLastProcessedTimeStep() << "\n";
 }
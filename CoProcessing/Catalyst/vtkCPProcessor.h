@@ -96,13 +96,61 @@ public:
 
   /// Processing Step:
   /// Provides the grid and the field data for the co-procesor to process.
-  /// Return value is 1 for success and 0 for failure.
+  /// Return value is 1 for success and 0 for failure. Afterwards,
+  /// vtkCPInputDataDescription::GetNumberOfFallbackCopies() tells how many
+  /// times the pipelines had to copy arrays that share simulation memory.
+  /// In asynchronous mode the return value is 0 if one of the steps
+  /// processed since the previous call failed, and the fallback copies
+  /// are counted for the step GetLastProcessedTimeStep() once the helper
+  /// thread processed it, e.g. after Flush().
   virtual int CoProcess(vtkCPDataDescription* dataDescription);
 
   /// Called after all co-processing is complete giving the Co-Processor
   /// implementation an opportunity to clean up, before it is destroyed.
   virtual int Finalize();
 
+  /// Asynchronous mode. When on, CoProcess() copies the fields that the
+  /// pipelines need (see vtkCPInputDataDescription::IsFieldNeeded()) into a
+  /// snapshot of the grids, queues it and returns. The pipelines process the
+  /// snapshots in order on a helper thread while the simulation goes on.
+  /// The mesh itself is not copied: the adaptor may replace the grids or
+  /// their fields but must not change their points or cells in place.
+  /// RequestDataDescription() does not wait for the helper thread: the
+  /// pipelines get it from the simulation thread while they process an
+  /// earlier step. The steps are processed on the simulation thread as in
+  /// synchronous mode while a pipeline cannot run on the helper thread,
+  /// see vtkCPPipeline::CanCoProcessAsynchronously().
+  /// In parallel this requires MPI initialized with MPI_THREAD_MULTIPLE.
+  /// The helper thread then gets its own duplicate of the communicator of
+  /// the global controller, which replaces the global controller until the
+  /// mode is turned off: the simulation must keep its own communicator.
+  /// Off by default. Turning it off waits for the queued steps to be
+  /// processed.
+  virtual void SetAsynchronous(bool asynchronous);
+  vtkGetMacro(Asynchronous, bool);
+
+  /// The number of snapshots that can wait for the helper thread in
+  /// addition to the one it processes. When the queue is full CoProcess()
+  /// waits for the helper thread, which bounds the memory used by the
+  /// snapshots. 1 by default.
+  vtkSetClampMacro(MaximumNumberOfQueuedSteps, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfQueuedSteps, int);
+
+  /// Waits until the helper thread processed all the queued steps. Returns
+  /// 1 when all the steps processed since the last call to Flush() or
+  /// CoProcess() succeeded and 0 otherwise. Does nothing in synchronous
+  /// mode.
+  virtual int Flush();
+
+  /// Timings in seconds of the last step: the time CoProcess() took to copy
+  /// the fields, the time it waited for room in the queue and the time the
+  /// pipelines took for the step LastProcessedTimeStep. In synchronous mode
+  /// the snapshot and wait times are 0.
+  double GetLastSnapshotTime();
+  double GetLastWaitTime();
+  double GetLastAnalysisTime();
+  vtkIdType GetLastProcessedTimeStep();
+
 protected:
   vtkCPProcessor();
   virtual ~vtkCPProcessor();
@@ -110,10 +158,17 @@ protected:
   /// Create a new instance of the InitializationHelper.
   virtual vtkObject* NewInitializationHelper();
 
+  /// Runs the pipelines that need to on dataDescription.
+  virtual int RunPipelines(vtkCPDataDescription* dataDescription);
+
+  bool Asynchronous;
+  int MaximumNumberOfQueuedSteps;
+
 private:
   vtkCPProcessor(const vtkCPProcessor&); // Not implemented
   void operator=(const vtkCPProcessor&); // Not implemented
 
+  friend struct vtkCPProcessorInternals;
   vtkCPProcessorInternals* Internal;
   vtkObject* InitializationHelper;
   static vtkMultiProcessController* Controller;
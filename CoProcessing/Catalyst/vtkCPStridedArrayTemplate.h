@@ -0,0 +1,142 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPStridedArrayTemplate.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#ifndef __vtkCPStridedArrayTemplate_h
+#define __vtkCPStridedArrayTemplate_h
+
+#include "vtkMappedDataArray.h"
+
+#include "vtkTimeStamp.h" // For CopyTime
+#include "vtkTypeTemplate.h" // For templated vtkObject API
+#include "vtkObjectFactory.h" // for vtkStandardNewMacro
+
+#include <vector> // For Components and Copy
+
+/// @ingroup CoProcessing
+/// vtkCPStridedArrayTemplate is a read-only vtkDataArray that uses simulation
+/// memory in place. Component c of tuple i is the value at
+/// components[c] + i * stride, which describes arrays of structures (the
+/// components of a tuple are next to each other), structures of arrays (each
+/// component is in its own array) as well as arrays with padding or other
+/// values in between.
+///
+/// The values are never copied unless a filter asks for a pointer to
+/// contiguous values with GetVoidPointer(). In that case a copy is made once
+/// per modification of the array and reported with
+/// vtkCPInputDataDescription::AddFallbackCopy().
+///
+/// The array does not own the simulation memory which must stay valid while
+/// the array is used. Call Modified() when the simulation changes the values.
+/// Use vtkCPInputDataDescription::AddSharedArray() or
+/// vtkCPInputDataDescription::AddSharedComponentArrays() rather than creating
+/// these arrays directly.
+template <class Scalar>
+class vtkCPStridedArrayTemplate:
+    public vtkTypeTemplate<vtkCPStridedArrayTemplate<Scalar>,
+                           vtkMappedDataArray<Scalar> >
+{
+public:
+  vtkMappedDataArrayNewInstanceMacro(
+      vtkCPStridedArrayTemplate<Scalar>)
+  static vtkCPStridedArrayTemplate *New();
+  virtual void PrintSelf(ostream &os, vtkIndent indent);
+
+  /// Set the simulation memory: numComp component pointers, the number of
+  /// tuples and the distance, in values, between two tuples of a component.
+  void SetComponentArrays(Scalar **components, int numComp,
+                          vtkIdType numTuples, vtkIdType stride);
+
+  // Reimplemented virtuals -- see superclasses for descriptions:
+  void Initialize();
+  void GetTuples(vtkIdList *ptIds, vtkAbstractArray *output);
+  void GetTuples(vtkIdType p1, vtkIdType p2, vtkAbstractArray *output);
+  void Squeeze();
+  vtkArrayIterator *NewIterator();
+  vtkIdType LookupValue(vtkVariant value);
+  void LookupValue(vtkVariant value, vtkIdList *ids);
+  vtkVariant GetVariantValue(vtkIdType idx);
+  void ClearLookup();
+  double* GetTuple(vtkIdType i);
+  void GetTuple(vtkIdType i, double *tuple);
+  vtkIdType LookupTypedValue(Scalar value);
+  void LookupTypedValue(Scalar value, vtkIdList *ids);
+  Scalar GetValue(vtkIdType idx);
+  Scalar& GetValueReference(vtkIdType idx);
+  void GetTupleValue(vtkIdType idx, Scalar *t);
+  void ExportToVoidPointer(void *ptr);
+
+  /// Returns a copy of the values, made once per modification of the array.
+  void *GetVoidPointer(vtkIdType id);
+
+  /// This container is read only -- this method does nothing but print a
+  /// warning.
+  int Allocate(vtkIdType sz, vtkIdType ext);
+  int Resize(vtkIdType numTuples);
+  void SetNumberOfTuples(vtkIdType number);
+  void SetTuple(vtkIdType i, vtkIdType j, vtkAbstractArray *source);
+  void SetTuple(vtkIdType i, const float *source);
+  void SetTuple(vtkIdType i, const double *source);
+  void InsertTuple(vtkIdType i, vtkIdType j, vtkAbstractArray *source);
+  void InsertTuple(vtkIdType i, const float *source);
+  void InsertTuple(vtkIdType i, const double *source);
+  void InsertTuples(vtkIdList *dstIds, vtkIdList *srcIds,
+                    vtkAbstractArray *source);
+  void InsertTuples(vtkIdType dstStart, vtkIdType n, vtkIdType srcStart,
+                    vtkAbstractArray* source);
+  vtkIdType InsertNextTuple(vtkIdType j, vtkAbstractArray *source);
+  vtkIdType InsertNextTuple(const float *source);
+  vtkIdType InsertNextTuple(const double *source);
+  void DeepCopy(vtkAbstractArray *aa);
+  void DeepCopy(vtkDataArray *da);
+  void InterpolateTuple(vtkIdType i, vtkIdList *ptIndices,
+                        vtkAbstractArray* source,  double* weights);
+  void InterpolateTuple(vtkIdType i, vtkIdType id1, vtkAbstractArray *source1,
+                        vtkIdType id2, vtkAbstractArray *source2, double t);
+  void SetVariantValue(vtkIdType idx, vtkVariant value);
+  void InsertVariantValue(vtkIdType idx, vtkVariant value);
+  void RemoveTuple(vtkIdType id);
+  void RemoveFirstTuple();
+  void RemoveLastTuple();
+  void SetTupleValue(vtkIdType i, const Scalar *t);
+  void InsertTupleValue(vtkIdType i, const Scalar *t);
+  vtkIdType InsertNextTupleValue(const Scalar *t);
+  void SetValue(vtkIdType idx, Scalar value);
+  vtkIdType InsertNextValue(Scalar v);
+  void InsertValue(vtkIdType idx, Scalar v);
+
+protected:
+  vtkCPStridedArrayTemplate();
+  ~vtkCPStridedArrayTemplate();
+
+  std::vector<Scalar*> Components;
+  vtkIdType Stride;
+
+  // The contiguous copy handed out by GetVoidPointer().
+  std::vector<Scalar> Copy;
+  vtkTimeStamp CopyTime;
+
+private:
+  vtkCPStridedArrayTemplate(
+      const vtkCPStridedArrayTemplate &); // Not implemented.
+  void operator=(
+      const vtkCPStridedArrayTemplate &); // Not implemented.
+
+  vtkIdType Lookup(const Scalar &val, vtkIdType startIndex);
+  std::vector<double> TempDoubleArray;
+};
+
+#include "vtkCPStridedArrayTemplate.txx"
+
+#endif //__vtkCPStridedArrayTemplate_h
+// VTK-HeaderTest-Exclude: vtkCPStridedArrayTemplate.h
@@ -0,0 +1,544 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPStridedArrayTemplate.txx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkCPStridedArrayTemplate.h"
+
+#include "vtkArrayIteratorTemplate.h"
+#include "vtkCPInputDataDescription.h"
+#include "vtkIdList.h"
+#include "vtkObjectFactory.h"
+#include "vtkVariant.h"
+#include "vtkVariantCast.h"
+
+//------------------------------------------------------------------------------
+// Can't use vtkStandardNewMacro with a template.
+template <class Scalar> vtkCPStridedArrayTemplate<Scalar> *
+vtkCPStridedArrayTemplate<Scalar>::New()
+{
+  VTK_STANDARD_NEW_BODY(vtkCPStridedArrayTemplate<Scalar>)
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::PrintSelf(ostream &os, vtkIndent indent)
+{
+  this->vtkCPStridedArrayTemplate<Scalar>::Superclass::PrintSelf(
+        os, indent);
+  os << indent << "Components:";
+  for (size_t c = 0; c < this->Components.size(); ++c)
+    {
+    os << " " << this->Components[c];
+    }
+  os << std::endl;
+  os << indent << "Stride: " << this->Stride << std::endl;
+  os << indent << "Copy: " << (this->Copy.empty() ? "none" : "made")
+     << std::endl;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::Initialize()
+{
+  this->Components.clear();
+  this->Stride = 1;
+  this->Copy.clear();
+  this->MaxId = -1;
+  this->Size = 0;
+  this->NumberOfComponents = 1;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::GetTuples(vtkIdList *ptIds, vtkAbstractArray *output)
+{
+  vtkDataArray *outArray = vtkDataArray::FastDownCast(output);
+  if (!outArray)
+    {
+    vtkWarningMacro(<<"Input is not a vtkDataArray");
+    return;
+    }
+
+  vtkIdType numTuples = ptIds->GetNumberOfIds();
+
+  outArray->SetNumberOfComponents(this->NumberOfComponents);
+  outArray->SetNumberOfTuples(numTuples);
+
+  for (vtkIdType i = 0; i < numTuples; ++i)
+    {
+    outArray->SetTuple(i, this->GetTuple(ptIds->GetId(i)));
+    }
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::GetTuples(vtkIdType p1, vtkIdType p2, vtkAbstractArray *output)
+{
+  vtkDataArray *da = vtkDataArray::FastDownCast(output);
+  if (!da)
+    {
+    vtkErrorMacro(<<"Input is not a vtkDataArray");
+    return;
+    }
+
+  if (da->GetNumberOfComponents() != this->GetNumberOfComponents())
+    {
+    vtkErrorMacro(<<"Incorrect number of components in input array.");
+    return;
+    }
+
+  for (vtkIdType daTupleId = 0; p1 <= p2; ++p1)
+    {
+    da->SetTuple(daTupleId++, this->GetTuple(p1));
+    }
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::Squeeze()
+{
+  // noop
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkArrayIterator*
+vtkCPStridedArrayTemplate<Scalar>::NewIterator()
+{
+  // The iterator works on contiguous values, i.e. on the copy.
+  vtkArrayIteratorTemplate<Scalar> *iter =
+    vtkArrayIteratorTemplate<Scalar>::New();
+  iter->Initialize(this);
+  return iter;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkIdType vtkCPStridedArrayTemplate<Scalar>
+::LookupValue(vtkVariant value)
+{
+  bool valid = true;
+  Scalar val = vtkVariantCast<Scalar>(value, &valid);
+  if (valid)
+    {
+    return this->Lookup(val, 0);
+    }
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::LookupValue(vtkVariant value, vtkIdList *ids)
+{
+  bool valid = true;
+  Scalar val = vtkVariantCast<Scalar>(value, &valid);
+  ids->Reset();
+  if (valid)
+    {
+    vtkIdType index = 0;
+    while ((index = this->Lookup(val, index)) >= 0)
+      {
+      ids->InsertNextId(index++);
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkVariant vtkCPStridedArrayTemplate<Scalar>
+::GetVariantValue(vtkIdType idx)
+{
+  return vtkVariant(this->GetValueReference(idx));
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::ClearLookup()
+{
+  // no-op, no fast lookup implemented.
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> double* vtkCPStridedArrayTemplate<Scalar>
+::GetTuple(vtkIdType i)
+{
+  this->TempDoubleArray.resize(this->NumberOfComponents);
+  this->GetTuple(i, &this->TempDoubleArray[0]);
+  return &this->TempDoubleArray[0];
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::GetTuple(vtkIdType i, double *tuple)
+{
+  const vtkIdType offset = i * this->Stride;
+  for (int c = 0; c < this->NumberOfComponents; ++c)
+    {
+    tuple[c] = static_cast<double>(this->Components[c][offset]);
+    }
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkIdType vtkCPStridedArrayTemplate<Scalar>
+::LookupTypedValue(Scalar value)
+{
+  return this->Lookup(value, 0);
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::LookupTypedValue(Scalar value, vtkIdList *ids)
+{
+  ids->Reset();
+  vtkIdType index = 0;
+  while ((index = this->Lookup(value, index)) >= 0)
+    {
+    ids->InsertNextId(index++);
+    }
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> Scalar vtkCPStridedArrayTemplate<Scalar>
+::GetValue(vtkIdType idx)
+{
+  return this->GetValueReference(idx);
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> Scalar& vtkCPStridedArrayTemplate<Scalar>
+::GetValueReference(vtkIdType idx)
+{
+  const vtkIdType tuple = idx / this->NumberOfComponents;
+  const int comp = static_cast<int>(idx % this->NumberOfComponents);
+  return this->Components[comp][tuple * this->Stride];
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::GetTupleValue(vtkIdType tupleId, Scalar *tuple)
+{
+  const vtkIdType offset = tupleId * this->Stride;
+  for (int c = 0; c < this->NumberOfComponents; ++c)
+    {
+    tuple[c] = this->Components[c][offset];
+    }
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::ExportToVoidPointer(void *ptr)
+{
+  Scalar *out = static_cast<Scalar*>(ptr);
+  const int numComp = this->NumberOfComponents;
+  const vtkIdType numTuples = this->GetNumberOfTuples();
+  for (int c = 0; c < numComp; ++c)
+    {
+    const Scalar *in = this->Components[c];
+    Scalar *outComp = out + c;
+    for (vtkIdType i = 0; i < numTuples; ++i)
+      {
+      outComp[i * numComp] = in[i * this->Stride];
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void* vtkCPStridedArrayTemplate<Scalar>
+::GetVoidPointer(vtkIdType id)
+{
+  if (this->Size == 0)
+    {
+    return NULL;
+    }
+  if (this->Copy.empty() || this->CopyTime < this->GetMTime())
+    {
+    this->Copy.resize(this->Size);
+    this->ExportToVoidPointer(&this->Copy[0]);
+    this->CopyTime.Modified();
+    vtkCPInputDataDescription::AddFallbackCopy(
+      static_cast<vtkIdType>(this->Size * sizeof(Scalar)));
+    }
+  return &this->Copy[0] + id;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> int vtkCPStridedArrayTemplate<Scalar>
+::Allocate(vtkIdType, vtkIdType)
+{
+  vtkErrorMacro("Read only container.")
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> int vtkCPStridedArrayTemplate<Scalar>
+::Resize(vtkIdType)
+{
+  vtkErrorMacro("Read only container.")
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::SetNumberOfTuples(vtkIdType)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::SetTuple(vtkIdType, vtkIdType, vtkAbstractArray *)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::SetTuple(vtkIdType, const float *)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::SetTuple(vtkIdType, const double *)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::InsertTuple(vtkIdType, vtkIdType, vtkAbstractArray *)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::InsertTuple(vtkIdType, const float *)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::InsertTuple(vtkIdType, const double *)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::InsertTuples(vtkIdList *, vtkIdList *, vtkAbstractArray *)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::InsertTuples(vtkIdType, vtkIdType, vtkIdType, vtkAbstractArray *)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkIdType vtkCPStridedArrayTemplate<Scalar>
+::InsertNextTuple(vtkIdType, vtkAbstractArray *)
+{
+  vtkErrorMacro("Read only container.")
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkIdType vtkCPStridedArrayTemplate<Scalar>
+::InsertNextTuple(const float *)
+{
+  vtkErrorMacro("Read only container.")
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkIdType vtkCPStridedArrayTemplate<Scalar>
+::InsertNextTuple(const double *)
+{
+  vtkErrorMacro("Read only container.")
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::DeepCopy(vtkAbstractArray *)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::DeepCopy(vtkDataArray *)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::InterpolateTuple(vtkIdType, vtkIdList *, vtkAbstractArray *, double *)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::InterpolateTuple(vtkIdType, vtkIdType, vtkAbstractArray*, vtkIdType,
+                   vtkAbstractArray*, double)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::SetVariantValue(vtkIdType, vtkVariant)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::InsertVariantValue(vtkIdType, vtkVariant)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::RemoveTuple(vtkIdType)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::RemoveFirstTuple()
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::RemoveLastTuple()
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::SetTupleValue(vtkIdType, const Scalar*)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::InsertTupleValue(vtkIdType, const Scalar*)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkIdType vtkCPStridedArrayTemplate<Scalar>
+::InsertNextTupleValue(const Scalar *)
+{
+  vtkErrorMacro("Read only container.")
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::SetValue(vtkIdType, Scalar)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkIdType vtkCPStridedArrayTemplate<Scalar>
+::InsertNextValue(Scalar)
+{
+  vtkErrorMacro("Read only container.")
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::InsertValue(vtkIdType, Scalar)
+{
+  vtkErrorMacro("Read only container.")
+  return;
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkCPStridedArrayTemplate<Scalar>
+::vtkCPStridedArrayTemplate()
+  : Stride(1)
+{
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkCPStridedArrayTemplate<Scalar>
+::~vtkCPStridedArrayTemplate()
+{ }
+
+//------------------------------------------------------------------------------
+template <class Scalar> void vtkCPStridedArrayTemplate<Scalar>
+::SetComponentArrays(Scalar **components, int numComp, vtkIdType numTuples,
+                     vtkIdType stride)
+{
+  this->Initialize();
+  this->Components.assign(components, components + numComp);
+  this->Stride = stride;
+  this->NumberOfComponents = numComp;
+  this->Size = this->NumberOfComponents * numTuples;
+  this->MaxId = this->Size - 1;
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+template <class Scalar> vtkIdType vtkCPStridedArrayTemplate<Scalar>
+::Lookup(const Scalar &val, vtkIdType index)
+{
+  while (index <= this->MaxId)
+    {
+    if (this->GetValueReference(index) == val)
+      {
+      return index;
+      }
+    ++index;
+    }
+  return -1;
+}
@@ -6,6 +6,7 @@
 # COPROCESSING_TEST_SCRIPT -- python script to run
 # COPROCESSING_IMAGE_TESTER -- path to CoProcessingCompareImagesTester
 # COPROCESSING_DATA_DIR     -- path to data dir for baselines
+# COPROCESSING_BROADCAST_BYTECODE -- broadcast the Python bytecode from process 0
 
 # USE_MPI
 # MPIEXEC
@@ -22,20 +23,27 @@ if(NOT EXISTS "${COPROCESSING_TEST_DRIVER}")
   message(FATAL_ERROR "'${COPROCESSING_TEST_DRIVER}' does not exist")
 endif()
 
+set(COPROCESSING_TEST_DRIVER_ARGS)
+if (COPROCESSING_BROADCAST_BYTECODE)
+  set(COPROCESSING_TEST_DRIVER_ARGS --broadcast-bytecode)
+endif()
+
 if (USE_MPI)
   message("Executing :
       ${MPIEXEC} ${MPIEXEC_NUMPROC_FLAG} ${MPIEXEC_NUMPROCS} ${MPIEXEC_PREFLAGS}
       \"${COPROCESSING_TEST_DRIVER}\"
-      \"${COPROCESSING_TEST_SCRIPT}\"")
+      \"${COPROCESSING_TEST_SCRIPT}\" ${COPROCESSING_TEST_DRIVER_ARGS}")
   execute_process(COMMAND
       ${MPIEXEC} ${MPIEXEC_NUMPROC_FLAG} ${MPIEXEC_NUMPROCS} ${MPIEXEC_PREFLAGS}
       "${COPROCESSING_TEST_DRIVER}"
       "${COPROCESSING_TEST_SCRIPT}"
+      ${COPROCESSING_TEST_DRIVER_ARGS}
     WORKING_DIRECTORY ${COPROCESSING_TEST_DIR}
     RESULT_VARIABLE rv)
 else()
-  message("Executing : \"${COPROCESSING_TEST_DRIVER}\" \"${COPROCESSING_TEST_SCRIPT}\"")
+  message("Executing : \"${COPROCESSING_TEST_DRIVER}\" \"${COPROCESSING_TEST_SCRIPT}\" ${COPROCESSING_TEST_DRIVER_ARGS}")
   execute_process(COMMAND "${COPROCESSING_TEST_DRIVER}" "${COPROCESSING_TEST_SCRIPT}"
+    ${COPROCESSING_TEST_DRIVER_ARGS}
     WORKING_DIRECTORY ${COPROCESSING_TEST_DIR}
     RESULT_VARIABLE rv)
 endif()
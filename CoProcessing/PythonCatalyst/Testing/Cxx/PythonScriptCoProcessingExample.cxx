@@ -23,12 +23,14 @@
 # include "vtkMPI.h"
 #endif
 #include <iostream>
+#include <string.h>
 
 int main(int argc, char* argv[])
 {
   if(argc < 2)
     {
-    cerr << "Wrong number of arguments.  Command is: <exe> <python script>\n";
+    cerr << "Wrong number of arguments.  Command is: <exe> <python script>"
+         << " [--broadcast-bytecode]\n";
     return 1;
     }
 #ifdef PARAVIEW_USE_MPI
@@ -36,6 +38,8 @@ int main(int argc, char* argv[])
 #endif
   int errors = 0;
   vtkPVCustomTestDriver* testDriver = vtkPVCustomTestDriver::New();
+  testDriver->SetBroadcastBytecode(
+    argc > 2 && strcmp(argv[2], "--broadcast-bytecode") == 0);
   if(testDriver->Initialize(argv[1]))
     {
     testDriver->SetNumberOfTimeSteps(1);
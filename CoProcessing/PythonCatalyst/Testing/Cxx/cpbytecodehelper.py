@@ -0,0 +1,5 @@
+# Module that cpbytecodeimport.py imports from the directory of the script
+
+def GetValue():
+    "Returns the value that cpbytecodeimport.py checks"
+    return 42
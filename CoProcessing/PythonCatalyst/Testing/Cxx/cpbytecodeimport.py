@@ -0,0 +1,23 @@
+# Script to make sure that when process 0 broadcasts the Python bytecode,
+# the other processes import the paraview modules from that bytecode and
+# can still import another script from the directory of this one
+
+from paraview import servermanager
+import paraview.simple
+import cpbytecodehelper
+
+_rank = servermanager.vtkProcessModule.GetProcessModule().GetPartitionId()
+_loader = getattr(paraview.simple, '__loader__', None)
+if _rank > 0 and type(_loader).__name__ != '_vtkCPBundleImporter':
+    raise SystemExit("process %d did not import paraview.simple from the "
+                     "broadcast bytecode" % _rank)
+if cpbytecodehelper.GetValue() != 42:
+    raise SystemExit("process %d did not import cpbytecodehelper" % _rank)
+
+def RequestDataDescription(datadescription):
+    "Callback to populate the request for current timestep -- NULL for this test"
+    pass
+
+def DoCoProcessing(datadescription):
+    "Callback to do co-processing for current timestep -- NULL for this test"
+    pass
@@ -36,6 +36,7 @@ vtkPVCustomTestDriver::vtkPVCustomTestDriver()
 {
   this->Processor = vtkCPProcessor::New();
   this->Processor->Initialize();
+  this->BroadcastBytecode = false;
 
   // Specify how the field varies over space and time.
   vtkCPLinearScalarFieldFunction* fieldFunction =
@@ -143,6 +144,7 @@ int vtkPVCustomTestDriver::Run()
 int vtkPVCustomTestDriver::Initialize(const char* fileName)
 {
   vtkCPPythonScriptPipeline* pipeline = vtkCPPythonScriptPipeline::New();
+  pipeline->SetBroadcastBytecode(this->BroadcastBytecode);
 
   int success = pipeline->Initialize(fileName);
   this->Processor->AddPipeline(pipeline);
@@ -190,4 +192,5 @@ void vtkPVCustomTestDriver::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "Processor: " << this->Processor << endl;
+  os << indent << "BroadcastBytecode: " << this->BroadcastBytecode << endl;
 }
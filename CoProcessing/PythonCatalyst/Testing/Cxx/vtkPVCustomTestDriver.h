@@ -46,6 +46,14 @@ public:
   // Finalize the driver with the coprocessor.
   virtual int Finalize();
 
+  // Description:
+  // When on, process 0 broadcasts the bytecode of the python script and of
+  // the paraview modules to the other processes, see
+  // vtkCPPythonScriptPipeline::SetBroadcastBytecode(). Must be set before
+  // Initialize(). Off by default.
+  vtkSetMacro(BroadcastBytecode, bool);
+  vtkGetMacro(BroadcastBytecode, bool);
+
 protected:
   vtkPVCustomTestDriver();
   ~vtkPVCustomTestDriver();
@@ -57,6 +65,8 @@ private:
   // Description:
   // The coprocessor to be called by this custom test.
   vtkCPProcessor* Processor;
+
+  bool BroadcastBytecode;
 };
 
 #endif
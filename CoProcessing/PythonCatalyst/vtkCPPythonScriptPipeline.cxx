@@ -12,6 +12,7 @@
   PURPOSE.  See the above copyright notice for more information.
 
   =========================================================================*/
+#include "vtkPython.h" // must be the first thing that's included
 #include "vtkCPPythonScriptPipeline.h"
 
 #include "vtkCPDataDescription.h"
@@ -25,10 +26,12 @@
 #include "vtkPythonInterpreter.h"
 #include "vtkSMObject.h"
 #include "vtkSMProxyManager.h"
+#include "vtkTimerLog.h"
 
 #include <string>
 #include <vtksys/SystemTools.hxx>
 #include <sstream>
+#include <vector>
 
 extern "C" {
   void vtkPVInitializePythonModules();
@@ -37,12 +40,145 @@ extern "C" {
 namespace
 {
 //----------------------------------------------------------------------------
-  void InitializePython()
+  // Sets the variable name of __main__ to a Python string holding data.
+  void SetMainString(const char* name, const std::vector<char>& data)
+  {
+    PyObject* value = PyString_FromStringAndSize(
+      data.empty() ? NULL : &data[0], static_cast<Py_ssize_t>(data.size()));
+    PyObject* mainDict = PyModule_GetDict(
+      PyImport_AddModule(const_cast<char*>("__main__")));
+    PyDict_SetItemString(mainDict, const_cast<char*>(name), value);
+    Py_DECREF(value);
+  }
+
+//----------------------------------------------------------------------------
+  // Moves the Python string in the variable name of __main__, if any, to data.
+  void TakeMainString(const char* name, std::vector<char>& data)
+  {
+    data.clear();
+    PyObject* mainDict = PyModule_GetDict(
+      PyImport_AddModule(const_cast<char*>("__main__")));
+    PyObject* value = PyDict_GetItemString(mainDict, const_cast<char*>(name));
+    if (value && PyString_Check(value))
+      {
+      const char* bytes = PyString_AS_STRING(value);
+      data.assign(bytes, bytes + PyString_GET_SIZE(value));
+      }
+    if (value)
+      {
+      PyDict_DelItemString(mainDict, const_cast<char*>(name));
+      }
+  }
+
+//----------------------------------------------------------------------------
+  // Broadcasts data from process 0 and returns the time it took.
+  double BroadcastBytes(vtkMultiProcessController* controller,
+    std::vector<char>& data)
+  {
+    double start = vtkTimerLog::GetUniversalTime();
+    vtkIdType size = static_cast<vtkIdType>(data.size());
+    controller->Broadcast(&size, 1, 0);
+    data.resize(size);
+    if (size > 0)
+      {
+      controller->Broadcast(&data[0], size, 0);
+      }
+    return vtkTimerLog::GetUniversalTime() - start;
+  }
+
+//----------------------------------------------------------------------------
+  // Run on process 0 once the modules are imported: marshals the code of
+  // every module loaded from a Python source file as a list of
+  // (name, is package, file name, marshaled code) into _vtkCPModuleBundle.
+  const char* BuildModuleBundle =
+    "def _vtkCPBuildModuleBundle():\n"
+    "  import marshal, os, sys\n"
+    "  modules = []\n"
+    "  for name, module in sys.modules.items():\n"
+    "    fileName = getattr(module, '__file__', None)\n"
+    "    if not fileName or name == '__main__':\n"
+    "      continue\n"
+    "    if fileName.endswith('.pyc') or fileName.endswith('.pyo'):\n"
+    "      fileName = fileName[:-1]\n"
+    "    if not fileName.endswith('.py') or not os.path.isfile(fileName):\n"
+    "      continue\n"
+    "    try:\n"
+    "      code = compile(open(fileName, 'rU').read(), fileName, 'exec')\n"
+    "    except Exception:\n"
+    "      continue\n"
+    "    modules.append((name, hasattr(module, '__path__'), fileName,\n"
+    "                    marshal.dumps(code)))\n"
+    "  return marshal.dumps(modules)\n"
+    "_vtkCPModuleBundle = _vtkCPBuildModuleBundle()\n"
+    "del _vtkCPBuildModuleBundle\n";
+
+//----------------------------------------------------------------------------
+  // Run on the other processes before the modules are imported: serves the
+  // modules of _vtkCPModuleBundle from memory. Packages keep their directory
+  // as __path__ so that their extension modules are still found.
+  const char* InstallModuleBundle =
+    "import imp, marshal, os, sys\n"
+    "class _vtkCPBundleImporter(object):\n"
+    "  def __init__(self, bundle):\n"
+    "    self.Modules = {}\n"
+    "    for name, package, fileName, code in marshal.loads(bundle):\n"
+    "      self.Modules[name] = (package, fileName, code)\n"
+    "  def find_module(self, fullname, path=None):\n"
+    "    if fullname in self.Modules:\n"
+    "      return self\n"
+    "    return None\n"
+    "  def load_module(self, fullname):\n"
+    "    if fullname in sys.modules:\n"
+    "      return sys.modules[fullname]\n"
+    "    package, fileName, code = self.Modules.pop(fullname)\n"
+    "    module = imp.new_module(fullname)\n"
+    "    module.__file__ = fileName\n"
+    "    module.__loader__ = self\n"
+    "    if package:\n"
+    "      module.__path__ = [os.path.dirname(fileName)]\n"
+    "      module.__package__ = fullname\n"
+    "    else:\n"
+    "      module.__package__ = fullname.rpartition('.')[0]\n"
+    "    sys.modules[fullname] = module\n"
+    "    try:\n"
+    "      exec marshal.loads(code) in module.__dict__\n"
+    "    except:\n"
+    "      del sys.modules[fullname]\n"
+    "      raise\n"
+    "    return sys.modules[fullname]\n"
+    "sys.meta_path.insert(0, _vtkCPBundleImporter(_vtkCPModuleBundle))\n"
+    "del _vtkCPModuleBundle\n";
+
+//----------------------------------------------------------------------------
+  // State of the main thread when Catalyst initialized Python itself. The
+  // main thread then only holds the global interpreter lock while it runs
+  // Python code, so that the pipelines can also run on the helper thread of
+  // an asynchronous vtkCPProcessor. NULL when the application initialized
+  // Python, or once the main thread took the lock back to finalize Python.
+  PyThreadState* MainThreadState = NULL;
+
+//----------------------------------------------------------------------------
+  // Holds the global interpreter lock while in scope.
+  class vtkCPPythonLock
+  {
+  public:
+    vtkCPPythonLock() { this->State = PyGILState_Ensure(); }
+    ~vtkCPPythonLock() { PyGILState_Release(this->State); }
+  private:
+    PyGILState_STATE State;
+  };
+
+//----------------------------------------------------------------------------
+  // Initializes Python and imports the paraview modules the first time it is
+  // called. With a controller, process 0 also imports the modules used by
+  // coprocessing scripts and broadcasts their bytecode, which the other
+  // processes import from memory. Returns the time spent broadcasting.
+  double InitializePython(vtkMultiProcessController* controller = NULL)
   {
     static bool initialized = false;
     if (initialized)
       {
-      return;
+      return 0;
       }
     initialized = true;
 
@@ -50,7 +186,26 @@ namespace
     // empty when BUILD_SHARED_LIBS is ON.
     vtkPVInitializePythonModules();
 
+    bool ownsInterpreter = !vtkPythonInterpreter::IsInitialized();
     vtkPythonInterpreter::Initialize();
+    if (ownsInterpreter)
+      {
+      PyEval_InitThreads();
+      }
+    PyGILState_STATE gilState = PyGILState_Ensure();
+
+    double broadcastTime = 0;
+    std::vector<char> bundle;
+    if (controller && controller->GetNumberOfProcesses() > 1 &&
+        controller->GetLocalProcessId() != 0)
+      {
+      broadcastTime = BroadcastBytes(controller, bundle);
+      if (!bundle.empty())
+        {
+        SetMainString("_vtkCPModuleBundle", bundle);
+        vtkPythonInterpreter::RunSimpleString(InstallModuleBundle);
+        }
+      }
 
     std::ostringstream loadPythonModules;
     loadPythonModules
@@ -65,7 +220,31 @@ namespace
       << "paraview.print_error = f1\n"
       << "paraview.print_debug_info = f2\n"
       << "import vtkPVCatalystPython\n";
+    if (controller)
+      {
+      loadPythonModules
+        << "try:\n"
+        << "  import paraview.simple\n"
+        << "  import paraview.coprocessing\n"
+        << "except ImportError:\n"
+        << "  pass\n";
+      }
     vtkPythonInterpreter::RunSimpleString(loadPythonModules.str().c_str());
+
+    if (controller && controller->GetNumberOfProcesses() > 1 &&
+        controller->GetLocalProcessId() == 0)
+      {
+      vtkPythonInterpreter::RunSimpleString(BuildModuleBundle);
+      TakeMainString("_vtkCPModuleBundle", bundle);
+      broadcastTime = BroadcastBytes(controller, bundle);
+      }
+
+    PyGILState_Release(gilState);
+    if (ownsInterpreter)
+      {
+      MainThreadState = PyEval_SaveThread();
+      }
+    return broadcastTime;
   }
 
 //----------------------------------------------------------------------------
@@ -90,6 +269,11 @@ vtkStandardNewMacro(vtkCPPythonScriptPipeline);
 vtkCPPythonScriptPipeline::vtkCPPythonScriptPipeline()
 {
   this->PythonScriptName = 0;
+  this->BroadcastBytecode = false;
+  this->ReadTime = 0;
+  this->BroadcastTime = 0;
+  this->PythonInitializationTime = 0;
+  this->ImportTime = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -101,6 +285,11 @@ vtkCPPythonScriptPipeline::~vtkCPPythonScriptPipeline()
 //----------------------------------------------------------------------------
 int vtkCPPythonScriptPipeline::Initialize(const char* fileName)
 {
+  this->ReadTime = 0;
+  this->BroadcastTime = 0;
+  this->PythonInitializationTime = 0;
+  this->ImportTime = 0;
+
   // only process 0 checks if the file exists and broadcasts that information
   // to the other processes
   int fileExists = 0;
@@ -117,7 +306,12 @@ int vtkCPPythonScriptPipeline::Initialize(const char* fileName)
     return 0;
     }
 
-  InitializePython();
+  double start = vtkTimerLog::GetUniversalTime();
+  this->BroadcastTime =
+    InitializePython(this->BroadcastBytecode ? controller : NULL);
+  this->PythonInitializationTime =
+    vtkTimerLog::GetUniversalTime() - start - this->BroadcastTime;
+  vtkCPPythonLock lock;
 
   // for now do not check on filename extension:
   //vtksys::SystemTools::GetFilenameLastExtension(FileName) == ".py" == 0)
@@ -128,14 +322,31 @@ int vtkCPPythonScriptPipeline::Initialize(const char* fileName)
   // need to save the script name as it is used as the name of the module
   this->SetPythonScriptName(fileNameName.c_str());
 
-  // only process 0 reads the actual script and then broadcasts it out
-  char* scriptText = NULL;
+  // only process 0 reads the actual script and then broadcasts it out,
+  // compiled with BroadcastBytecode
+  std::vector<char> scriptText;
   // we need to add the script path to PYTHONPATH
-  char* scriptPath = NULL;
+  std::vector<char> scriptPath;
 
   int rank = controller->GetLocalProcessId();
-  int scriptSizes[2] = {0, 0};
-  if(rank == 0)
+  start = vtkTimerLog::GetUniversalTime();
+  if(rank == 0 && this->BroadcastBytecode)
+    {
+    SetMainString("_vtkCPScriptFileName",
+      std::vector<char>(fileName, fileName + strlen(fileName)));
+    std::ostringstream compileScript;
+    compileScript
+      << "try:\n"
+      << "  import marshal\n"
+      << "  _vtkCPScriptCode = marshal.dumps(compile(\n"
+      << "    open(_vtkCPScriptFileName, 'rU').read(), '" << fileNameName
+      << ".py', 'exec'))\n"
+      << "finally:\n"
+      << "  del _vtkCPScriptFileName\n";
+    vtkPythonInterpreter::RunSimpleString(compileScript.str().c_str());
+    TakeMainString("_vtkCPScriptCode", scriptText);
+    }
+  else if(rank == 0)
     {
     std::string line;
     std::ifstream myfile (fileName);
@@ -149,32 +360,28 @@ int vtkCPPythonScriptPipeline::Initialize(const char* fileName)
         }
       myfile.close();
       }
-
+    scriptText.assign(desiredString.begin(), desiredString.end());
+    }
+  if(rank == 0)
+    {
     if(fileNamePath.empty())
       {
       fileNamePath = ".";
       }
-    scriptSizes[0] = static_cast<int>(fileNamePath.size()+1);
-    scriptPath = new char[scriptSizes[0]];
-    memcpy(scriptPath, fileNamePath.c_str(), sizeof(char)*scriptSizes[0]);
-
-    scriptSizes[1] = static_cast<int>(desiredString.size()+1);
-    scriptText = new char[scriptSizes[1]];
-    memcpy(scriptText, desiredString.c_str(), sizeof(char)*scriptSizes[1]);
+    scriptPath.assign(fileNamePath.begin(), fileNamePath.end());
     }
+  this->ReadTime = vtkTimerLog::GetUniversalTime() - start;
 
-  controller->Broadcast(scriptSizes, 2, 0);
-
-  if (rank != 0)
+  this->BroadcastTime += BroadcastBytes(controller, scriptPath);
+  this->BroadcastTime += BroadcastBytes(controller, scriptText);
+  if(this->BroadcastBytecode && scriptText.empty())
     {
-    scriptPath = new char[scriptSizes[0]];
-    scriptText = new char[scriptSizes[1]];
+    vtkErrorMacro("Could not compile " << fileName);
+    return 0;
     }
 
-  controller->Broadcast(scriptPath, scriptSizes[0], 0);
-  controller->Broadcast(scriptText, scriptSizes[1], 0);
-
-  vtkPythonInterpreter::PrependPythonPath(scriptPath);
+  scriptPath.push_back(0);
+  vtkPythonInterpreter::PrependPythonPath(&scriptPath[0]);
 
   // The code below creates a module from the scriptText string.
   // This requires the manual creation of a module object like this:
@@ -190,6 +397,9 @@ int vtkCPPythonScriptPipeline::Initialize(const char* fileName)
   // del _source
   // del _code
   // import foo
+  //
+  // With BroadcastBytecode the code object is unmarshaled from the
+  // broadcast bytecode instead of being compiled.
   std::ostringstream loadPythonModules;
   loadPythonModules << "import types" << std::endl;
   loadPythonModules << "_" << fileNameName << " = types.ModuleType('" << fileNameName << "')" << std::endl;
@@ -198,20 +408,30 @@ int vtkCPPythonScriptPipeline::Initialize(const char* fileName)
   loadPythonModules << "import sys" << std::endl;
   loadPythonModules << "sys.modules['" << fileNameName << "'] = _" << fileNameName << std::endl;
 
-  loadPythonModules << "_source = \"\"\"" << std::endl;
-  loadPythonModules << scriptText;
-  loadPythonModules << "\"\"\"" << std::endl;
+  if(this->BroadcastBytecode)
+    {
+    SetMainString("_vtkCPScriptCode", scriptText);
+    loadPythonModules << "import marshal" << std::endl;
+    loadPythonModules << "_code = marshal.loads(_vtkCPScriptCode)" << std::endl;
+    loadPythonModules << "del _vtkCPScriptCode" << std::endl;
+    }
+  else
+    {
+    scriptText.push_back(0);
+    loadPythonModules << "_source = \"\"\"" << std::endl;
+    loadPythonModules << &scriptText[0];
+    loadPythonModules << "\"\"\"" << std::endl;
 
-  loadPythonModules << "_code = compile(_source, \"" << fileNameName << ".py\", \"exec\")" << std::endl;
+    loadPythonModules << "_code = compile(_source, \"" << fileNameName << ".py\", \"exec\")" << std::endl;
+    loadPythonModules << "del _source" << std::endl;
+    }
   loadPythonModules << "exec _code in _" << fileNameName << ".__dict__" << std::endl;
-  loadPythonModules << "del _source" << std::endl;
   loadPythonModules << "del _code" << std::endl;
   loadPythonModules << "import " << fileNameName << std::endl;
 
-  delete[] scriptPath;
-  delete[] scriptText;
-
+  start = vtkTimerLog::GetUniversalTime();
   vtkPythonInterpreter::RunSimpleString(loadPythonModules.str().c_str());
+  this->ImportTime = vtkTimerLog::GetUniversalTime() - start;
   return 1;
 }
 
@@ -226,6 +446,7 @@ int vtkCPPythonScriptPipeline::RequestDataDescription(
     }
 
   InitializePython();
+  vtkCPPythonLock lock;
 
   // check the script to see if it should be run...
   vtkStdString dataDescriptionString = this->GetPythonAddress(dataDescription);
@@ -251,6 +472,7 @@ int vtkCPPythonScriptPipeline::CoProcess(
     }
 
   InitializePython();
+  vtkCPPythonLock lock;
 
   vtkStdString dataDescriptionString = this->GetPythonAddress(dataDescription);
 
@@ -269,6 +491,13 @@ int vtkCPPythonScriptPipeline::CoProcess(
 int vtkCPPythonScriptPipeline::Finalize()
 {
   InitializePython();
+  // Python is finalized on the main thread, which needs the lock for it.
+  if (MainThreadState)
+    {
+    PyEval_RestoreThread(MainThreadState);
+    MainThreadState = NULL;
+    }
+  vtkCPPythonLock lock;
 
   std::ostringstream pythonInput;
   pythonInput
@@ -280,6 +509,12 @@ int vtkCPPythonScriptPipeline::Finalize()
   return 1;
 }
 
+//----------------------------------------------------------------------------
+bool vtkCPPythonScriptPipeline::CanCoProcessAsynchronously()
+{
+  return MainThreadState != NULL;
+}
+
 //----------------------------------------------------------------------------
 vtkStdString vtkCPPythonScriptPipeline::GetPythonAddress(void* pointer)
 {
@@ -305,4 +540,10 @@ void vtkCPPythonScriptPipeline::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "PythonScriptName: " << this->PythonScriptName << "\n";
+  os << indent << "BroadcastBytecode: " << this->BroadcastBytecode << "\n";
+  os << indent << "ReadTime: " << this->ReadTime << "\n";
+  os << indent << "BroadcastTime: " << this->BroadcastTime << "\n";
+  os << indent << "PythonInitializationTime: "
+     << this->PythonInitializationTime << "\n";
+  os << indent << "ImportTime: " << this->ImportTime << "\n";
 }
@@ -37,6 +37,27 @@ public:
   /// python script. Returns 1 for success and 0 for failure.
   int Initialize(const char* fileName);
 
+  /// When on, Initialize() spares the processes other than 0 from reading
+  /// Python files: process 0 compiles the script and, the first time Python
+  /// is initialized, the pure Python modules that paraview, paraview.simple
+  /// and paraview.coprocessing need, then broadcasts the bytecode that the
+  /// other processes import from memory. Extension modules are still loaded
+  /// from the file system. Must be the same on all processes. Off by default.
+  vtkSetMacro(BroadcastBytecode, bool);
+  vtkGetMacro(BroadcastBytecode, bool);
+  vtkBooleanMacro(BroadcastBytecode, bool);
+
+  /// Time in seconds taken on this process by each phase of the last call
+  /// to Initialize(): reading the script on process 0 (compiling it with
+  /// BroadcastBytecode), broadcasting the script and modules, initializing
+  /// Python and importing the paraview modules (compiling them on process 0
+  /// with BroadcastBytecode), which is 0 when Python was already
+  /// initialized, and importing the script.
+  vtkGetMacro(ReadTime, double);
+  vtkGetMacro(BroadcastTime, double);
+  vtkGetMacro(PythonInitializationTime, double);
+  vtkGetMacro(ImportTime, double);
+
   /// Configuration Step:
   /// The coprocessor first determines if any coprocessing needs to be done
   /// at this TimeStep/Time combination returning 1 if it does and 0
@@ -53,6 +74,13 @@ public:
   /// is given. Returns 1 for success and 0 for failure.
   virtual int Finalize();
 
+  /// Returns true when Catalyst initialized Python itself: the pipelines
+  /// then take the global interpreter lock only while they run Python code,
+  /// and can run on the helper thread of an asynchronous vtkCPProcessor.
+  /// Finalize() must then be called before Python is finalized. An
+  /// application that initialized Python runs the pipelines on its thread.
+  virtual bool CanCoProcessAsynchronously();
+
 protected:
   vtkCPPythonScriptPipeline();
   virtual ~vtkCPPythonScriptPipeline();
@@ -64,6 +92,12 @@ protected:
   vtkSetStringMacro(PythonScriptName);
   vtkGetStringMacro(PythonScriptName);
 
+  bool BroadcastBytecode;
+  double ReadTime;
+  double BroadcastTime;
+  double PythonInitializationTime;
+  double ImportTime;
+
 private:
   vtkCPPythonScriptPipeline(const vtkCPPythonScriptPipeline&); // Not implemented
   void operator=(const vtkCPPythonScriptPipeline&); // Not implemented
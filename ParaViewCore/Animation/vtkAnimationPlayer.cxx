@@ -101,6 +101,10 @@ void vtkAnimationPlayer::Play()
       this->InvokeEvent(vtkCommand::ProgressEvent, &progress);
 
       double nexttime = this->GetNextTime(this->CurrentTime);
+      if (!this->StopPlay && nexttime <= playbackWindow[1])
+        {
+        this->AnimationScene->Prefetch(nexttime);
+        }
       deltatime = nexttime - this->CurrentTime;
       this->CurrentTime = nexttime; 
       }
@@ -116,6 +120,8 @@ void vtkAnimationPlayer::Play()
     // loop when this->Loop is true.
     } while (this->Loop && !this->StopPlay);
 
+  // the time prefetched last is not going to be shown when stopped.
+  this->AnimationScene->CancelPrefetch();
   this->InPlay = false;
   this->StopPlay = false;
 
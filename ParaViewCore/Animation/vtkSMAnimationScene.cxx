@@ -107,6 +107,24 @@ public:
       }
     }
 
+  void PrefetchAllViews(double time)
+    {
+    for (VectorOfViews::iterator iter=this->ViewModules.begin();
+      iter != this->ViewModules.end(); ++iter)
+      {
+      iter->GetPointer()->Prefetch(time);
+      }
+    }
+
+  void CancelPrefetchAllViews(double time)
+    {
+    for (VectorOfViews::iterator iter=this->ViewModules.begin();
+      iter != this->ViewModules.end(); ++iter)
+      {
+      iter->GetPointer()->CancelPrefetch(time);
+      }
+    }
+
   void PassUseCache(bool usecache)
     {
     VectorOfViews::iterator iter = this->ViewModules.begin();
@@ -219,6 +237,9 @@ vtkSMAnimationScene::vtkSMAnimationScene()
   this->PlaybackTimeWindow[1] = -1.0;
   this->InTick = false;
   this->Caching = false;
+  this->Prefetching = false;
+  this->PrefetchPending = false;
+  this->PrefetchedTime = 0.0;
   this->LockEndTime = false;
   this->LockStartTime = false;
   this->OverrideStillRender = false;
@@ -446,6 +467,13 @@ void vtkSMAnimationScene::TickInternal(
 {
   assert(!this->InTick);
 
+  // Free the prefetched data when another time is shown instead.
+  if (this->PrefetchPending && this->PrefetchedTime != currenttime)
+    {
+    this->CancelPrefetch();
+    }
+  this->PrefetchPending = false;
+
   // We see that here we don't check if the cache is full at all. Views have
   // logic in them to periodically check and synchronize the "fullness" of cache
   // among all participating processes. So we don't have to manage that here at
@@ -496,6 +524,40 @@ void vtkSMAnimationScene::TickInternal(
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkSMAnimationScene::Prefetch(double time)
+{
+  if (!this->Caching || !this->Prefetching || this->InTick ||
+    time == this->SceneTime || !this->TimeKeeper)
+    {
+    return;
+    }
+
+  // Cached data is looked up using the animation time but produced for the
+  // time keeper's time. Only prefetch when the two are the same, otherwise
+  // the prefetched data may not be what the next frame shows.
+  if (vtkSMPropertyHelper(this->TimeKeeper, "Time").GetAsDouble() !=
+    this->SceneTime)
+    {
+    return;
+    }
+
+  this->CancelPrefetch();
+  this->Internals->PrefetchAllViews(time);
+  this->PrefetchPending = true;
+  this->PrefetchedTime = time;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMAnimationScene::CancelPrefetch()
+{
+  if (this->PrefetchPending)
+    {
+    this->Internals->CancelPrefetchAllViews(this->PrefetchedTime);
+    this->PrefetchPending = false;
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkSMAnimationScene::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -75,6 +75,27 @@ public:
   vtkSetMacro(Caching, bool);
   vtkGetMacro(Caching, bool);
 
+  // Description:
+  // Set if the next animation time should be prefetched during playback.
+  // This is only used when Caching is enabled. After a frame is rendered, the
+  // views are asked to execute the pipeline for the next frame and cache the
+  // result (see vtkSMViewProxy::Prefetch()). In client-server mode, this lets
+  // the server work on the next frame while the client displays the current
+  // one. Off by default.
+  vtkSetMacro(Prefetching, bool);
+  vtkGetMacro(Prefetching, bool);
+
+  // Description:
+  // Called by vtkAnimationPlayer during playback with the time of the
+  // upcoming frame. Prefetches that time if Prefetching is enabled.
+  void Prefetch(double time);
+
+  // Description:
+  // Frees the data prefetched for a time that has not been shown yet. This is
+  // done automatically when another time is shown, and called by
+  // vtkAnimationPlayer when playback stops.
+  void CancelPrefetch();
+
   // Description:
   // Set the time keeper. Time keeper is used to obtain the information about
   // timesteps. This is required to play animation in "Snap To Timesteps" mode.
@@ -168,6 +189,9 @@ protected:
   void TimeKeeperTimestepsChanged();
 
   bool Caching;
+  bool Prefetching;
+  bool PrefetchPending;
+  double PrefetchedTime;
   bool LockStartTime;
   bool LockEndTime;
   bool InTick;
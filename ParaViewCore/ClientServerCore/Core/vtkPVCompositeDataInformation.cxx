@@ -204,31 +204,49 @@ void vtkPVCompositeDataInformation::CopyFromObject(vtkObject* object)
   iter->SkipEmptyNodesOff();
 
   // vtkTimerLog::MarkStartEvent("Copying information from composite data");
-  unsigned int index=0;
-  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem(), index++)
+  std::vector<vtkDataObject*> children;
+  std::vector<const char*> names;
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
     {
-    vtkSmartPointer<vtkPVDataInformation> childInfo;
-    vtkDataObject* curDO = iter->GetCurrentDataObject();
-    if (curDO)
-      {
-      childInfo = vtkSmartPointer<vtkPVDataInformation>::New();
-      childInfo->CopyFromObject(curDO);
-      }
-    this->Internal->ChildrenInformation.resize(index+1);
-    this->Internal->ChildrenInformation[index].Info = childInfo;
+    children.push_back(iter->GetCurrentDataObject());
+    const char* name = NULL;
     if (iter->HasCurrentMetaData())
       {
       vtkInformation* info = iter->GetCurrentMetaData();
       if (info->Has(vtkCompositeDataSet::NAME()))
         {
-        const char* name = info->Get(vtkCompositeDataSet::NAME());
-        this->Internal->ChildrenInformation[index].Name = name;
-        if (childInfo)
-          {
-          childInfo->SetCompositeDataSetName(name);
-          }
+        name = info->Get(vtkCompositeDataSet::NAME());
         }
       }
+    names.push_back(name);
+    }
+
+  // The information of the children is gathered all at once so that it can
+  // be done in parallel.
+  unsigned int numChildren = static_cast<unsigned int>(children.size());
+  std::vector<vtkPVDataInformation*> childrenInfo(numChildren);
+  if (numChildren > 0)
+    {
+    vtkPVDataInformation::CopyFromBlocks(&children[0], &childrenInfo[0],
+      numChildren);
+    }
+  this->Internal->ChildrenInformation.resize(numChildren);
+  for (unsigned int index=0; index < numChildren; index++)
+    {
+    vtkPVDataInformation* childInfo = childrenInfo[index];
+    this->Internal->ChildrenInformation[index].Info = childInfo;
+    if (names[index])
+      {
+      this->Internal->ChildrenInformation[index].Name = names[index];
+      if (childInfo)
+        {
+        childInfo->SetCompositeDataSetName(names[index]);
+        }
+      }
+    if (childInfo)
+      {
+      childInfo->FastDelete();
+      }
     }
   // vtkTimerLog::MarkEndEvent("Copying information from composite data");
 }
@@ -248,7 +266,6 @@ void vtkPVCompositeDataInformation::CopyFromAMR(vtkUniformGridAMR* amr)
 
   // we use this to "simulate" a composite tree from AMR
   vtkNew<vtkMultiPieceDataSet> tempMultiPiece;
-  vtkNew<vtkPVDataInformation> tempDSInfo;
 
   for (unsigned int level=0; level < num_levels; level++)
     {
@@ -259,13 +276,23 @@ void vtkPVCompositeDataInformation::CopyFromAMR(vtkUniformGridAMR* amr)
     levelInfo->CopyFromCompositeDataSetInitialize(tempMultiPiece.GetPointer());
 
     // now fill up levelInfo with meta-data about arrays.
+    std::vector<vtkDataObject*> datasets(num_datasets);
+    std::vector<vtkPVDataInformation*> datasetsInfo(num_datasets);
+    for (unsigned int idx=0; idx < num_datasets; idx++)
+      {
+      datasets[idx] = amr->GetDataSet(level, idx);
+      }
+    if (num_datasets > 0)
+      {
+      vtkPVDataInformation::CopyFromBlocks(&datasets[0], &datasetsInfo[0],
+        num_datasets);
+      }
     for (unsigned int idx=0; idx < num_datasets; idx++)
       {
-      vtkUniformGrid* dataset = amr->GetDataSet(level, idx);
-      if (dataset)
+      if (datasetsInfo[idx])
         {
-        tempDSInfo->CopyFromObject(dataset);
-        levelInfo->AddInformation(tempDSInfo.GetPointer(), 1);
+        levelInfo->AddInformation(datasetsInfo[idx], 1);
+        datasetsInfo[idx]->FastDelete();
         }
       }
     levelInfo->CopyFromCompositeDataSetFinalize(tempMultiPiece.GetPointer());
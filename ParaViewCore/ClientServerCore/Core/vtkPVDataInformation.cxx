@@ -27,6 +27,7 @@
 #include "vtkDataObjectTypes.h"
 #include "vtkDataSet.h"
 #include "vtkExecutive.h"
+#include "vtkFieldData.h"
 #include "vtkGenericDataSet.h"
 #include "vtkGraph.h"
 #include "vtkImageData.h"
@@ -36,6 +37,8 @@
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
 #include "vtkPVArrayInformation.h"
 #include "vtkPVDataInformationHelper.h"
 #include "vtkPVCompositeDataInformation.h"
@@ -43,14 +46,18 @@
 #include "vtkPVInformationKeys.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkSelection.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkStructuredGrid.h"
 #include "vtkTable.h"
 #include "vtkUniformGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkMultiProcessStream.h"
+#include "vtkWeakPointer.h"
 
 #include <algorithm>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -58,6 +65,126 @@ vtkStandardNewMacro(vtkPVDataInformation);
 
 std::map<std::string, std::string> helpers;
 
+namespace
+{
+  // Information of the blocks of composite datasets, kept so that blocks
+  // that were not modified since they were last visited are not visited
+  // again. Blocks are referenced weakly so that a new block allocated at the
+  // address of a deleted one is not mistaken for it.
+  struct vtkBlockInformation
+    {
+    vtkWeakPointer<vtkDataObject> Block;
+    unsigned long MTime;
+    vtkSmartPointer<vtkPVDataInformation> Information;
+    };
+  typedef std::map<vtkDataObject*, vtkBlockInformation> vtkBlockInformationMap;
+  vtkBlockInformationMap BlockInformationCache;
+
+  // Entries of deleted blocks are pruned when the cache has doubled in size.
+  const size_t MIN_BLOCK_CACHE_PRUNE_SIZE = 1024;
+  size_t BlockInformationCachePruneSize = MIN_BLOCK_CACHE_PRUNE_SIZE;
+
+  void vtkPruneBlockInformationCache()
+    {
+    if (BlockInformationCache.size() < BlockInformationCachePruneSize)
+      {
+      return;
+      }
+    vtkBlockInformationMap::iterator iter = BlockInformationCache.begin();
+    while (iter != BlockInformationCache.end())
+      {
+      if (iter->second.Block.GetPointer() == NULL)
+        {
+        BlockInformationCache.erase(iter++);
+        }
+      else
+        {
+        ++iter;
+        }
+      }
+    BlockInformationCachePruneSize = std::max(MIN_BLOCK_CACHE_PRUNE_SIZE,
+      2 * BlockInformationCache.size());
+    }
+
+  unsigned long vtkGetBlockMTime(vtkDataObject* block)
+    {
+    // The field data is not accounted for in the MTime of the data object.
+    unsigned long mtime = block->GetMTime();
+    vtkFieldData* fd = block->GetFieldData();
+    if (fd && fd->GetMTime() > mtime)
+      {
+      mtime = fd->GetMTime();
+      }
+    return mtime;
+    }
+
+  // Adds the arrays of \c fd whose information is gathered.
+  void vtkCollectArrays(vtkFieldData* fd, std::set<vtkDataArray*>& visited,
+    std::vector<vtkDataArray*>& arrays)
+    {
+    int num = fd? fd->GetNumberOfArrays() : 0;
+    for (int cc = 0; cc < num; ++cc)
+      {
+      vtkDataArray* array = fd->GetArray(cc);
+      if (array && array->GetName() && visited.insert(array).second)
+        {
+        arrays.push_back(array);
+        }
+      }
+    }
+
+  // Computes, and thereby caches, the ranges vtkPVArrayInformation asks for.
+  class vtkComputeArrayRanges
+    {
+  public:
+    vtkDataArray** Arrays;
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      double range[2];
+      for (vtkIdType cc = begin; cc < end; ++cc)
+        {
+        vtkDataArray* array = this->Arrays[cc];
+        int numComps = array->GetNumberOfComponents();
+        if (numComps > 1)
+          {
+          array->GetRange(range, -1);
+          }
+        for (int comp = 0; comp < numComps; ++comp)
+          {
+          array->GetRange(range, comp);
+          }
+        }
+      }
+    };
+
+  class vtkComputePointsBounds
+    {
+  public:
+    vtkPoints** Points;
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType cc = begin; cc < end; ++cc)
+        {
+        this->Points[cc]->GetBounds();
+        }
+      }
+    };
+
+  class vtkCopyFromDataSets
+    {
+  public:
+    vtkDataSet** DataSets;
+    vtkPVDataInformation** Infos;
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType cc = begin; cc < end; ++cc)
+        {
+        this->Infos[cc]->CopyFromObject(this->DataSets[cc]);
+        }
+      }
+    };
+}
+
 //----------------------------------------------------------------------------
 vtkPVDataInformation::vtkPVDataInformation()
 {
@@ -322,21 +449,177 @@ void vtkPVDataInformation::DeepCopy(vtkPVDataInformation *dataInfo,
 //----------------------------------------------------------------------------
 void vtkPVDataInformation::AddFromMultiPieceDataSet(vtkCompositeDataSet* data)
 {
+  std::vector<vtkDataObject*> pieces;
   vtkCompositeDataIterator* iter = data->NewIterator();
   for(iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
     {
     vtkDataObject* dobj = iter->GetCurrentDataObject();
     if (dobj)
       {
-      vtkPVDataInformation* dinf = vtkPVDataInformation::New();
-      dinf->CopyFromObject(dobj);
-      dinf->SetDataClassName(dobj->GetClassName());
-      dinf->DataSetType = dobj->GetDataObjectType();
-      this->AddInformation(dinf, /*addingParts=*/ 1);
-      dinf->FastDelete();
+      pieces.push_back(dobj);
       }
     }
   iter->Delete();
+
+  if (pieces.empty())
+    {
+    return;
+    }
+  std::vector<vtkPVDataInformation*> infos(pieces.size());
+  vtkPVDataInformation::CopyFromBlocks(&pieces[0], &infos[0],
+    static_cast<unsigned int>(pieces.size()));
+  for (size_t cc = 0; cc < pieces.size(); ++cc)
+    {
+    vtkPVDataInformation* dinf = infos[cc];
+    dinf->SetDataClassName(pieces[cc]->GetClassName());
+    dinf->DataSetType = pieces[cc]->GetDataObjectType();
+    this->AddInformation(dinf, /*addingParts=*/ 1);
+    dinf->FastDelete();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataInformation::CopyFromBlocks(vtkDataObject** blocks,
+  vtkPVDataInformation** infos, unsigned int numBlocks)
+{
+  vtkPruneBlockInformationCache();
+
+  // Information each block is copied from, and the data sets that need to be
+  // visited. The same data set may appear in several blocks.
+  std::vector<vtkPVDataInformation*> sources(numBlocks,
+    static_cast<vtkPVDataInformation*>(NULL));
+  std::vector<vtkIdType> blockDataSets(numBlocks, -1);
+  std::vector<vtkDataSet*> dataSets;
+  std::map<vtkDataSet*, vtkIdType> dataSetIds;
+  for (unsigned int cc = 0; cc < numBlocks; ++cc)
+    {
+    infos[cc] = NULL;
+    vtkDataObject* block = blocks[cc];
+    if (!block)
+      {
+      continue;
+      }
+    if (block->IsA("vtkCompositeDataSet"))
+      {
+      // Nested composite datasets gather the information of their own blocks.
+      infos[cc] = vtkPVDataInformation::New();
+      infos[cc]->CopyFromObject(block);
+      continue;
+      }
+
+    unsigned long mtime = vtkGetBlockMTime(block);
+    vtkBlockInformationMap::iterator iter = BlockInformationCache.find(block);
+    if (iter != BlockInformationCache.end() &&
+      iter->second.Block.GetPointer() == block &&
+      iter->second.MTime == mtime)
+      {
+      sources[cc] = iter->second.Information;
+      continue;
+      }
+
+    vtkDataSet* ds = vtkDataSet::SafeDownCast(block);
+    if (ds)
+      {
+      std::pair<std::map<vtkDataSet*, vtkIdType>::iterator, bool> added =
+        dataSetIds.insert(std::make_pair(ds,
+            static_cast<vtkIdType>(dataSets.size())));
+      if (added.second)
+        {
+        dataSets.push_back(ds);
+        }
+      blockDataSets[cc] = added.first->second;
+      continue;
+      }
+
+    // Other types of data are rare as blocks, visit them serially.
+    vtkBlockInformation& entry = BlockInformationCache[block];
+    entry.Block = block;
+    entry.MTime = mtime;
+    entry.Information = vtkSmartPointer<vtkPVDataInformation>::New();
+    entry.Information->CopyFromObject(block);
+    sources[cc] = entry.Information;
+    }
+
+  const vtkIdType numDataSets = static_cast<vtkIdType>(dataSets.size());
+  if (numDataSets > 0)
+    {
+    // Arrays and points may be shared among data sets. Compute their ranges
+    // and bounds once up front, so that the data sets can then be visited
+    // concurrently without racing to cache them.
+    std::set<vtkDataArray*> visitedArrays;
+    std::vector<vtkDataArray*> arrays;
+    std::set<vtkPoints*> visitedPoints;
+    std::vector<vtkPoints*> points;
+    for (vtkIdType cc = 0; cc < numDataSets; ++cc)
+      {
+      vtkDataSet* ds = dataSets[cc];
+      vtkCollectArrays(ds->GetPointData(), visitedArrays, arrays);
+      vtkCollectArrays(ds->GetCellData(), visitedArrays, arrays);
+      vtkCollectArrays(ds->GetFieldData(), visitedArrays, arrays);
+      vtkPointSet* ps = vtkPointSet::SafeDownCast(ds);
+      if (ps && ps->GetPoints() && visitedPoints.insert(ps->GetPoints()).second)
+        {
+        points.push_back(ps->GetPoints());
+        if (visitedArrays.insert(ps->GetPoints()->GetData()).second)
+          {
+          arrays.push_back(ps->GetPoints()->GetData());
+          }
+        }
+      }
+    if (!arrays.empty())
+      {
+      vtkComputeArrayRanges functor;
+      functor.Arrays = &arrays[0];
+      vtkSMPTools::For(0, static_cast<vtkIdType>(arrays.size()), functor);
+      }
+    if (!points.empty())
+      {
+      vtkComputePointsBounds functor;
+      functor.Points = &points[0];
+      vtkSMPTools::For(0, static_cast<vtkIdType>(points.size()), functor);
+      }
+
+    std::vector<vtkSmartPointer<vtkPVDataInformation> > dataSetInfos(
+      numDataSets);
+    std::vector<vtkPVDataInformation*> dataSetInfoPtrs(numDataSets);
+    for (vtkIdType cc = 0; cc < numDataSets; ++cc)
+      {
+      dataSetInfos[cc] = vtkSmartPointer<vtkPVDataInformation>::New();
+      dataSetInfoPtrs[cc] = dataSetInfos[cc];
+      }
+    vtkCopyFromDataSets functor;
+    functor.DataSets = &dataSets[0];
+    functor.Infos = &dataSetInfoPtrs[0];
+    vtkSMPTools::For(0, numDataSets, functor);
+
+    for (vtkIdType cc = 0; cc < numDataSets; ++cc)
+      {
+      vtkBlockInformation& entry = BlockInformationCache[dataSets[cc]];
+      entry.Block = dataSets[cc];
+      entry.MTime = vtkGetBlockMTime(dataSets[cc]);
+      entry.Information = dataSetInfos[cc];
+      }
+    for (unsigned int cc = 0; cc < numBlocks; ++cc)
+      {
+      if (blockDataSets[cc] >= 0)
+        {
+        sources[cc] = dataSetInfoPtrs[blockDataSets[cc]];
+        }
+      }
+    }
+
+  // Hand out copies, the cached information must not be altered by the
+  // caller.
+  for (unsigned int cc = 0; cc < numBlocks; ++cc)
+    {
+    if (vtkPVDataInformation* source = sources[cc])
+      {
+      infos[cc] = vtkPVDataInformation::New();
+      infos[cc]->DeepCopy(source);
+      infos[cc]->Time = source->Time;
+      infos[cc]->HasTime = source->HasTime;
+      }
+    }
 }
 
 //----------------------------------------------------------------------------
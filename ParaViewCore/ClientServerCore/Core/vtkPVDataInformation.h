@@ -218,6 +218,16 @@ protected:
   void DeepCopy(vtkPVDataInformation *dataInfo, bool copyCompositeInformation=true);
 
   void AddFromMultiPieceDataSet(vtkCompositeDataSet* data);
+
+  // Description:
+  // Creates the information of each of the \c numBlocks \c blocks of a
+  // composite dataset in \c infos, NULL for NULL blocks. Data set blocks are
+  // visited in parallel and the information of blocks that were not modified
+  // since they were last visited is reused. The caller is responsible for
+  // deleting the created information objects.
+  static void CopyFromBlocks(vtkDataObject** blocks,
+    vtkPVDataInformation** infos, unsigned int numBlocks);
+
   void CopyFromCompositeDataSet(vtkCompositeDataSet* data);
   void CopyFromCompositeDataSetInitialize(vtkCompositeDataSet* data);
   void CopyFromCompositeDataSetFinalize(vtkCompositeDataSet* data);
@@ -22,7 +22,19 @@
 #include "vtkQuadricClustering.h"
 #include "vtkTimerLog.h"
 
+#include <map>
 #include <sstream>
+#include <string>
+
+namespace
+{
+  typedef std::map<std::string, std::string> StatisticsType;
+  StatisticsType& GetStatistics()
+    {
+    static StatisticsType statistics;
+    return statistics;
+    }
+}
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkPVTimerInformation);
@@ -144,16 +156,55 @@ void vtkPVTimerInformation::CopyFromObject(vtkObject*)
   float threshold = this->LogThreshold;
 
   length = vtkTimerLog::GetNumberOfEvents() * 40;
-  if (length > 0)
+  const StatisticsType& statistics = GetStatistics();
+  if (length > 0 || !statistics.empty())
     {
     std::ostringstream fptr;
     //*fptr << "Hello world !!!\n ()";
-    vtkTimerLog::DumpLogWithIndents(&fptr, threshold);
+    if (length > 0)
+      {
+      vtkTimerLog::DumpLogWithIndents(&fptr, threshold);
+      }
+    if (!statistics.empty())
+      {
+      fptr << "Statistics:\n";
+      for (StatisticsType::const_iterator iter = statistics.begin();
+        iter != statistics.end(); ++iter)
+        {
+        fptr << "    " << iter->first << ": " << iter->second << "\n";
+        }
+      }
     fptr << ends;
     this->InsertLog(0, fptr.str().c_str());
     }  
 }
 
+//----------------------------------------------------------------------------
+void vtkPVTimerInformation::SetStatistic(const char* name, const char* value)
+{
+  if (name)
+    {
+    GetStatistics()[name] = value? value : "";
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTimerInformation::SetStatistic(const char* name, double value)
+{
+  std::ostringstream stream;
+  stream << value;
+  vtkPVTimerInformation::SetStatistic(name, stream.str().c_str());
+}
+
+//----------------------------------------------------------------------------
+const char* vtkPVTimerInformation::GetStatistic(const char* name)
+{
+  const StatisticsType& statistics = GetStatistics();
+  StatisticsType::const_iterator iter =
+    statistics.find(name? name : "");
+  return iter != statistics.end()? iter->second.c_str() : NULL;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVTimerInformation::CopyFromMessage(unsigned char* msg)
 {
@@ -42,6 +42,17 @@ public:
   int GetNumberOfLogs();
   char *GetLog(int proc);
 
+  // Description:
+  // Named values reported at the end of the log of the local process. This
+  // makes it possible for components to expose the settings they picked at
+  // runtime or measurements that are not timer events, e.g. the image
+  // compression chosen by vtkPVClientServerSynchronizedRenderers.
+  // Statistics are kept per process, like the timer log: the values set on
+  // a server are only seen by gathering this information from that server.
+  static void SetStatistic(const char* name, const char* value);
+  static void SetStatistic(const char* name, double value);
+  static const char* GetStatistic(const char* name);
+
   // Description:
   // Transfer information about a single object into
   // this object.
@@ -0,0 +1,458 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVTraceInformation.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVTraceInformation.h"
+
+#include "vtkClientServerStream.h"
+#include "vtkMultiProcessStream.h"
+#include "vtkObjectFactory.h"
+#include "vtkProcessModule.h"
+#include "vtkPVTraceEventRecorder.h"
+
+#include <vtksys/SystemInformation.hxx>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define vtkVerifyParseMacro(_call,_field) \
+  if (!(_call)) \
+    { \
+    vtkErrorMacro("Error parsing " _field "."); \
+    return; \
+    }
+
+class vtkPVTraceInformation::vtkInternals
+{
+public:
+  struct ProcessEvents
+    {
+    ProcessEvents() : ProcessType(vtkProcessModule::PROCESS_INVALID), Rank(0),
+      ReferenceTime(0.0), GatherTime(0.0), ClockOffset(0.0) {}
+    int ProcessType;
+    int Rank;
+    std::string Hostname;
+    // Reference time of the request the events were gathered for, 0 once
+    // the clock offset is known.
+    double ReferenceTime;
+    // Time at which the events were gathered, in the clock of the process.
+    double GatherTime;
+    double ClockOffset;
+    std::vector<vtkPVTraceEventRecorder::Event> Events;
+    };
+  std::vector<ProcessEvents> Processes;
+};
+
+namespace
+{
+  // Last reference time sent by this process. A request stamped with it was
+  // sent by this process, whose clock the events can then be put in.
+  double LastReferenceTime = 0.0;
+
+  void WriteJSONString(ostream& os, const std::string& str)
+    {
+    os << "\"";
+    for (size_t cc=0; cc < str.size(); cc++)
+      {
+      unsigned char c = static_cast<unsigned char>(str[cc]);
+      switch (c)
+        {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      case '\t':
+        os << "\\t";
+        break;
+      default:
+        if (c < 0x20)
+          {
+          const char* digits = "0123456789abcdef";
+          os << "\\u00" << digits[c >> 4] << digits[c & 0xf];
+          }
+        else
+          {
+          os << str[cc];
+          }
+        }
+      }
+    os << "\"";
+    }
+
+  const char* GetProcessTypeName(int type)
+    {
+    switch (type)
+      {
+    case vtkProcessModule::PROCESS_CLIENT:
+      return "client";
+    case vtkProcessModule::PROCESS_SERVER:
+      return "server";
+    case vtkProcessModule::PROCESS_DATA_SERVER:
+      return "data server";
+    case vtkProcessModule::PROCESS_RENDER_SERVER:
+      return "render server";
+    case vtkProcessModule::PROCESS_BATCH:
+      return "batch";
+    default:
+      return "process";
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkPVTraceInformation);
+
+//----------------------------------------------------------------------------
+vtkPVTraceInformation::vtkPVTraceInformation()
+{
+  this->ResetEvents = 0;
+  this->ReferenceTime = 0.0;
+  this->Internals = new vtkInternals();
+}
+
+//----------------------------------------------------------------------------
+vtkPVTraceInformation::~vtkPVTraceInformation()
+{
+  delete this->Internals;
+  this->Internals = NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceInformation::CopyParametersToStream(vtkMultiProcessStream& str)
+{
+  // The process that requests the gathering stamps it with its own time, the
+  // server root forwards that time to its satellites.
+  if (this->ReferenceTime == 0.0 || this->ReferenceTime == LastReferenceTime)
+    {
+    this->ReferenceTime = vtkPVTraceEventRecorder::GetTime();
+    LastReferenceTime = this->ReferenceTime;
+    }
+  str << 828794 << this->ResetEvents << this->ReferenceTime;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceInformation::CopyParametersFromStream(vtkMultiProcessStream& str)
+{
+  int magic_number;
+  str >> magic_number >> this->ResetEvents >> this->ReferenceTime;
+  if (magic_number != 828794)
+    {
+    vtkErrorMacro("Magic number mismatch.");
+    }
+}
+
+//----------------------------------------------------------------------------
+// This ignores the object, and gets the events from the recorder.
+void vtkPVTraceInformation::CopyFromObject(vtkObject*)
+{
+  this->Internals->Processes.clear();
+  this->Internals->Processes.resize(1);
+
+  vtkInternals::ProcessEvents& process = this->Internals->Processes[0];
+  process.ProcessType = vtkProcessModule::GetProcessType();
+  vtkProcessModule* pm = vtkProcessModule::GetProcessModule();
+  process.Rank = pm ? pm->GetPartitionId() : 0;
+  vtksys::SystemInformation sysInfo;
+  sysInfo.RunOSCheck();
+  process.Hostname = sysInfo.GetHostname() ? sysInfo.GetHostname() : "";
+  // Events gathered for a request of this process are in its clock already.
+  process.ReferenceTime = this->ReferenceTime == LastReferenceTime ?
+    0.0 : this->ReferenceTime;
+  process.GatherTime = vtkPVTraceEventRecorder::GetTime();
+  vtkPVTraceEventRecorder::GetEvents(process.Events);
+  if (this->ResetEvents)
+    {
+    vtkPVTraceEventRecorder::ResetEvents();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceInformation::AddInformation(vtkPVInformation* pvinfo)
+{
+  vtkPVTraceInformation* info = vtkPVTraceInformation::SafeDownCast(pvinfo);
+  if (!info)
+    {
+    return;
+    }
+
+  this->Internals->Processes.insert(this->Internals->Processes.end(),
+    info->Internals->Processes.begin(), info->Internals->Processes.end());
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceInformation::CopyToStream(vtkClientServerStream* css)
+{
+  css->Reset();
+  *css << vtkClientServerStream::Reply
+       << static_cast<int>(this->Internals->Processes.size());
+  for (size_t cc=0; cc < this->Internals->Processes.size(); cc++)
+    {
+    const vtkInternals::ProcessEvents& process = this->Internals->Processes[cc];
+    *css << process.ProcessType
+         << process.Rank
+         << process.Hostname.c_str()
+         << process.ReferenceTime
+         << process.GatherTime
+         << process.ClockOffset
+         << static_cast<int>(process.Events.size());
+    for (size_t kk=0; kk < process.Events.size(); kk++)
+      {
+      const vtkPVTraceEventRecorder::Event& event = process.Events[kk];
+      *css << event.Category.c_str()
+           << event.Name.c_str()
+           << event.Start
+           << event.End
+           << event.Thread
+           << event.Bytes;
+      }
+    }
+  *css << vtkClientServerStream::End;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceInformation::CopyFromStream(const vtkClientServerStream* css)
+{
+  const double receiveTime = vtkPVTraceEventRecorder::GetTime();
+  this->Internals->Processes.clear();
+
+  int offset = 0;
+  int numProcesses = 0;
+  vtkVerifyParseMacro(css->GetArgument(0, offset++, &numProcesses),
+    "NumberOfProcesses");
+  this->Internals->Processes.resize(numProcesses);
+  for (int cc=0; cc < numProcesses; cc++)
+    {
+    vtkInternals::ProcessEvents& process = this->Internals->Processes[cc];
+    char* hostname = NULL;
+    int numEvents = 0;
+    vtkVerifyParseMacro(css->GetArgument(0, offset++, &process.ProcessType),
+      "ProcessType");
+    vtkVerifyParseMacro(css->GetArgument(0, offset++, &process.Rank), "Rank");
+    vtkVerifyParseMacro(css->GetArgument(0, offset++, &hostname), "Hostname");
+    vtkVerifyParseMacro(
+      css->GetArgument(0, offset++, &process.ReferenceTime), "ReferenceTime");
+    vtkVerifyParseMacro(
+      css->GetArgument(0, offset++, &process.GatherTime), "GatherTime");
+    vtkVerifyParseMacro(
+      css->GetArgument(0, offset++, &process.ClockOffset), "ClockOffset");
+    vtkVerifyParseMacro(css->GetArgument(0, offset++, &numEvents),
+      "NumberOfEvents");
+    process.Hostname = hostname ? hostname : "";
+    process.Events.resize(numEvents);
+    for (int kk=0; kk < numEvents; kk++)
+      {
+      vtkPVTraceEventRecorder::Event& event = process.Events[kk];
+      char* category = NULL;
+      char* name = NULL;
+      vtkVerifyParseMacro(css->GetArgument(0, offset++, &category),
+        "Category");
+      vtkVerifyParseMacro(css->GetArgument(0, offset++, &name), "Name");
+      vtkVerifyParseMacro(css->GetArgument(0, offset++, &event.Start),
+        "Start");
+      vtkVerifyParseMacro(css->GetArgument(0, offset++, &event.End), "End");
+      vtkVerifyParseMacro(css->GetArgument(0, offset++, &event.Thread),
+        "Thread");
+      vtkVerifyParseMacro(css->GetArgument(0, offset++, &event.Bytes),
+        "Bytes");
+      event.Category = category ? category : "";
+      event.Name = name ? name : "";
+      }
+
+    // The process gathered its events between the time this process sent
+    // the request and the time it received the reply: assume it did so
+    // halfway, the error is at most half the round trip.
+    if (process.ReferenceTime != 0.0 &&
+      process.ReferenceTime == LastReferenceTime)
+      {
+      process.ClockOffset = 0.5 * (process.ReferenceTime + receiveTime) -
+        process.GatherTime;
+      process.ReferenceTime = 0.0;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTraceInformation::GetNumberOfProcesses()
+{
+  return static_cast<int>(this->Internals->Processes.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTraceInformation::GetProcessType(int index)
+{
+  if (index < 0 || index >= this->GetNumberOfProcesses())
+    {
+    return vtkProcessModule::PROCESS_INVALID;
+    }
+  return this->Internals->Processes[index].ProcessType;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTraceInformation::GetRank(int index)
+{
+  if (index < 0 || index >= this->GetNumberOfProcesses())
+    {
+    return -1;
+    }
+  return this->Internals->Processes[index].Rank;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkPVTraceInformation::GetHostname(int index)
+{
+  if (index < 0 || index >= this->GetNumberOfProcesses())
+    {
+    return NULL;
+    }
+  return this->Internals->Processes[index].Hostname.c_str();
+}
+
+//----------------------------------------------------------------------------
+double vtkPVTraceInformation::GetClockOffset(int index)
+{
+  if (index < 0 || index >= this->GetNumberOfProcesses())
+    {
+    return 0.0;
+    }
+  return this->Internals->Processes[index].ClockOffset;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTraceInformation::GetNumberOfEvents(int index)
+{
+  if (index < 0 || index >= this->GetNumberOfProcesses())
+    {
+    return 0;
+    }
+  return static_cast<int>(this->Internals->Processes[index].Events.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTraceInformation::GetNumberOfEvents()
+{
+  int count = 0;
+  for (int cc=0; cc < this->GetNumberOfProcesses(); cc++)
+    {
+    count += this->GetNumberOfEvents(cc);
+    }
+  return count;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTraceInformation::WriteChromeTrace(const char* filename)
+{
+  std::ofstream file(filename ? filename : "");
+  if (!file)
+    {
+    vtkErrorMacro("Failed to open " << (filename ? filename : "(null)")
+      << " for writing.");
+    return 0;
+    }
+  this->WriteChromeTrace(file);
+  file.close();
+  return file.fail() ? 0 : 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceInformation::WriteChromeTrace(ostream& os)
+{
+  const std::vector<vtkInternals::ProcessEvents>& processes =
+    this->Internals->Processes;
+
+  double origin = 0.0;
+  bool hasOrigin = false;
+  for (size_t cc=0; cc < processes.size(); cc++)
+    {
+    for (size_t kk=0; kk < processes[cc].Events.size(); kk++)
+      {
+      double start =
+        processes[cc].Events[kk].Start + processes[cc].ClockOffset;
+      if (!hasOrigin || start < origin)
+        {
+        origin = start;
+        hasOrigin = true;
+        }
+      }
+    }
+
+  // Each process is a "pid" named after its type, rank and host. Events use
+  // the "complete" phase with times in microseconds, in the clock of this
+  // process.
+  std::ostringstream stream;
+  stream.setf(std::ios::fixed, std::ios::floatfield);
+  stream.precision(3);
+  stream << "{\"traceEvents\":[";
+  const char* separator = "\n";
+  for (size_t cc=0; cc < processes.size(); cc++)
+    {
+    const vtkInternals::ProcessEvents& process = processes[cc];
+    std::ostringstream label;
+    label << GetProcessTypeName(process.ProcessType) << " " << process.Rank;
+    if (!process.Hostname.empty())
+      {
+      label << " (" << process.Hostname << ")";
+      }
+    stream << separator
+      << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << cc
+      << ",\"args\":{\"name\":";
+    WriteJSONString(stream, label.str());
+    stream << "}}";
+    separator = ",\n";
+    stream << separator
+      << "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << cc
+      << ",\"args\":{\"sort_index\":" << cc << "}}";
+
+    for (size_t kk=0; kk < process.Events.size(); kk++)
+      {
+      const vtkPVTraceEventRecorder::Event& event = process.Events[kk];
+      stream << separator << "{\"name\":";
+      WriteJSONString(stream, event.Name);
+      stream << ",\"cat\":";
+      WriteJSONString(stream, event.Category);
+      stream << ",\"ph\":\"X\",\"ts\":"
+        << 1e6 * (event.Start + process.ClockOffset - origin)
+        << ",\"dur\":" << 1e6 * (event.End - event.Start)
+        << ",\"pid\":" << cc << ",\"tid\":" << event.Thread;
+      if (event.Bytes > 0)
+        {
+        stream << ",\"args\":{\"bytes\":" << event.Bytes << "}";
+        }
+      stream << "}";
+      }
+    }
+  stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  os << stream.str();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceInformation::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "ResetEvents: " << this->ResetEvents << endl;
+  os << indent << "NumberOfProcesses: " << this->GetNumberOfProcesses()
+    << endl;
+  for (int cc=0; cc < this->GetNumberOfProcesses(); cc++)
+    {
+    os << indent.GetNextIndent()
+      << GetProcessTypeName(this->GetProcessType(cc)) << " "
+      << this->GetRank(cc) << ": " << this->GetNumberOfEvents(cc)
+      << " events, clock offset " << this->GetClockOffset(cc) << endl;
+    }
+}
@@ -0,0 +1,115 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVTraceInformation.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVTraceInformation - gathers the trace events of all processes.
+// .SECTION Description
+// vtkPVTraceInformation gathers the events recorded by
+// vtkPVTraceEventRecorder on each process along with the type, rank and host
+// of the process. Information gathered from different servers can be merged
+// with AddInformation() and the result written as a Chrome trace (JSON)
+// file that chrome://tracing and Perfetto open, with one row per process and
+// thread on a common timeline.
+// .SECTION See Also
+// vtkPVTraceEventRecorder vtkPVTimerInformation
+
+#ifndef __vtkPVTraceInformation_h
+#define __vtkPVTraceInformation_h
+
+#include "vtkPVClientServerCoreCoreModule.h" //needed for exports
+#include "vtkPVInformation.h"
+
+class VTKPVCLIENTSERVERCORECORE_EXPORT vtkPVTraceInformation : public vtkPVInformation
+{
+public:
+  static vtkPVTraceInformation* New();
+  vtkTypeMacro(vtkPVTraceInformation, vtkPVInformation);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // When on, the events are removed from the recorders once gathered so
+  // that the next gathering only returns new events. This must be set
+  // before calling GatherInformation(). Off by default.
+  vtkSetMacro(ResetEvents, int);
+  vtkGetMacro(ResetEvents, int);
+  vtkBooleanMacro(ResetEvents, int);
+
+  // Description:
+  // Access to the gathered information: the processes and the number of
+  // events of each process.
+  int GetNumberOfProcesses();
+  int GetProcessType(int index);
+  int GetRank(int index);
+  const char* GetHostname(int index);
+  int GetNumberOfEvents(int index);
+
+  // Description:
+  // Offset, in seconds, added to the times of the events of a process to
+  // express them in the clock of the process that gathered the information.
+  // It is estimated from the time at which the process gathered its events
+  // and the times at which the request was sent and the reply received.
+  double GetClockOffset(int index);
+
+  // Description:
+  // Total number of events of all processes.
+  int GetNumberOfEvents();
+
+  // Description:
+  // Writes the events as a Chrome trace event file. Times are corrected by
+  // the clock offset of their process and relative to the first event.
+  // Returns 0 if the file could not be written.
+  int WriteChromeTrace(const char* filename);
+  //BTX
+  void WriteChromeTrace(ostream& os);
+  //ETX
+
+  // Description:
+  // Transfer information about a single object into
+  // this object.
+  virtual void CopyFromObject(vtkObject* data);
+
+  // Description:
+  // Merge another information object.
+  virtual void AddInformation(vtkPVInformation* info);
+
+  // Description:
+  // Serialize objects to/from a stream object.
+  virtual void CopyToStream(vtkClientServerStream*);
+  virtual void CopyFromStream(const vtkClientServerStream* css);
+
+  // Description:
+  // Serialize/Deserialize the parameters that control how/what information is
+  // gathered. This are different from the ivars that constitute the gathered
+  // information itself.
+  virtual void CopyParametersToStream(vtkMultiProcessStream&);
+  virtual void CopyParametersFromStream(vtkMultiProcessStream&);
+
+protected:
+  vtkPVTraceInformation();
+  ~vtkPVTraceInformation();
+
+  int ResetEvents;
+
+  // Time at which the gathering was requested, in the clock of the process
+  // that requested it, sent along with the parameters.
+  double ReferenceTime;
+
+private:
+  vtkPVTraceInformation(const vtkPVTraceInformation&); // Not implemented
+  void operator=(const vtkPVTraceInformation&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+};
+
+#endif
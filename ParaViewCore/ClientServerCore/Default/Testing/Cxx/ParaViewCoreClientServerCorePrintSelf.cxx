@@ -69,6 +69,7 @@
 #include "vtkPVSynchronizedRenderer.h"
 #include "vtkPVTemporalDataInformation.h"
 #include "vtkPVTimerInformation.h"
+#include "vtkPVTraceInformation.h"
 #include "vtkPVView.h"
 #include "vtkPVXYChartView.h"
 #include "vtkProcessModule.h"
@@ -173,6 +174,7 @@ int ParaViewCoreClientServerCorePrintSelf(int, char*[])
   //PRINT_SELF(vtkPVSynchronizedRenderer);
   PRINT_SELF(vtkPVTemporalDataInformation);
   PRINT_SELF(vtkPVTimerInformation);
+  PRINT_SELF(vtkPVTraceInformation);
   //PRINT_SELF(vtkPVView);
   //PRINT_SELF(vtkPVXYChartView);
   PRINT_SELF(vtkProcessModule);
@@ -0,0 +1,142 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestAdaptiveCompression.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Feeds frame measurements to the adaptive compression of
+// vtkPVClientServerSynchronizedRenderers, checks the level it picks and the
+// statistics it reports, and checks that the statistics travel with the log
+// of vtkPVTimerInformation as they do when gathered from a server.
+
+#include "vtkClientServerStream.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPVClientServerSynchronizedRenderers.h"
+#include "vtkPVTimerInformation.h"
+
+#include <string>
+
+namespace
+{
+  // Exposes the measurements normally made by MasterEndRender().
+  class vtkTestAdaptiveRenderers : public vtkPVClientServerSynchronizedRenderers
+    {
+  public:
+    static vtkTestAdaptiveRenderers* New();
+    vtkTypeMacro(vtkTestAdaptiveRenderers,
+      vtkPVClientServerSynchronizedRenderers);
+
+    void AddFrames(int count, double frameTime, double transferTime,
+      vtkIdType numberOfBytes)
+      {
+      for (int cc = 0; cc < count; ++cc)
+        {
+        this->UpdateAdaptiveLevel(frameTime, transferTime, numberOfBytes);
+        }
+      }
+    };
+  vtkStandardNewMacro(vtkTestAdaptiveRenderers);
+
+  bool CheckStatistic(const char* name, const char* expected)
+    {
+    const char* value = vtkPVTimerInformation::GetStatistic(name);
+    if (!value || std::string(value) != expected)
+      {
+      cerr << "Statistic \"" << name << "\" is "
+        << (value? value : "(none)") << ", expected " << expected << endl;
+      return false;
+      }
+    return true;
+    }
+}
+
+int TestAdaptiveCompression(int, char*[])
+{
+  vtkNew<vtkTestAdaptiveRenderers> renderers;
+  renderers->SetTargetInteractiveFrameRate(10.0);
+  renderers->SetAdaptiveCompression(true);
+  if (renderers->GetAdaptiveLevel() != 2 ||
+    !CheckStatistic("Image Compressor Mode", "adaptive") ||
+    !CheckStatistic("Image Compressor", "vtkSquirtCompressor 0 3"))
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Frames far too slow because of the transfer make the compression harder
+  // once the level settled.
+  renderers->AddFrames(2, 0.5, 0.4, 4 * 1024 * 1024);
+  if (renderers->GetAdaptiveLevel() != 2)
+    {
+    cerr << "Level changed before settling." << endl;
+    return EXIT_FAILURE;
+    }
+  renderers->AddFrames(1, 0.5, 0.4, 4 * 1024 * 1024);
+  if (renderers->GetAdaptiveLevel() != 3 ||
+    !CheckStatistic("Image Compressor", "vtkZlibImageCompressor 0 1 3 1") ||
+    !CheckStatistic("Image Bandwidth (MB/s)", "10") ||
+    !CheckStatistic("Interactive Frame Time (ms)", "500"))
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Slow frames that are not due to the transfer leave the level alone.
+  renderers->AddFrames(6, 0.5, 0.01, 1024);
+  if (renderers->GetAdaptiveLevel() != 3)
+    {
+    cerr << "Level changed for a rendering bound frame." << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Fast frames go back to cheaper settings once the running average came
+  // down below 60% of the target frame time.
+  renderers->AddFrames(6, 0.01, 0.005, 1024 * 1024);
+  if (renderers->GetAdaptiveLevel() != 3)
+    {
+    cerr << "Level changed before the average came down." << endl;
+    return EXIT_FAILURE;
+    }
+  renderers->AddFrames(1, 0.01, 0.005, 1024 * 1024);
+  if (renderers->GetAdaptiveLevel() != 2)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  // The statistics are part of the log sent by each process.
+  vtkNew<vtkPVTimerInformation> serverInfo;
+  serverInfo->CopyFromObject(NULL);
+  vtkClientServerStream stream;
+  serverInfo->CopyToStream(&stream);
+  vtkNew<vtkPVTimerInformation> info;
+  info->CopyFromStream(&stream);
+  const char* log = info->GetNumberOfLogs() == 1? info->GetLog(0) : NULL;
+  if (!log || std::string(log).find(
+      "Statistics:\n    Image Bandwidth (MB/s): ") == std::string::npos ||
+    std::string(log).find("Image Compressor Mode: adaptive\n") ==
+    std::string::npos)
+    {
+    cerr << "Statistics missing from the log." << endl;
+    return EXIT_FAILURE;
+    }
+
+  renderers->SetAdaptiveCompression(false);
+  if (!CheckStatistic("Image Compressor Mode", "fixed") ||
+    !CheckStatistic("Image Compressor", "vtkSquirtCompressor 0 3") ||
+    !CheckStatistic("Image Transmit Reduction Factor", "1"))
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
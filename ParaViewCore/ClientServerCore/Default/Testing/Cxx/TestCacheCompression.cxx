@@ -0,0 +1,146 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestCacheCompression.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Caches a time series with and without compressed cache entries, checks
+// that cache hits reproduce the data and reports the number of time steps
+// that fit in a GB of cache along with the latency of a cache hit.
+
+#include "vtkCacheSizeKeeper.h"
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVCacheKeeper.h"
+#include "vtkSphereSource.h"
+#include "vtkTimerLog.h"
+
+#include <iostream>
+#include <string.h>
+
+namespace
+{
+  const int NUMBER_OF_TIME_STEPS = 10;
+
+  void SetTime(vtkSphereSource* sphere, int time)
+    {
+    sphere->SetCenter(time, 0.5 * time, 0);
+    sphere->SetRadius(1.0 + 0.1 * time);
+    }
+
+  bool SameArray(vtkDataArray* a, vtkDataArray* b)
+    {
+    if (!a || !b)
+      {
+      return a == b;
+      }
+    return a->GetDataType() == b->GetDataType() &&
+      a->GetNumberOfComponents() == b->GetNumberOfComponents() &&
+      a->GetNumberOfTuples() == b->GetNumberOfTuples() &&
+      memcmp(a->GetVoidPointer(0), b->GetVoidPointer(0),
+        a->GetNumberOfTuples() * a->GetNumberOfComponents() *
+        a->GetDataTypeSize()) == 0;
+    }
+
+  bool SamePolyData(vtkPolyData* a, vtkPolyData* b)
+    {
+    return a->GetNumberOfPoints() == b->GetNumberOfPoints() &&
+      a->GetNumberOfCells() == b->GetNumberOfCells() &&
+      SameArray(a->GetPoints()->GetData(), b->GetPoints()->GetData()) &&
+      SameArray(a->GetPolys()->GetData(), b->GetPolys()->GetData()) &&
+      SameArray(a->GetPointData()->GetNormals(),
+        b->GetPointData()->GetNormals());
+    }
+
+  bool Benchmark(bool compress)
+    {
+    vtkCacheSizeKeeper* csk = vtkCacheSizeKeeper::GetInstance();
+    csk->SetCompressCacheEntries(compress? 1 : 0);
+    csk->SetCacheLimit(VTK_UNSIGNED_LONG_MAX);
+    csk->SetCacheFull(0);
+
+    vtkNew<vtkSphereSource> sphere;
+    sphere->SetThetaResolution(256);
+    sphere->SetPhiResolution(256);
+    vtkNew<vtkPVCacheKeeper> keeper;
+    keeper->SetInputConnection(sphere->GetOutputPort());
+
+    // Fill the cache.
+    vtkNew<vtkTimerLog> timer;
+    double missTime = 0.0;
+    for (int time = 0; time < NUMBER_OF_TIME_STEPS; ++time)
+      {
+      SetTime(sphere.GetPointer(), time);
+      keeper->SetCacheTime(time);
+      timer->StartTimer();
+      keeper->Update();
+      timer->StopTimer();
+      missTime += timer->GetElapsedTime();
+      }
+    const double kbPerTimeStep =
+      static_cast<double>(csk->GetCacheSize()) / NUMBER_OF_TIME_STEPS;
+
+    // Play back the cached time steps.
+    vtkNew<vtkSphereSource> reference;
+    reference->SetThetaResolution(256);
+    reference->SetPhiResolution(256);
+    double hitTime = 0.0;
+    for (int time = 0; time < NUMBER_OF_TIME_STEPS; ++time)
+      {
+      keeper->SetCacheTime(time);
+      timer->StartTimer();
+      keeper->Update();
+      timer->StopTimer();
+      hitTime += timer->GetElapsedTime();
+
+      SetTime(reference.GetPointer(), time);
+      reference->Update();
+      vtkPolyData* output = vtkPolyData::SafeDownCast(keeper->GetOutput());
+      if (!output || !SamePolyData(output, reference->GetOutput()))
+        {
+        std::cerr << "ERROR: cached data does not match time step " << time
+          << (compress? " (compressed)" : "") << std::endl;
+        return false;
+        }
+      }
+
+    std::cout << (compress? "Compressed cache:" : "Uncompressed cache:")
+      << std::endl
+      << "  size per time step: " << kbPerTimeStep << " KB" << std::endl
+      << "  time steps per GB:  "
+      << (kbPerTimeStep > 0? 1024.0 * 1024.0 / kbPerTimeStep : 0.0)
+      << std::endl
+      << "  miss latency:       "
+      << 1000.0 * missTime / NUMBER_OF_TIME_STEPS << " ms" << std::endl
+      << "  hit latency:        "
+      << 1000.0 * hitTime / NUMBER_OF_TIME_STEPS << " ms" << std::endl;
+
+    keeper->RemoveAllCaches();
+    return csk->GetCacheSize() == 0;
+    }
+}
+
+int TestCacheCompression(int , char* [])
+{
+  vtkCacheSizeKeeper* csk = vtkCacheSizeKeeper::GetInstance();
+  unsigned long limit = csk->GetCacheLimit();
+
+  bool success = Benchmark(false);
+  success = Benchmark(true) && success;
+
+  csk->SetCompressCacheEntries(0);
+  csk->SetCacheLimit(limit);
+  return success? 0 : 1;
+}
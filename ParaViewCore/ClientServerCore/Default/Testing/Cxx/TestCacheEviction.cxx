@@ -0,0 +1,131 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestCacheEviction.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCacheSizeKeeper.h"
+#include "vtkNew.h"
+#include "vtkPVCacheKeeper.h"
+#include "vtkPVCacheSizeInformation.h"
+#include "vtkSphereSource.h"
+
+#include <iostream>
+
+namespace
+{
+  // Mimics what vtkPVView::Update() does on a single process.
+  void UpdateTime(vtkPVCacheKeeper* keepers[], int numKeepers, double time)
+    {
+    vtkCacheSizeKeeper* csk = vtkCacheSizeKeeper::GetInstance();
+    csk->EvictCacheTimes(csk->GetNumberOfCacheTimesToEvict(time), time);
+    csk->SetCacheFull(csk->GetCacheSize() > csk->GetCacheLimit());
+    for (int cc = 0; cc < numKeepers; ++cc)
+      {
+      keepers[cc]->SetCacheTime(time);
+      keepers[cc]->Update();
+      }
+    }
+}
+
+int TestCacheEviction(int , char* [])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(200);
+  sphere->SetPhiResolution(200);
+
+  vtkNew<vtkPVCacheKeeper> keeper0;
+  vtkNew<vtkPVCacheKeeper> keeper1;
+  vtkPVCacheKeeper* keepers[2] = { keeper0.GetPointer(), keeper1.GetPointer() };
+  for (int cc = 0; cc < 2; ++cc)
+    {
+    keepers[cc]->SetInputConnection(sphere->GetOutputPort());
+    }
+
+  vtkCacheSizeKeeper* csk = vtkCacheSizeKeeper::GetInstance();
+  csk->SetEvictionPolicy(vtkCacheSizeKeeper::LEAST_RECENTLY_USED);
+  csk->ResetStatistics();
+
+  // Find out the size of a time step and allow for 3 of them.
+  UpdateTime(keepers, 2, 0);
+  unsigned long timeSize = csk->GetCacheSize();
+  if (timeSize == 0)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  csk->SetCacheLimit(3 * timeSize);
+
+  for (int time = 1; time < 10; ++time)
+    {
+    UpdateTime(keepers, 2, time);
+    if (csk->GetNumberOfCachedTimes() > 4)
+      {
+      cerr << "Failed at " << __LINE__ << endl;
+      return EXIT_FAILURE;
+      }
+    if (!keeper0->IsCached(time) || !keeper1->IsCached(time))
+      {
+      cerr << "Failed at " << __LINE__ << endl;
+      return EXIT_FAILURE;
+      }
+    }
+  if (csk->GetNumberOfEvictions() <= 0 || csk->GetNumberOfHits() != 0)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  // The most recent time steps are still there, the first ones were evicted.
+  if (keeper0->IsCached(0) || keeper1->IsCached(0))
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  UpdateTime(keepers, 2, 8);
+  if (csk->GetNumberOfHits() != 2)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  // With the distance policy, the time steps far from the current time go
+  // first.
+  csk->SetEvictionPolicy(vtkCacheSizeKeeper::FARTHEST_FROM_CURRENT_TIME);
+  UpdateTime(keepers, 2, 10);
+  if (!keeper0->IsCached(9) || !keeper0->IsCached(10))
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkPVCacheSizeInformation> info;
+  info->CopyFromObject(NULL);
+  if (info->GetNumberOfHits() != csk->GetNumberOfHits() ||
+    info->GetNumberOfEvictions() != csk->GetNumberOfEvictions() ||
+    info->GetCacheSize() != csk->GetCacheSize())
+    {
+    cerr << "Statistics not copied by vtkPVCacheSizeInformation." << endl;
+    return EXIT_FAILURE;
+    }
+
+  for (int cc = 0; cc < 2; ++cc)
+    {
+    keepers[cc]->RemoveAllCaches();
+    }
+  if (csk->GetCacheSize() != 0 || csk->GetNumberOfCachedTimes() != 0)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  csk->SetEvictionPolicy(vtkCacheSizeKeeper::NO_EVICTION);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,216 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestDataDeltaEncoder.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Sends an animated polydata through a pair of vtkPVDataDeltaEncoder, using
+// the legacy format as vtkMPIMoveData does, and checks that only the parts
+// that changed are sent while the received data matches the data sent.
+
+#include "vtkCellArray.h"
+#include "vtkCharArray.h"
+#include "vtkFloatArray.h"
+#include "vtkGenericDataObjectReader.h"
+#include "vtkGenericDataObjectWriter.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVDataDeltaEncoder.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+#include <iostream>
+#include <string.h>
+
+namespace
+{
+  // Mimics what vtkMPIMoveData does between the data server and the client.
+  vtkSmartPointer<vtkPolyData> Transfer(vtkPVDataDeltaEncoder* sender,
+    vtkPVDataDeltaEncoder* receiver, vtkPolyData* data)
+    {
+    vtkDataObject* encoded = sender->Encode(data);
+    vtkNew<vtkGenericDataObjectWriter> writer;
+    writer->SetInputData(encoded);
+    writer->SetFileTypeToBinary();
+    writer->WriteToOutputStringOn();
+    writer->Write();
+    encoded->Delete();
+
+    vtkNew<vtkCharArray> buffer;
+    buffer->SetArray(writer->GetOutputString(),
+      writer->GetOutputStringLength(), 1);
+    vtkNew<vtkGenericDataObjectReader> reader;
+    reader->ReadFromInputStringOn();
+    reader->SetInputArray(buffer.GetPointer());
+    reader->Update();
+
+    vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+    output->ShallowCopy(reader->GetOutputDataObject(0));
+    if (!receiver->Decode(output))
+      {
+      return NULL;
+      }
+    return output;
+    }
+
+  bool SameArray(vtkDataArray* a, vtkDataArray* b)
+    {
+    if (!a || !b)
+      {
+      return a == b;
+      }
+    return a->GetDataType() == b->GetDataType() &&
+      a->GetNumberOfComponents() == b->GetNumberOfComponents() &&
+      a->GetNumberOfTuples() == b->GetNumberOfTuples() &&
+      memcmp(a->GetVoidPointer(0), b->GetVoidPointer(0),
+        a->GetNumberOfTuples() * a->GetNumberOfComponents() *
+        a->GetDataTypeSize()) == 0;
+    }
+
+  bool SamePolyData(vtkPolyData* a, vtkPolyData* b)
+    {
+    return a && b &&
+      a->GetNumberOfPoints() == b->GetNumberOfPoints() &&
+      a->GetNumberOfCells() == b->GetNumberOfCells() &&
+      SameArray(a->GetPoints()->GetData(), b->GetPoints()->GetData()) &&
+      SameArray(a->GetPolys()->GetData(), b->GetPolys()->GetData()) &&
+      SameArray(a->GetPointData()->GetNormals(),
+        b->GetPointData()->GetNormals()) &&
+      SameArray(a->GetPointData()->GetArray("scalars"),
+        b->GetPointData()->GetArray("scalars"));
+    }
+}
+
+int TestDataDeltaEncoder(int , char* [])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(64);
+  sphere->Update();
+  vtkNew<vtkPolyData> data;
+  data->DeepCopy(sphere->GetOutput());
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("scalars");
+  scalars->SetNumberOfTuples(data->GetNumberOfPoints());
+  scalars->FillComponent(0, 0);
+  data->GetPointData()->AddArray(scalars.GetPointer());
+
+  vtkNew<vtkPVDataDeltaEncoder> sender;
+  vtkNew<vtkPVDataDeltaEncoder> receiver;
+
+  // The first transfer is complete.
+  vtkSmartPointer<vtkPolyData> received =
+    Transfer(sender.GetPointer(), receiver.GetPointer(), data.GetPointer());
+  if (!SamePolyData(received, data.GetPointer()))
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  if (sender->GetLastSkippedSize() != 0)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  const vtkTypeInt64 fullSize = sender->GetLastSentSize();
+
+  // Only the scalars changed.
+  scalars->FillComponent(0, 1);
+  scalars->Modified();
+  received =
+    Transfer(sender.GetPointer(), receiver.GetPointer(), data.GetPointer());
+  if (!SamePolyData(received, data.GetPointer()))
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  if (sender->GetLastSentSize() !=
+    static_cast<vtkTypeInt64>(sizeof(float)) * data->GetNumberOfPoints())
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  if (sender->GetLastSkippedSize() <= 0)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  if (received->GetPointData()->GetNormals() == NULL)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Nothing changed.
+  received =
+    Transfer(sender.GetPointer(), receiver.GetPointer(), data.GetPointer());
+  if (!SamePolyData(received, data.GetPointer()))
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  if (sender->GetLastSentSize() != 0)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  // The points moved.
+  data->GetPoints()->SetPoint(0, 10, 10, 10);
+  data->GetPoints()->Modified();
+  received =
+    Transfer(sender.GetPointer(), receiver.GetPointer(), data.GetPointer());
+  if (!SamePolyData(received, data.GetPointer()))
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  if (sender->GetLastSentSize() <= 0 || sender->GetLastSentSize() >= fullSize)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  // A receiver that lost track cannot rebuild the next delta; once the
+  // sender is reset as well, as vtkMPIMoveData does, the data is sent
+  // complete and both are in sync again.
+  receiver->Reset();
+  scalars->FillComponent(0, 2);
+  scalars->Modified();
+  received =
+    Transfer(sender.GetPointer(), receiver.GetPointer(), data.GetPointer());
+  if (received.GetPointer() != NULL)
+    {
+    cerr << "A delta was rebuilt without the data it refers to." << endl;
+    return EXIT_FAILURE;
+    }
+  sender->Reset();
+  received =
+    Transfer(sender.GetPointer(), receiver.GetPointer(), data.GetPointer());
+  if (!SamePolyData(received, data.GetPointer()) ||
+    sender->GetLastSkippedSize() != 0)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  scalars->FillComponent(0, 3);
+  scalars->Modified();
+  received =
+    Transfer(sender.GetPointer(), receiver.GetPointer(), data.GetPointer());
+  if (!SamePolyData(received, data.GetPointer()) ||
+    sender->GetLastSkippedSize() <= 0)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestDataInformationBlocks.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Gathers the information of a multiblock dataset with many blocks twice,
+// modifying one block in between, and checks that the information of
+// unchanged blocks is reused while the modified block is visited again.
+
+#include "vtkFloatArray.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVArrayInformation.h"
+#include "vtkPVDataInformation.h"
+#include "vtkPVDataSetAttributesInformation.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTimerLog.h"
+
+#include <iostream>
+
+namespace
+{
+  const unsigned int NUMBER_OF_BLOCKS = 1000;
+
+  double GetRange(vtkPVDataInformation* info, int comp)
+    {
+    vtkPVArrayInformation* ainfo =
+      info->GetPointDataInformation()->GetArrayInformation("scalars");
+    return ainfo? ainfo->GetComponentRange(0)[comp] : 0.0;
+    }
+}
+
+int TestDataInformationBlocks(int , char* [])
+{
+  vtkNew<vtkSphereSource> sphere;
+  vtkNew<vtkMultiBlockDataSet> mb;
+  mb->SetNumberOfBlocks(NUMBER_OF_BLOCKS);
+  for (unsigned int cc = 0; cc < NUMBER_OF_BLOCKS; ++cc)
+    {
+    sphere->SetCenter(cc, 0, 0);
+    sphere->Update();
+    vtkSmartPointer<vtkPolyData> block = vtkSmartPointer<vtkPolyData>::New();
+    block->DeepCopy(sphere->GetOutput());
+    vtkNew<vtkFloatArray> scalars;
+    scalars->SetName("scalars");
+    scalars->SetNumberOfTuples(block->GetNumberOfPoints());
+    scalars->FillComponent(0, cc);
+    block->GetPointData()->AddArray(scalars.GetPointer());
+    mb->SetBlock(cc, block);
+    }
+
+  vtkNew<vtkTimerLog> timer;
+  vtkNew<vtkPVDataInformation> first;
+  timer->StartTimer();
+  first->CopyFromObject(mb.GetPointer());
+  timer->StopTimer();
+  double firstTime = timer->GetElapsedTime();
+  if (first->GetNumberOfDataSets() != static_cast<int>(NUMBER_OF_BLOCKS))
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  if (GetRange(first.GetPointer(), 1) != NUMBER_OF_BLOCKS - 1)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Unchanged blocks are reused.
+  vtkNew<vtkPVDataInformation> second;
+  timer->StartTimer();
+  second->CopyFromObject(mb.GetPointer());
+  timer->StopTimer();
+  double secondTime = timer->GetElapsedTime();
+  if (second->GetNumberOfPoints() != first->GetNumberOfPoints())
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  if (second->GetMemorySize() != first->GetMemorySize())
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  for (int cc = 0; cc < 6; ++cc)
+    {
+    if (second->GetBounds()[cc] != first->GetBounds()[cc])
+      {
+      cerr << "Failed at " << __LINE__ << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // A modified block is visited again.
+  vtkPolyData* last = vtkPolyData::SafeDownCast(
+    mb->GetBlock(NUMBER_OF_BLOCKS - 1));
+  vtkFloatArray::SafeDownCast(
+    last->GetPointData()->GetArray("scalars"))->FillComponent(0, 2000);
+  last->GetPointData()->GetArray("scalars")->Modified();
+  vtkPoints* points = last->GetPoints();
+  points->SetPoint(0, 5000, 0, 0);
+  points->Modified();
+
+  vtkNew<vtkPVDataInformation> third;
+  third->CopyFromObject(mb.GetPointer());
+  if (GetRange(third.GetPointer(), 1) != 2000)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  if (third->GetBounds()[1] != 5000)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "First gather:  " << 1000.0 * firstTime << " ms" << std::endl
+    << "Second gather: " << 1000.0 * secondTime << " ms" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,197 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestGeometryPrefetch.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Prefetches the next time of a temporal source with vtkGeometryRepresentation
+// and checks that the input and the rendered geometry are left untouched,
+// that the next frame is served from the prefetched geometry without
+// executing the source again, and that a prefetch can be cancelled.
+
+#include "vtkCacheSizeKeeper.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkGeometryRepresentation.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+namespace
+{
+  // Produces a single vertex whose x coordinate is the requested time.
+  class vtkTestTimeSource : public vtkPolyDataAlgorithm
+    {
+  public:
+    static vtkTestTimeSource* New();
+    vtkTypeMacro(vtkTestTimeSource, vtkPolyDataAlgorithm);
+
+    int NumberOfExecutions;
+
+  protected:
+    vtkTestTimeSource() : NumberOfExecutions(0)
+      {
+      this->SetNumberOfInputPorts(0);
+      }
+
+    virtual int RequestInformation(vtkInformation*, vtkInformationVector**,
+      vtkInformationVector* outputVector)
+      {
+      double times[4] = { 0.0, 1.0, 2.0, 3.0 };
+      double range[2] = { 0.0, 3.0 };
+      vtkInformation* outInfo = outputVector->GetInformationObject(0);
+      outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), times, 4);
+      outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+      return 1;
+      }
+
+    virtual int RequestData(vtkInformation*, vtkInformationVector**,
+      vtkInformationVector* outputVector)
+      {
+      vtkInformation* outInfo = outputVector->GetInformationObject(0);
+      double time = outInfo->Has(
+        vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP())?
+        outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP()) :
+        0.0;
+      vtkPolyData* output = vtkPolyData::GetData(outInfo);
+      vtkNew<vtkPoints> points;
+      points->InsertNextPoint(time, 0.0, 0.0);
+      output->SetPoints(points.GetPointer());
+      vtkIdType cell = 0;
+      output->Allocate(1);
+      output->InsertNextCell(VTK_VERTEX, 1, &cell);
+      output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), time);
+      this->NumberOfExecutions++;
+      return 1;
+      }
+    };
+  vtkStandardNewMacro(vtkTestTimeSource);
+
+  class vtkTestGeometryRepresentation : public vtkGeometryRepresentation
+    {
+  public:
+    static vtkTestGeometryRepresentation* New();
+    vtkTypeMacro(vtkTestGeometryRepresentation, vtkGeometryRepresentation);
+
+    bool IsTimeCached(double time) { return this->IsCached(time); }
+    };
+  vtkStandardNewMacro(vtkTestGeometryRepresentation);
+
+  // Returns the x coordinate of the first point rendered.
+  double GetRenderedTime(vtkGeometryRepresentation* repr)
+    {
+    vtkCompositeDataSet* output = vtkCompositeDataSet::SafeDownCast(
+      repr->GetRenderedDataObject(0));
+    if (!output)
+      {
+      return -1.0;
+      }
+    vtkCompositeDataIterator* iter = output->NewIterator();
+    double time = -1.0;
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      vtkPolyData* block = vtkPolyData::SafeDownCast(
+        iter->GetCurrentDataObject());
+      if (block && block->GetNumberOfPoints() > 0)
+        {
+        time = block->GetPoint(0)[0];
+        break;
+        }
+      }
+    iter->Delete();
+    return time;
+    }
+}
+
+int TestGeometryPrefetch(int, char*[])
+{
+  vtkCacheSizeKeeper::GetInstance()->SetCacheLimit(100 * 1024);
+  vtkCacheSizeKeeper::GetInstance()->SetCacheFull(false);
+
+  vtkNew<vtkTestTimeSource> source;
+  vtkNew<vtkTestGeometryRepresentation> repr;
+  repr->SetInputConnection(source->GetOutputPort());
+  repr->SetUseCache(true);
+  repr->SetCacheKey(0.0);
+  repr->SetUpdateTime(0.0);
+  repr->Update();
+  if (source->NumberOfExecutions != 1 ||
+    GetRenderedTime(repr.GetPointer()) != 0.0)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Prefetching executes the source for the next time but leaves its output
+  // and the rendered geometry as they were.
+  if (!repr->Prefetch(1.0) || !repr->IsTimeCached(1.0))
+    {
+    cerr << "Time 1 was not prefetched." << endl;
+    return EXIT_FAILURE;
+    }
+  vtkPolyData* input = source->GetOutput();
+  if (source->NumberOfExecutions != 2 ||
+    input->GetPoint(0)[0] != 0.0 ||
+    input->GetInformation()->Get(vtkDataObject::DATA_TIME_STEP()) != 0.0 ||
+    GetRenderedTime(repr.GetPointer()) != 0.0)
+    {
+    cerr << "Prefetching changed the input or the rendered geometry." << endl;
+    return EXIT_FAILURE;
+    }
+
+  // The next frame is the prefetched geometry, the source does not execute.
+  repr->SetCacheKey(1.0);
+  repr->SetUpdateTime(1.0);
+  repr->Update();
+  if (source->NumberOfExecutions != 2 ||
+    GetRenderedTime(repr.GetPointer()) != 1.0)
+    {
+    cerr << "The next frame did not use the prefetched geometry." << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Cancelling frees a prefetched time that was not rendered only.
+  repr->CancelPrefetch(1.0);
+  if (!repr->IsTimeCached(1.0))
+    {
+    cerr << "Cancelling removed a rendered time." << endl;
+    return EXIT_FAILURE;
+    }
+  if (!repr->Prefetch(2.0))
+    {
+    cerr << "Time 2 was not prefetched." << endl;
+    return EXIT_FAILURE;
+    }
+  repr->CancelPrefetch(2.0);
+  if (repr->IsTimeCached(2.0) || GetRenderedTime(repr.GetPointer()) != 1.0)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Without caching, the representation executes the source for the time
+  // asked for, not for the prefetched one.
+  repr->SetUseCache(false);
+  repr->SetUpdateTime(3.0);
+  repr->Update();
+  if (GetRenderedTime(repr.GetPointer()) != 3.0)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
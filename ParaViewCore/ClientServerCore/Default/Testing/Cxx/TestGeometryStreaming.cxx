@@ -0,0 +1,280 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestGeometryStreaming.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the order in which vtkMultiBlockStreamingPriorityQueue returns the
+// blocks of a multiblock meta-data for a given camera, then streams the
+// blocks of a source providing such meta-data with vtkGeometryRepresentation
+// and checks the blocks requested and the geometry produced for each of them.
+
+#include "vtkCamera.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataPipeline.h"
+#include "vtkGeometryRepresentation.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiBlockDataSetAlgorithm.h"
+#include "vtkMultiBlockStreamingPriorityQueue.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVView.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+#include <vector>
+
+namespace
+{
+  const int NUMBER_OF_BLOCKS = 4;
+
+  // Centers of the blocks, seen from a camera at (0, 0, 10) looking at the
+  // origin: the first one is at the origin, the second one off-screen, the
+  // third one close to the camera and the last one behind the origin.
+  const double CENTERS[NUMBER_OF_BLOCKS][3] = {
+    { 0.0, 0.0, 0.0 }, { 100.0, 0.0, 0.0 }, { 0.0, 0.0, 5.0 },
+    { 0.0, 0.0, -5.0 } };
+
+  // Returns the meta-data of the blocks, with bounds for all but
+  // \c unbounded.
+  vtkMultiBlockDataSet* NewMetaData(int unbounded)
+    {
+    vtkMultiBlockDataSet* metadata = vtkMultiBlockDataSet::New();
+    metadata->SetNumberOfBlocks(NUMBER_OF_BLOCKS);
+    for (int cc = 0; cc < NUMBER_OF_BLOCKS; ++cc)
+      {
+      if (cc == unbounded)
+        {
+        continue;
+        }
+      double bounds[6];
+      for (int kk = 0; kk < 3; ++kk)
+        {
+        bounds[2 * kk] = CENTERS[cc][kk] - 0.5;
+        bounds[2 * kk + 1] = CENTERS[cc][kk] + 0.5;
+        }
+      metadata->GetMetaData(static_cast<unsigned int>(cc))->Set(
+        vtkStreamingDemandDrivenPipeline::BOUNDS(), bounds, 6);
+      }
+    return metadata;
+    }
+
+  // Produces one vertex per block, at its center. Without a request for
+  // specific blocks, only the first one is produced.
+  class vtkTestBlockSource : public vtkMultiBlockDataSetAlgorithm
+    {
+  public:
+    static vtkTestBlockSource* New();
+    vtkTypeMacro(vtkTestBlockSource, vtkMultiBlockDataSetAlgorithm);
+
+    // Composite indices of the blocks produced by each execution.
+    std::vector<std::vector<int> > Executions;
+
+  protected:
+    vtkTestBlockSource()
+      {
+      this->SetNumberOfInputPorts(0);
+      }
+
+    virtual int RequestInformation(vtkInformation*, vtkInformationVector**,
+      vtkInformationVector* outputVector)
+      {
+      vtkMultiBlockDataSet* metadata = NewMetaData(-1);
+      outputVector->GetInformationObject(0)->Set(
+        vtkCompositeDataPipeline::COMPOSITE_DATA_META_DATA(), metadata);
+      metadata->Delete();
+      return 1;
+      }
+
+    virtual int RequestData(vtkInformation*, vtkInformationVector**,
+      vtkInformationVector* outputVector)
+      {
+      vtkInformation* outInfo = outputVector->GetInformationObject(0);
+      std::vector<int> ids(1, 1);
+      if (outInfo->Has(vtkCompositeDataPipeline::LOAD_REQUESTED_BLOCKS()) &&
+        outInfo->Has(vtkCompositeDataPipeline::UPDATE_COMPOSITE_INDICES()))
+        {
+        int* indices =
+          outInfo->Get(vtkCompositeDataPipeline::UPDATE_COMPOSITE_INDICES());
+        ids.assign(indices, indices + outInfo->Length(
+            vtkCompositeDataPipeline::UPDATE_COMPOSITE_INDICES()));
+        }
+
+      vtkMultiBlockDataSet* output = vtkMultiBlockDataSet::GetData(outInfo);
+      output->SetNumberOfBlocks(NUMBER_OF_BLOCKS);
+      for (size_t cc = 0; cc < ids.size(); ++cc)
+        {
+        // The composite index of a block is one more than its number.
+        int block = ids[cc] - 1;
+        vtkNew<vtkPoints> points;
+        points->InsertNextPoint(CENTERS[block]);
+        vtkNew<vtkPolyData> polydata;
+        polydata->SetPoints(points.GetPointer());
+        vtkIdType cell = 0;
+        polydata->Allocate(1);
+        polydata->InsertNextCell(VTK_VERTEX, 1, &cell);
+        output->SetBlock(block, polydata.GetPointer());
+        }
+      this->Executions.push_back(ids);
+      return 1;
+      }
+    };
+  vtkStandardNewMacro(vtkTestBlockSource);
+
+  class vtkTestGeometryRepresentation : public vtkGeometryRepresentation
+    {
+  public:
+    static vtkTestGeometryRepresentation* New();
+    vtkTypeMacro(vtkTestGeometryRepresentation, vtkGeometryRepresentation);
+
+    bool StreamNextBlocks(const double viewPlanes[24])
+      {
+      return this->StreamingUpdate(viewPlanes);
+      }
+    vtkDataObject* GetStreamedPiece() { return this->ProcessedPiece; }
+    const double* GetDataBounds() { return this->DataBounds; }
+    };
+  vtkStandardNewMacro(vtkTestGeometryRepresentation);
+
+  // Returns the block number of the single vertex produced for \c data, -1 if
+  // there is none or more than one.
+  int GetStreamedBlock(vtkDataObject* data)
+    {
+    vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(data);
+    if (!cd)
+      {
+      return -1;
+      }
+    int block = -1;
+    vtkCompositeDataIterator* iter = cd->NewIterator();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      vtkPolyData* polydata =
+        vtkPolyData::SafeDownCast(iter->GetCurrentDataObject());
+      if (!polydata || polydata->GetNumberOfPoints() == 0)
+        {
+        continue;
+        }
+      double pt[3];
+      polydata->GetPoint(0, pt);
+      for (int cc = 0; cc < NUMBER_OF_BLOCKS; ++cc)
+        {
+        if (block == -1 && pt[0] == CENTERS[cc][0] &&
+          pt[1] == CENTERS[cc][1] && pt[2] == CENTERS[cc][2])
+          {
+          block = cc;
+          break;
+          }
+        }
+      }
+    iter->Delete();
+    return block;
+    }
+}
+
+int TestGeometryStreaming(int, char*[])
+{
+  vtkNew<vtkCamera> camera;
+  camera->SetPosition(0.0, 0.0, 10.0);
+  camera->SetFocalPoint(0.0, 0.0, 0.0);
+  camera->SetClippingRange(0.1, 100.0);
+  double viewPlanes[24];
+  camera->GetFrustumPlanes(1.0, viewPlanes);
+
+  // Without view planes the blocks come in order, the ones without bounds
+  // last. With them, the visible blocks come first, the closest one first.
+  vtkNew<vtkMultiBlockStreamingPriorityQueue> queue;
+  queue->SetController(NULL);
+  vtkMultiBlockDataSet* metadata = NewMetaData(0);
+  queue->Initialize(metadata);
+  metadata->Delete();
+  const unsigned int inOrder[NUMBER_OF_BLOCKS] = { 2, 3, 4, 1 };
+  for (int cc = 0; cc < NUMBER_OF_BLOCKS; ++cc)
+    {
+    if (queue->IsEmpty() || queue->Pop() != inOrder[cc])
+      {
+      cerr << "Wrong order without view planes at " << cc << endl;
+      return EXIT_FAILURE;
+      }
+    }
+  metadata = NewMetaData(0);
+  queue->Initialize(metadata);
+  metadata->Delete();
+  double bounds[6];
+  if (!queue->GetBounds(bounds) || bounds[0] != -0.5 || bounds[1] != 100.5 ||
+    bounds[4] != -5.5 || bounds[5] != 5.5)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+  queue->Update(viewPlanes);
+  const unsigned int byPriority[NUMBER_OF_BLOCKS] = { 3, 4, 2, 1 };
+  for (int cc = 0; cc < NUMBER_OF_BLOCKS; ++cc)
+    {
+    if (queue->IsEmpty() || queue->Pop() != byPriority[cc])
+      {
+      cerr << "Wrong order with view planes at " << cc << endl;
+      return EXIT_FAILURE;
+      }
+    }
+  if (!queue->IsEmpty())
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  // The representation renders the first block and reports the bounds of
+  // all of them, then streams the others one at a time, by priority.
+  vtkPVView::SetEnableStreaming(true);
+  vtkNew<vtkTestBlockSource> source;
+  vtkNew<vtkTestGeometryRepresentation> repr;
+  repr->SetInputConnection(source->GetOutputPort());
+  repr->SetStreamingRequestSize(1);
+  repr->Update();
+  const double* dataBounds = repr->GetDataBounds();
+  if (source->Executions.size() != 1 ||
+    GetStreamedBlock(repr->GetRenderedDataObject(0)) != 0 ||
+    dataBounds[0] != -0.5 || dataBounds[1] != 100.5 ||
+    dataBounds[4] != -5.5 || dataBounds[5] != 5.5)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    vtkPVView::SetEnableStreaming(false);
+    return EXIT_FAILURE;
+    }
+
+  const int streamed[NUMBER_OF_BLOCKS - 1] = { 2, 3, 1 };
+  for (int cc = 0; cc < NUMBER_OF_BLOCKS - 1; ++cc)
+    {
+    if (!repr->StreamNextBlocks(viewPlanes) ||
+      source->Executions.size() != static_cast<size_t>(cc + 2) ||
+      source->Executions.back().size() != 1 ||
+      source->Executions.back()[0] != streamed[cc] + 1 ||
+      GetStreamedBlock(repr->GetStreamedPiece()) != streamed[cc])
+      {
+      cerr << "Block " << streamed[cc] << " was not streamed." << endl;
+      vtkPVView::SetEnableStreaming(false);
+      return EXIT_FAILURE;
+      }
+    }
+  if (repr->StreamNextBlocks(viewPlanes) ||
+    GetStreamedBlock(repr->GetRenderedDataObject(0)) != 0)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    vtkPVView::SetEnableStreaming(false);
+    return EXIT_FAILURE;
+    }
+  vtkPVView::SetEnableStreaming(false);
+  return EXIT_SUCCESS;
+}
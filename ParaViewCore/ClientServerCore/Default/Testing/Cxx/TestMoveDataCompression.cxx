@@ -0,0 +1,237 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestMoveDataCompression.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Sends data through the codecs of vtkMPIMoveData, compressed as a whole as
+// among the processes of a server and streamed in chunks as over a socket,
+// and checks that the data received matches the data sent. The data is
+// either small, large enough to span several chunks, or random so that it
+// does not compress. Also checks that the receiver sends nothing back.
+
+#include "vtkCommunicator.h"
+#include "vtkDataArray.h"
+#include "vtkMPIMoveData.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <deque>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+  const int TAG = 100;
+
+  // Queues the messages sent for them to be received in the same thread.
+  class vtkLoopbackCommunicator : public vtkCommunicator
+    {
+  public:
+    static vtkLoopbackCommunicator* New();
+    vtkTypeMacro(vtkLoopbackCommunicator, vtkCommunicator);
+
+    virtual int SendVoidArray(const void* data, vtkIdType length, int type,
+      int, int tag)
+      {
+      const char* bytes = static_cast<const char*>(data);
+      this->Messages.push_back(Message());
+      this->Messages.back().Tag = tag;
+      this->Messages.back().Type = type;
+      this->Messages.back().Bytes.assign(bytes,
+        bytes + length * vtkDataArray::GetDataTypeSize(type));
+      return 1;
+      }
+
+    virtual int ReceiveVoidArray(void* data, vtkIdType maxlength, int type,
+      int, int tag)
+      {
+      std::deque<Message>::iterator iter = this->Messages.begin();
+      while (iter != this->Messages.end() && iter->Tag != tag)
+        {
+        ++iter;
+        }
+      const vtkIdType size =
+        static_cast<vtkIdType>(vtkDataArray::GetDataTypeSize(type));
+      if (iter == this->Messages.end() || iter->Type != type ||
+        static_cast<vtkIdType>(iter->Bytes.size()) > maxlength * size)
+        {
+        return 0;
+        }
+      if (!iter->Bytes.empty())
+        {
+        memcpy(data, &iter->Bytes[0], iter->Bytes.size());
+        }
+      this->Count = static_cast<vtkIdType>(iter->Bytes.size()) / size;
+      this->Messages.erase(iter);
+      return 1;
+      }
+
+    size_t GetNumberOfPendingMessages() { return this->Messages.size(); }
+
+  protected:
+    vtkLoopbackCommunicator() {}
+
+    struct Message
+      {
+      int Tag;
+      int Type;
+      std::vector<char> Bytes;
+      };
+    std::deque<Message> Messages;
+    };
+  vtkStandardNewMacro(vtkLoopbackCommunicator);
+
+  // Exposes the buffer handling normally driven by RequestData().
+  class vtkTestMoveData : public vtkMPIMoveData
+    {
+  public:
+    static vtkTestMoveData* New();
+    vtkTypeMacro(vtkTestMoveData, vtkMPIMoveData);
+
+    bool CompressedRoundTrip(vtkPolyData* input, int method,
+      vtkPolyData* output)
+      {
+      this->ClearBuffer();
+      this->MarshalDataToBuffer(input);
+      this->CompressBuffer(method);
+      bool compressed = this->BufferTotalLength > 4 &&
+        memcmp(this->Buffers, "vmdc", 4) == 0;
+      if (compressed != (method != vtkMPIMoveData::NO_COMPRESSION))
+        {
+        cerr << "Method " << method << " was not applied." << endl;
+        return false;
+        }
+      this->ReconstructDataFromBuffer(output);
+      return true;
+      }
+
+    void Send(vtkCommunicator* com, vtkPolyData* input)
+      {
+      this->ClearBuffer();
+      this->MarshalDataToBuffer(input);
+      this->SendBuffer(com, 1, TAG);
+      }
+
+    void Receive(vtkCommunicator* com, vtkPolyData* output)
+      {
+      this->ReceiveBuffer(com, 0, TAG);
+      this->ReconstructDataFromBuffer(output);
+      }
+    };
+  vtkStandardNewMacro(vtkTestMoveData);
+
+  bool SameArray(vtkDataArray* a, vtkDataArray* b)
+    {
+    if (!a || !b)
+      {
+      return a == b;
+      }
+    return a->GetDataType() == b->GetDataType() &&
+      a->GetNumberOfComponents() == b->GetNumberOfComponents() &&
+      a->GetNumberOfTuples() == b->GetNumberOfTuples() &&
+      memcmp(a->GetVoidPointer(0), b->GetVoidPointer(0),
+        a->GetNumberOfTuples() * a->GetNumberOfComponents() *
+        a->GetDataTypeSize()) == 0;
+    }
+
+  bool SamePolyData(vtkPolyData* a, vtkPolyData* b)
+    {
+    return a->GetNumberOfPoints() == b->GetNumberOfPoints() &&
+      SameArray(a->GetPoints()->GetData(), b->GetPoints()->GetData()) &&
+      SameArray(a->GetPointData()->GetArray("Noise"),
+        b->GetPointData()->GetArray("Noise"));
+    }
+
+  // Points on a regular grid, which compress well, and optionally random
+  // bytes, which do not.
+  void CreatePolyData(vtkIdType numberOfPoints, bool noise,
+    vtkPolyData* data)
+    {
+    vtkNew<vtkPoints> points;
+    points->SetDataTypeToFloat();
+    points->SetNumberOfPoints(numberOfPoints);
+    for (vtkIdType cc = 0; cc < numberOfPoints; ++cc)
+      {
+      points->SetPoint(cc, cc % 100, (cc / 100) % 100, cc / 10000);
+      }
+    data->SetPoints(points.GetPointer());
+    if (noise)
+      {
+      vtkNew<vtkUnsignedCharArray> array;
+      array->SetName("Noise");
+      array->SetNumberOfComponents(8);
+      array->SetNumberOfTuples(numberOfPoints);
+      unsigned int seed = 12345;
+      unsigned char* ptr = array->GetPointer(0);
+      for (vtkIdType cc = 0; cc < 8 * numberOfPoints; ++cc)
+        {
+        seed = seed * 1103515245u + 12345u;
+        ptr[cc] = static_cast<unsigned char>(seed >> 24);
+        }
+      data->GetPointData()->AddArray(array.GetPointer());
+      }
+    }
+}
+
+int TestMoveDataCompression(int, char*[])
+{
+  // A single chunk, several chunks of compressible data and several chunks
+  // of mostly random data.
+  vtkNew<vtkPolyData> inputs[3];
+  CreatePolyData(10, false, inputs[0].GetPointer());
+  CreatePolyData(200000, false, inputs[1].GetPointer());
+  CreatePolyData(200000, true, inputs[2].GetPointer());
+
+  const int methods[3] = { vtkMPIMoveData::NO_COMPRESSION,
+    vtkMPIMoveData::LZ4_COMPRESSION, vtkMPIMoveData::ZLIB_COMPRESSION };
+  vtkNew<vtkTestMoveData> sender;
+  vtkNew<vtkTestMoveData> receiver;
+  vtkNew<vtkLoopbackCommunicator> com;
+  for (int i = 0; i < 3; ++i)
+    {
+    for (int j = 0; j < 3; ++j)
+      {
+      vtkNew<vtkPolyData> output;
+      if (!sender->CompressedRoundTrip(inputs[j].GetPointer(), methods[i],
+          output.GetPointer()) ||
+        !SamePolyData(inputs[j].GetPointer(), output.GetPointer()))
+        {
+        cerr << "Buffer compressed with method " << methods[i]
+          << " differs for input " << j << endl;
+        return EXIT_FAILURE;
+        }
+
+      sender->SetCompressionMethod(methods[i]);
+      sender->Send(com.GetPointer(), inputs[j].GetPointer());
+      vtkNew<vtkPolyData> received;
+      receiver->Receive(com.GetPointer(), received.GetPointer());
+      if (!SamePolyData(inputs[j].GetPointer(), received.GetPointer()))
+        {
+        cerr << "Data streamed with method " << methods[i]
+          << " differs for input " << j << endl;
+        return EXIT_FAILURE;
+        }
+      if (com->GetNumberOfPendingMessages() != 0)
+        {
+        cerr << com->GetNumberOfPendingMessages()
+          << " messages left after a transfer with method " << methods[i]
+          << endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+  return EXIT_SUCCESS;
+}
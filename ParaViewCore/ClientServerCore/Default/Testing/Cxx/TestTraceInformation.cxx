@@ -0,0 +1,191 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestTraceInformation.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Records events from several threads, checks that nothing is recorded when
+// recording is off and that the oldest events are discarded, sends the
+// events through a vtkClientServerStream as a server would, merges two
+// processes and checks the Chrome trace written. Also checks that the events
+// of a server whose clock is ahead are put back in the clock of the client.
+
+#include "vtkClientServerStream.h"
+#include "vtkMultiProcessStream.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
+#include "vtkProcessModule.h"
+#include "vtkPVTraceEventRecorder.h"
+#include "vtkPVTraceInformation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+
+namespace
+{
+  const int NUMBER_OF_THREADS = 4;
+
+  VTK_THREAD_RETURN_TYPE RecordEvent(void*)
+    {
+    vtkPVTraceEventScope traceEvent("pipeline", "vtk\"Quoted\"Filter", 64);
+    return VTK_THREAD_RETURN_VALUE;
+    }
+}
+
+int TestTraceInformation(int, char*[])
+{
+  vtkPVTraceEventRecorder::ResetEvents();
+  vtkPVTraceEventRecorder::SetEnabled(0);
+  {
+  vtkPVTraceEventScope traceEvent("pipeline", "ignored");
+  if (traceEvent.IsRecording())
+    {
+    cerr << "Recording while disabled." << endl;
+    return EXIT_FAILURE;
+    }
+  }
+  vtkPVTraceEventRecorder::AddEvent("message", "ignored", 0.0, 1.0);
+  if (vtkPVTraceEventRecorder::GetNumberOfEvents() != 0)
+    {
+    cerr << "An event was recorded while disabled." << endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkPVTraceEventRecorder::SetEnabled(1);
+  double start = vtkPVTraceEventRecorder::GetTime();
+  vtkPVTraceEventRecorder::AddEvent("message", "PushState", start,
+    start + 0.5, 1000);
+  vtkNew<vtkMultiThreader> threader;
+  threader->SetNumberOfThreads(NUMBER_OF_THREADS);
+  threader->SetSingleMethod(RecordEvent, NULL);
+  threader->SingleMethodExecute();
+  if (vtkPVTraceEventRecorder::GetNumberOfEvents() != 1 + NUMBER_OF_THREADS)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  std::vector<vtkPVTraceEventRecorder::Event> events;
+  vtkPVTraceEventRecorder::GetEvents(events);
+  int maxThread = 0;
+  for (size_t cc=0; cc < events.size(); cc++)
+    {
+    if (events[cc].End < events[cc].Start)
+      {
+      cerr << "Event " << cc << " ends before it starts." << endl;
+      return EXIT_FAILURE;
+      }
+    maxThread = std::max(maxThread, events[cc].Thread);
+    }
+  if (events[0].Name != "PushState" || events[0].Bytes != 1000 ||
+    maxThread <= 0 || maxThread > NUMBER_OF_THREADS)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Gather the events as a server would and merge them with the client's.
+  vtkNew<vtkPVTraceInformation> serverInfo;
+  serverInfo->ResetEventsOn();
+  serverInfo->CopyFromObject(NULL);
+  if (vtkPVTraceEventRecorder::GetNumberOfEvents() != 0)
+    {
+    cerr << "The events were not reset once gathered." << endl;
+    return EXIT_FAILURE;
+    }
+  vtkClientServerStream stream;
+  serverInfo->CopyToStream(&stream);
+
+  vtkPVTraceEventRecorder::AddEvent("delivery", "Receive buffer", start + 1,
+    start + 2, 2048);
+  vtkNew<vtkPVTraceInformation> info;
+  info->CopyFromObject(NULL);
+  vtkNew<vtkPVTraceInformation> received;
+  received->CopyFromStream(&stream);
+  info->AddInformation(received.GetPointer());
+  if (info->GetNumberOfProcesses() != 2 ||
+    info->GetNumberOfEvents(0) != 1 ||
+    info->GetNumberOfEvents(1) != 1 + NUMBER_OF_THREADS ||
+    info->GetNumberOfEvents() != 2 + NUMBER_OF_THREADS ||
+    info->GetClockOffset(0) != 0.0 || info->GetClockOffset(1) != 0.0)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  std::ostringstream json;
+  info->WriteChromeTrace(json);
+  const std::string trace = json.str();
+  if (trace.find("{\"traceEvents\":[") != 0 ||
+    trace.find("\"process_name\"") == std::string::npos ||
+    trace.find("\"name\":\"vtk\\\"Quoted\\\"Filter\"") == std::string::npos ||
+    trace.find("\"ts\":0.000,\"dur\":500000.000") == std::string::npos ||
+    trace.find("\"ts\":1000000.000,\"dur\":1000000.000,\"pid\":0") ==
+    std::string::npos ||
+    trace.find("\"args\":{\"bytes\":2048}") == std::string::npos)
+    {
+    cerr << "Unexpected trace:" << endl << trace << endl;
+    return EXIT_FAILURE;
+    }
+
+  // A server whose clock is ahead of the client's gathers its events
+  // between the request and the reply. Its offset brings them back within
+  // the round trip of the client's clock.
+  const double skew = 1000.0;
+  vtkNew<vtkPVTraceInformation> request;
+  vtkMultiProcessStream parameters;
+  request->CopyParametersToStream(parameters);
+  int magicNumber = 0;
+  int resetEvents = 0;
+  double referenceTime = 0.0;
+  parameters >> magicNumber >> resetEvents >> referenceTime;
+  double gatherTime = vtkPVTraceEventRecorder::GetTime() + skew;
+  vtkClientServerStream reply;
+  reply << vtkClientServerStream::Reply << 1
+        << static_cast<int>(vtkProcessModule::PROCESS_DATA_SERVER) << 0
+        << "remote" << referenceTime << gatherTime << 0.0 << 1
+        << "pipeline" << "Remote filter" << gatherTime - 0.25 << gatherTime
+        << 0 << static_cast<vtkTypeInt64>(0)
+        << vtkClientServerStream::End;
+  request->CopyFromStream(&reply);
+  double roundTrip = vtkPVTraceEventRecorder::GetTime() - referenceTime;
+  if (request->GetNumberOfProcesses() != 1 ||
+    request->GetNumberOfEvents(0) != 1 ||
+    fabs(request->GetClockOffset(0) + skew) > roundTrip)
+    {
+    cerr << "Wrong clock offset " << request->GetClockOffset(0) << endl;
+    return EXIT_FAILURE;
+    }
+
+  // The oldest events are discarded once the maximum is reached.
+  vtkPVTraceEventRecorder::ResetEvents();
+  vtkPVTraceEventRecorder::SetMaxNumberOfEvents(3);
+  for (int cc=0; cc < 5; cc++)
+    {
+    std::ostringstream name;
+    name << "event " << cc;
+    vtkPVTraceEventRecorder::AddEvent("message", name.str().c_str(),
+      start + cc, start + cc);
+    }
+  vtkPVTraceEventRecorder::GetEvents(events);
+  if (events.size() != 3 || events[0].Name != "event 2" ||
+    vtkPVTraceEventRecorder::GetNumberOfDiscardedEvents() != 2)
+    {
+    cerr << "Failed at " << __LINE__ << endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkPVTraceEventRecorder::SetMaxNumberOfEvents(100000);
+  vtkPVTraceEventRecorder::SetEnabled(0);
+  return EXIT_SUCCESS;
+}
@@ -15,8 +15,63 @@
 #include "vtkCacheSizeKeeper.h"
 
 #include "vtkObjectFactory.h"
+#include "vtkPVCacheKeeper.h"
 #include "vtkSmartPointer.h"
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+//----------------------------------------------------------------------------
+class vtkCacheSizeKeeper::vtkInternals
+{
+public:
+  struct vtkTimeEntry
+    {
+    unsigned long Size;
+    int NumberOfEntries;
+    unsigned long LastUsed;
+    vtkTimeEntry() : Size(0), NumberOfEntries(0), LastUsed(0) {}
+    };
+
+  typedef std::map<double, vtkTimeEntry> TimesType;
+  TimesType Times;
+  std::set<vtkPVCacheKeeper*> Keepers;
+  unsigned long Clock;
+
+  vtkInternals() : Clock(0) {}
+
+  // Fills candidates with the cache times that may be evicted, in eviction
+  // order. Ties are broken on the cache time so that the order is the same
+  // on all processes.
+  void GetCandidates(int policy, double currentTime,
+    std::vector<double>& candidates)
+    {
+    std::vector<std::pair<double, double> > keys;
+    for (TimesType::iterator iter = this->Times.begin();
+      iter != this->Times.end(); ++iter)
+      {
+      if (iter->first == currentTime)
+        {
+        continue;
+        }
+      double key = (policy == vtkCacheSizeKeeper::LEAST_RECENTLY_USED)?
+        static_cast<double>(iter->second.LastUsed) :
+        -std::fabs(iter->first - currentTime);
+      keys.push_back(std::pair<double, double>(key, iter->first));
+      }
+    std::sort(keys.begin(), keys.end());
+    candidates.clear();
+    for (size_t cc = 0; cc < keys.size(); ++cc)
+      {
+      candidates.push_back(keys[cc].second);
+      }
+    }
+};
+
 //----------------------------------------------------------------------------
 // Can't use vtkStandardNewMacro since it adds the instantiator function which
 // does not compile since vtkClientServerInterpreterInitializer::New() is
@@ -49,11 +104,150 @@ vtkCacheSizeKeeper::vtkCacheSizeKeeper()
   this->CacheSize = 0;
   this->CacheFull = 0;
   this->CacheLimit = 100*1024; // 100 MBs.
+  this->EvictionPolicy = NO_EVICTION;
+  this->CompressCacheEntries = 0;
+  this->NumberOfHits = 0;
+  this->NumberOfMisses = 0;
+  this->NumberOfEvictions = 0;
+  this->Internals = new vtkInternals();
 }
 
 //-----------------------------------------------------------------------------
 vtkCacheSizeKeeper::~vtkCacheSizeKeeper()
 {
+  delete this->Internals;
+  this->Internals = NULL;
+}
+
+//-----------------------------------------------------------------------------
+void vtkCacheSizeKeeper::RegisterCacheKeeper(vtkPVCacheKeeper* keeper)
+{
+  this->Internals->Keepers.insert(keeper);
+}
+
+//-----------------------------------------------------------------------------
+void vtkCacheSizeKeeper::UnRegisterCacheKeeper(vtkPVCacheKeeper* keeper)
+{
+  this->Internals->Keepers.erase(keeper);
+}
+
+//-----------------------------------------------------------------------------
+void vtkCacheSizeKeeper::AddCacheEntry(double cacheTime, unsigned long kbytes)
+{
+  this->CacheSize += kbytes;
+  vtkInternals::vtkTimeEntry& entry = this->Internals->Times[cacheTime];
+  entry.Size += kbytes;
+  entry.NumberOfEntries++;
+  entry.LastUsed = ++this->Internals->Clock;
+}
+
+//-----------------------------------------------------------------------------
+void vtkCacheSizeKeeper::RemoveCacheEntry(double cacheTime, unsigned long kbytes)
+{
+  this->FreeCacheSize(kbytes);
+  vtkInternals::TimesType::iterator iter =
+    this->Internals->Times.find(cacheTime);
+  if (iter != this->Internals->Times.end())
+    {
+    iter->second.Size = (iter->second.Size > kbytes)?
+      (iter->second.Size - kbytes) : 0;
+    if (--iter->second.NumberOfEntries <= 0)
+      {
+      this->Internals->Times.erase(iter);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkCacheSizeKeeper::RecordHit(double cacheTime)
+{
+  this->NumberOfHits++;
+  vtkInternals::TimesType::iterator iter =
+    this->Internals->Times.find(cacheTime);
+  if (iter != this->Internals->Times.end())
+    {
+    iter->second.LastUsed = ++this->Internals->Clock;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkCacheSizeKeeper::RecordMiss(double vtkNotUsed(cacheTime))
+{
+  this->NumberOfMisses++;
+}
+
+//-----------------------------------------------------------------------------
+int vtkCacheSizeKeeper::GetNumberOfCachedTimes()
+{
+  return static_cast<int>(this->Internals->Times.size());
+}
+
+//-----------------------------------------------------------------------------
+void vtkCacheSizeKeeper::ResetStatistics()
+{
+  this->NumberOfHits = 0;
+  this->NumberOfMisses = 0;
+  this->NumberOfEvictions = 0;
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkCacheSizeKeeper::GetNumberOfCacheTimesToEvict(double currentTime)
+{
+  vtkInternals::TimesType& times = this->Internals->Times;
+  if (this->EvictionPolicy == NO_EVICTION || times.empty())
+    {
+    return 0;
+    }
+
+  // If the current time is not cached yet, make room for an entry of the
+  // average size.
+  unsigned long required = 0;
+  if (times.find(currentTime) == times.end())
+    {
+    required = this->CacheSize / times.size();
+    }
+  if (required > this->CacheLimit)
+    {
+    // it won't fit anyways.
+    return 0;
+    }
+
+  std::vector<double> candidates;
+  this->Internals->GetCandidates(this->EvictionPolicy, currentTime, candidates);
+  unsigned long size = this->CacheSize;
+  vtkIdType count = 0;
+  for (size_t cc = 0; cc < candidates.size() &&
+    size + required > this->CacheLimit; ++cc, ++count)
+    {
+    unsigned long timeSize = times[candidates[cc]].Size;
+    size = (size > timeSize)? (size - timeSize) : 0;
+    }
+  return count;
+}
+
+//-----------------------------------------------------------------------------
+void vtkCacheSizeKeeper::EvictCacheTimes(vtkIdType count, double currentTime)
+{
+  if (count <= 0 || this->EvictionPolicy == NO_EVICTION)
+    {
+    return;
+    }
+
+  std::vector<double> candidates;
+  this->Internals->GetCandidates(this->EvictionPolicy, currentTime, candidates);
+  // keepers unregister their entries as they are evicted, iterate over a
+  // copy.
+  std::vector<vtkPVCacheKeeper*> keepers(
+    this->Internals->Keepers.begin(), this->Internals->Keepers.end());
+  for (vtkIdType cc = 0;
+    cc < count && cc < static_cast<vtkIdType>(candidates.size()); ++cc)
+    {
+    for (size_t kk = 0; kk < keepers.size(); ++kk)
+      {
+      keepers[kk]->RemoveCache(candidates[cc]);
+      }
+    this->NumberOfEvictions++;
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -63,4 +257,10 @@ void vtkCacheSizeKeeper::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "CacheSize: " << this->CacheSize << endl;
   os << indent << "CacheFull: " << this->CacheFull << endl;
   os << indent << "CacheLimit: " << this->CacheLimit << endl;
+  os << indent << "EvictionPolicy: " << this->EvictionPolicy << endl;
+  os << indent << "CompressCacheEntries: " << this->CompressCacheEntries
+    << endl;
+  os << indent << "NumberOfHits: " << this->NumberOfHits << endl;
+  os << indent << "NumberOfMisses: " << this->NumberOfMisses << endl;
+  os << indent << "NumberOfEvictions: " << this->NumberOfEvictions << endl;
 }
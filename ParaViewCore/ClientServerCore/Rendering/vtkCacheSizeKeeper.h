@@ -13,10 +13,25 @@
 
 =========================================================================*/
 // .NAME vtkCacheSizeKeeper - keeps track of amount of memory consumed
-// by caches in vtkPVUpateSupressor objects. 
+// by caches in vtkPVCacheKeeper objects. 
 // .SECTION Description:
 // vtkCacheSizeKeeper keeps track of the amount of memory cached
-// by several vtkPVUpdateSuppressor objects.
+// by several vtkPVCacheKeeper objects.
+//
+// Sizes are accounted per cache time, over all the vtkPVCacheKeeper
+// instances. When an EvictionPolicy is set, instead of refusing new entries
+// once CacheLimit is reached, whole cache times are evicted from all the
+// registered vtkPVCacheKeeper instances to make room for new ones. The cache
+// times to evict are picked either by least recent use or by distance from
+// the current time. Since both only depend on the sequence of cache times
+// used, all processes pick the same cache times, vtkPVView::Update() only
+// needs to agree on how many to evict.
+//
+// When CompressCacheEntries is set, vtkPVCacheKeeper instances store new
+// cache entries compressed and only the compressed size is accounted for.
+//
+// The keeper also counts cache hits, misses and evictions. These are
+// gathered by vtkPVCacheSizeInformation.
 
 #ifndef __vtkCacheSizeKeeper_h
 #define __vtkCacheSizeKeeper_h
@@ -24,6 +39,8 @@
 #include "vtkObject.h"
 #include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
 
+class vtkPVCacheKeeper;
+
 class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkCacheSizeKeeper : public vtkObject
 {
 public:
@@ -72,6 +89,61 @@ public:
   vtkGetMacro(CacheFull, int);
   vtkSetMacro(CacheFull, int);
 
+  enum EvictionPolicies
+    {
+    NO_EVICTION = 0,
+    LEAST_RECENTLY_USED = 1,
+    FARTHEST_FROM_CURRENT_TIME = 2
+    };
+
+  // Description:
+  // Get/Set the policy used to free cache space once CacheLimit is reached.
+  // With NO_EVICTION (default), caching simply stops when the cache is full.
+  // Must be set identically on all processes.
+  vtkSetClampMacro(EvictionPolicy, int, NO_EVICTION,
+    FARTHEST_FROM_CURRENT_TIME);
+  vtkGetMacro(EvictionPolicy, int);
+
+  // Description:
+  // Returns the number of cache times that must be evicted, in the order
+  // dictated by the EvictionPolicy, to make room for caching
+  // \c currentTime without exceeding CacheLimit. The cache time
+  // \c currentTime itself is never evicted.
+  vtkIdType GetNumberOfCacheTimesToEvict(double currentTime);
+
+  // Description:
+  // Evicts the first \c count cache times, in the order dictated by the
+  // EvictionPolicy, from all registered vtkPVCacheKeeper instances.
+  void EvictCacheTimes(vtkIdType count, double currentTime);
+
+  // Description:
+  // Get/Set if vtkPVCacheKeeper instances should store their cache entries
+  // compressed. Compressed entries take less of CacheLimit, hence more time
+  // steps can be cached, at the cost of decompressing the data on every cache
+  // hit. Off by default.
+  vtkSetMacro(CompressCacheEntries, int);
+  vtkGetMacro(CompressCacheEntries, int);
+  vtkBooleanMacro(CompressCacheEntries, int);
+
+  // Description:
+  // Cache statistics.
+  vtkGetMacro(NumberOfHits, unsigned long);
+  vtkGetMacro(NumberOfMisses, unsigned long);
+  vtkGetMacro(NumberOfEvictions, unsigned long);
+  int GetNumberOfCachedTimes();
+  void ResetStatistics();
+
+//BTX
+  // Description:
+  // Used by vtkPVCacheKeeper to register itself and its cache entries.
+  void RegisterCacheKeeper(vtkPVCacheKeeper*);
+  void UnRegisterCacheKeeper(vtkPVCacheKeeper*);
+  void AddCacheEntry(double cacheTime, unsigned long kbytes);
+  void RemoveCacheEntry(double cacheTime, unsigned long kbytes);
+  void RecordHit(double cacheTime);
+  void RecordMiss(double cacheTime);
+//ETX
+
 protected:
   static vtkCacheSizeKeeper* New();
   vtkCacheSizeKeeper();
@@ -80,9 +152,17 @@ protected:
   unsigned long CacheSize;
   unsigned long CacheLimit;
   int CacheFull;
+  int EvictionPolicy;
+  int CompressCacheEntries;
+  unsigned long NumberOfHits;
+  unsigned long NumberOfMisses;
+  unsigned long NumberOfEvictions;
 private:
   vtkCacheSizeKeeper(const vtkCacheSizeKeeper&); // Not implemented.
   void operator=(const vtkCacheSizeKeeper&); // Not implemented.
+
+  class vtkInternals;
+  vtkInternals* Internals;
 };
 
 #endif
@@ -302,6 +302,25 @@ void vtkCompositeRepresentation::SetCacheKey(double val)
   this->Superclass::SetCacheKey(val);
 }
 
+//----------------------------------------------------------------------------
+bool vtkCompositeRepresentation::Prefetch(double time)
+{
+  vtkPVDataRepresentation* activeRepr = this->GetActiveRepresentation();
+  return activeRepr? activeRepr->Prefetch(time) : false;
+}
+
+//----------------------------------------------------------------------------
+void vtkCompositeRepresentation::CancelPrefetch(double time)
+{
+  // the active representation may have changed since the prefetch.
+  vtkInternals::RepresentationMap::iterator iter;
+  for (iter = this->Internals->Representations.begin();
+    iter != this->Internals->Representations.end(); iter++)
+    {
+    iter->second.GetPointer()->CancelPrefetch(time);
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkCompositeRepresentation::SetForceUseCache(bool val)
 {
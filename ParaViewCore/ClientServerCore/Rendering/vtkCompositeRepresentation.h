@@ -98,6 +98,12 @@ public:
   virtual void SetForceUseCache(bool val);
   virtual void SetForcedCacheKey(double val);
 
+  // Description:
+  // Prefetch() is forwarded to the active representation, CancelPrefetch()
+  // to all representations.
+  virtual bool Prefetch(double time);
+  virtual void CancelPrefetch(double time);
+
 //BTX
 protected:
   vtkCompositeRepresentation();
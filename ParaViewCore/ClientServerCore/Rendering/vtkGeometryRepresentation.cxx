@@ -20,16 +20,19 @@
 # include "vtkShadowMapBakerPass.h"
 #endif
 #include "vtkAlgorithmOutput.h"
+#include "vtkAppendCompositeDataLeaves.h"
 #include "vtkBoundingBox.h"
 #include "vtkCommand.h"
 #include "vtkCompositeDataDisplayAttributes.h"
 #include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataPipeline.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkMatrix4x4.h"
 #include "vtkMultiBlockDataSetAlgorithm.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkMultiBlockStreamingPriorityQueue.h"
 #include "vtkMultiProcessController.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
@@ -38,6 +41,7 @@
 #include "vtkPVGeometryFilter.h"
 #include "vtkPVLODActor.h"
 #include "vtkPVRenderView.h"
+#include "vtkPVStreamingMacros.h"
 #include "vtkPVTrivialProducer.h"
 #include "vtkPVUpdateSuppressor.h"
 #include "vtkQuadricClustering.h"
@@ -51,6 +55,9 @@
 
 #include <vtksys/SystemTools.hxx>
 
+#include <assert.h>
+#include <vector>
+
 //*****************************************************************************
 // This is used to convert a vtkPolyData to a vtkMultiBlockDataSet. If input is
 // vtkMultiBlockDataSet, then this is simply a pass-through filter. This makes
@@ -149,6 +156,13 @@ vtkGeometryRepresentation::vtkGeometryRepresentation()
 
   vtkMath::UninitializeBounds(this->DataBounds);
 
+  this->PriorityQueue = vtkMultiBlockStreamingPriorityQueue::New();
+  this->StreamingRequestSize = 1;
+  this->StreamingCapablePipeline = false;
+  this->InStreamingUpdate = false;
+  this->PrefetchedTime = 0.0;
+  this->HasPrefetchedTime = false;
+
   this->SetupDefaults();
 }
 
@@ -165,6 +179,7 @@ vtkGeometryRepresentation::~vtkGeometryRepresentation()
   this->LODMapper->Delete();
   this->Actor->Delete();
   this->Property->Delete();
+  this->PriorityQueue->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -288,6 +303,29 @@ int vtkGeometryRepresentation::ProcessViewRequest(
     this->Actor->GetMatrix(matrix.GetPointer());
     vtkPVRenderView::SetGeometryBounds(inInfo, this->DataBounds,
       matrix.GetPointer());
+
+    // Let the view know if this representation can stream blocks.
+    vtkPVRenderView::SetStreamable(inInfo, this, this->StreamingCapablePipeline);
+    }
+  else if (request_type == vtkPVRenderView::REQUEST_STREAMING_UPDATE())
+    {
+    if (this->StreamingCapablePipeline)
+      {
+      // This is a streaming update request, request the next blocks.
+      double view_planes[24];
+      inInfo->Get(vtkPVRenderView::VIEW_PLANES(), view_planes);
+      if (this->StreamingUpdate(view_planes))
+        {
+        // since we indeed "had" a next piece to produce, give it to the view
+        // so it can deliver it to the rendering nodes.
+        vtkPVRenderView::SetNextStreamedPiece(
+          inInfo, this, this->ProcessedPiece);
+        }
+      }
+    }
+  else if (request_type == vtkPVRenderView::REQUEST_PROCESS_STREAMED_PIECE())
+    {
+    this->AddStreamedPiece(inInfo);
     }
   else if (request_type == vtkPVView::REQUEST_UPDATE_LOD())
     {
@@ -397,23 +435,90 @@ int vtkGeometryRepresentation::RequestUpdateExtent(vtkInformation* request,
         ghostLevels++;
         }
       vtkStreamingDemandDrivenPipeline::SetUpdateGhostLevel(inInfo, ghostLevels);
+
+      if (this->InStreamingUpdate)
+        {
+        assert(this->PriorityQueue->IsEmpty() == false);
+
+        // Request the next "group of blocks" to stream. When the queue
+        // empties out, some processes may not have any block left to request,
+        // they still update (with an empty request) along with the others.
+        std::vector<int> request_ids;
+        for (int jj=0; jj < this->StreamingRequestSize &&
+          !this->PriorityQueue->IsEmpty(); jj++)
+          {
+          unsigned int cid = this->PriorityQueue->Pop();
+          if (cid != VTK_UNSIGNED_INT_MAX)
+            {
+            request_ids.push_back(static_cast<int>(cid));
+            }
+          }
+        int dummy = 0;
+        inInfo->Set(vtkCompositeDataPipeline::LOAD_REQUESTED_BLOCKS(), 1);
+        inInfo->Set(vtkCompositeDataPipeline::UPDATE_COMPOSITE_INDICES(),
+          request_ids.empty()? &dummy : &request_ids[0],
+          static_cast<int>(request_ids.size()));
+        }
+      else
+        {
+        // let the source deliver whatever is the default.
+        inInfo->Remove(vtkCompositeDataPipeline::LOAD_REQUESTED_BLOCKS());
+        inInfo->Remove(vtkCompositeDataPipeline::UPDATE_COMPOSITE_INDICES());
+        }
       }
     }
 
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkGeometryRepresentation::RequestInformation(vtkInformation* request,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  // Determine if the input is streaming capable. A pipeline is streaming
+  // capable if it provides us with COMPOSITE_DATA_META_DATA() in the
+  // RequestInformation() pass. It implies that we can request arbitrary blocks
+  // from the input pipeline which implies stream-ability.
+  this->StreamingCapablePipeline = false;
+  if (inputVector[0]->GetNumberOfInformationObjects() == 1)
+    {
+    vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+    if (vtkPVView::GetEnableStreaming() &&
+      vtkCompositeDataSet::SafeDownCast(
+        inInfo->Get(vtkCompositeDataPipeline::COMPOSITE_DATA_META_DATA())))
+      {
+      this->StreamingCapablePipeline = true;
+      }
+    }
+
+  vtkStreamingStatusMacro(
+    << this << ": streaming capable input pipeline? "
+    << (this->StreamingCapablePipeline? "yes" : "no"));
+  return this->Superclass::RequestInformation(request, inputVector,
+    outputVector);
+}
+
 //----------------------------------------------------------------------------
 int vtkGeometryRepresentation::RequestData(vtkInformation* request,
   vtkInformationVector** inputVector, vtkInformationVector* outputVector)
 {
   // cout << this << ":" << this->DebugString << ":RequestData" << endl;
 
-  vtkMath::UninitializeBounds(this->DataBounds);
+  this->ProcessedPiece = NULL;
+  if (!this->InStreamingUpdate)
+    {
+    vtkMath::UninitializeBounds(this->DataBounds);
+    }
 
   // Pass caching information to the cache keeper.
   this->CacheKeeper->SetCachingEnabled(this->GetUseCache());
   this->CacheKeeper->SetCacheTime(this->GetCacheKey());
+  if (this->HasPrefetchedTime && this->GetUseCache() &&
+    this->PrefetchedTime == this->GetCacheKey())
+    {
+    // the prefetched geometry is being shown, it can no longer be cancelled.
+    this->HasPrefetchedTime = false;
+    }
 
   if (inputVector[0]->GetNumberOfInformationObjects()==1)
     {
@@ -433,20 +538,119 @@ int vtkGeometryRepresentation::RequestData(vtkInformation* request,
       }
     this->GeometryFilter->SetInputConnection(
       this->GetInternalOutputPort());
+
+    if (this->StreamingCapablePipeline && !this->InStreamingUpdate)
+      {
+      // Since the representation reexecuted, it means that the input changed
+      // and we should initialize our streaming.
+      this->PriorityQueue->Initialize(vtkCompositeDataSet::SafeDownCast(
+        inInfo->Get(vtkCompositeDataPipeline::COMPOSITE_DATA_META_DATA())));
+      }
     }
   else
     {
     vtkNew<vtkMultiBlockDataSet> placeholder;
     this->GeometryFilter->SetInputDataObject(0, placeholder.GetPointer());
     }
+
+  if (this->InStreamingUpdate)
+    {
+    // Only extract the geometry of the blocks just loaded. The view delivers
+    // it to the rendering nodes as the next streamed piece, the geometry being
+    // rendered (the output of the cache keeper) is left untouched.
+    this->MultiBlockMaker->Update();
+    vtkNew<vtkMultiBlockDataSet> piece;
+    piece->ShallowCopy(this->MultiBlockMaker->GetOutputDataObject(0));
+    this->ProcessedPiece = piece.GetPointer();
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+    }
+
   this->CacheKeeper->Update();
 
   // Determine data bounds.
   this->GetBounds(this->CacheKeeper->GetOutputDataObject(0),
     this->DataBounds);
+
+  if (this->StreamingCapablePipeline)
+    {
+    // Don't stream the blocks the input pipeline already produced. The bounds
+    // include the blocks yet to be streamed, so that the camera can be reset
+    // to the whole data.
+    this->PriorityQueue->RemoveLoadedBlocks(
+      vtkCompositeDataSet::GetData(inputVector[0], 0));
+    double bounds[6];
+    if (this->PriorityQueue->GetBounds(bounds))
+      {
+      vtkBoundingBox bbox(bounds);
+      if (vtkMath::AreBoundsInitialized(this->DataBounds))
+        {
+        bbox.AddBounds(this->DataBounds);
+        }
+      bbox.GetBounds(this->DataBounds);
+      }
+    }
   return this->Superclass::RequestData(request, inputVector, outputVector);
 }
 
+//----------------------------------------------------------------------------
+bool vtkGeometryRepresentation::StreamingUpdate(const double view_planes[24])
+{
+  assert(this->InStreamingUpdate == false);
+
+  // The queue is the same on all processes, so they all agree on whether
+  // there is anything left to stream.
+  if (this->PriorityQueue->IsEmpty())
+    {
+    return false;
+    }
+
+  this->InStreamingUpdate = true;
+  vtkStreamingStatusMacro(<< this << ": doing streaming-update.");
+
+  // update the priority queue using the current view.
+  this->PriorityQueue->Update(view_planes);
+
+  // This ensures that the representation re-executes.
+  this->MarkModified();
+  this->Update();
+
+  this->InStreamingUpdate = false;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkGeometryRepresentation::AddStreamedPiece(vtkInformation* inInfo)
+{
+  vtkMultiBlockDataSet* piece = vtkMultiBlockDataSet::SafeDownCast(
+    vtkPVRenderView::GetCurrentStreamedPiece(inInfo, this));
+  vtkAlgorithmOutput* producerPort =
+    vtkPVRenderView::GetPieceProducer(inInfo, this);
+  if (!piece || !producerPort)
+    {
+    return;
+    }
+  vtkMultiBlockDataSet* rendered = vtkMultiBlockDataSet::SafeDownCast(
+    producerPort->GetProducer()->GetOutputDataObject(producerPort->GetIndex()));
+  if (!rendered)
+    {
+    return;
+    }
+  vtkStreamingStatusMacro(<< this << ": received new piece.");
+
+  // merge with what we are already rendering. Since the piece and the
+  // rendered data come from the same meta-data, they have the same structure.
+  // All mappers take their input from the piece producer, hence all of them
+  // render the merged data.
+  vtkNew<vtkAppendCompositeDataLeaves> appender;
+  appender->AddInputDataObject(piece);
+  if (rendered->GetNumberOfBlocks() > 0)
+    {
+    appender->AddInputDataObject(rendered);
+    }
+  appender->Update();
+  rendered->ShallowCopy(appender->GetOutputDataObject(0));
+}
+
 //----------------------------------------------------------------------------
 bool vtkGeometryRepresentation::GetBounds(
   vtkDataObject* dataObject, double bounds[6])
@@ -485,6 +689,133 @@ bool vtkGeometryRepresentation::IsCached(double cache_key)
   return this->CacheKeeper->IsCached(cache_key);
 }
 
+//----------------------------------------------------------------------------
+bool vtkGeometryRepresentation::Prefetch(double time)
+{
+  if (!this->GetVisibility() || this->GetNumberOfInputConnections(0) != 1 ||
+    this->CacheKeeper->IsCached(time))
+    {
+    return false;
+    }
+
+  // Update the input for the requested time the same way
+  // vtkSISourceProxy::UpdatePipeline() does.
+  vtkAlgorithmOutput* input = this->GetInputConnection(0, 0);
+  vtkStreamingDemandDrivenPipeline* sddp =
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(
+      input->GetProducer()->GetExecutive());
+  if (!sddp)
+    {
+    return false;
+    }
+  int port = input->GetIndex();
+  sddp->UpdateInformation();
+  sddp->UpdateDataObject();
+
+  // The output of the input is shared with its other consumers and with the
+  // internal producer of this representation. Keep the data and the time it
+  // was produced for, to put them back once the geometry is extracted.
+  vtkInformation* outInfo = sddp->GetOutputInformation(port);
+  vtkDataObject* inputData = sddp->GetOutputData(port);
+  if (!inputData)
+    {
+    return false;
+    }
+  vtkSmartPointer<vtkDataObject> savedData;
+  savedData.TakeReference(inputData->NewInstance());
+  savedData->ShallowCopy(inputData);
+  vtkInformation* dataInfo = inputData->GetInformation();
+  bool hadDataTime = dataInfo->Has(vtkDataObject::DATA_TIME_STEP()) != 0;
+  double savedDataTime = hadDataTime?
+    dataInfo->Get(vtkDataObject::DATA_TIME_STEP()) : 0.0;
+  bool hadUpdateTime =
+    outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP()) != 0;
+  double savedUpdateTime = hadUpdateTime?
+    outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP()) : 0.0;
+
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  int ghostLevels = 0;
+  if (this->RequestGhostCellsIfNeeded &&
+    vtkGeometryRepresentation::DoRequestGhostCells(outInfo))
+    {
+    ghostLevels++;
+    }
+  sddp->SetUpdateExtent(port,
+    controller? controller->GetLocalProcessId() : 0,
+    controller? controller->GetNumberOfProcesses() : 1, ghostLevels);
+  sddp->SetUpdateTimeStep(port, time);
+
+  bool cached = false;
+  vtkAlgorithmOutput* aout = this->GetInternalOutputPort();
+  vtkPVTrivialProducer* prod = vtkPVTrivialProducer::SafeDownCast(
+    aout->GetProducer());
+  int savedWholeExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (prod)
+    {
+    prod->GetWholeExtent(savedWholeExtent);
+    }
+  if (sddp->Update(port))
+    {
+    // Run the geometry filter but stop before the cache keeper, whose output
+    // is what is being rendered.
+    if (prod &&
+      outInfo->Has(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()))
+      {
+      prod->SetWholeExtent(outInfo->Get(
+          vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()));
+      }
+    this->GeometryFilter->SetInputConnection(aout);
+    this->MultiBlockMaker->Update();
+    cached = this->CacheKeeper->AddCache(time,
+      this->MultiBlockMaker->GetOutputDataObject(0));
+    }
+
+  // Put the input back as it was, so that neither the consumers of the input
+  // nor this representation see the prefetched time until they ask for it.
+  // The geometry filter is marked modified as its output is now that of the
+  // prefetched time.
+  inputData->ShallowCopy(savedData);
+  if (hadDataTime)
+    {
+    dataInfo->Set(vtkDataObject::DATA_TIME_STEP(), savedDataTime);
+    }
+  else
+    {
+    dataInfo->Remove(vtkDataObject::DATA_TIME_STEP());
+    }
+  if (hadUpdateTime)
+    {
+    sddp->SetUpdateTimeStep(port, savedUpdateTime);
+    }
+  else
+    {
+    outInfo->Remove(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP());
+    }
+  if (prod)
+    {
+    prod->SetWholeExtent(savedWholeExtent);
+    }
+  this->GeometryFilter->Modified();
+
+  if (cached)
+    {
+    this->PrefetchedTime = time;
+    this->HasPrefetchedTime = true;
+    }
+  return cached;
+}
+
+//----------------------------------------------------------------------------
+void vtkGeometryRepresentation::CancelPrefetch(double time)
+{
+  if (this->HasPrefetchedTime && this->PrefetchedTime == time)
+    {
+    this->CacheKeeper->RemoveCache(time);
+    this->HasPrefetchedTime = false;
+    }
+}
+
 //----------------------------------------------------------------------------
 vtkDataObject* vtkGeometryRepresentation::GetRenderedDataObject(int port)
 {
@@ -686,6 +1017,8 @@ void vtkGeometryRepresentation::SetVisibility(bool val)
 void vtkGeometryRepresentation::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "StreamingRequestSize: "
+    << this->StreamingRequestSize << endl;
 }
 
 //****************************************************************************
@@ -872,6 +1205,32 @@ void vtkGeometryRepresentation::SetNonlinearSubdivisionLevel(int val)
   this->MarkModified();
 }
 
+//----------------------------------------------------------------------------
+void vtkGeometryRepresentation::SetUseThreadedBlockExecution(bool val)
+{
+  if (vtkPVGeometryFilter::SafeDownCast(this->GeometryFilter))
+    {
+    vtkPVGeometryFilter::SafeDownCast(this->GeometryFilter)->SetUseThreadedBlockExecution(val);
+    }
+
+  // since geometry filter needs to execute, we need to mark the representation
+  // modified.
+  this->MarkModified();
+}
+
+//----------------------------------------------------------------------------
+void vtkGeometryRepresentation::SetUseSurfaceCache(bool val)
+{
+  if (vtkPVGeometryFilter::SafeDownCast(this->GeometryFilter))
+    {
+    vtkPVGeometryFilter::SafeDownCast(this->GeometryFilter)->SetUseSurfaceCache(val);
+    }
+
+  // since geometry filter needs to execute, we need to mark the representation
+  // modified.
+  this->MarkModified();
+}
+
 //----------------------------------------------------------------------------
 #if !defined(VTK_LEGACY_REMOVE)
 bool vtkGeometryRepresentation::GenerateMetaData(vtkInformation*,
@@ -28,9 +28,11 @@
 #include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
 #include "vtkPVDataRepresentation.h"
 #include "vtkProperty.h" // needed for VTK_POINTS etc.
+#include "vtkSmartPointer.h" // needed for vtkSmartPointer.
 
 class vtkCompositePolyDataMapper2;
 class vtkMapper;
+class vtkMultiBlockStreamingPriorityQueue;
 class vtkPVCacheKeeper;
 class vtkPVGeometryFilter;
 class vtkPVLODActor;
@@ -112,6 +114,17 @@ public:
   // Returns the data object that is rendered from the given input port.
   virtual vtkDataObject* GetRenderedDataObject(int port);
 
+  // Description:
+  // Overridden to update the input for the given time and add the resulting
+  // geometry to the cache. The rendered geometry and the data of the input
+  // are not changed.
+  virtual bool Prefetch(double time);
+
+  // Description:
+  // Overridden to remove the geometry cached by the last Prefetch() if it is
+  // for the given time and has not been rendered.
+  virtual void CancelPrefetch(double time);
+
   // Description:
   // Returns true if this class would like to get ghost-cells if available for
   // the connection whose information object is passed as the argument.
@@ -125,11 +138,19 @@ public:
   vtkGetMacro(RequestGhostCellsIfNeeded, bool);
   vtkBooleanMacro(RequestGhostCellsIfNeeded, bool);
 
+  // Description:
+  // Set the number of blocks to request at a given time on a single process
+  // when streaming.
+  vtkSetClampMacro(StreamingRequestSize, int, 1, 10000);
+  vtkGetMacro(StreamingRequestSize, int);
+
   //***************************************************************************
   // Forwarded to vtkPVGeometryFilter
   virtual void SetUseOutline(int);
   void SetTriangulate(int);
   void SetNonlinearSubdivisionLevel(int);
+  void SetUseThreadedBlockExecution(bool);
+  void SetUseSurfaceCache(bool);
 
   //***************************************************************************
   // Forwarded to vtkProperty.
@@ -233,9 +254,31 @@ protected:
 
   // Description:
   // Overridden to request correct ghost-level to avoid internal surfaces.
+  // During StreamingUpdate(), this also requests the blocks based on the
+  // priorities determined by the vtkMultiBlockStreamingPriorityQueue.
   virtual int RequestUpdateExtent(vtkInformation* request,
     vtkInformationVector** inputVector, vtkInformationVector* outputVector);
 
+  // Description:
+  // Overridden to check if the input pipeline is streaming capable i.e.
+  // streaming is enabled (vtkPVView::GetEnableStreaming()) and the input
+  // pipeline provides the composite data meta-data, hence can produce
+  // arbitrary blocks.
+  virtual int RequestInformation(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector);
+
+  // Description:
+  // Returns true if this representation has a "next piece" that it streamed.
+  // This method will update the PriorityQueue using the view planes specified
+  // and then call Update() on the representation, making it reexecute and
+  // extract the geometry of the next blocks in ProcessedPiece.
+  bool StreamingUpdate(const double view_planes[24]);
+
+  // Description:
+  // Adds the geometry of the blocks streamed to the rendering nodes to the
+  // data being rendered.
+  void AddStreamedPiece(vtkInformation* inInfo);
+
   // Description:
   // Produce meta-data about this representation that the view may find useful.
   VTK_LEGACY(virtual bool GenerateMetaData(vtkInformation*, vtkInformation*));
@@ -284,6 +327,32 @@ protected:
   bool RequestGhostCellsIfNeeded;
   double DataBounds[6];
 
+  // Description:
+  // Helper used to compute the order in which to request blocks from a
+  // streaming capable input pipeline.
+  vtkMultiBlockStreamingPriorityQueue* PriorityQueue;
+
+  // Description:
+  // Geometry of the blocks requested by the most recent StreamingUpdate().
+  // This is non-empty only on the data-server nodes.
+  vtkSmartPointer<vtkDataObject> ProcessedPiece;
+
+  int StreamingRequestSize;
+
+  // Description:
+  // Set in RequestInformation() when the input pipeline supports streaming.
+  // In client-server mode, this is valid only on the data-server nodes.
+  bool StreamingCapablePipeline;
+
+  // Description:
+  // True while StreamingUpdate() is being processed.
+  bool InStreamingUpdate;
+
+  // Description:
+  // Time cached by the last Prefetch(), until it is rendered or cancelled.
+  double PrefetchedTime;
+  bool HasPrefetchedTime;
+
 private:
   vtkGeometryRepresentation(const vtkGeometryRepresentation&); // Not implemented
   void operator=(const vtkGeometryRepresentation&); // Not implemented
@@ -27,10 +27,12 @@
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkLZ4Codec.h"
 #include "vtkMPIMToNSocketConnection.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiProcessController.h"
 #include "vtkMultiProcessControllerHelper.h"
+#include "vtkNew.h"
 #include "vtkNonOverlappingAMR.h"
 #include "vtkObjectFactory.h"
 #include "vtkOutlineFilter.h"
@@ -39,7 +41,10 @@
 #include "vtkPolyData.h"
 #include "vtkProcessModule.h"
 #include "vtkPVConfig.h"
+#include "vtkPVDataDeltaEncoder.h"
 #include "vtkPVSession.h"
+#include "vtkPVTraceEventRecorder.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkSocketCommunicator.h"
 #include "vtkSocketController.h"
@@ -50,7 +55,9 @@
 #include "vtkUnstructuredGrid.h"
 
 #include "vtk_zlib.h"
+#include <algorithm>
 #include <sstream>
+#include <string.h>
 #include <vector>
 
 #ifdef PARAVIEW_USE_MPI
@@ -96,7 +103,197 @@ namespace
       it->Delete();
       }
   }
-};
+
+  // Buffers are compressed in chunks of this size. Over sockets the chunks
+  // are streamed: a chunk is compressed while the previous ones drain from
+  // the socket buffers, and decompressed while the next ones arrive.
+  const vtkIdType CHUNK_SIZE = 512 * 1024;
+
+  // Buffers smaller than this are never compressed automatically.
+  const vtkIdType MIN_COMPRESSED_SIZE = 64 * 1024;
+
+  // The link bandwidth is only measured on transfers at least this large,
+  // smaller ones are absorbed by the socket buffers.
+  const vtkIdType MIN_BANDWIDTH_SAMPLE_SIZE = 4 * CHUNK_SIZE;
+
+  // Buffers compressed as a whole start with this magic, the method, the
+  // uncompressed length, the number of chunks and the compressed length of
+  // each chunk, followed by the chunks.
+  const char COMPRESSED_MAGIC[4] = { 'v', 'm', 'd', 'c' };
+  const size_t COMPRESSED_HEADER_SIZE = 24;
+
+  // Lengths are stored little-endian so that the processes may differ.
+  inline void WriteInt64(char* ptr, vtkTypeInt64 value)
+    {
+    for (int cc = 0; cc < 8; ++cc)
+      {
+      ptr[cc] = static_cast<char>((value >> (8 * cc)) & 0xff);
+      }
+    }
+
+  inline vtkTypeInt64 ReadInt64(const char* ptr)
+    {
+    vtkTypeInt64 value = 0;
+    for (int cc = 0; cc < 8; ++cc)
+      {
+      value |= static_cast<vtkTypeInt64>(static_cast<unsigned char>(ptr[cc]))
+        << (8 * cc);
+      }
+    return value;
+    }
+
+  // Throughput and ratio of the codecs, and bandwidth of the socket links,
+  // averaged over the transfers done by this process. They start with
+  // typical values. The decompression rate is measured when this process
+  // receives data and stands for the rate of its peers when it sends data,
+  // so that transfers never wait for a reply from the receiver.
+  struct vtkCodecStatistics
+    {
+    double CompressRate;   // uncompressed bytes per second
+    double DecompressRate; // uncompressed bytes per second
+    double Ratio;          // uncompressed over compressed size
+    };
+  vtkCodecStatistics CodecStatistics[3] = {
+      { 0.0, 0.0, 1.0 },
+      { 300e6, 1000e6, 2.0 },
+      { 30e6, 200e6, 4.0 }
+  };
+  double LinkBandwidth = 100e6;
+
+  inline void UpdateAverage(double& average, double value)
+    {
+    average = 0.75 * average + 0.25 * value;
+    }
+
+  // Compresses \c length bytes into \c out. Returns the compressed size, 0
+  // on failure.
+  size_t CompressChunk(int method, const char* in, size_t length,
+    std::vector<unsigned char>& out)
+    {
+    const unsigned char* input = reinterpret_cast<const unsigned char*>(in);
+    if (method == vtkMPIMoveData::LZ4_COMPRESSION)
+      {
+      out.resize(vtkLZ4Codec::GetMaximumCompressedSize(length));
+      return vtkLZ4Codec::Compress(input, length, &out[0], out.size());
+      }
+    uLongf outLength = compressBound(static_cast<uLong>(length));
+    out.resize(outLength);
+    if (compress2(&out[0], &outLength, input, static_cast<uLong>(length),
+        Z_DEFAULT_COMPRESSION) != Z_OK)
+      {
+      return 0;
+      }
+    return outLength;
+    }
+
+  bool DecompressChunk(int method, const char* in, size_t length,
+    char* out, size_t outLength)
+    {
+    const unsigned char* input = reinterpret_cast<const unsigned char*>(in);
+    if (method == vtkMPIMoveData::LZ4_COMPRESSION)
+      {
+      return vtkLZ4Codec::Decompress(input, length,
+        reinterpret_cast<unsigned char*>(out), outLength) == outLength;
+      }
+    uLongf destLength = static_cast<uLongf>(outLength);
+    return uncompress(reinterpret_cast<Bytef*>(out), &destLength, input,
+      static_cast<uLong>(length)) == Z_OK && destLength == outLength;
+    }
+
+  class vtkCompressChunks
+    {
+  public:
+    int Method;
+    const char* Input;
+    vtkIdType Length;
+    std::vector<unsigned char>* Chunks;
+    size_t* Sizes;
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType cc = begin; cc < end; ++cc)
+        {
+        vtkIdType offset = cc * CHUNK_SIZE;
+        this->Sizes[cc] = CompressChunk(this->Method, this->Input + offset,
+          static_cast<size_t>(std::min(CHUNK_SIZE, this->Length - offset)),
+          this->Chunks[cc]);
+        }
+      }
+    };
+
+  class vtkDecompressChunks
+    {
+  public:
+    int Method;
+    const char** Chunks;
+    const vtkIdType* Sizes;
+    char* Output;
+    vtkIdType Length;
+    unsigned char* Status;
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType cc = begin; cc < end; ++cc)
+        {
+        vtkIdType offset = cc * CHUNK_SIZE;
+        this->Status[cc] = DecompressChunk(this->Method, this->Chunks[cc],
+          static_cast<size_t>(this->Sizes[cc]), this->Output + offset,
+          static_cast<size_t>(std::min(CHUNK_SIZE, this->Length - offset)));
+        }
+      }
+    };
+
+  // Decompresses a buffer compressed as a whole. Returns a new buffer, NULL
+  // on failure.
+  char* DecompressBuffer(const char* buffer, vtkIdType length,
+    vtkIdType& rawLength)
+    {
+    if (length < static_cast<vtkIdType>(COMPRESSED_HEADER_SIZE))
+      {
+      return NULL;
+      }
+    int method = buffer[4];
+    rawLength = ReadInt64(buffer + 8);
+    vtkIdType numChunks = ReadInt64(buffer + 16);
+    if ((method != vtkMPIMoveData::LZ4_COMPRESSION &&
+        method != vtkMPIMoveData::ZLIB_COMPRESSION) || rawLength < 0 ||
+      numChunks != (rawLength + CHUNK_SIZE - 1) / CHUNK_SIZE ||
+      length < static_cast<vtkIdType>(COMPRESSED_HEADER_SIZE + 8 * numChunks))
+      {
+      return NULL;
+      }
+    std::vector<const char*> chunks(numChunks);
+    std::vector<vtkIdType> sizes(numChunks);
+    vtkIdType offset = COMPRESSED_HEADER_SIZE + 8 * numChunks;
+    for (vtkIdType cc = 0; cc < numChunks; ++cc)
+      {
+      sizes[cc] = ReadInt64(buffer + COMPRESSED_HEADER_SIZE + 8 * cc);
+      chunks[cc] = buffer + offset;
+      offset += sizes[cc];
+      if (sizes[cc] < 0 || offset > length)
+        {
+        return NULL;
+        }
+      }
+    char* output = new char[rawLength > 0? rawLength : 1];
+    if (numChunks > 0)
+      {
+      std::vector<unsigned char> status(numChunks, 0);
+      vtkDecompressChunks functor;
+      functor.Method = method;
+      functor.Chunks = &chunks[0];
+      functor.Sizes = &sizes[0];
+      functor.Output = output;
+      functor.Length = rawLength;
+      functor.Status = &status[0];
+      vtkSMPTools::For(0, numChunks, functor);
+      if (std::find(status.begin(), status.end(), 0) != status.end())
+        {
+        delete [] output;
+        return NULL;
+        }
+      }
+    return output;
+    }
+}
 
 
 vtkStandardNewMacro(vtkMPIMoveData);
@@ -104,16 +301,20 @@ vtkStandardNewMacro(vtkMPIMoveData);
 vtkCxxSetObjectMacro(vtkMPIMoveData,Controller, vtkMultiProcessController);
 vtkCxxSetObjectMacro(vtkMPIMoveData,ClientDataServerSocketController, vtkMultiProcessController);
 vtkCxxSetObjectMacro(vtkMPIMoveData,MPIMToNSocketConnection, vtkMPIMToNSocketConnection);
+vtkCxxSetObjectMacro(vtkMPIMoveData,DeltaEncoder, vtkPVDataDeltaEncoder);
 //-----------------------------------------------------------------------------
 vtkMPIMoveData::vtkMPIMoveData()
 {
   this->Controller = 0;
   this->ClientDataServerSocketController = 0;
   this->MPIMToNSocketConnection = 0;
+  this->DeltaEncoder = 0;
+  this->UseDeltaEncoding = true;
 
   this->SetController(vtkMultiProcessController::GetGlobalController());
 
   this->MoveMode = vtkMPIMoveData::PASS_THROUGH;
+  this->CompressionMethod = vtkMPIMoveData::AUTOMATIC_COMPRESSION;
   // This tells which server/client this object is on.
   this->Server = -1;
 
@@ -141,6 +342,7 @@ vtkMPIMoveData::~vtkMPIMoveData()
   this->SetController(0);
   this->SetClientDataServerSocketController(0);
   this->SetMPIMToNSocketConnection(0);
+  this->SetDeltaEncoder(0);
   this->ClearBuffer();
 }
 
@@ -199,6 +401,45 @@ bool vtkMPIMoveData::GetUseZLibCompression()
   return vtkMPIMoveData::UseZLibCompression;
 }
 
+//----------------------------------------------------------------------------
+int vtkMPIMoveData::GetTransferCompressionMethod(vtkIdType length,
+  bool socket)
+{
+  if (vtkMPIMoveData::UseZLibCompression)
+    {
+    return vtkMPIMoveData::ZLIB_COMPRESSION;
+    }
+  if (this->CompressionMethod != vtkMPIMoveData::AUTOMATIC_COMPRESSION)
+    {
+    return this->CompressionMethod;
+    }
+  if (!socket || length < MIN_COMPRESSED_SIZE)
+    {
+    return vtkMPIMoveData::NO_COMPRESSION;
+    }
+
+  // Chunks are compressed, transferred and decompressed concurrently, so the
+  // slowest of these stages bounds the transfer time, plus the time to get
+  // the first chunk through and the last one out.
+  const double size = static_cast<double>(length);
+  int method = vtkMPIMoveData::NO_COMPRESSION;
+  double bestTime = size / LinkBandwidth;
+  for (int cc = vtkMPIMoveData::LZ4_COMPRESSION;
+    cc <= vtkMPIMoveData::ZLIB_COMPRESSION; ++cc)
+    {
+    const vtkCodecStatistics& stats = CodecStatistics[cc];
+    double time = std::max(size / (stats.Ratio * LinkBandwidth),
+      std::max(size / stats.CompressRate, size / stats.DecompressRate)) +
+      CHUNK_SIZE / stats.CompressRate + CHUNK_SIZE / stats.DecompressRate;
+    if (time < bestTime)
+      {
+      bestTime = time;
+      method = cc;
+      }
+    }
+  return method;
+}
+
 //----------------------------------------------------------------------------
 int vtkMPIMoveData::FillInputPortInformation(int, vtkInformation *info)
 {
@@ -645,6 +886,7 @@ void vtkMPIMoveData::DataServerGatherAll(vtkDataObject* input,
     return;
     }
 
+  vtkPVTraceEventScope traceEvent("delivery", "Dataserver gathering to all");
 #ifdef PARAVIEW_USE_MPI
   int idx;
   vtkMPICommunicator* com = vtkMPICommunicator::SafeDownCast(
@@ -657,6 +899,8 @@ void vtkMPIMoveData::DataServerGatherAll(vtkDataObject* input,
     }
   this->ClearBuffer();
   this->MarshalDataToBuffer(input);
+  this->CompressBuffer(
+    this->GetTransferCompressionMethod(this->BufferTotalLength, false));
 
   // Save a copy of the buffer so we can receive into the buffer.
   // We will be responsiblefor deleting the buffer.
@@ -666,6 +910,7 @@ void vtkMPIMoveData::DataServerGatherAll(vtkDataObject* input,
   char *inBuffer = this->Buffers;
   this->Buffers = NULL;
   this->ClearBuffer();
+  traceEvent.SetBytes(inBufferLength);
 
   // Allocate arrays used by the AllGatherV call.
   this->BufferLengths = new vtkIdType[numProcs];
@@ -718,6 +963,7 @@ void vtkMPIMoveData::DataServerGatherToZero(vtkDataObject* input,
     }
 
     vtkTimerLog::MarkStartEvent("Dataserver gathering to 0");
+  vtkPVTraceEventScope traceEvent("delivery", "Dataserver gathering to 0");
 
 #ifdef PARAVIEW_USE_MPI
   int idx;
@@ -732,6 +978,8 @@ void vtkMPIMoveData::DataServerGatherToZero(vtkDataObject* input,
     }
   this->ClearBuffer();
   this->MarshalDataToBuffer(input);
+  this->CompressBuffer(
+    this->GetTransferCompressionMethod(this->BufferTotalLength, false));
 
   // Save a copy of the buffer so we can receive into the buffer.
   // We will be responsiblefor deleting the buffer.
@@ -741,6 +989,7 @@ void vtkMPIMoveData::DataServerGatherToZero(vtkDataObject* input,
   char *inBuffer = this->Buffers;
   this->Buffers = NULL;
   this->ClearBuffer();
+  traceEvent.SetBytes(inBufferLength);
 
   if (myId == 0)
     {
@@ -801,10 +1050,8 @@ void vtkMPIMoveData::DataServerSendToRenderServer(vtkDataObject* output)
   // We might be able to eliminate this marshal.
   this->ClearBuffer();
   this->MarshalDataToBuffer(output);
-
-  com->Send(&(this->NumberOfBuffers), 1, 1, 23480);
-  com->Send(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
-  com->Send(this->Buffers, this->BufferTotalLength, 1, 23482);
+  this->SendBuffer(com, 1, 23480);
+  this->ClearBuffer();
 }
 
 //-----------------------------------------------------------------------------
@@ -819,20 +1066,7 @@ void vtkMPIMoveData::RenderServerReceiveFromDataServer(vtkDataObject* output)
     return;
     }
 
-  this->ClearBuffer();
-  com->Receive(&(this->NumberOfBuffers), 1, 1, 23480);
-  this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
-  com->Receive(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
-  // Compute additional buffer information.
-  this->BufferOffsets = new vtkIdType[this->NumberOfBuffers];
-  this->BufferTotalLength = 0;
-  for (int idx = 0; idx < this->NumberOfBuffers; ++idx)
-    {
-    this->BufferOffsets[idx] = this->BufferTotalLength;
-    this->BufferTotalLength += this->BufferLengths[idx];
-    }
-  this->Buffers = new char[this->BufferTotalLength];
-  com->Receive(this->Buffers, this->BufferTotalLength, 1, 23482);
+  this->ReceiveBuffer(com, 1, 23480);
 
   //int fixme;  // Can we avoid this?
   this->ReconstructDataFromBuffer(output);
@@ -860,9 +1094,7 @@ void vtkMPIMoveData::DataServerZeroSendToRenderServerZero(vtkDataObject* data)
     // We might be able to eliminate this marshal.
     this->ClearBuffer();
     this->MarshalDataToBuffer(data);
-    com->Send(&(this->NumberOfBuffers), 1, 1, 23480);
-    com->Send(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
-    com->Send(this->Buffers, this->BufferTotalLength, 1, 23482);
+    this->SendBuffer(com, 1, 23480);
     this->ClearBuffer();
     }
 }
@@ -883,20 +1115,7 @@ void vtkMPIMoveData::RenderServerZeroReceiveFromDataServerZero(vtkDataObject* da
       return;
       }
 
-    this->ClearBuffer();
-    com->Receive(&(this->NumberOfBuffers), 1, 1, 23480);
-    this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
-    com->Receive(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
-    // Compute additional buffer information.
-    this->BufferOffsets = new vtkIdType[this->NumberOfBuffers];
-    this->BufferTotalLength = 0;
-    for (int idx = 0; idx < this->NumberOfBuffers; ++idx)
-      {
-      this->BufferOffsets[idx] = this->BufferTotalLength;
-      this->BufferTotalLength += this->BufferLengths[idx];
-      }
-    this->Buffers = new char[this->BufferTotalLength];
-    com->Receive(this->Buffers, this->BufferTotalLength, 1, 23482);
+    this->ReceiveBuffer(com, 1, 23480);
 
     //int fixme;  // Can we avoid this?
     this->ReconstructDataFromBuffer(data);
@@ -917,15 +1136,50 @@ void vtkMPIMoveData::DataServerSendToClient(vtkDataObject* output)
   if (myId == 0)
     {
     vtkTimerLog::MarkStartEvent("Dataserver sending to client");
-    this->ClearBuffer();
-    this->MarshalDataToBuffer(output);
-    this->ClientDataServerSocketController->Send(
-                                     &(this->NumberOfBuffers), 1, 1, 23490);
-    this->ClientDataServerSocketController->Send(this->BufferLengths,
-                                     this->NumberOfBuffers, 1, 23491);
-    this->ClientDataServerSocketController->Send(this->Buffers,
-                                     this->BufferTotalLength, 1, 23492);
-    this->ClearBuffer();
+    vtkPVTraceEventScope traceEvent("delivery", "Dataserver sending to client");
+    vtkCommunicator* com =
+      this->ClientDataServerSocketController->GetCommunicator();
+
+    // The client follows the data server, so that delta delivery only needs
+    // to be turned on or off here.
+    int encoded = (this->DeltaEncoder && this->UseDeltaEncoding)? 1 : 0;
+    com->Send(&encoded, 1, 1, 23494);
+    if (!encoded)
+      {
+      if (this->DeltaEncoder)
+        {
+        this->DeltaEncoder->Reset();
+        }
+      this->ClearBuffer();
+      this->MarshalDataToBuffer(output);
+      this->SendBuffer(com, 1, 23490);
+      this->ClearBuffer();
+      }
+    else
+      {
+      // The client tells whether it could rebuild the data. If not, e.g. it
+      // missed a transfer, the encoder starts over and the data is sent
+      // again, complete this time.
+      for (int attempt = 0; attempt < 2; ++attempt)
+        {
+        this->ClearBuffer();
+        vtkDataObject* delta = this->DeltaEncoder->Encode(output);
+        this->MarshalDataToBuffer(delta);
+        if (delta)
+          {
+          delta->Delete();
+          }
+        this->SendBuffer(com, 1, 23490);
+        this->ClearBuffer();
+        int decoded = 0;
+        com->Receive(&decoded, 1, 1, 23495);
+        if (decoded)
+          {
+          break;
+          }
+        this->DeltaEncoder->Reset();
+        }
+      }
     vtkTimerLog::MarkEndEvent("Dataserver sending to client");
     }
 }
@@ -941,24 +1195,38 @@ void vtkMPIMoveData::ClientReceiveFromDataServer(vtkDataObject* output)
     return;
     }
 
-  this->ClearBuffer();
-  com->Receive(&(this->NumberOfBuffers), 1, 1, 23490);
-  this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
-  com->Receive(this->BufferLengths, this->NumberOfBuffers,
-                                  1, 23491);
-  // Compute additional buffer information.
-  this->BufferOffsets = new vtkIdType[this->NumberOfBuffers];
-  this->BufferTotalLength = 0;
-  for (int idx = 0; idx < this->NumberOfBuffers; ++idx)
+  int encoded = 0;
+  com->Receive(&encoded, 1, 1, 23494);
+  if (!encoded)
     {
-    this->BufferOffsets[idx] = this->BufferTotalLength;
-    this->BufferTotalLength += this->BufferLengths[idx];
+    if (this->DeltaEncoder)
+      {
+      this->DeltaEncoder->Reset();
+      }
+    this->ReceiveBuffer(com, 1, 23490);
+    this->ReconstructDataFromBuffer(output);
+    this->ClearBuffer();
+    return;
     }
-  this->Buffers = new char[this->BufferTotalLength];
-  com->Receive(this->Buffers, this->BufferTotalLength,
-                                  1, 23492);
-  this->ReconstructDataFromBuffer(output);
-  this->ClearBuffer();
+
+  // A new encoder can only rebuild complete transfers, the data server
+  // resends the data complete when told it could not be rebuilt.
+  vtkNew<vtkPVDataDeltaEncoder> newEncoder;
+  vtkPVDataDeltaEncoder* encoder = this->DeltaEncoder?
+    this->DeltaEncoder : newEncoder.GetPointer();
+  for (int attempt = 0; attempt < 2; ++attempt)
+    {
+    this->ReceiveBuffer(com, 1, 23490);
+    this->ReconstructDataFromBuffer(output);
+    this->ClearBuffer();
+    int decoded = encoder->Decode(output)? 1 : 0;
+    com->Send(&decoded, 1, 1, 23495);
+    if (decoded)
+      {
+      return;
+      }
+    }
+  vtkErrorMacro("Cannot rebuild the data received from the data server.");
 }
 
 
@@ -989,6 +1257,8 @@ void vtkMPIMoveData::RenderServerZeroBroadcast(vtkDataObject* data)
     {
     this->ClearBuffer();
     this->MarshalDataToBuffer(data);
+    this->CompressBuffer(
+      this->GetTransferCompressionMethod(this->BufferTotalLength, false));
     bufferLength = this->BufferLengths[0];
     }
 
@@ -1083,51 +1353,225 @@ void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
   writer->WriteToOutputStringOn();
   writer->Write();
 
-  char* buffer =NULL;
-  vtkIdType buffer_length = 0;
+  vtkIdType buffer_length = writer->GetOutputStringLength();
+  char* buffer = writer->RegisterAndGetOutputString();
 
-  if (vtkMPIMoveData::UseZLibCompression)
+  // Get string.
+  this->NumberOfBuffers = 1;
+  this->BufferLengths = new vtkIdType[1];
+  this->BufferLengths[0] = buffer_length;
+  this->BufferOffsets = new vtkIdType[1];
+  this->BufferOffsets[0] = 0;
+  this->Buffers = buffer;
+  this->BufferTotalLength = this->BufferLengths[0];
+
+  writer->Delete();
+  writer = 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkMPIMoveData::CompressBuffer(int method)
+{
+  if (method == vtkMPIMoveData::NO_COMPRESSION || this->NumberOfBuffers != 1)
+    {
+    return;
+    }
+
+  vtkTimerLog::MarkStartEvent("Compress buffer");
+  const vtkIdType rawLength = this->BufferTotalLength;
+  const vtkIdType numChunks = (rawLength + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  std::vector<std::vector<unsigned char> > chunks(numChunks);
+  std::vector<size_t> sizes(numChunks, 0);
+  if (numChunks > 0)
+    {
+    vtkCompressChunks functor;
+    functor.Method = method;
+    functor.Input = this->Buffers;
+    functor.Length = rawLength;
+    functor.Chunks = &chunks[0];
+    functor.Sizes = &sizes[0];
+    vtkSMPTools::For(0, numChunks, functor);
+    }
+
+  vtkIdType length = COMPRESSED_HEADER_SIZE + 8 * numChunks;
+  for (vtkIdType cc = 0; cc < numChunks; ++cc)
     {
-    vtkTimerLog::MarkStartEvent("Zlib compress");
-    // Use z-lib compression.
-    uLongf out_size =compressBound(writer->GetOutputStringLength());
-    buffer = new char[out_size + 8]; 
-    memcpy(buffer, "zlib0000", 8);
-
-    compress2(reinterpret_cast<Bytef*>(buffer + 8), 
-      &out_size,
-      reinterpret_cast<const Bytef*>(writer->GetOutputString()),
-      writer->GetOutputStringLength(), /* compression_level */ Z_DEFAULT_COMPRESSION);
-    vtkTimerLog::MarkEndEvent("Zlib compress");
-    int in_size = static_cast<int>(writer->GetOutputStringLength());
-    for (int cc=0; cc < 4; cc++)
+    if (sizes[cc] == 0)
       {
-      // the first 4 bytes in the header are "zlib" which helps the receiver
-      // identify that zlib compression has been used.
-      // the next 4 bytes are the original length since zlib doesn't provide
-      // that to the receiver.
-      buffer[4+cc] = (in_size & 0x0ff);
-      in_size = in_size >> 8;
+      // Keep the buffer uncompressed.
+      vtkTimerLog::MarkEndEvent("Compress buffer");
+      return;
       }
-    buffer_length = out_size + 8;
+    length += static_cast<vtkIdType>(sizes[cc]);
+    }
+
+  char* buffer = new char[length];
+  memcpy(buffer, COMPRESSED_MAGIC, 4);
+  buffer[4] = static_cast<char>(method);
+  buffer[5] = buffer[6] = buffer[7] = 0;
+  WriteInt64(buffer + 8, rawLength);
+  WriteInt64(buffer + 16, numChunks);
+  char* ptr = buffer + COMPRESSED_HEADER_SIZE + 8 * numChunks;
+  for (vtkIdType cc = 0; cc < numChunks; ++cc)
+    {
+    WriteInt64(buffer + COMPRESSED_HEADER_SIZE + 8 * cc, sizes[cc]);
+    memcpy(ptr, &chunks[cc][0], sizes[cc]);
+    ptr += sizes[cc];
+    }
+
+  delete [] this->Buffers;
+  this->Buffers = buffer;
+  this->BufferLengths[0] = length;
+  this->BufferTotalLength = length;
+  vtkTimerLog::MarkEndEvent("Compress buffer");
+}
+
+//-----------------------------------------------------------------------------
+void vtkMPIMoveData::SendBuffer(vtkCommunicator* com, int remoteId, int tag)
+{
+  const vtkIdType length = this->NumberOfBuffers > 0?
+    this->BufferTotalLength : 0;
+  const int method = this->GetTransferCompressionMethod(length, true);
+
+  vtkIdType header[2] = { method, length };
+  com->Send(header, 2, remoteId, tag);
+  if (length == 0)
+    {
+    return;
+    }
+
+  vtkTimerLog::MarkStartEvent("Send buffer");
+  vtkPVTraceEventScope traceEvent("delivery", "Send buffer");
+  double sendTime = 0.0;
+  double compressTime = 0.0;
+  vtkIdType sentLength = 0;
+  double start;
+  if (method == vtkMPIMoveData::NO_COMPRESSION)
+    {
+    start = vtkTimerLog::GetUniversalTime();
+    com->Send(this->Buffers, length, remoteId, tag + 2);
+    sendTime = vtkTimerLog::GetUniversalTime() - start;
+    sentLength = length;
     }
   else
     {
-    buffer_length = writer->GetOutputStringLength();
-    buffer = writer->RegisterAndGetOutputString();
+    std::vector<unsigned char> chunk;
+    for (vtkIdType offset = 0; offset < length; offset += CHUNK_SIZE)
+      {
+      const vtkIdType chunkLength = std::min(CHUNK_SIZE, length - offset);
+      start = vtkTimerLog::GetUniversalTime();
+      vtkIdType compressedLength = static_cast<vtkIdType>(CompressChunk(
+          method, this->Buffers + offset, chunkLength, chunk));
+      compressTime += vtkTimerLog::GetUniversalTime() - start;
+
+      start = vtkTimerLog::GetUniversalTime();
+      if (compressedLength > 0)
+        {
+        com->Send(&compressedLength, 1, remoteId, tag + 1);
+        com->Send(reinterpret_cast<char*>(&chunk[0]), compressedLength,
+          remoteId, tag + 2);
+        sentLength += compressedLength;
+        }
+      else
+        {
+        // A negative length tells the chunk is sent uncompressed.
+        vtkIdType rawLength = -chunkLength;
+        com->Send(&rawLength, 1, remoteId, tag + 1);
+        com->Send(this->Buffers + offset, chunkLength, remoteId, tag + 2);
+        sentLength += chunkLength;
+        }
+      sendTime += vtkTimerLog::GetUniversalTime() - start;
+      }
+
+    vtkCodecStatistics& stats = CodecStatistics[method];
+    if (compressTime > 0.0)
+      {
+      UpdateAverage(stats.CompressRate, length / compressTime);
+      }
+    UpdateAverage(stats.Ratio,
+      static_cast<double>(length) / std::max<vtkIdType>(sentLength, 1));
+    }
+
+  // Sends only measure the link when it was the bottleneck, otherwise they
+  // return as soon as the data is copied to the socket buffers.
+  if (sentLength >= MIN_BANDWIDTH_SAMPLE_SIZE && sendTime > 0.0 &&
+    sendTime >= compressTime)
+    {
+    UpdateAverage(LinkBandwidth, sentLength / sendTime);
     }
+  traceEvent.SetBytes(sentLength);
+  vtkTimerLog::MarkEndEvent("Send buffer");
+}
 
-  // Get string.
+//-----------------------------------------------------------------------------
+void vtkMPIMoveData::ReceiveBuffer(vtkCommunicator* com, int remoteId, int tag)
+{
+  this->ClearBuffer();
+
+  vtkIdType header[2] = { 0, 0 };
+  com->Receive(header, 2, remoteId, tag);
+  const int method = static_cast<int>(header[0]);
+  const vtkIdType length = header[1];
+  if (length <= 0)
+    {
+    return;
+    }
+
+  vtkTimerLog::MarkStartEvent("Receive buffer");
+  vtkPVTraceEventScope traceEvent("delivery", "Receive buffer", length);
   this->NumberOfBuffers = 1;
   this->BufferLengths = new vtkIdType[1];
-  this->BufferLengths[0] = buffer_length;
+  this->BufferLengths[0] = length;
   this->BufferOffsets = new vtkIdType[1];
   this->BufferOffsets[0] = 0;
-  this->Buffers = buffer;
-  this->BufferTotalLength = this->BufferLengths[0];
+  this->BufferTotalLength = length;
+  this->Buffers = new char[length];
+  if (method == vtkMPIMoveData::NO_COMPRESSION)
+    {
+    com->Receive(this->Buffers, length, remoteId, tag + 2);
+    vtkTimerLog::MarkEndEvent("Receive buffer");
+    return;
+    }
 
-  writer->Delete();
-  writer = 0;
+  // Every chunk is received, even after a failure, to stay in sync with the
+  // sender.
+  bool valid = (method == vtkMPIMoveData::LZ4_COMPRESSION ||
+    method == vtkMPIMoveData::ZLIB_COMPRESSION);
+  double decompressTime = 0.0;
+  std::vector<char> chunk;
+  for (vtkIdType offset = 0; offset < length; offset += CHUNK_SIZE)
+    {
+    const vtkIdType chunkLength = std::min(CHUNK_SIZE, length - offset);
+    vtkIdType compressedLength = 0;
+    com->Receive(&compressedLength, 1, remoteId, tag + 1);
+    if (compressedLength < 0)
+      {
+      valid = valid && (-compressedLength == chunkLength);
+      com->Receive(this->Buffers + offset, chunkLength, remoteId, tag + 2);
+      continue;
+      }
+    chunk.resize(std::max<vtkIdType>(compressedLength, 1));
+    com->Receive(&chunk[0], compressedLength, remoteId, tag + 2);
+    if (valid)
+      {
+      double start = vtkTimerLog::GetUniversalTime();
+      valid = DecompressChunk(method, &chunk[0], compressedLength,
+        this->Buffers + offset, chunkLength);
+      decompressTime += vtkTimerLog::GetUniversalTime() - start;
+      }
+    }
+
+  if (!valid)
+    {
+    vtkErrorMacro("Failed to decompress the data received.");
+    this->ClearBuffer();
+    }
+  else if (decompressTime > 0.0)
+    {
+    UpdateAverage(CodecStatistics[method].DecompressRate,
+      length / decompressTime);
+    }
+  vtkTimerLog::MarkEndEvent("Receive buffer");
 }
 
 //-----------------------------------------------------------------------------
@@ -1148,25 +1592,19 @@ void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data)
     vtkIdType bufferLength = this->BufferLengths[idx];
 
     char* realBuffer = 0;
-    if (bufferLength > 4 && strncmp(bufferArray, "zlib", 4) == 0)
+    if (bufferLength > 4 && memcmp(bufferArray, COMPRESSED_MAGIC, 4) == 0)
       {
-      // sender used zlib compression. Decompress it.
-      vtkIdType compressed_length = bufferLength - 8; // remove the zlib header.
+      // sender compressed the buffer. Decompress it.
       vtkIdType uncompressed_length = 0;
-      for (int cc=0; cc < 4; cc++)
+      vtkTimerLog::MarkStartEvent("Decompress buffer");
+      realBuffer = DecompressBuffer(bufferArray, bufferLength,
+        uncompressed_length);
+      vtkTimerLog::MarkEndEvent("Decompress buffer");
+      if (!realBuffer)
         {
-        uncompressed_length = uncompressed_length | 
-          ((0xff & (bufferArray[4+cc])) <<8 *cc);
+        vtkErrorMacro("Failed to decompress the data received.");
+        continue;
         }
-
-      // using zlib compression.
-      realBuffer = new char[uncompressed_length];
-      uLongf destLen = uncompressed_length;
-      vtkTimerLog::MarkStartEvent("Zlib uncompress");
-      uncompress(reinterpret_cast<Bytef*>(realBuffer), &destLen,
-        reinterpret_cast<const Bytef*>(bufferArray+8), compressed_length);
-      vtkTimerLog::MarkEndEvent("Zlib uncompress");
-
       bufferArray = realBuffer;
       bufferLength = uncompressed_length;
       }
@@ -1233,6 +1671,9 @@ void vtkMPIMoveData::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "NumberOfBuffers: " << this->NumberOfBuffers << endl;
   os << indent << "Server: " << this->Server << endl;
   os << indent << "MoveMode: " << this->MoveMode << endl;
+  os << indent << "CompressionMethod: " << this->CompressionMethod << endl;
+  os << indent << "DeltaEncoder: " << this->DeltaEncoder << endl;
+  os << indent << "UseDeltaEncoding: " << this->UseDeltaEncoding << endl;
   os << indent << "SkipDataServerGatherToZero: " <<
     this->SkipDataServerGatherToZero << endl;
   os << indent << "OutputDataType: ";
@@ -26,9 +26,11 @@
 #include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
 #include "vtkPassInputTypeAlgorithm.h"
 
+class vtkCommunicator;
 class vtkMultiProcessController;
 class vtkSocketController;
 class vtkMPIMToNSocketConnection;
+class vtkPVDataDeltaEncoder;
 class vtkDataSet;
 class vtkIndent;
 
@@ -90,9 +92,22 @@ public:
   vtkGetMacro(OutputDataType, int);
 
   // Description:
-  // When set to true, zlib compression is used. False by default.
-  // This value has any effect only on the data-sender processes. The receiver
-  // always checks the received data to see if zlib decompression is required.
+  // Compression applied to the data sent by this filter. With
+  // AUTOMATIC_COMPRESSION (the default), each transfer over a socket (to the
+  // client or the render server) picks the codec expected to deliver the data
+  // the fastest given its size and the bandwidth measured on previous
+  // transfers, while transfers among the processes of a server are not
+  // compressed. Other methods apply to every transfer. Socket transfers are
+  // streamed in chunks so that compression, transfer and decompression
+  // overlap. This value has any effect only on the data-sender processes.
+  // The receiver always detects how the data it receives was compressed.
+  vtkSetClampMacro(CompressionMethod, int, vtkMPIMoveData::NO_COMPRESSION,
+    vtkMPIMoveData::AUTOMATIC_COMPRESSION);
+  vtkGetMacro(CompressionMethod, int);
+
+  // Description:
+  // When set to true, zlib compression is used for all transfers regardless
+  // of CompressionMethod. False by default.
   static void SetUseZLibCompression(bool b);
   static bool GetUseZLibCompression();
 
@@ -110,6 +125,22 @@ public:
   vtkSetMacro(SkipDataServerGatherToZero, bool);
   vtkGetMacro(SkipDataServerGatherToZero, bool);
 
+  // Description:
+  // When set, the data sent from the data server to the client is encoded by
+  // (on the data server) and decoded by (on the client) this encoder so that
+  // only what changed since the previous transfer through the same encoder is
+  // sent. See vtkPVDataDeltaEncoder.
+  void SetDeltaEncoder(vtkPVDataDeltaEncoder*);
+  vtkGetObjectMacro(DeltaEncoder, vtkPVDataDeltaEncoder);
+
+  // Description:
+  // When off, the data is sent complete even if a DeltaEncoder is set. Only
+  // the value set on the data server matters, the client follows it. When
+  // the client cannot rebuild the data from a delta, the data server sends it
+  // again, complete. On by default.
+  vtkSetMacro(UseDeltaEncoding, bool);
+  vtkGetMacro(UseDeltaEncoding, bool);
+
 //BTX
   enum MoveModes {
     PASS_THROUGH=0,
@@ -117,6 +148,13 @@ public:
     CLONE=2,
     COLLECT_AND_PASS_THROUGH=3
   };
+
+  enum CompressionMethods {
+    NO_COMPRESSION=0,
+    LZ4_COMPRESSION=1,
+    ZLIB_COMPRESSION=2,
+    AUTOMATIC_COMPRESSION=3
+  };
 //ETX
 
 //ETX
@@ -135,6 +173,8 @@ protected:
   vtkMultiProcessController* Controller;
   vtkMultiProcessController* ClientDataServerSocketController;
   vtkMPIMToNSocketConnection* MPIMToNSocketConnection;
+  vtkPVDataDeltaEncoder* DeltaEncoder;
+  bool UseDeltaEncoding;
 
   void DataServerAllToN(vtkDataObject* inData, vtkDataObject* outData, int n);
   void DataServerGatherAll(vtkDataObject* input, vtkDataObject* output);
@@ -157,7 +197,25 @@ protected:
   void MarshalDataToBuffer(vtkDataObject* data);
   void ReconstructDataFromBuffer(vtkDataObject* data);
 
+  // Description:
+  // Returns the codec to use for a transfer of \c length bytes, over a
+  // socket or among the processes of a server.
+  int GetTransferCompressionMethod(vtkIdType length, bool socket);
+
+  // Description:
+  // Compresses the marshaled buffer as a whole, for transfers among the
+  // processes of a server.
+  void CompressBuffer(int method);
+
+  // Description:
+  // Sends the marshaled buffer over a socket, compressing it chunk by chunk
+  // while previous chunks are being transferred, and receives it on the
+  // other end. \c tag is the first of the 3 tags used.
+  void SendBuffer(vtkCommunicator* com, int remoteId, int tag);
+  void ReceiveBuffer(vtkCommunicator* com, int remoteId, int tag);
+
   int MoveMode;
+  int CompressionMethod;
   int Server;
 
   bool SkipDataServerGatherToZero;
@@ -0,0 +1,244 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkMultiBlockStreamingPriorityQueue.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkMultiBlockStreamingPriorityQueue.h"
+
+#include "vtkBoundingBox.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkInformation.h"
+#include "vtkMath.h"
+#include "vtkMultiProcessController.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkStreamingPriorityQueue.h"
+#include "vtkUnsignedIntArray.h"
+
+#include <assert.h>
+#include <deque>
+#include <set>
+#include <vector>
+
+class vtkMultiBlockStreamingPriorityQueue::vtkInternals
+{
+public:
+  vtkStreamingPriorityQueue<> PriorityQueue;
+
+  // Blocks without bounds, requested in order once the PriorityQueue is empty.
+  std::deque<unsigned int> UnboundedBlocks;
+
+  vtkBoundingBox Bounds;
+
+  bool PopItem(unsigned int& identifier)
+    {
+    if (!this->PriorityQueue.empty())
+      {
+      identifier = this->PriorityQueue.top().Identifier;
+      this->PriorityQueue.pop();
+      return true;
+      }
+    if (!this->UnboundedBlocks.empty())
+      {
+      identifier = this->UnboundedBlocks.front();
+      this->UnboundedBlocks.pop_front();
+      return true;
+      }
+    return false;
+    }
+};
+
+vtkStandardNewMacro(vtkMultiBlockStreamingPriorityQueue);
+vtkCxxSetObjectMacro(vtkMultiBlockStreamingPriorityQueue, Controller, vtkMultiProcessController);
+//----------------------------------------------------------------------------
+vtkMultiBlockStreamingPriorityQueue::vtkMultiBlockStreamingPriorityQueue()
+{
+  this->Internals = new vtkInternals();
+  this->Controller = 0;
+  this->SetController(vtkMultiProcessController::GetGlobalController());
+}
+
+//----------------------------------------------------------------------------
+vtkMultiBlockStreamingPriorityQueue::~vtkMultiBlockStreamingPriorityQueue()
+{
+  delete this->Internals;
+  this->Internals = 0;
+  this->SetController(0);
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiBlockStreamingPriorityQueue::Initialize(
+  vtkCompositeDataSet* metadata)
+{
+  delete this->Internals;
+  this->Internals = new vtkInternals();
+  if (!metadata)
+    {
+    return;
+    }
+
+  // The meta-data has no heavy data, don't skip the empty leaves.
+  std::vector<vtkStreamingPriorityQueueItem> items;
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(metadata->NewIterator());
+  iter->SkipEmptyNodesOff();
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+    vtkInformation* blockInfo = iter->HasCurrentMetaData()?
+      iter->GetCurrentMetaData() : NULL;
+    double block_bounds[6];
+    if (blockInfo && blockInfo->Has(vtkStreamingDemandDrivenPipeline::BOUNDS()))
+      {
+      blockInfo->Get(vtkStreamingDemandDrivenPipeline::BOUNDS(), block_bounds);
+      }
+    else
+      {
+      vtkMath::UninitializeBounds(block_bounds);
+      }
+
+    vtkStreamingPriorityQueueItem item;
+    item.Identifier = iter->GetCurrentFlatIndex();
+    if (vtkMath::AreBoundsInitialized(block_bounds))
+      {
+      item.Bounds.SetBounds(block_bounds);
+      }
+    if (item.Bounds.IsValid())
+      {
+      this->Internals->Bounds.AddBox(item.Bounds);
+      items.push_back(item);
+      }
+    else
+      {
+      this->Internals->UnboundedBlocks.push_back(item.Identifier);
+      }
+    }
+
+  // default priority is to preserve the order of the blocks. Thus even without
+  // view-planes we have a reasonable priority.
+  for (size_t cc=0; cc < items.size(); cc++)
+    {
+    items[cc].Priority = static_cast<double>(items.size() - cc);
+    this->Internals->PriorityQueue.push(items[cc]);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiBlockStreamingPriorityQueue::RemoveLoadedBlocks(
+  vtkCompositeDataSet* data)
+{
+  vtkNew<vtkUnsignedIntArray> localIds;
+  if (data)
+    {
+    vtkSmartPointer<vtkCompositeDataIterator> iter;
+    iter.TakeReference(data->NewIterator());
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      localIds->InsertNextValue(iter->GetCurrentFlatIndex());
+      }
+    }
+
+  vtkNew<vtkUnsignedIntArray> ids;
+  if (this->Controller && this->Controller->GetNumberOfProcesses() > 1)
+    {
+    this->Controller->AllGatherV(localIds.GetPointer(), ids.GetPointer());
+    }
+  else
+    {
+    ids->ShallowCopy(localIds.GetPointer());
+    }
+  if (ids->GetNumberOfTuples() == 0)
+    {
+    return;
+    }
+
+  std::set<unsigned int> loaded(ids->GetPointer(0),
+    ids->GetPointer(0) + ids->GetNumberOfTuples());
+
+  vtkStreamingPriorityQueue<> current_queue;
+  std::swap(current_queue, this->Internals->PriorityQueue);
+  for (; !current_queue.empty(); current_queue.pop())
+    {
+    if (loaded.find(current_queue.top().Identifier) == loaded.end())
+      {
+      this->Internals->PriorityQueue.push(current_queue.top());
+      }
+    }
+
+  std::deque<unsigned int> unbounded;
+  std::swap(unbounded, this->Internals->UnboundedBlocks);
+  for (size_t cc=0; cc < unbounded.size(); cc++)
+    {
+    if (loaded.find(unbounded[cc]) == loaded.end())
+      {
+      this->Internals->UnboundedBlocks.push_back(unbounded[cc]);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkMultiBlockStreamingPriorityQueue::IsEmpty()
+{
+  return this->Internals->PriorityQueue.empty() &&
+    this->Internals->UnboundedBlocks.empty();
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkMultiBlockStreamingPriorityQueue::Pop()
+{
+  if (this->IsEmpty())
+    {
+    vtkErrorMacro("Queue is empty!");
+    return VTK_UNSIGNED_INT_MAX;
+    }
+
+  int num_procs = this->Controller? this->Controller->GetNumberOfProcesses() : 1;
+  int myid = this->Controller? this->Controller->GetLocalProcessId() : 0;
+  assert(myid < num_procs);
+
+  // All processes pop the same items, each one keeps the item at its rank.
+  std::vector<unsigned int> items(num_procs, VTK_UNSIGNED_INT_MAX);
+  for (int cc=0; cc < num_procs && this->Internals->PopItem(items[cc]); cc++)
+    {
+    }
+  return items[myid];
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiBlockStreamingPriorityQueue::Update(const double view_planes[24])
+{
+  double clamp_bounds[6];
+  vtkMath::UninitializeBounds(clamp_bounds);
+  this->Internals->PriorityQueue.UpdatePriorities(view_planes, clamp_bounds);
+}
+
+//----------------------------------------------------------------------------
+bool vtkMultiBlockStreamingPriorityQueue::GetBounds(double bounds[6])
+{
+  if (!this->Internals->Bounds.IsValid())
+    {
+    vtkMath::UninitializeBounds(bounds);
+    return false;
+    }
+  this->Internals->Bounds.GetBounds(bounds);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiBlockStreamingPriorityQueue::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Controller: " << this->Controller << endl;
+}
@@ -0,0 +1,111 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkMultiBlockStreamingPriorityQueue.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkMultiBlockStreamingPriorityQueue - implements a coverage based
+// priority queue for the blocks of a composite dataset.
+// .SECTION Description
+// vtkMultiBlockStreamingPriorityQueue is used by representations supporting
+// streaming of composite datasets e.g. multiblock or multipiece datasets
+// of unstructured grids, to determine the order in which to request the
+// blocks. The queue is built from the meta-data the input pipeline provides
+// in vtkCompositeDataPipeline::COMPOSITE_DATA_META_DATA() and relies on the
+// bounds of the blocks (vtkStreamingDemandDrivenPipeline::BOUNDS()) to
+// prioritize the blocks that are visible and close to the camera. Simply
+// provide the view planes (returned by vtkCamera::GetFrustumPlanes()) to
+// Update() to update the priorities of the blocks currently in the queue.
+// Blocks without bounds cannot be prioritized, they are requested in order
+// after the others.
+//
+// This implementation is based on vtkAMRStreamingPriorityQueue.
+// .SECTION See Also
+// vtkAMRStreamingPriorityQueue, vtkGeometryRepresentation.
+
+#ifndef __vtkMultiBlockStreamingPriorityQueue_h
+#define __vtkMultiBlockStreamingPriorityQueue_h
+
+#include "vtkPVClientServerCoreRenderingModule.h" // for export macros
+#include "vtkObject.h"
+
+class vtkCompositeDataSet;
+class vtkMultiProcessController;
+
+class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkMultiBlockStreamingPriorityQueue : public vtkObject
+{
+public:
+  static vtkMultiBlockStreamingPriorityQueue* New();
+  vtkTypeMacro(vtkMultiBlockStreamingPriorityQueue, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // If the controller is specified, the queue can be used in parallel. So long
+  // as Initialize(), Update() and Pop() methods are called on all processes
+  // and all process get the same meta-data and view_planes (which is
+  // generally true with ParaView), the blocks are distributed among the
+  // processes.
+  // By default, this is set to the
+  // vtkMultiProcessController::GetGlobalController();
+  void SetController(vtkMultiProcessController*);
+  vtkGetObjectMacro(Controller, vtkMultiProcessController);
+
+  // Description:
+  // Initializes the queue with all the leaves of the meta-data. All
+  // information about items in the queue is lost. Only the meta-data of the
+  // leaves is looked at, none of the heavy data is tested or checked.
+  void Initialize(vtkCompositeDataSet* metadata);
+
+  // Description:
+  // Removes from the queue the blocks that are not empty in \c data, i.e. the
+  // blocks the input pipeline already produced without being asked for
+  // specific blocks. When a controller is set, this must be called on all
+  // processes since the blocks loaded on any process are removed.
+  void RemoveLoadedBlocks(vtkCompositeDataSet* data);
+
+  // Description:
+  // Updates the priorities of blocks based on the new view frustum planes.
+  // Blocks "popped" from the queue are not reinserted in the queue.
+  void Update(const double view_planes[24]);
+
+  // Description:
+  // Returns if the queue is empty.
+  bool IsEmpty();
+
+  // Description:
+  // Pops and returns the composite id (flat index) of the block this process
+  // must request next. When the queue empties out, processes that have no
+  // block left to request get VTK_UNSIGNED_INT_MAX.
+  // Test if the queue is empty before calling this method.
+  unsigned int Pop();
+
+  // Description:
+  // Returns the bounds of all the blocks in the meta-data given to the most
+  // recent call to Initialize(). Returns false if no block has bounds.
+  bool GetBounds(double bounds[6]);
+
+//BTX
+protected:
+  vtkMultiBlockStreamingPriorityQueue();
+  ~vtkMultiBlockStreamingPriorityQueue();
+
+  vtkMultiProcessController* Controller;
+
+private:
+  vtkMultiBlockStreamingPriorityQueue(const vtkMultiBlockStreamingPriorityQueue&); // Not implemented
+  void operator=(const vtkMultiBlockStreamingPriorityQueue&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+};
+
+#endif
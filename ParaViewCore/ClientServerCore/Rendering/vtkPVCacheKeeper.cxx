@@ -15,34 +15,227 @@
 #include "vtkPVCacheKeeper.h"
 
 #include "vtkCacheSizeKeeper.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkDataArray.h"
 #include "vtkDataObject.h"
+#include "vtkFieldData.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkLZ4Codec.h"
 #include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
 #include "vtkProcessModule.h"
 #include "vtkPVCacheKeeperPipeline.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkTable.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
 
 #include <map>
-//----------------------------------------------------------------------------
-class vtkPVCacheKeeper::vtkCacheMap :
-  public std::map<double, vtkSmartPointer<vtkDataObject> >
+#include <set>
+#include <vector>
+
+namespace
 {
-public:
-  unsigned long GetActualMemorySize() 
+  // Arrays smaller than this are left uncompressed in the cache.
+  const size_t MIN_COMPRESSED_ARRAY_SIZE = 4096;
+
+  // Compressed values of one array of a cached data object.
+  struct vtkCompressedArray
     {
-    unsigned long actual_size = 0;
-    vtkCacheMap::iterator iter;
-    for (iter = this->begin(); iter != this->end(); ++iter)
+    vtkIdType NumberOfTuples;
+    int NumberOfComponents;
+    size_t RawSize;
+    bool Compressed;
+    std::vector<unsigned char> Data;
+    };
+
+  // Collects the arrays holding the bulk of the data in the given data
+  // object, in a deterministic order, so that a deep copy of it yields the
+  // matching arrays.
+  class vtkArrayCollector
+    {
+  public:
+    std::vector<vtkDataArray*> Arrays;
+
+    void Collect(vtkDataObject* dobj)
       {
-      actual_size += iter->second.GetPointer()->GetActualMemorySize();
+      if (!dobj)
+        {
+        return;
+        }
+      this->Add(dobj->GetFieldData());
+
+      if (vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(dobj))
+        {
+        vtkCompositeDataIterator* iter = cd->NewIterator();
+        for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+          iter->GoToNextItem())
+          {
+          this->Collect(iter->GetCurrentDataObject());
+          }
+        iter->Delete();
+        return;
+        }
+
+      if (vtkTable* table = vtkTable::SafeDownCast(dobj))
+        {
+        this->Add(table->GetRowData());
+        return;
+        }
+
+      vtkDataSet* ds = vtkDataSet::SafeDownCast(dobj);
+      if (!ds)
+        {
+        return;
+        }
+      this->Add(ds->GetPointData());
+      this->Add(ds->GetCellData());
+      if (vtkPointSet* ps = vtkPointSet::SafeDownCast(ds))
+        {
+        this->Add(ps->GetPoints()? ps->GetPoints()->GetData() : NULL);
+        }
+      if (vtkPolyData* pd = vtkPolyData::SafeDownCast(ds))
+        {
+        this->Add(pd->GetVerts());
+        this->Add(pd->GetLines());
+        this->Add(pd->GetPolys());
+        this->Add(pd->GetStrips());
+        }
+      else if (vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(ds))
+        {
+        this->Add(ug->GetCells());
+        this->Add(ug->GetCellTypesArray());
+        this->Add(ug->GetCellLocationsArray());
+        this->Add(ug->GetFaces());
+        this->Add(ug->GetFaceLocations());
+        }
+      else if (vtkRectilinearGrid* rg = vtkRectilinearGrid::SafeDownCast(ds))
+        {
+        this->Add(rg->GetXCoordinates());
+        this->Add(rg->GetYCoordinates());
+        this->Add(rg->GetZCoordinates());
+        }
       }
-    return actual_size;
-    }
+
+  private:
+    std::set<vtkDataArray*> Visited;
+
+    void Add(vtkFieldData* fd)
+      {
+      for (int cc = 0; fd && cc < fd->GetNumberOfArrays(); ++cc)
+        {
+        this->Add(fd->GetArray(cc));
+        }
+      }
+    void Add(vtkCellArray* cells)
+      {
+      this->Add(cells? cells->GetData() : NULL);
+      }
+    void Add(vtkDataArray* array)
+      {
+      // Only arrays with a contiguous buffer can be compressed. The choice
+      // must not depend on the array size, which is lost once compressed.
+      if (array && array->GetDataType() != VTK_BIT &&
+        array->HasStandardMemoryLayout() &&
+        this->Visited.insert(array).second)
+        {
+        this->Arrays.push_back(array);
+        }
+      }
+    };
+
+  class vtkCompressArrays
+    {
+  public:
+    vtkDataArray** Arrays;
+    vtkCompressedArray* Values;
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType cc = begin; cc < end; ++cc)
+        {
+        vtkDataArray* array = this->Arrays[cc];
+        vtkCompressedArray& value = this->Values[cc];
+        value.NumberOfTuples = array->GetNumberOfTuples();
+        value.NumberOfComponents = array->GetNumberOfComponents();
+        value.RawSize = static_cast<size_t>(value.NumberOfTuples) *
+          value.NumberOfComponents * array->GetDataTypeSize();
+        value.Compressed = false;
+        if (value.RawSize < MIN_COMPRESSED_ARRAY_SIZE)
+          {
+          continue;
+          }
+        value.Data.resize(vtkLZ4Codec::GetMaximumCompressedSize(value.RawSize));
+        size_t size = vtkLZ4Codec::Compress(
+          static_cast<unsigned char*>(array->GetVoidPointer(0)),
+          value.RawSize, &value.Data[0], value.Data.size());
+        if (size > 0 && size < value.RawSize)
+          {
+          // Release the over-allocated capacity.
+          std::vector<unsigned char>(value.Data.begin(),
+            value.Data.begin() + size).swap(value.Data);
+          value.Compressed = true;
+          }
+        else
+          {
+          std::vector<unsigned char>().swap(value.Data);
+          }
+        }
+      }
+    };
+
+  class vtkDecompressArrays
+    {
+  public:
+    vtkDataArray** Arrays;
+    const vtkCompressedArray* Values;
+    int* Status;
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType cc = begin; cc < end; ++cc)
+        {
+        const vtkCompressedArray& value = this->Values[cc];
+        if (value.Compressed)
+          {
+          this->Status[cc] = vtkLZ4Codec::Decompress(&value.Data[0],
+            value.Data.size(),
+            static_cast<unsigned char*>(this->Arrays[cc]->GetVoidPointer(0)),
+            value.RawSize) == value.RawSize;
+          }
+        }
+      }
+    };
+}
+
+//----------------------------------------------------------------------------
+// A cached data object. When compressed, Data is a deep copy of the cached
+// data object in which the compressed arrays have been emptied, and Arrays
+// holds their values in the order given by vtkArrayCollector.
+class vtkPVCacheKeeper::vtkCacheEntry
+{
+public:
+  vtkSmartPointer<vtkDataObject> Data;
+  std::vector<vtkCompressedArray> Arrays;
+  unsigned long Size;
+
+  vtkCacheEntry() : Size(0) {}
+};
+
+//----------------------------------------------------------------------------
+class vtkPVCacheKeeper::vtkCacheMap :
+  public std::map<double, vtkPVCacheKeeper::vtkCacheEntry>
+{
 };
 
 vtkStandardNewMacro(vtkPVCacheKeeper);
-vtkCxxSetObjectMacro(vtkPVCacheKeeper, CacheSizeKeeper, vtkCacheSizeKeeper);
 //----------------------------------------------------------------------------
 vtkPVCacheKeeper::vtkPVCacheKeeper()
 {
@@ -65,17 +258,59 @@ vtkPVCacheKeeper::~vtkPVCacheKeeper()
   this->Cache = 0;
 }
 
+//----------------------------------------------------------------------------
+void vtkPVCacheKeeper::SetCacheSizeKeeper(vtkCacheSizeKeeper* keeper)
+{
+  if (this->CacheSizeKeeper == keeper)
+    {
+    return;
+    }
+  if (this->CacheSizeKeeper)
+    {
+    this->CacheSizeKeeper->UnRegisterCacheKeeper(this);
+    this->CacheSizeKeeper->UnRegister(this);
+    }
+  this->CacheSizeKeeper = keeper;
+  if (this->CacheSizeKeeper)
+    {
+    this->CacheSizeKeeper->Register(this);
+    this->CacheSizeKeeper->RegisterCacheKeeper(this);
+    }
+  this->Modified();
+}
+
 //----------------------------------------------------------------------------
 void vtkPVCacheKeeper::RemoveAllCaches()
 {
   // cout << this << " RemoveAllCaches" << endl;
-  unsigned long freed_size = this->Cache->GetActualMemorySize();
-  this->Cache->clear();
-  if (freed_size > 0 && this->CacheSizeKeeper)
+  if (this->CacheSizeKeeper)
     {
     // Tell the cache size keeper about the newly freed memory size.
-    this->CacheSizeKeeper->FreeCacheSize(freed_size);
+    vtkCacheMap::iterator iter;
+    for (iter = this->Cache->begin(); iter != this->Cache->end(); ++iter)
+      {
+      this->CacheSizeKeeper->RemoveCacheEntry(iter->first,
+        iter->second.Size);
+      }
+    }
+  this->Cache->clear();
+
+  // this method should never mark the filter modified !!!
+}
+
+//----------------------------------------------------------------------------
+void vtkPVCacheKeeper::RemoveCache(double cacheTime)
+{
+  vtkCacheMap::iterator iter = this->Cache->find(cacheTime);
+  if (iter == this->Cache->end())
+    {
+    return;
+    }
+  if (this->CacheSizeKeeper)
+    {
+    this->CacheSizeKeeper->RemoveCacheEntry(cacheTime, iter->second.Size);
     }
+  this->Cache->erase(iter);
 
   // this method should never mark the filter modified !!!
 }
@@ -89,24 +324,120 @@ bool vtkPVCacheKeeper::IsCached(double cacheTime)
 
 //----------------------------------------------------------------------------
 bool vtkPVCacheKeeper::SaveData(vtkDataObject* output)
+{
+  return this->AddCache(this->CacheTime, output);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVCacheKeeper::AddCache(double cacheTime, vtkDataObject* output)
 {
   if (!this->CacheSizeKeeper  || !this->CacheSizeKeeper->GetCacheFull())
     {
-    vtkSmartPointer<vtkDataObject> cache;
-    cache.TakeReference(output->NewInstance());
-    cache->ShallowCopy(output);
-    (*this->Cache)[this->CacheTime] = cache;
+    this->RemoveCache(cacheTime);
+    vtkCacheEntry& entry = (*this->Cache)[cacheTime];
+    entry.Data.TakeReference(output->NewInstance());
+    entry.Arrays.clear();
+    if (this->CacheSizeKeeper &&
+      this->CacheSizeKeeper->GetCompressCacheEntries())
+      {
+      this->CompressData(output, entry);
+      }
+    else
+      {
+      entry.Data->ShallowCopy(output);
+      entry.Size = entry.Data->GetActualMemorySize();
+      }
 
     if (this->CacheSizeKeeper)
       {
       // Register used cache size.
-      this->CacheSizeKeeper->AddCacheSize(cache->GetActualMemorySize());
+      this->CacheSizeKeeper->AddCacheEntry(cacheTime, entry.Size);
       }
     return true;
     }
   return false;
 }
 
+//----------------------------------------------------------------------------
+void vtkPVCacheKeeper::CompressData(vtkDataObject* data, vtkCacheEntry& entry)
+{
+  entry.Data->DeepCopy(data);
+
+  vtkArrayCollector collector;
+  collector.Collect(entry.Data);
+  const vtkIdType numArrays =
+    static_cast<vtkIdType>(collector.Arrays.size());
+  entry.Arrays.resize(collector.Arrays.size());
+  if (numArrays > 0)
+    {
+    vtkCompressArrays compressor;
+    compressor.Arrays = &collector.Arrays[0];
+    compressor.Values = &entry.Arrays[0];
+    vtkSMPTools::For(0, numArrays, 1, compressor);
+    }
+
+  size_t compressedSize = 0;
+  for (vtkIdType cc = 0; cc < numArrays; ++cc)
+    {
+    if (entry.Arrays[cc].Compressed)
+      {
+      collector.Arrays[cc]->Initialize();
+      compressedSize += entry.Arrays[cc].Data.size();
+      }
+    }
+  if (compressedSize == 0)
+    {
+    // Nothing worth compressing, keep the plain copy.
+    entry.Arrays.clear();
+    }
+  entry.Size = entry.Data->GetActualMemorySize() +
+    static_cast<unsigned long>((compressedSize + 1023) / 1024);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVCacheKeeper::DecompressData(const vtkCacheEntry& entry,
+  vtkDataObject* data)
+{
+  data->DeepCopy(entry.Data);
+
+  vtkArrayCollector collector;
+  collector.Collect(data);
+  const vtkIdType numArrays =
+    static_cast<vtkIdType>(collector.Arrays.size());
+  if (collector.Arrays.size() != entry.Arrays.size())
+    {
+    return false;
+    }
+  for (vtkIdType cc = 0; cc < numArrays; ++cc)
+    {
+    const vtkCompressedArray& value = entry.Arrays[cc];
+    if (value.Compressed)
+      {
+      vtkDataArray* array = collector.Arrays[cc];
+      array->SetNumberOfComponents(value.NumberOfComponents);
+      array->SetNumberOfTuples(value.NumberOfTuples);
+      }
+    }
+  if (numArrays > 0)
+    {
+    std::vector<int> status(collector.Arrays.size(), 1);
+    vtkDecompressArrays decompressor;
+    decompressor.Arrays = &collector.Arrays[0];
+    decompressor.Values = &entry.Arrays[0];
+    decompressor.Status = &status[0];
+    vtkSMPTools::For(0, numArrays, 1, decompressor);
+    for (vtkIdType cc = 0; cc < numArrays; ++cc)
+      {
+      if (!status[cc])
+        {
+        return false;
+        }
+      collector.Arrays[cc]->Modified();
+      }
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 vtkExecutive* vtkPVCacheKeeper::CreateDefaultExecutive()
 {
@@ -160,13 +491,33 @@ int vtkPVCacheKeeper::RequestData(vtkInformation* vtkNotUsed(reqInfo),
 
   if (this->CachingEnabled)
     {
-    if (this->IsCached(this->CacheTime))
+    vtkCacheMap::iterator iter = this->Cache->find(this->CacheTime);
+    if (iter != this->Cache->end())
       {
-      output->ShallowCopy((*this->Cache)[this->CacheTime]);
+      if (iter->second.Arrays.empty())
+        {
+        output->ShallowCopy(iter->second.Data);
+        }
+      else if (!this->DecompressData(iter->second, output))
+        {
+        vtkErrorMacro("Failed to decompress the cache for time "
+          << this->CacheTime << ".");
+        output->Initialize();
+        this->RemoveCache(this->CacheTime);
+        return 1;
+        }
+      if (this->CacheSizeKeeper)
+        {
+        this->CacheSizeKeeper->RecordHit(this->CacheTime);
+        }
       //cout << this << " using Cache: " << this->CacheTime << endl;
       }
     else
       {
+      if (this->CacheSizeKeeper)
+        {
+        this->CacheSizeKeeper->RecordMiss(this->CacheTime);
+        }
       output->ShallowCopy(input);
       this->SaveData(output);
       //cout << this << " Saving cache: " << this->CacheTime << endl;
@@ -20,6 +20,11 @@
 // then this filter shuts the update request, otherwise propagates the update
 // and then cache the result for later use.  The current time step is set using
 // SetCacheTime().
+// The cached data is accounted for in vtkCacheSizeKeeper which may evict
+// cache entries when the cache size limit is reached. When
+// vtkCacheSizeKeeper::CompressCacheEntries is set, the arrays of the cached
+// data are kept compressed with vtkLZ4Codec and decompressed on every cache
+// hit, which trades playback speed for the number of cached time steps.
 // .SECTION See Also
 // vtkPVCacheKeeperPipeline
 
@@ -43,6 +48,17 @@ public:
   // This removes all saved cache.
   void RemoveAllCaches();
 
+  // Description:
+  // Removes the data cached for the given time, if any. This is used by
+  // vtkCacheSizeKeeper to evict cache entries.
+  void RemoveCache(double cacheTime);
+
+  // Description:
+  // Caches \c data for the given time without executing or changing the
+  // output of this filter. This is used to prefetch time steps. Returns false
+  // if the cache is full.
+  bool AddCache(double cacheTime, vtkDataObject* data);
+
   // Description:
   // Set/Get the current cache time.
   vtkSetMacro(CacheTime, double);
@@ -83,6 +99,14 @@ protected:
   // false.
   bool SaveData(vtkDataObject*);
 
+  class vtkCacheEntry;
+
+  // Description:
+  // Stores a compressed copy of \c data in \c entry, used when
+  // vtkCacheSizeKeeper::GetCompressCacheEntries() is set, and restores it.
+  void CompressData(vtkDataObject* data, vtkCacheEntry& entry);
+  bool DecompressData(const vtkCacheEntry& entry, vtkDataObject* data);
+
   bool CachingEnabled;
   double CacheTime;
   vtkCacheSizeKeeper* CacheSizeKeeper;
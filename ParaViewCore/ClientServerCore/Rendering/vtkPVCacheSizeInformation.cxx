@@ -24,6 +24,10 @@ vtkStandardNewMacro(vtkPVCacheSizeInformation);
 vtkPVCacheSizeInformation::vtkPVCacheSizeInformation()
 {
   this->CacheSize = 0;
+  this->NumberOfHits = 0;
+  this->NumberOfMisses = 0;
+  this->NumberOfEvictions = 0;
+  this->NumberOfCachedTimes = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -34,7 +38,8 @@ vtkPVCacheSizeInformation::~vtkPVCacheSizeInformation()
 //-----------------------------------------------------------------------------
 void vtkPVCacheSizeInformation::CopyFromObject(vtkObject* obj)
 {
-  vtkCacheSizeKeeper* csk = vtkCacheSizeKeeper::SafeDownCast(obj);
+  vtkCacheSizeKeeper* csk = obj? vtkCacheSizeKeeper::SafeDownCast(obj) :
+    vtkCacheSizeKeeper::GetInstance();
 #ifdef FIXME
   vtkProcessModule* pm = vtkProcessModule::SafeDownCast(obj);
   if (pm)
@@ -49,6 +54,10 @@ void vtkPVCacheSizeInformation::CopyFromObject(vtkObject* obj)
     return;
     }
   this->CacheSize = csk->GetCacheSize();
+  this->NumberOfHits = csk->GetNumberOfHits();
+  this->NumberOfMisses = csk->GetNumberOfMisses();
+  this->NumberOfEvictions = csk->GetNumberOfEvictions();
+  this->NumberOfCachedTimes = csk->GetNumberOfCachedTimes();
 }
 
 //-----------------------------------------------------------------------------
@@ -57,6 +66,10 @@ void vtkPVCacheSizeInformation::CopyToStream(vtkClientServerStream* stream)
   stream->Reset();
   *stream << vtkClientServerStream::Reply
     << this->CacheSize
+    << this->NumberOfHits
+    << this->NumberOfMisses
+    << this->NumberOfEvictions
+    << this->NumberOfCachedTimes
     << vtkClientServerStream::End;
 }
 
@@ -68,6 +81,13 @@ void vtkPVCacheSizeInformation::CopyFromStream(const vtkClientServerStream* stre
     {
     vtkErrorMacro("Error parsing CacheSize.");
     }
+  if (!stream->GetArgument(0, 1, &this->NumberOfHits) ||
+    !stream->GetArgument(0, 2, &this->NumberOfMisses) ||
+    !stream->GetArgument(0, 3, &this->NumberOfEvictions) ||
+    !stream->GetArgument(0, 4, &this->NumberOfCachedTimes))
+    {
+    vtkErrorMacro("Error parsing cache statistics.");
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -81,6 +101,15 @@ void vtkPVCacheSizeInformation::AddInformation(vtkPVInformation* info)
     }
   this->CacheSize = (cinfo->CacheSize > this->CacheSize)?
     cinfo->CacheSize : this->CacheSize;
+  this->NumberOfHits = (cinfo->NumberOfHits > this->NumberOfHits)?
+    cinfo->NumberOfHits : this->NumberOfHits;
+  this->NumberOfMisses = (cinfo->NumberOfMisses > this->NumberOfMisses)?
+    cinfo->NumberOfMisses : this->NumberOfMisses;
+  this->NumberOfEvictions = (cinfo->NumberOfEvictions > this->NumberOfEvictions)?
+    cinfo->NumberOfEvictions : this->NumberOfEvictions;
+  this->NumberOfCachedTimes =
+    (cinfo->NumberOfCachedTimes > this->NumberOfCachedTimes)?
+    cinfo->NumberOfCachedTimes : this->NumberOfCachedTimes;
 }
 
 
@@ -89,4 +118,8 @@ void vtkPVCacheSizeInformation::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "CacheSize: " << this->CacheSize << endl;
+  os << indent << "NumberOfHits: " << this->NumberOfHits << endl;
+  os << indent << "NumberOfMisses: " << this->NumberOfMisses << endl;
+  os << indent << "NumberOfEvictions: " << this->NumberOfEvictions << endl;
+  os << indent << "NumberOfCachedTimes: " << this->NumberOfCachedTimes << endl;
 }
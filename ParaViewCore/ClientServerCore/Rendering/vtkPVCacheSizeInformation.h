@@ -16,6 +16,10 @@
 // collect cache size information from a vtkCacheSizeKeeper.
 // .SECTION Description
 // Gather information about cache size from vtkCacheSizeKeeper.
+// Along with the cache size, the cache statistics (hits, misses and
+// evictions) are gathered. When gathered from the global id 0, the
+// vtkCacheSizeKeeper singleton is used. When gathering from several
+// processes, the maximum over all processes is reported.
 
 #ifndef __vtkPVCacheSizeInformation_h
 #define __vtkPVCacheSizeInformation_h
@@ -47,11 +51,22 @@ public:
 
   vtkGetMacro(CacheSize, unsigned long);
   vtkSetMacro(CacheSize, unsigned long);
+
+  // Description:
+  // Cache statistics, see vtkCacheSizeKeeper.
+  vtkGetMacro(NumberOfHits, unsigned long);
+  vtkGetMacro(NumberOfMisses, unsigned long);
+  vtkGetMacro(NumberOfEvictions, unsigned long);
+  vtkGetMacro(NumberOfCachedTimes, int);
 protected:
   vtkPVCacheSizeInformation();
   ~vtkPVCacheSizeInformation();
 
   unsigned long CacheSize;
+  unsigned long NumberOfHits;
+  unsigned long NumberOfMisses;
+  unsigned long NumberOfEvictions;
+  int NumberOfCachedTimes;
 private:
   vtkPVCacheSizeInformation(const vtkPVCacheSizeInformation&); // Not implemented.
   void operator=(const vtkPVCacheSizeInformation&); // Not implemented.
@@ -14,16 +14,76 @@
 =========================================================================*/
 #include "vtkPVClientServerSynchronizedRenderers.h"
 
+#include "vtkImageCompressor.h"
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkOpenGLRenderer.h"
-#include "vtkSquirtCompressor.h"
+#include "vtkPVTimerInformation.h"
+#include "vtkPVTraceEventRecorder.h"
+#include "vtkTimerLog.h"
 #include "vtkUnsignedCharArray.h"
-#include "vtkZlibImageCompressor.h"
 
 #include <sstream>
 #include <assert.h>
 
+namespace
+{
+  // Settings walked by the adaptive compression, ordered from the cheapest to
+  // encode to the smallest to transmit.
+  struct vtkAdaptiveSetting
+    {
+    const char* Compressor;
+    int ReductionFactor;
+    };
+
+  const vtkAdaptiveSetting ADAPTIVE_SETTINGS[] = {
+      { "NULL", 1 },
+      { "vtkLZ4ImageCompressor 0 0", 1 },
+      { "vtkSquirtCompressor 0 3", 1 },
+      { "vtkZlibImageCompressor 0 1 3 1", 1 },
+      { "vtkZlibImageCompressor 0 6 3 1", 1 },
+      { "vtkZlibImageCompressor 0 6 3 1", 2 },
+      { "vtkZlibImageCompressor 0 6 3 1", 3 },
+      { "vtkZlibImageCompressor 0 6 3 1", 4 }
+  };
+
+  const int NUMBER_OF_ADAPTIVE_SETTINGS =
+    static_cast<int>(sizeof(ADAPTIVE_SETTINGS) / sizeof(vtkAdaptiveSetting));
+
+  // Matches the default compressor configuration.
+  const int DEFAULT_ADAPTIVE_LEVEL = 2;
+
+  // Number of frames to measure before changing the level again.
+  const int ADAPTIVE_SETTLE_FRAMES = 3;
+
+  // Weight of the last frame in the running averages.
+  const double ADAPTIVE_SMOOTHING = 0.3;
+
+  // Picks every factor-th pixel of every factor-th row.
+  void SubSample(vtkUnsignedCharArray* input, int width, int height,
+    int factor, vtkUnsignedCharArray* output, int& outWidth, int& outHeight)
+    {
+    const int numComps = input->GetNumberOfComponents();
+    outWidth = (width + factor - 1) / factor;
+    outHeight = (height + factor - 1) / factor;
+    output->SetNumberOfComponents(numComps);
+    output->SetNumberOfTuples(outWidth * outHeight);
+    const unsigned char* in = input->GetPointer(0);
+    unsigned char* out = output->GetPointer(0);
+    for (int y = 0; y < height; y += factor)
+      {
+      const unsigned char* row = in + static_cast<size_t>(y) * width * numComps;
+      for (int x = 0; x < width; x += factor)
+        {
+        for (int cc = 0; cc < numComps; ++cc)
+          {
+          *out++ = row[x * numComps + cc];
+          }
+        }
+      }
+    }
+}
+
 vtkStandardNewMacro(vtkPVClientServerSynchronizedRenderers);
 vtkCxxSetObjectMacro(vtkPVClientServerSynchronizedRenderers, Compressor,
   vtkImageCompressor);
@@ -31,6 +91,18 @@ vtkCxxSetObjectMacro(vtkPVClientServerSynchronizedRenderers, Compressor,
 vtkPVClientServerSynchronizedRenderers::vtkPVClientServerSynchronizedRenderers()
 {
   this->Compressor = NULL;
+  this->CompressorConfiguration = NULL;
+  this->AdaptiveCompression = false;
+  this->TargetInteractiveFrameRate = 10.0;
+  this->AdaptiveLevel = -1;
+  this->TransmitReductionFactor = 1;
+  this->FramesSinceLevelChange = 0;
+  this->MeasuredBandwidth = 0.0;
+  this->MeasuredFrameTime = 0.0;
+  this->MeasuredTransferTime = 0.0;
+  this->MeasuredBytesPerFrame = 0.0;
+  this->RenderStartTime = 0.0;
+  this->ReducedTransmitImage = vtkUnsignedCharArray::New();
   this->ConfigureCompressor("vtkSquirtCompressor 0 3");
   this->LossLessCompression = true;
 }
@@ -39,6 +111,35 @@ vtkPVClientServerSynchronizedRenderers::vtkPVClientServerSynchronizedRenderers()
 vtkPVClientServerSynchronizedRenderers::~vtkPVClientServerSynchronizedRenderers()
 {
   this->SetCompressor(NULL);
+  this->SetCompressorConfiguration(NULL);
+  this->ReducedTransmitImage->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVClientServerSynchronizedRenderers::MasterStartRender()
+{
+  this->Superclass::MasterStartRender();
+  this->RenderStartTime = vtkTimerLog::GetUniversalTime();
+
+  if (this->AdaptiveCompression)
+    {
+    // let the server know which compressor to use for this frame.
+    int level = this->AdaptiveLevel;
+    this->ParallelController->Send(&level, 1, 1, 0x023431);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVClientServerSynchronizedRenderers::SlaveStartRender()
+{
+  this->Superclass::SlaveStartRender();
+
+  if (this->AdaptiveCompression)
+    {
+    int level = DEFAULT_ADAPTIVE_LEVEL;
+    this->ParallelController->Receive(&level, 1, 1, 0x023431);
+    this->SetAdaptiveLevel(level);
+    }
 }
 
 
@@ -57,18 +158,35 @@ void vtkPVClientServerSynchronizedRenderers::MasterEndRender()
   if (header[0] > 0)
     {
     rawImage.Resize(header[1], header[2], header[3]);
+    // the server compresses the image before sending the header, hence the
+    // time spent receiving the image is mostly the transfer time.
+    double transferStart = vtkTimerLog::GetUniversalTime();
+    vtkIdType numberOfBytes = 0;
     if (this->Compressor)
       {
       vtkUnsignedCharArray* data = vtkUnsignedCharArray::New();
       this->ParallelController->Receive(data, 1, 0x023430);
+      numberOfBytes = data->GetNumberOfTuples() * data->GetNumberOfComponents();
       this->Decompress(data, rawImage.GetRawPtr());
       data->Delete();
       }
     else
       {
       this->ParallelController->Receive(rawImage.GetRawPtr(), 1, 0x023430);
+      numberOfBytes = static_cast<vtkIdType>(header[1]) * header[2] * header[3];
       }
+    double transferTime = vtkTimerLog::GetUniversalTime() - transferStart;
+    double traceEnd = vtkPVTraceEventRecorder::GetTime();
+    vtkPVTraceEventRecorder::AddEvent("compositing", "Receive image",
+      traceEnd - transferTime, traceEnd, numberOfBytes);
     rawImage.MarkValid();
+
+    if (!this->LossLessCompression)
+      {
+      this->UpdateAdaptiveLevel(
+        vtkTimerLog::GetUniversalTime() - this->RenderStartTime,
+        transferTime, numberOfBytes);
+      }
     }
 }
 
@@ -87,12 +205,30 @@ void vtkPVClientServerSynchronizedRenderers::SlaveEndRender()
   header[3] = rawImage.IsValid()?
     rawImage.GetRawPtr()->GetNumberOfComponents() : 0;
 
+  // compress the image before sending the header so that the client can
+  // measure the transfer time alone.
+  vtkUnsignedCharArray* data = NULL;
+  if (rawImage.IsValid())
+    {
+    data = rawImage.GetRawPtr();
+    if (this->TransmitReductionFactor > 1 && !this->LossLessCompression)
+      {
+      SubSample(data, header[1], header[2], this->TransmitReductionFactor,
+        this->ReducedTransmitImage, header[1], header[2]);
+      data = this->ReducedTransmitImage;
+      }
+    vtkPVTraceEventScope traceEvent("compositing", "Compress image");
+    data = this->Compress(data);
+    }
+
   // send the image to the client.
+  vtkPVTraceEventScope traceEvent("compositing", "Send image");
   this->ParallelController->Send(header, 4, 1, 0x023430);
-  if (rawImage.IsValid())
+  if (data)
     {
-    this->ParallelController->Send(
-      this->Compress(rawImage.GetRawPtr()), 1, 0x023430);
+    this->ParallelController->Send(data, 1, 0x023430);
+    traceEvent.SetBytes(
+      data->GetNumberOfTuples() * data->GetNumberOfComponents());
     }
 }
 
@@ -141,6 +277,23 @@ void vtkPVClientServerSynchronizedRenderers::ConfigureCompressor(const char *str
 {
   // cerr << this->GetClassName() << "::ConfigureCompressor " << stream << endl;
 
+  // remember the user's choice to restore it when adaptive compression is
+  // turned off.
+  this->SetCompressorConfiguration(stream);
+  if (!this->AdaptiveCompression)
+    {
+    this->SetupCompressor(stream);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVClientServerSynchronizedRenderers::SetupCompressor(const char *stream)
+{
+  if (!stream)
+    {
+    return;
+    }
+
   // Configure the compressor from a string. The string will
   // contain the class name of the compressor type to use,
   // follwed by a stream that the named class will restore itself
@@ -152,20 +305,13 @@ void vtkPVClientServerSynchronizedRenderers::ConfigureCompressor(const char *str
   // Allocate the desired compressor unless we have one in hand.
   if (!(this->Compressor && this->Compressor->IsA(className.c_str())))
     {
-    vtkImageCompressor *comp=0;
-    if (className=="vtkSquirtCompressor")
-      {
-      comp=vtkSquirtCompressor::New();
-      }
-    else if (className=="vtkZlibImageCompressor")
-      {
-      comp=vtkZlibImageCompressor::New();
-      }
-    else if (className=="NULL" || className.empty())
+    if (className=="NULL" || className.empty())
       {
       this->SetCompressor(0);
       return;
       }
+    vtkImageCompressor *comp =
+      vtkImageCompressor::NewCompressor(className.c_str());
     if (comp==0)
       {
       vtkWarningMacro("Could not create the compressor by name " << className << ".");
@@ -183,6 +329,115 @@ void vtkPVClientServerSynchronizedRenderers::ConfigureCompressor(const char *str
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkPVClientServerSynchronizedRenderers::SetAdaptiveCompression(bool val)
+{
+  if (this->AdaptiveCompression == val)
+    {
+    return;
+    }
+
+  this->AdaptiveCompression = val;
+  this->AdaptiveLevel = -1;
+  if (val)
+    {
+    this->SetAdaptiveLevel(DEFAULT_ADAPTIVE_LEVEL);
+    }
+  else
+    {
+    this->TransmitReductionFactor = 1;
+    this->SetupCompressor(this->CompressorConfiguration);
+    this->ReportStatistics();
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVClientServerSynchronizedRenderers::SetAdaptiveLevel(int level)
+{
+  level = level < 0? 0 : level;
+  level = level >= NUMBER_OF_ADAPTIVE_SETTINGS?
+    NUMBER_OF_ADAPTIVE_SETTINGS - 1 : level;
+  if (this->AdaptiveLevel == level)
+    {
+    return;
+    }
+
+  this->AdaptiveLevel = level;
+  this->SetupCompressor(ADAPTIVE_SETTINGS[level].Compressor);
+  this->TransmitReductionFactor = ADAPTIVE_SETTINGS[level].ReductionFactor;
+  this->FramesSinceLevelChange = 0;
+  this->ReportStatistics();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVClientServerSynchronizedRenderers::UpdateAdaptiveLevel(
+  double frameTime, double transferTime, vtkIdType numberOfBytes)
+{
+  const double bandwidth = transferTime > 0.0?
+    numberOfBytes / (1024.0 * 1024.0) / transferTime : 0.0;
+  if (this->FramesSinceLevelChange == 0)
+    {
+    this->MeasuredFrameTime = frameTime;
+    this->MeasuredTransferTime = transferTime;
+    this->MeasuredBytesPerFrame = numberOfBytes;
+    }
+  else
+    {
+    this->MeasuredFrameTime += ADAPTIVE_SMOOTHING *
+      (frameTime - this->MeasuredFrameTime);
+    this->MeasuredTransferTime += ADAPTIVE_SMOOTHING *
+      (transferTime - this->MeasuredTransferTime);
+    this->MeasuredBytesPerFrame += ADAPTIVE_SMOOTHING *
+      (numberOfBytes - this->MeasuredBytesPerFrame);
+    }
+  // the bandwidth does not depend on the level, keep averaging it.
+  this->MeasuredBandwidth = this->MeasuredBandwidth > 0.0?
+    this->MeasuredBandwidth + ADAPTIVE_SMOOTHING *
+      (bandwidth - this->MeasuredBandwidth) : bandwidth;
+  this->FramesSinceLevelChange++;
+
+  if (this->AdaptiveCompression &&
+    this->FramesSinceLevelChange >= ADAPTIVE_SETTLE_FRAMES)
+    {
+    // Compress harder only when too slow because of the transfer, and go back
+    // to cheaper settings when well below the target.
+    const double targetFrameTime = 1.0 / this->TargetInteractiveFrameRate;
+    int level = this->AdaptiveLevel;
+    if (this->MeasuredFrameTime > 1.15 * targetFrameTime &&
+      this->MeasuredTransferTime > 0.25 * this->MeasuredFrameTime)
+      {
+      level++;
+      }
+    else if (this->MeasuredFrameTime < 0.6 * targetFrameTime)
+      {
+      level--;
+      }
+    // the server is told about the new level at the start of the next render.
+    this->SetAdaptiveLevel(level);
+    }
+  this->ReportStatistics();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVClientServerSynchronizedRenderers::ReportStatistics()
+{
+  vtkPVTimerInformation::SetStatistic("Image Compressor",
+    this->AdaptiveCompression?
+    ADAPTIVE_SETTINGS[this->AdaptiveLevel].Compressor :
+    this->CompressorConfiguration);
+  vtkPVTimerInformation::SetStatistic("Image Compressor Mode",
+    this->AdaptiveCompression? "adaptive" : "fixed");
+  vtkPVTimerInformation::SetStatistic("Image Transmit Reduction Factor",
+    this->TransmitReductionFactor);
+  vtkPVTimerInformation::SetStatistic("Image Bandwidth (MB/s)",
+    this->MeasuredBandwidth);
+  vtkPVTimerInformation::SetStatistic("Image Bytes Per Frame",
+    this->MeasuredBytesPerFrame);
+  vtkPVTimerInformation::SetStatistic("Interactive Frame Time (ms)",
+    this->MeasuredFrameTime * 1000.0);
+}
+
 //----------------------------------------------------------------------------
 void vtkPVClientServerSynchronizedRenderers::PushImageToScreen()
 {
@@ -209,4 +464,11 @@ void vtkPVClientServerSynchronizedRenderers::PushImageToScreen()
 void vtkPVClientServerSynchronizedRenderers::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "LossLessCompression: " << this->LossLessCompression << endl;
+  os << indent << "AdaptiveCompression: " << this->AdaptiveCompression << endl;
+  os << indent << "TargetInteractiveFrameRate: "
+     << this->TargetInteractiveFrameRate << endl;
+  os << indent << "AdaptiveLevel: " << this->AdaptiveLevel << endl;
+  os << indent << "MeasuredBandwidth: " << this->MeasuredBandwidth << endl;
+  os << indent << "MeasuredFrameTime: " << this->MeasuredFrameTime << endl;
 }
@@ -17,6 +17,18 @@
 // vtkPVClientServerSynchronizedRenderers is similar to
 // vtkClientServerSynchronizedRenderers except that it optionally uses image
 // compressors to compress the image before transmitting.
+//
+// When AdaptiveCompression is enabled, the compressor configured with
+// ConfigureCompressor() is ignored. Instead the client measures the round trip
+// time and the number of bytes received for every interactive frame and walks
+// a ladder of settings, from no compression to the most aggressive compressor
+// combined with sub-sampling of the transmitted image, in order to reach
+// TargetInteractiveFrameRate. The chosen setting is sent to the server at the
+// start of every render. The settings in use and the measured bandwidth are
+// reported through vtkPVTimerInformation. Only the client measures frames:
+// the bandwidth and frame time statistics are those of the client log, while
+// the log gathered from the servers only has the compressor and reduction
+// factor they use.
 
 #ifndef __vtkPVClientServerSynchronizedRenderers_h
 #define __vtkPVClientServerSynchronizedRenderers_h
@@ -47,6 +59,30 @@ public:
   // user settings.
   virtual void ConfigureCompressor(const char *stream);
 
+  // Description:
+  // Enable/Disable adaptive selection of the compressor and of the image
+  // sub-sampling used for interactive renders. This must be set identically
+  // on the client and the server.
+  void SetAdaptiveCompression(bool);
+  vtkGetMacro(AdaptiveCompression, bool);
+
+  // Description:
+  // Frame rate that adaptive compression tries to achieve for interactive
+  // renders. Default is 10.
+  vtkSetClampMacro(TargetInteractiveFrameRate, double, 0.1, 1000.0);
+  vtkGetMacro(TargetInteractiveFrameRate, double);
+
+  // Description:
+  // Returns the index of the setting currently chosen by adaptive compression,
+  // 0 being the fastest to encode and the largest to transmit.
+  vtkGetMacro(AdaptiveLevel, int);
+
+  // Description:
+  // Returns the bandwidth (in MB/s) and the round trip time (in seconds)
+  // measured over the last interactive frames.
+  vtkGetMacro(MeasuredBandwidth, double);
+  vtkGetMacro(MeasuredFrameTime, double);
+
 //BTX
 protected:
   vtkPVClientServerSynchronizedRenderers();
@@ -66,11 +102,48 @@ protected:
   vtkUnsignedCharArray* Compress(vtkUnsignedCharArray*);
   void Decompress(vtkUnsignedCharArray* input, vtkUnsignedCharArray* outputBuffer);
 
+  virtual void MasterStartRender();
+  virtual void SlaveStartRender();
   virtual void MasterEndRender();
   virtual void SlaveEndRender();
 
+  // Description:
+  // Creates and configures the compressor from the given configuration
+  // stream, without remembering it as the user requested configuration.
+  void SetupCompressor(const char* stream);
+
+  // Description:
+  // Applies the compressor and image sub-sampling for the given adaptive
+  // level.
+  void SetAdaptiveLevel(int level);
+
+  // Description:
+  // Updates the measurements with the last frame and picks the adaptive level
+  // to use for the next one.
+  void UpdateAdaptiveLevel(double frameTime, double transferTime,
+    vtkIdType numberOfBytes);
+
+  // Description:
+  // Reports the current settings and measurements to vtkPVTimerInformation.
+  void ReportStatistics();
+
   vtkImageCompressor* Compressor;
   bool LossLessCompression;
+
+  char* CompressorConfiguration;
+  vtkSetStringMacro(CompressorConfiguration);
+
+  bool AdaptiveCompression;
+  double TargetInteractiveFrameRate;
+  int AdaptiveLevel;
+  int TransmitReductionFactor;
+  int FramesSinceLevelChange;
+  double MeasuredBandwidth;
+  double MeasuredFrameTime;
+  double MeasuredTransferTime;
+  double MeasuredBytesPerFrame;
+  double RenderStartTime;
+  vtkUnsignedCharArray* ReducedTransmitImage;
 private:
   vtkPVClientServerSynchronizedRenderers(const vtkPVClientServerSynchronizedRenderers&); // Not implemented
   void operator=(const vtkPVClientServerSynchronizedRenderers&); // Not implemented
@@ -24,9 +24,11 @@
 #include "vtkObjectFactory.h"
 #include "vtkOrderedCompositeDistributor.h"
 #include "vtkPKdTree.h"
+#include "vtkPVDataDeltaEncoder.h"
 #include "vtkPVDataRepresentation.h"
 #include "vtkPVRenderView.h"
 #include "vtkPVStreamingMacros.h"
+#include "vtkPVTraceEventRecorder.h"
 #include "vtkPVTrivialProducer.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -93,6 +95,9 @@ public:
     // Data object for a streamed piece.
     vtkSmartPointer<vtkDataObject> StreamedPiece;
 
+    // Keeps track of the data delivered to the client to only send changes.
+    vtkSmartPointer<vtkPVDataDeltaEncoder> DeltaEncoder;
+
     unsigned long TimeStamp;
     unsigned long ActualMemorySize;
   public:
@@ -168,6 +173,15 @@ public:
     unsigned long GetTimeStamp() const
       { return this->TimeStamp; }
 
+    vtkPVDataDeltaEncoder* GetDeltaEncoder()
+      {
+      if (this->DeltaEncoder.GetPointer() == NULL)
+        {
+        this->DeltaEncoder = vtkSmartPointer<vtkPVDataDeltaEncoder>::New();
+        }
+      return this->DeltaEncoder;
+      }
+
     unsigned long GetVisibleDataSize()
       {
       if (this->Representation && this->Representation->GetVisibility())
@@ -232,6 +246,7 @@ vtkStandardNewMacro(vtkPVDataDeliveryManager);
 vtkPVDataDeliveryManager::vtkPVDataDeliveryManager()
   : Internals(new vtkInternals())
 {
+  this->UseDeltaDelivery = true;
 }
 
 //----------------------------------------------------------------------------
@@ -489,6 +504,8 @@ void vtkPVDataDeliveryManager::Deliver(int use_lod, unsigned int size, unsigned
 
   vtkTimerLog::MarkStartEvent(use_lod?
     "LowRes Data Migration" : "FullRes Data Migration");
+  vtkPVTraceEventScope traceEvent("delivery", use_lod?
+    "LowRes Data Migration" : "FullRes Data Migration");
 
   bool using_remote_rendering =
     use_lod? this->RenderView->GetUseDistributedRenderingForInteractiveRender() :
@@ -534,6 +551,8 @@ void vtkPVDataDeliveryManager::Deliver(int use_lod, unsigned int size, unsigned
         item->GatherBeforeDeliveringToClient == false);
       }
     dataMover->SetInputData(data);
+    dataMover->SetDeltaEncoder(item->GetDeltaEncoder());
+    dataMover->SetUseDeltaEncoding(this->UseDeltaDelivery);
 
     if (dataMover->GetOutputGeneratedOnProcess())
       {
@@ -597,6 +616,8 @@ void vtkPVDataDeliveryManager::RedistributeDataForOrderedCompositing(
     }
 
   vtkTimerLog::MarkStartEvent("Redistributing Data for Ordered Compositing");
+  vtkPVTraceEventScope traceEvent("delivery",
+    "Redistributing Data for Ordered Compositing");
   vtkInternals::ItemsMapType::iterator iter;
   for (iter = this->Internals->ItemsMap.begin();
     iter != this->Internals->ItemsMap.end(); ++iter)
@@ -757,6 +778,7 @@ void vtkPVDataDeliveryManager::DeliverStreamedPieces(
 void vtkPVDataDeliveryManager::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "UseDeltaDelivery: " << this->UseDeltaDelivery << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -108,6 +108,16 @@ public:
   // or a multi-block comprising of vtkPolyData is currently supported.
   void MarkAsRedistributable(vtkPVDataRepresentation*, bool value=true);
 
+  // Description:
+  // When set, the geometry delivered to the client for a representation only
+  // includes the points, cells and arrays that changed since the previous
+  // delivery of the same representation; the client reuses the others. Only
+  // the value set on the data server matters, the client follows it for each
+  // delivery. On by default.
+  vtkSetMacro(UseDeltaDelivery, bool);
+  vtkGetMacro(UseDeltaDelivery, bool);
+  vtkBooleanMacro(UseDeltaDelivery, bool);
+
   // Description:
   // Returns the size for all visible geometry. If low_res is true, and low-res
   // data is not available for a particular representation, then it's high-res
@@ -193,6 +203,7 @@ protected:
   vtkSmartPointer<vtkPKdTree> KdTree;
 
   vtkTimeStamp RedistributionTimeStamp;
+  bool UseDeltaDelivery;
 private:
   vtkPVDataDeliveryManager(const vtkPVDataDeliveryManager&); // Not implemented
   void operator=(const vtkPVDataDeliveryManager&); // Not implemented
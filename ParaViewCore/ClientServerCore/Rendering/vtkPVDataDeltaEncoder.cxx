@@ -0,0 +1,727 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVDataDeltaEncoder.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVDataDeltaEncoder.h"
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkDataArray.h"
+#include "vtkFieldData.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStringArray.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <map>
+#include <sstream>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+  typedef vtkTypeUInt64 vtkHashType;
+
+  // Name of the field data array listing the parts of an encoded leaf.
+  const char* MANIFEST_NAME = "vtkDeltaDeliveryManifest";
+
+  // Prefix of the field data arrays holding the parts that changed.
+  const char* DELTA_PREFIX = "vtkDelta";
+
+  // 64-bit FNV-1a, applied to 64-bit words rather than bytes for speed.
+  const vtkHashType FNV_OFFSET_BASIS =
+    (static_cast<vtkHashType>(0xcbf29ce4) << 32) | 0x84222325;
+  const vtkHashType FNV_PRIME =
+    (static_cast<vtkHashType>(0x00000100) << 32) | 0x000001b3;
+
+  vtkHashType vtkHash(const void* data, size_t size, vtkHashType hash)
+    {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    const size_t numWords = size / sizeof(vtkHashType);
+    for (size_t cc = 0; cc < numWords; ++cc)
+      {
+      vtkHashType word;
+      memcpy(&word, bytes + cc * sizeof(vtkHashType), sizeof(vtkHashType));
+      hash = (hash ^ word) * FNV_PRIME;
+      }
+    for (size_t cc = numWords * sizeof(vtkHashType); cc < size; ++cc)
+      {
+      hash = (hash ^ bytes[cc]) * FNV_PRIME;
+      }
+    return hash;
+    }
+
+  // A part of a leaf that is sent only when its content changes: its points,
+  // one of its topology arrays or one of its attribute arrays.
+  struct vtkComponent
+    {
+    // Kinds of components:
+    //   'P'                     points
+    //   'V', 'L', 'Y', 'S'      vertices, lines, polygons and strips of a
+    //                           vtkPolyData
+    //   'T', 'O', 'C', 'F', 'G' cell types, cell locations, connectivity,
+    //                           faces and face locations of a
+    //                           vtkUnstructuredGrid
+    //   'p', 'c', 'f'           point, cell and field data arrays
+    char Kind;
+
+    // Number of cells for topology arrays, attribute type for point and cell
+    // data arrays (-1 when the array is not an attribute).
+    vtkIdType Extra;
+
+    std::string Key;
+    vtkAbstractArray* Array;
+    vtkHashType Hash;
+    bool Hashed;
+    };
+
+  struct vtkLeaf
+    {
+    unsigned int FlatIndex;
+    vtkDataObject* Data;
+    size_t Begin;
+    size_t End;
+    };
+
+  std::string vtkComponentKey(unsigned int flatIndex, char kind,
+    const char* name)
+    {
+    std::ostringstream key;
+    key << flatIndex << ":" << kind << ":" << (name? name : "");
+    return key.str();
+    }
+
+  void vtkAddComponent(std::vector<vtkComponent>& components,
+    unsigned int flatIndex, char kind, vtkIdType extra,
+    vtkAbstractArray* array)
+    {
+    if (array == NULL)
+      {
+      return;
+      }
+    vtkComponent component;
+    component.Kind = kind;
+    component.Extra = extra;
+    component.Key = vtkComponentKey(flatIndex, kind,
+      (kind == 'p' || kind == 'c' || kind == 'f')? array->GetName() : NULL);
+    component.Array = array;
+    component.Hash = 0;
+    component.Hashed = false;
+    components.push_back(component);
+    }
+
+  void vtkAddCells(std::vector<vtkComponent>& components,
+    unsigned int flatIndex, char kind, vtkCellArray* cells)
+    {
+    if (cells)
+      {
+      vtkAddComponent(components, flatIndex, kind,
+        cells->GetNumberOfCells(), cells->GetData());
+      }
+    }
+
+  void vtkAddArrays(std::vector<vtkComponent>& components,
+    unsigned int flatIndex, char kind, vtkFieldData* fd)
+    {
+    if (fd == NULL)
+      {
+      return;
+      }
+    vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fd);
+    for (int cc = 0; cc < fd->GetNumberOfArrays(); ++cc)
+      {
+      vtkAbstractArray* array = fd->GetAbstractArray(cc);
+      if (array)
+        {
+        vtkAddComponent(components, flatIndex, kind,
+          dsa? dsa->IsArrayAnAttribute(cc) : -1, array);
+        }
+      }
+    }
+
+  // Returns false if the leaf is not a type that can be encoded.
+  bool vtkCollectComponents(std::vector<vtkComponent>& components,
+    unsigned int flatIndex, vtkDataObject* data)
+    {
+    if (vtkPolyData* pd = vtkPolyData::SafeDownCast(data))
+      {
+      vtkAddComponent(components, flatIndex, 'P', 0,
+        pd->GetPoints()? pd->GetPoints()->GetData() : NULL);
+      vtkAddCells(components, flatIndex, 'V', pd->GetVerts());
+      vtkAddCells(components, flatIndex, 'L', pd->GetLines());
+      vtkAddCells(components, flatIndex, 'Y', pd->GetPolys());
+      vtkAddCells(components, flatIndex, 'S', pd->GetStrips());
+      }
+    else if (vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(data))
+      {
+      vtkAddComponent(components, flatIndex, 'P', 0,
+        ug->GetPoints()? ug->GetPoints()->GetData() : NULL);
+      vtkAddComponent(components, flatIndex, 'T', 0, ug->GetCellTypesArray());
+      vtkAddComponent(components, flatIndex, 'O', 0,
+        ug->GetCellLocationsArray());
+      vtkAddCells(components, flatIndex, 'C', ug->GetCells());
+      vtkAddComponent(components, flatIndex, 'F', 0, ug->GetFaces());
+      vtkAddComponent(components, flatIndex, 'G', 0, ug->GetFaceLocations());
+      }
+    else
+      {
+      return false;
+      }
+    vtkDataSet* ds = vtkDataSet::SafeDownCast(data);
+    vtkAddArrays(components, flatIndex, 'p', ds->GetPointData());
+    vtkAddArrays(components, flatIndex, 'c', ds->GetCellData());
+    vtkAddArrays(components, flatIndex, 'f', ds->GetFieldData());
+    return true;
+    }
+
+  vtkTypeInt64 vtkGetArraySize(vtkAbstractArray* array)
+    {
+    vtkDataArray* da = vtkDataArray::SafeDownCast(array);
+    if (da)
+      {
+      return static_cast<vtkTypeInt64>(da->GetNumberOfTuples()) *
+        da->GetNumberOfComponents() * da->GetDataTypeSize();
+      }
+    return static_cast<vtkTypeInt64>(array->GetActualMemorySize()) * 1024;
+    }
+
+  // Hashes the content of the data arrays among the components. Other arrays
+  // (e.g. string arrays) are left unhashed and are always sent.
+  class vtkHashComponents
+    {
+  public:
+    std::vector<vtkComponent>* Components;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType cc = begin; cc < end; ++cc)
+        {
+        vtkComponent& component = (*this->Components)[cc];
+        // Arrays are matched by name, unnamed arrays are always sent.
+        vtkDataArray* array = vtkDataArray::SafeDownCast(component.Array);
+        if (array == NULL || (strchr("pcf", component.Kind) &&
+            (array->GetName() == NULL || array->GetName()[0] == 0)))
+          {
+          continue;
+          }
+        int header[3] = { array->GetDataType(),
+          array->GetNumberOfComponents(), component.Kind };
+        vtkIdType numTuples = array->GetNumberOfTuples();
+        const char* name = array->GetName()? array->GetName() : "";
+        vtkHashType hash = vtkHash(name, strlen(name), FNV_OFFSET_BASIS);
+        hash = vtkHash(header, sizeof(header), hash);
+        hash = vtkHash(&numTuples, sizeof(numTuples), hash);
+        if (numTuples > 0)
+          {
+          hash = vtkHash(array->GetVoidPointer(0),
+            static_cast<size_t>(vtkGetArraySize(array)), hash);
+          }
+        component.Hash = hash;
+        component.Hashed = true;
+        }
+      }
+    };
+
+  // Returns the component of \c data matching an entry of the manifest.
+  vtkAbstractArray* vtkGetComponent(vtkDataObject* data, char kind,
+    const char* name)
+    {
+    vtkPolyData* pd = vtkPolyData::SafeDownCast(data);
+    vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(data);
+    vtkPointSet* ps = vtkPointSet::SafeDownCast(data);
+    if (ps == NULL)
+      {
+      return NULL;
+      }
+    switch (kind)
+      {
+    case 'P':
+      return ps->GetPoints()? ps->GetPoints()->GetData() : NULL;
+    case 'V':
+      return (pd && pd->GetVerts())? pd->GetVerts()->GetData() : NULL;
+    case 'L':
+      return (pd && pd->GetLines())? pd->GetLines()->GetData() : NULL;
+    case 'Y':
+      return (pd && pd->GetPolys())? pd->GetPolys()->GetData() : NULL;
+    case 'S':
+      return (pd && pd->GetStrips())? pd->GetStrips()->GetData() : NULL;
+    case 'T':
+      return ug? ug->GetCellTypesArray() : NULL;
+    case 'O':
+      return ug? ug->GetCellLocationsArray() : NULL;
+    case 'C':
+      return (ug && ug->GetCells())? ug->GetCells()->GetData() : NULL;
+    case 'F':
+      return ug? ug->GetFaces() : NULL;
+    case 'G':
+      return ug? ug->GetFaceLocations() : NULL;
+    case 'p':
+      return ps->GetPointData()->GetAbstractArray(name);
+    case 'c':
+      return ps->GetCellData()->GetAbstractArray(name);
+    case 'f':
+      return ps->GetFieldData()->GetAbstractArray(name);
+      }
+    return NULL;
+    }
+
+  vtkSmartPointer<vtkCellArray> vtkNewCells(vtkIdType numCells,
+    vtkAbstractArray* array)
+    {
+    vtkIdTypeArray* ids = vtkIdTypeArray::SafeDownCast(array);
+    if (ids == NULL)
+      {
+      return NULL;
+      }
+    vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+    cells->SetCells(numCells, ids);
+    return cells;
+    }
+}
+
+class vtkPVDataDeltaEncoder::vtkInternals
+{
+public:
+  // Sending side: hashes of the components sent by the last Encode().
+  std::map<std::string, vtkHashType> Hashes;
+
+  // Receiving side: the leaves rebuilt by the last Decode(), by flat index.
+  std::map<unsigned int, vtkSmartPointer<vtkDataObject> > Previous;
+
+  // Rebuilds an encoded leaf from its manifest and the previous leaf.
+  // Returns NULL on failure.
+  vtkSmartPointer<vtkDataObject> DecodeLeaf(
+    unsigned int flatIndex, vtkDataObject* leaf)
+    {
+    vtkFieldData* fd = leaf->GetFieldData();
+    vtkStringArray* manifest = fd? vtkStringArray::SafeDownCast(
+      fd->GetAbstractArray(MANIFEST_NAME)) : NULL;
+    if (manifest == NULL)
+      {
+      // Leaves sent whole are used as is.
+      return leaf;
+      }
+
+    std::map<unsigned int, vtkSmartPointer<vtkDataObject> >::iterator iter =
+      this->Previous.find(flatIndex);
+    vtkDataObject* previous =
+      iter != this->Previous.end()? iter->second.GetPointer() : NULL;
+    if (previous == NULL ||
+      strcmp(previous->GetClassName(), leaf->GetClassName()) != 0)
+      {
+      return NULL;
+      }
+
+    vtkSmartPointer<vtkDataObject> result;
+    result.TakeReference(leaf->NewInstance());
+    vtkPointSet* ds = vtkPointSet::SafeDownCast(result);
+    vtkPolyData* pd = vtkPolyData::SafeDownCast(result);
+    vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(result);
+    if (ds == NULL)
+      {
+      return NULL;
+      }
+
+    vtkAbstractArray* ugArrays[5] = { NULL, NULL, NULL, NULL, NULL };
+    vtkIdType ugNumCells = 0;
+    int numChanged = 0;
+    for (vtkIdType cc = 0; cc < manifest->GetNumberOfValues(); ++cc)
+      {
+      // Entries are "<kind><changed>:<extra>:<name>".
+      const std::string& entry = manifest->GetValue(cc);
+      size_t sep1 = entry.find(':');
+      size_t sep2 = sep1 == std::string::npos?
+        std::string::npos : entry.find(':', sep1 + 1);
+      if (sep1 != 2 || sep2 == std::string::npos)
+        {
+        return NULL;
+        }
+      const char kind = entry[0];
+      const bool changed = entry[1] == '1';
+      vtkIdType extra = 0;
+      std::istringstream(entry.substr(sep1 + 1, sep2 - sep1 - 1)) >> extra;
+      const std::string name = entry.substr(sep2 + 1);
+
+      vtkAbstractArray* array = NULL;
+      if (changed)
+        {
+        std::ostringstream deltaName;
+        deltaName << DELTA_PREFIX << numChanged++;
+        array = fd->GetAbstractArray(deltaName.str().c_str());
+        if (array)
+          {
+          array->SetName(name.empty()? NULL : name.c_str());
+          }
+        }
+      else
+        {
+        array = vtkGetComponent(previous, kind, name.c_str());
+        }
+      if (array == NULL)
+        {
+        return NULL;
+        }
+
+      switch (kind)
+        {
+      case 'P':
+        if (vtkDataArray::SafeDownCast(array))
+          {
+          vtkNew<vtkPoints> points;
+          points->SetData(vtkDataArray::SafeDownCast(array));
+          ds->SetPoints(points.GetPointer());
+          }
+        break;
+      case 'V':
+      case 'L':
+      case 'Y':
+      case 'S':
+        {
+        vtkSmartPointer<vtkCellArray> cells = vtkNewCells(extra, array);
+        if (pd == NULL || cells.GetPointer() == NULL)
+          {
+          return NULL;
+          }
+        if (kind == 'V')
+          {
+          pd->SetVerts(cells);
+          }
+        else if (kind == 'L')
+          {
+          pd->SetLines(cells);
+          }
+        else if (kind == 'Y')
+          {
+          pd->SetPolys(cells);
+          }
+        else
+          {
+          pd->SetStrips(cells);
+          }
+        }
+        break;
+      case 'T':
+      case 'O':
+      case 'C':
+      case 'F':
+      case 'G':
+        {
+        const char* ugKinds = "TOCFG";
+        ugArrays[strchr(ugKinds, kind) - ugKinds] = array;
+        }
+        if (kind == 'C')
+          {
+          ugNumCells = extra;
+          }
+        break;
+      case 'p':
+      case 'c':
+        {
+        vtkDataSetAttributes* dsa = kind == 'p'?
+          static_cast<vtkDataSetAttributes*>(ds->GetPointData()) :
+          static_cast<vtkDataSetAttributes*>(ds->GetCellData());
+        int index = dsa->AddArray(array);
+        if (extra >= 0)
+          {
+          dsa->SetActiveAttribute(index, static_cast<int>(extra));
+          }
+        }
+        break;
+      case 'f':
+        ds->GetFieldData()->AddArray(array);
+        break;
+      default:
+        return NULL;
+        }
+      }
+
+    if (ug && ugArrays[2])
+      {
+      vtkUnsignedCharArray* types =
+        vtkUnsignedCharArray::SafeDownCast(ugArrays[0]);
+      vtkIdTypeArray* locations = vtkIdTypeArray::SafeDownCast(ugArrays[1]);
+      vtkSmartPointer<vtkCellArray> cells =
+        vtkNewCells(ugNumCells, ugArrays[2]);
+      if (types == NULL || locations == NULL || cells.GetPointer() == NULL)
+        {
+        return NULL;
+        }
+      ug->SetCells(types, locations, cells,
+        vtkIdTypeArray::SafeDownCast(ugArrays[4]),
+        vtkIdTypeArray::SafeDownCast(ugArrays[3]));
+      }
+    return result;
+    }
+};
+
+vtkStandardNewMacro(vtkPVDataDeltaEncoder);
+//----------------------------------------------------------------------------
+vtkPVDataDeltaEncoder::vtkPVDataDeltaEncoder()
+{
+  this->Internals = new vtkInternals();
+  this->LastSentSize = 0;
+  this->LastSkippedSize = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkPVDataDeltaEncoder::~vtkPVDataDeltaEncoder()
+{
+  delete this->Internals;
+  this->Internals = NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataDeltaEncoder::Reset()
+{
+  this->Internals->Hashes.clear();
+  this->Internals->Previous.clear();
+  this->LastSentSize = 0;
+  this->LastSkippedSize = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkPVDataDeltaEncoder::Encode(vtkDataObject* data)
+{
+  this->LastSentSize = 0;
+  this->LastSkippedSize = 0;
+  if (data == NULL)
+    {
+    this->Internals->Hashes.clear();
+    return NULL;
+    }
+
+  // Collect the components of all the leaves to hash them together.
+  std::vector<vtkLeaf> leaves;
+  std::vector<vtkComponent> components;
+  vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(data);
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  if (cd)
+    {
+    iter.TakeReference(cd->NewIterator());
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      vtkLeaf leaf;
+      leaf.FlatIndex = iter->GetCurrentFlatIndex();
+      leaf.Data = iter->GetCurrentDataObject();
+      leaf.Begin = components.size();
+      if (!vtkCollectComponents(components, leaf.FlatIndex, leaf.Data))
+        {
+        leaf.Data = NULL;
+        }
+      leaf.End = components.size();
+      leaves.push_back(leaf);
+      }
+    }
+  else
+    {
+    vtkLeaf leaf;
+    leaf.FlatIndex = 0;
+    leaf.Data = data;
+    leaf.Begin = 0;
+    if (!vtkCollectComponents(components, 0, data))
+      {
+      leaf.Data = NULL;
+      }
+    leaf.End = components.size();
+    leaves.push_back(leaf);
+    }
+
+  vtkHashComponents hasher;
+  hasher.Components = &components;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(components.size()), 1, hasher);
+
+  std::map<std::string, vtkHashType> hashes;
+  std::vector<vtkSmartPointer<vtkDataObject> > encoded(leaves.size());
+  for (size_t cc = 0; cc < leaves.size(); ++cc)
+    {
+    const vtkLeaf& leaf = leaves[cc];
+    if (leaf.Data == NULL)
+      {
+      continue;
+      }
+    bool anyUnchanged = false;
+    for (size_t kk = leaf.Begin; kk < leaf.End; ++kk)
+      {
+      vtkComponent& component = components[kk];
+      if (component.Hashed)
+        {
+        hashes[component.Key] = component.Hash;
+        std::map<std::string, vtkHashType>::iterator prev =
+          this->Internals->Hashes.find(component.Key);
+        component.Hashed = prev != this->Internals->Hashes.end() &&
+          prev->second == component.Hash;
+        anyUnchanged = anyUnchanged || component.Hashed;
+        }
+      }
+    if (!anyUnchanged)
+      {
+      // Nothing to reuse, send the leaf as is.
+      for (size_t kk = leaf.Begin; kk < leaf.End; ++kk)
+        {
+        this->LastSentSize += vtkGetArraySize(components[kk].Array);
+        }
+      continue;
+      }
+
+    // From here on, Hashed tells whether the component is unchanged.
+    vtkSmartPointer<vtkDataObject> delta;
+    delta.TakeReference(leaf.Data->NewInstance());
+    vtkNew<vtkStringArray> manifest;
+    manifest->SetName(MANIFEST_NAME);
+    int numChanged = 0;
+    for (size_t kk = leaf.Begin; kk < leaf.End; ++kk)
+      {
+      const vtkComponent& component = components[kk];
+      const bool changed = !component.Hashed;
+      const char* name = component.Array->GetName();
+      std::ostringstream entry;
+      entry << component.Kind << (changed? '1' : '0') << ":"
+        << component.Extra << ":"
+        << ((component.Kind == 'p' || component.Kind == 'c' ||
+             component.Kind == 'f') && name? name : "");
+      manifest->InsertNextValue(entry.str());
+      if (changed)
+        {
+        // The legacy format drops point and cell data of datasets without
+        // points or cells, so the changed parts travel as field data.
+        std::ostringstream deltaName;
+        deltaName << DELTA_PREFIX << numChanged++;
+        vtkAbstractArray* copy = component.Array->NewInstance();
+        copy->DeepCopy(component.Array);
+        copy->SetName(deltaName.str().c_str());
+        delta->GetFieldData()->AddArray(copy);
+        copy->Delete();
+        this->LastSentSize += vtkGetArraySize(component.Array);
+        }
+      else
+        {
+        this->LastSkippedSize += vtkGetArraySize(component.Array);
+        }
+      }
+    delta->GetFieldData()->AddArray(manifest.GetPointer());
+    encoded[cc] = delta;
+    }
+  this->Internals->Hashes.swap(hashes);
+
+  if (cd == NULL)
+    {
+    vtkDataObject* result =
+      encoded[0].GetPointer()? encoded[0].GetPointer() : data;
+    result->Register(NULL);
+    return result;
+    }
+
+  vtkCompositeDataSet* result = cd->NewInstance();
+  result->CopyStructure(cd);
+  size_t cc = 0;
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+    iter->GoToNextItem(), ++cc)
+    {
+    result->SetDataSet(iter, encoded[cc].GetPointer()?
+      encoded[cc].GetPointer() : iter->GetCurrentDataObject());
+    }
+  return result;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVDataDeltaEncoder::Decode(vtkDataObject* data)
+{
+  if (data == NULL)
+    {
+    this->Internals->Previous.clear();
+    return true;
+    }
+
+  // Rebuild all the leaves before touching the data.
+  std::vector<unsigned int> flatIndices;
+  std::vector<vtkSmartPointer<vtkDataObject> > decoded;
+  vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(data);
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  bool success = true;
+  if (cd)
+    {
+    iter.TakeReference(cd->NewIterator());
+    for (iter->InitTraversal(); success && !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      flatIndices.push_back(iter->GetCurrentFlatIndex());
+      decoded.push_back(this->Internals->DecodeLeaf(
+          flatIndices.back(), iter->GetCurrentDataObject()));
+      success = decoded.back().GetPointer() != NULL;
+      }
+    }
+  else
+    {
+    flatIndices.push_back(0);
+    decoded.push_back(this->Internals->DecodeLeaf(0, data));
+    success = decoded.back().GetPointer() != NULL;
+    }
+
+  this->Internals->Previous.clear();
+  if (!success)
+    {
+    vtkDebugMacro("Cannot rebuild the data received, "
+      "the data it refers to was not received before.");
+    data->Initialize();
+    return false;
+    }
+
+  // Keep shallow copies so that arrays later added to or removed from the
+  // output do not change what the next transfer reuses. The arrays
+  // themselves are shared with the output, copying them would double the
+  // memory used by the delivered geometry.
+  for (size_t cc = 0; cc < decoded.size(); ++cc)
+    {
+    vtkSmartPointer<vtkDataObject> copy;
+    copy.TakeReference(decoded[cc]->NewInstance());
+    copy->ShallowCopy(decoded[cc]);
+    this->Internals->Previous[flatIndices[cc]] = copy;
+    }
+
+  if (cd)
+    {
+    size_t cc = 0;
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem(), ++cc)
+      {
+      if (decoded[cc].GetPointer() != iter->GetCurrentDataObject())
+        {
+        cd->SetDataSet(iter, decoded[cc]);
+        }
+      }
+    }
+  else if (decoded[0].GetPointer() != data)
+    {
+    data->ShallowCopy(decoded[0]);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataDeltaEncoder::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "LastSentSize: " << this->LastSentSize << endl;
+  os << indent << "LastSkippedSize: " << this->LastSkippedSize << endl;
+}
@@ -0,0 +1,88 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVDataDeltaEncoder.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVDataDeltaEncoder - sends only the parts of a data object that
+// changed since it was last sent.
+// .SECTION Description
+// vtkPVDataDeltaEncoder is used by vtkMPIMoveData to reduce the geometry
+// delivered from the data server to the client when a representation
+// updates, e.g. when only the arrays of a static mesh change.
+// On the sending side, Encode() hashes the points, the topology and the
+// arrays of each vtkPolyData and vtkUnstructuredGrid (or leaf of a composite
+// dataset) and returns a data object that holds, in its field data, only the
+// parts whose content changed since the previous call along with a manifest
+// describing how to rebuild the others. On the receiving side, Decode()
+// rebuilds the full data object reusing the parts of the data object it
+// previously decoded. Other types of data are sent as is.
+// The encoder on the sending side and the one on the receiving side must see
+// the same sequence of transfers, which is why vtkPVDataDeliveryManager keeps
+// one per representation on every process.
+// .SECTION See Also
+// vtkMPIMoveData vtkPVDataDeliveryManager
+
+#ifndef __vtkPVDataDeltaEncoder_h
+#define __vtkPVDataDeltaEncoder_h
+
+#include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
+#include "vtkObject.h"
+
+class vtkDataObject;
+
+class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkPVDataDeltaEncoder : public vtkObject
+{
+public:
+  static vtkPVDataDeltaEncoder* New();
+  vtkTypeMacro(vtkPVDataDeltaEncoder, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Returns a new data object to send in place of \c data. The caller is
+  // responsible for deleting it.
+  vtkDataObject* Encode(vtkDataObject* data);
+
+  // Description:
+  // Rebuilds, in place, a data object produced by Encode() on the sending
+  // side. Returns false, and initializes \c data, if the parts to reuse are
+  // not available. The receiver is then reset and can rebuild the data once
+  // the sender is reset too, as vtkMPIMoveData does.
+  // The arrays of \c data are kept, not copied, to rebuild the next data
+  // received: they must not be modified in place afterwards.
+  bool Decode(vtkDataObject* data);
+
+  // Description:
+  // Forgets the data previously sent or received so that the next transfer
+  // is complete.
+  void Reset();
+
+  // Description:
+  // Number of bytes of arrays sent and skipped by the last Encode().
+  vtkGetMacro(LastSentSize, vtkTypeInt64);
+  vtkGetMacro(LastSkippedSize, vtkTypeInt64);
+
+protected:
+  vtkPVDataDeltaEncoder();
+  ~vtkPVDataDeltaEncoder();
+
+  vtkTypeInt64 LastSentSize;
+  vtkTypeInt64 LastSkippedSize;
+
+private:
+  vtkPVDataDeltaEncoder(const vtkPVDataDeltaEncoder&); // Not implemented
+  void operator=(const vtkPVDataDeltaEncoder&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+};
+
+#endif
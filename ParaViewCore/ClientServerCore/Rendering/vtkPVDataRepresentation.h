@@ -140,6 +140,20 @@ public:
   // entry is cached.
   bool GetUsingCacheForUpdate();
 
+  // Description:
+  // Called by vtkPVView::Prefetch() to execute the pipeline for the given
+  // time and cache the result under the same cache key, without changing what
+  // the representation renders. Subclasses that support caching should
+  // override this. Default does nothing and returns false.
+  virtual bool Prefetch(double vtkNotUsed(time))
+    { return false; }
+
+  // Description:
+  // Called by vtkPVView::CancelPrefetch() when the time prefetched is not
+  // going to be rendered, to free what Prefetch() cached for it. Default does
+  // nothing.
+  virtual void CancelPrefetch(double vtkNotUsed(time)) {}
+
   vtkGetMacro(NeedUpdate,  bool);
 
   // Description:
@@ -58,6 +58,7 @@
 #include "vtkPVStreamingMacros.h"
 #include "vtkPVSynchronizedRenderer.h"
 #include "vtkPVSynchronizedRenderWindows.h"
+#include "vtkPVTraceEventRecorder.h"
 #include "vtkPVTrackballMultiRotate.h"
 #include "vtkPVTrackballRoll.h"
 #include "vtkPVTrackballRotate.h"
@@ -1125,6 +1126,7 @@ void vtkPVRenderView::SynchronizeForCollaboration()
 void vtkPVRenderView::Update()
 {
   vtkTimerLog::MarkStartEvent("RenderView::Update");
+  vtkPVTraceEventScope traceEvent("pipeline", "RenderView::Update");
 
   // reset the bounds, so that representations can provide us with bounds
   // information during update.
@@ -1258,6 +1260,7 @@ void vtkPVRenderView::UpdateLOD()
 void vtkPVRenderView::StillRender()
 {
   vtkTimerLog::MarkStartEvent("Still Render");
+  vtkPVTraceEventScope traceEvent("rendering", "Still Render");
   this->GetRenderWindow()->SetDesiredUpdateRate(0.002);
 
   this->Internals->PreRender(this->RenderView);
@@ -1271,6 +1274,7 @@ void vtkPVRenderView::StillRender()
 void vtkPVRenderView::InteractiveRender()
 {
   vtkTimerLog::MarkStartEvent("Interactive Render");
+  vtkPVTraceEventScope traceEvent("rendering", "Interactive Render");
   this->GetRenderWindow()->SetDesiredUpdateRate(5.0);
 
   this->Internals->PreRender(this->RenderView);
@@ -1999,6 +2003,18 @@ void vtkPVRenderView::ConfigureCompressor(const char* configuration)
   this->SynchronizedRenderers->ConfigureCompressor(configuration);
 }
 
+//----------------------------------------------------------------------------
+void vtkPVRenderView::SetAdaptiveCompression(bool val)
+{
+  this->SynchronizedRenderers->SetAdaptiveCompression(val);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVRenderView::SetTargetInteractiveFrameRate(double val)
+{
+  this->SynchronizedRenderers->SetTargetInteractiveFrameRate(val);
+}
+
 //----------------------------------------------------------------------------
 void vtkPVRenderView::InvalidateCachedSelection()
 {
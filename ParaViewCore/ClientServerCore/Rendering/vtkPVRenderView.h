@@ -220,6 +220,16 @@ public:
   // @CallOnAllProcessess
   void ConfigureCompressor(const char* configuration);
 
+  // Description:
+  // Enable/Disable adaptive selection of the image compression and
+  // sub-sampling used to relay interactive renders back to the client, and
+  // set the frame rate it aims for.
+  // See vtkPVClientServerSynchronizedRenderers::SetAdaptiveCompression() for
+  // details.
+  // @CallOnAllProcessess
+  void SetAdaptiveCompression(bool);
+  void SetTargetInteractiveFrameRate(double);
+
   // Description:
   // Resets the clipping range. One does not need to call this directly ever. It
   // is called periodically by the vtkRenderer to reset the camera range.
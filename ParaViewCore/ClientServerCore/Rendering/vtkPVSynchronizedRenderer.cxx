@@ -281,6 +281,36 @@ void vtkPVSynchronizedRenderer::ConfigureCompressor(const char* configuration)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkPVSynchronizedRenderer::SetAdaptiveCompression(bool val)
+{
+  vtkPVClientServerSynchronizedRenderers* cssync =
+    vtkPVClientServerSynchronizedRenderers::SafeDownCast(this->CSSynchronizer);
+  if (cssync)
+    {
+    cssync->SetAdaptiveCompression(val);
+    }
+  else
+    {
+    vtkDebugMacro("Not in client-server mode.");
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVSynchronizedRenderer::SetTargetInteractiveFrameRate(double val)
+{
+  vtkPVClientServerSynchronizedRenderers* cssync =
+    vtkPVClientServerSynchronizedRenderers::SafeDownCast(this->CSSynchronizer);
+  if (cssync)
+    {
+    cssync->SetTargetInteractiveFrameRate(val);
+    }
+  else
+    {
+    vtkDebugMacro("Not in client-server mode.");
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkPVSynchronizedRenderer::SetImageProcessingPass(
   vtkImageProcessingPass* pass)
@@ -105,6 +105,14 @@ public:
   void ConfigureCompressor(const char* configuration);
   void SetLossLessCompression(bool);
 
+  // Description:
+  // Passes the adaptive compression parameters to the client-server
+  // synchronizer, if any.
+  // See vtkPVClientServerSynchronizedRenderers::SetAdaptiveCompression() for
+  // details.
+  void SetAdaptiveCompression(bool);
+  void SetTargetInteractiveFrameRate(double);
+
   // Description:
   // Activates or de-activated the use of Depth Buffer in an ImageProcessingPass
   void SetUseDepthBuffer(bool);
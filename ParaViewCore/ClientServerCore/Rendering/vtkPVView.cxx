@@ -264,14 +264,7 @@ void vtkPVView::Update()
   // Ensure that cache size if synchronized among the processes.
   if (this->GetUseCache())
     {
-    vtkCacheSizeKeeper* cacheSizeKeeper = vtkCacheSizeKeeper::GetInstance();
-    unsigned int cache_full = 0;
-    if (cacheSizeKeeper->GetCacheSize() > cacheSizeKeeper->GetCacheLimit())
-      {
-      cache_full = 1;
-      }
-    this->SynchronizedWindows->SynchronizeSize(cache_full);
-    cacheSizeKeeper->SetCacheFull(cache_full > 0);
+    this->SynchronizeCacheSize(this->CacheKey);
     }
 
   this->CallProcessViewRequest(vtkPVView::REQUEST_UPDATE(),
@@ -279,6 +272,67 @@ void vtkPVView::Update()
   vtkTimerLog::MarkEndEvent("vtkPVView::Update");
 }
 
+//----------------------------------------------------------------------------
+void vtkPVView::SynchronizeCacheSize(double cacheKey)
+{
+  vtkCacheSizeKeeper* cacheSizeKeeper = vtkCacheSizeKeeper::GetInstance();
+  if (cacheSizeKeeper->GetEvictionPolicy() != vtkCacheSizeKeeper::NO_EVICTION)
+    {
+    // All processes pick the cache times to evict in the same order, they
+    // only need to agree on how many.
+    vtkIdType count =
+      cacheSizeKeeper->GetNumberOfCacheTimesToEvict(cacheKey);
+    this->SynchronizedWindows->Reduce(count,
+      vtkPVSynchronizedRenderWindows::MAX_OP);
+    cacheSizeKeeper->EvictCacheTimes(count, cacheKey);
+    }
+  unsigned int cache_full = 0;
+  if (cacheSizeKeeper->GetCacheSize() > cacheSizeKeeper->GetCacheLimit())
+    {
+    cache_full = 1;
+    }
+  this->SynchronizedWindows->SynchronizeSize(cache_full);
+  cacheSizeKeeper->SetCacheFull(cache_full > 0);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVView::Prefetch(double time)
+{
+  vtkTimerLog::MarkStartEvent("vtkPVView::Prefetch");
+  this->SynchronizeCacheSize(time);
+  if (!vtkCacheSizeKeeper::GetInstance()->GetCacheFull())
+    {
+    // The cache fullness and the cached times are the same on all processes,
+    // hence all of them prefetch the same representations.
+    int num_reprs = this->GetNumberOfRepresentations();
+    for (int cc=0; cc < num_reprs; cc++)
+      {
+      vtkPVDataRepresentation* pvrepr =
+        vtkPVDataRepresentation::SafeDownCast(this->GetRepresentation(cc));
+      if (pvrepr)
+        {
+        pvrepr->Prefetch(time);
+        }
+      }
+    }
+  vtkTimerLog::MarkEndEvent("vtkPVView::Prefetch");
+}
+
+//----------------------------------------------------------------------------
+void vtkPVView::CancelPrefetch(double time)
+{
+  int num_reprs = this->GetNumberOfRepresentations();
+  for (int cc=0; cc < num_reprs; cc++)
+    {
+    vtkPVDataRepresentation* pvrepr =
+      vtkPVDataRepresentation::SafeDownCast(this->GetRepresentation(cc));
+    if (pvrepr)
+      {
+      pvrepr->CancelPrefetch(time);
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkPVView::CallProcessViewRequest(
   vtkInformationRequestKey* type, vtkInformation* inInfo, vtkInformationVector* outVec)
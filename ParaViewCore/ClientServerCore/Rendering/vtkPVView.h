@@ -147,6 +147,21 @@ public:
   // instead use ProcessViewRequest() for all vtkPVDataRepresentations.
   virtual void Update();
 
+  // Description:
+  // Prefetch the data for the given time into the representations' caches so
+  // that a subsequent Update() with UseCache and CacheKey set to \c time
+  // does not need to execute the pipeline. The time is used both as the view
+  // time and the cache key. This does not change what is being rendered.
+  // @CallOnAllProcessess
+  virtual void Prefetch(double time);
+
+  // Description:
+  // Frees what Prefetch() cached for the given time, unless it was rendered
+  // since. Used when the prefetched time is not going to be shown, e.g. when
+  // playback stops or jumps elsewhere.
+  // @CallOnAllProcessess
+  virtual void CancelPrefetch(double time);
+
   // Description:
   // Returns true if the application is currently in tile display mode.
   bool InTileDisplayMode();
@@ -205,6 +220,12 @@ protected:
   void CallProcessViewRequest(
     vtkInformationRequestKey* passType,
     vtkInformation* request, vtkInformationVector* reply);
+
+  // Description:
+  // Evicts cached data as needed to make room for \c cacheKey and
+  // synchronizes the cache fullness among all processes.
+  // @CallOnAllProcessess
+  void SynchronizeCacheSize(double cacheKey);
   double ViewTime;
 
   double CacheKey;
@@ -4,6 +4,8 @@
 #include "vtkDoubleArray.h"
 #include "vtkNew.h"
 
+#include <vector>
+
 static double dblIni[] = { 904., 906., 917. };
 static const char* strIni[] = { "901", "Turbo", "Targa" };
 
@@ -28,6 +30,14 @@ struct Help
       {
       return false;
       }
+    // Arrays are aligned in the stream whatever values precede them.
+    const T* view = 0;
+    vtkTypeUInt32 length = 0;
+    if(!css.GetArgument(0, arg-1, &view, &length) || length != 2 ||
+       view[0] != 12 || view[1] != 3)
+      {
+      return false;
+      }
     return true;
     }
 };
@@ -309,7 +319,138 @@ bool do_test()
   return true;
 }
 
+// Check arrays inserted by reference and read back in place.
+bool check_reference(const vtkClientServerStream& css, const double* values,
+                     const char* where)
+{
+  // The referenced doubles follow a one-byte value and precede floats.
+  const double* view = 0;
+  const float* floats = 0;
+  vtkTypeUInt32 length = 0;
+  vtkTypeUInt32 floatsLength = 0;
+  std::vector<double> copy(1000);
+  if(!css.GetArgument(0, 1, &view, &length) || length != 1000 ||
+     !css.GetArgument(0, 1, &copy[0], 1000) ||
+     !css.GetArgument(0, 2, &floats, &floatsLength) || floatsLength != 3)
+    {
+    cerr << "FAILED: Arrays could not be read in place " << where << "."
+         << endl;
+    return false;
+    }
+  if(values && view != values)
+    {
+    cerr << "FAILED: Referenced array was copied " << where << "." << endl;
+    return false;
+    }
+  for(vtkTypeUInt32 i = 0; i < length; ++i)
+    {
+    if(copy[i] != 0.5 * i || view[i] != 0.5 * i)
+      {
+      cerr << "FAILED: Referenced array values were not preserved "
+           << where << "." << endl;
+      return false;
+      }
+    }
+  if(floats[0] != 1 || floats[1] != 2 || floats[2] != 3)
+    {
+    cerr << "FAILED: Array after a referenced array was not preserved "
+         << where << "." << endl;
+    return false;
+    }
+  return true;
+}
+
+bool do_test_reference()
+{
+  vtkNew<vtkDoubleArray> values;
+  values->SetNumberOfTuples(1000);
+  for (vtkIdType i = 0; i < values->GetNumberOfTuples(); ++i)
+    {
+    values->SetValue(i, 0.5 * i);
+    }
+  const float floats[] = { 1, 2, 3 };
+
+  vtkClientServerStream css1;
+  css1 << vtkClientServerStream::Reply << 'x'
+       << vtkClientServerStream::InsertArrayReference(values.GetPointer())
+       << vtkClientServerStream::InsertArray(floats, 3)
+       << vtkClientServerStream::End;
+  if(css1.GetNumberOfDataSegments() != 3)
+    {
+    cerr << "FAILED: Referenced array was not kept as its own segment."
+         << endl;
+    return false;
+    }
+
+  // Reading the stream does not gather it.
+  if(!check_reference(css1, values->GetPointer(0), "before sending") ||
+     css1.GetNumberOfDataSegments() != 3)
+    {
+    return false;
+    }
+
+  // Copying the arguments to another stream, as the interpreter does,
+  // keeps the reference.
+  vtkClientServerStream css2;
+  css2 << vtkClientServerStream::Reply;
+  for(int a = 0; a < css1.GetNumberOfArguments(0); ++a)
+    {
+    css2 << css1.GetArgument(0, a);
+    }
+  css2 << vtkClientServerStream::End;
+  if(css2.GetNumberOfDataSegments() != 3 ||
+     !check_reference(css2, values->GetPointer(0), "after expanding"))
+    {
+    return false;
+    }
+
+  // Receive the segments directly into another stream as a vectored
+  // read would.
+  size_t size = 0;
+  for(int i = 0; i < css1.GetNumberOfDataSegments(); ++i)
+    {
+    const unsigned char* data;
+    size_t length;
+    if(!css1.GetDataSegment(i, &data, &length))
+      {
+      cerr << "FAILED: GetDataSegment failed." << endl;
+      return false;
+      }
+    size += length;
+    }
+  vtkClientServerStream css3;
+  unsigned char* buffer = css3.AllocateData(size);
+  for(int i = 0; buffer && i < css1.GetNumberOfDataSegments(); ++i)
+    {
+    const unsigned char* data;
+    size_t length;
+    css1.GetDataSegment(i, &data, &length);
+    memcpy(buffer, data, length);
+    buffer += length;
+    }
+  if(!buffer || !css3.CommitData())
+    {
+    cerr << "FAILED: Received segments could not be parsed." << endl;
+    return false;
+    }
+  if(!check_reference(css3, 0, "after receiving"))
+    {
+    return false;
+    }
+
+  // Getting the data gathers the stream into a single buffer.
+  const unsigned char* data;
+  size_t length;
+  if(!css1.GetData(&data, &length) || length != size ||
+     css1.GetNumberOfDataSegments() != 1)
+    {
+    cerr << "FAILED: Referenced array was not gathered." << endl;
+    return false;
+    }
+  return check_reference(css1, 0, "after gathering");
+}
+
 int coverClientServer(int, char*[])
 {
-  return do_test()? 0 : 1;
+  return (do_test() && do_test_reference())? 0 : 1;
 }
@@ -83,11 +83,13 @@ VTK_CLIENT_SERVER_TYPE_TRAIT(vtkTypeFloat64, float64);
 class vtkClientServerStreamInternals
 {
 public:
-  vtkClientServerStreamInternals(vtkObjectBase* owner): Objects(owner) {}
+  vtkClientServerStreamInternals(vtkObjectBase* owner): Objects(owner),
+                                                        ExternalSize(0) {}
   vtkClientServerStreamInternals(const vtkClientServerStreamInternals& r,
                                  vtkObjectBase* owner):
     Data(r.Data), ValueOffsets(r.ValueOffsets),
     MessageIndexes(r.MessageIndexes), Objects(r.Objects, owner),
+    ExternalSegments(r.ExternalSegments), ExternalSize(r.ExternalSize),
     StartIndex(r.StartIndex), Invalid(r.Invalid), String(r.String) {}
 
   // Actual binary data in the stream.
@@ -164,6 +166,170 @@ public:
   };
   ObjectsType Objects;
 
+  // Array payloads referenced by the stream instead of being copied
+  // into Data.  Each segment logically belongs right before the byte
+  // at InlineOffset in Data.  Holder keeps the referenced memory
+  // alive.
+  struct ExternalSegment
+  {
+    DataType::size_type InlineOffset;
+    const unsigned char* Data;
+    size_t Size;
+    vtkSmartPointer<vtkObjectBase> Holder;
+  };
+  typedef std::vector<ExternalSegment> ExternalSegmentsType;
+  ExternalSegmentsType ExternalSegments;
+
+  // Total number of bytes held in ExternalSegments.
+  size_t ExternalSize;
+
+  // Offset at which the next value written to the stream will be
+  // located once all external segments have been gathered.
+  DataType::difference_type GetWriteOffset() const
+    {
+    return static_cast<DataType::difference_type>(
+      this->Data.size() + this->ExternalSize);
+    }
+
+  // Reference the given memory as the next bytes of the stream.
+  void InsertExternal(const void* data, size_t size, vtkObjectBase* holder)
+    {
+    ExternalSegment segment;
+    segment.InlineOffset = this->Data.size();
+    segment.Data = static_cast<const unsigned char*>(data);
+    segment.Size = size;
+    segment.Holder = holder;
+    this->ExternalSegments.push_back(segment);
+    this->ExternalSize += size;
+    }
+
+  // Number of bytes in an element of an array of the given type, or 0
+  // if the type is not a numeric array.
+  static size_t GetArrayWordSize(vtkTypeUInt32 type)
+    {
+    switch(type)
+      {
+      case vtkClientServerStream::int8_array:
+      case vtkClientServerStream::uint8_array:
+        return 1;
+      case vtkClientServerStream::int16_array:
+      case vtkClientServerStream::uint16_array:
+        return 2;
+      case vtkClientServerStream::int32_array:
+      case vtkClientServerStream::uint32_array:
+      case vtkClientServerStream::float32_array:
+        return 4;
+      case vtkClientServerStream::int64_array:
+      case vtkClientServerStream::uint64_array:
+      case vtkClientServerStream::float64_array:
+        return 8;
+      default:
+        return 0;
+      }
+    }
+
+  // Number of zero bytes stored before array values starting at the
+  // given offset so that they are aligned to their word size.
+  static size_t GetArrayPadding(DataType::difference_type offset,
+                                size_t wordSize)
+    {
+    return wordSize > 1?
+      (wordSize - static_cast<size_t>(offset) % wordSize) % wordSize : 0;
+    }
+
+  // Write the padding needed before the values of an array of the
+  // given type.
+  void WriteArrayPadding(vtkTypeUInt32 type)
+    {
+    size_t padding = GetArrayPadding(this->GetWriteOffset(),
+                                     GetArrayWordSize(type));
+    this->Data.resize(this->Data.size() + padding, 0);
+    }
+
+  // Get the position in Data of the byte at the given offset of the
+  // gathered stream.  The byte must not belong to an external segment.
+  DataType::size_type GetInlineOffset(DataType::difference_type offset) const
+    {
+    DataType::size_type position =
+      static_cast<DataType::size_type>(offset);
+    for(ExternalSegmentsType::const_iterator i =
+          this->ExternalSegments.begin();
+        i != this->ExternalSegments.end() && position >= i->InlineOffset;
+        ++i)
+      {
+      position -= i->Size;
+      }
+    return position;
+    }
+
+  // Get the type, length and values of the array stored at the given
+  // offset of the gathered stream without gathering it.  Returns NULL
+  // if the value there is not a numeric array.  Holder is set to the
+  // object keeping referenced values alive, or NULL if the values are
+  // held in Data.
+  const unsigned char* GetArray(DataType::difference_type offset,
+                                vtkTypeUInt32* type, vtkTypeUInt32* length,
+                                vtkObjectBase** holder) const
+    {
+    const unsigned char* data =
+      &*this->Data.begin() + this->GetInlineOffset(offset);
+    memcpy(type, data, sizeof(*type));
+    memcpy(length, data + sizeof(*type), sizeof(*length));
+    size_t wordSize = GetArrayWordSize(*type);
+    if(!wordSize)
+      {
+      return 0;
+      }
+    offset += sizeof(*type) + sizeof(*length);
+    offset += GetArrayPadding(offset, wordSize);
+
+    // The values either start an external segment or follow the
+    // padding in Data.
+    DataType::size_type position =
+      static_cast<DataType::size_type>(offset);
+    for(ExternalSegmentsType::const_iterator i =
+          this->ExternalSegments.begin();
+        i != this->ExternalSegments.end() && position >= i->InlineOffset;
+        ++i)
+      {
+      if(position == i->InlineOffset)
+        {
+        *holder = i->Holder;
+        return i->Data;
+        }
+      position -= i->Size;
+      }
+    *holder = 0;
+    return &*this->Data.begin() + position;
+    }
+
+  // Copy all external segments into Data so that the stream is stored
+  // contiguously.  This releases the references to the holders.
+  void Gather()
+    {
+    if(this->ExternalSegments.empty())
+      {
+      return;
+      }
+    DataType gathered;
+    gathered.reserve(this->Data.size() + this->ExternalSize);
+    DataType::size_type inlineOffset = 0;
+    for(ExternalSegmentsType::const_iterator i =
+          this->ExternalSegments.begin();
+        i != this->ExternalSegments.end(); ++i)
+      {
+      gathered.insert(gathered.end(), this->Data.begin() + inlineOffset,
+                      this->Data.begin() + i->InlineOffset);
+      gathered.insert(gathered.end(), i->Data, i->Data + i->Size);
+      inlineOffset = i->InlineOffset;
+      }
+    gathered.insert(gathered.end(), this->Data.begin() + inlineOffset,
+                    this->Data.end());
+    this->Data.swap(gathered);
+    this->ExternalSegments.clear();
+    this->ExternalSize = 0;
+    }
+
   // Index into ValueOffsets where the last Command started.  Used to
   // detect valid message completion.
   static const ValueOffsetsType::size_type InvalidStartIndex;
@@ -182,6 +348,30 @@ public:
   static const unsigned char* GetValue(const vtkClientServerStream& css,
                                        int message, int value)
     { return css.GetValue(message, value); }
+
+  // Get the offset in the gathered stream of the given value of the
+  // given message, or -1 if there is no such value.
+  static DataType::difference_type
+  GetValueOffset(const vtkClientServerStream& css, int message, int value)
+    {
+    if(value >= 0 && value < css.GetNumberOfValues(message))
+      {
+      return css.Internal->ValueOffsets[
+        css.Internal->MessageIndexes[message] + value];
+      }
+    return -1;
+    }
+  static const unsigned char* GetArray(const vtkClientServerStream& css,
+                                       int message, int value,
+                                       vtkTypeUInt32* type,
+                                       vtkTypeUInt32* length)
+    {
+    DataType::difference_type offset =
+      GetValueOffset(css, message, value);
+    vtkObjectBase* holder;
+    return offset >= 0?
+      css.Internal->GetArray(offset, type, length, &holder) : 0;
+    }
 };
 
 const vtkClientServerStreamInternals::ValueOffsetsType::size_type
@@ -264,6 +454,8 @@ void vtkClientServerStream::Reset()
   this->Internal->MessageIndexes.erase(this->Internal->MessageIndexes.begin(),
                                        this->Internal->MessageIndexes.end());
   this->Internal->Objects.Clear();
+  this->Internal->ExternalSegments.clear();
+  this->Internal->ExternalSize = 0;
 
   // No message has yet been started.
   this->Internal->Invalid = 0;
@@ -298,7 +490,7 @@ vtkClientServerStream::operator << (vtkClientServerStream::Commands t)
 
   // The command counts as the first value in the message.
   this->Internal->ValueOffsets.push_back(
-    this->Internal->Data.end()-this->Internal->Data.begin());
+    this->Internal->GetWriteOffset());
 
   // Store the command in the stream.
   vtkTypeUInt32 data = static_cast<vtkTypeUInt32>(t);
@@ -333,7 +525,7 @@ vtkClientServerStream::operator << (vtkClientServerStream::Types t)
   // All values write their type first.  Mark the start of this type
   // and optional value.
   this->Internal->ValueOffsets.push_back(
-    this->Internal->Data.end()-this->Internal->Data.begin());
+    this->Internal->GetWriteOffset());
 
   // Store the type in the stream.
   vtkTypeUInt32 data = static_cast<vtkTypeUInt32>(t);
@@ -348,7 +540,7 @@ vtkClientServerStream::operator << (vtkClientServerStream::Argument a)
     {
     // Mark the start of this type and optional value.
     this->Internal->ValueOffsets.push_back(
-      this->Internal->Data.end()-this->Internal->Data.begin());
+      this->Internal->GetWriteOffset());
 
     // If the argument is a vtk_object_pointer, we need to store a
     // reference to the object.
@@ -361,8 +553,22 @@ vtkClientServerStream::operator << (vtkClientServerStream::Argument a)
       this->Internal->Objects.Insert(obj);
       }
 
-    // Write the data to the stream.
-    return this->Write(a.Data, a.Size);
+    // Write the data to the stream.  Array values are aligned again
+    // for their new position and stay referenced if they were.
+    this->Write(a.Data, a.Size);
+    if(vtkClientServerStreamInternals::GetArrayWordSize(tp))
+      {
+      this->Internal->WriteArrayPadding(tp);
+      if(a.ArrayHolder && a.ArrayData && a.ArraySize > 0)
+        {
+        this->Internal->InsertExternal(a.ArrayData, a.ArraySize,
+                                       a.ArrayHolder);
+        }
+      else
+        {
+        this->Write(a.ArrayData, a.ArraySize);
+        }
+      }
     }
   return *this;
 }
@@ -371,10 +577,20 @@ vtkClientServerStream::operator << (vtkClientServerStream::Argument a)
 vtkClientServerStream&
 vtkClientServerStream::operator << (vtkClientServerStream::Array a)
 {
-  // Store the array type, then length, then data.
+  // Store the array type, then length, then data.  The data are
+  // aligned to their word size so that they can be accessed in place.
+  // Referenced data are kept outside the stream buffer until gathered.
   *this << a.Type;
   this->Write(&a.Length, sizeof(a.Length));
-  this->Write(a.Data, a.Size);
+  this->Internal->WriteArrayPadding(a.Type);
+  if(a.Holder && a.Data && a.Size > 0)
+    {
+    this->Internal->InsertExternal(a.Data, a.Size, a.Holder);
+    }
+  else
+    {
+    this->Write(a.Data, a.Size);
+    }
 
   // Special case for InsertString.  We need to add the null terminator.
   if(a.Type == vtkClientServerStream::string_value)
@@ -571,7 +787,8 @@ vtkClientServerStream::InsertString(const char* begin, const char* end)
       vtkClientServerStream::string_value,
       static_cast<vtkTypeUInt32>(end-begin+1),
       static_cast<vtkTypeUInt32>(end-begin),
-      begin
+      begin,
+      0
     };
   return a;
 }
@@ -589,7 +806,8 @@ vtkClientServerStreamInsertArray(const T* data, int length)
       vtkClientServerTypeTraits<Type>::Array(),
       static_cast<vtkTypeUInt32>(length),
       static_cast<vtkTypeUInt32>(sizeof(Type)*length),
-      data
+      data,
+      0
     };
   return a;
 }
@@ -621,6 +839,29 @@ VTK_CLIENT_SERVER_INSERT_ARRAY(float)
 VTK_CLIENT_SERVER_INSERT_ARRAY(double)
 #undef VTK_CLIENT_SERVER_INSERT_ARRAY
 
+//----------------------------------------------------------------------------
+vtkClientServerStream::Array
+vtkClientServerStream::InsertArrayReference(vtkAbstractArray* array)
+{
+  vtkClientServerStream::Array a =
+    {
+      vtkClientServerStream::uint8_array, 0, 0, 0, 0
+    };
+  if(array && array->IsNumeric())
+    {
+    int length = static_cast<int>(array->GetNumberOfTuples() *
+                                  array->GetNumberOfComponents());
+    switch(array->GetDataType())
+      {
+      vtkTemplateMacro(
+        a = vtkClientServerStreamInsertArray(
+          static_cast<const VTK_TT*>(array->GetVoidPointer(0)), length));
+      }
+    a.Holder = array;
+    }
+  return a;
+}
+
 //----------------------------------------------------------------------------
 // Template to implement each type conversion in the lookup tables below.
 // The "long, long, long" arguments are used to convince VS6 to select
@@ -1016,29 +1257,19 @@ vtkClientServerStreamGetArgumentArray(const vtkClientServerStream* self,
                                       vtkTypeUInt32 length)
 {
   typedef VTK_CSS_TYPENAME vtkTypeTraits<T>::SizedType Type;
+  vtkTypeUInt32 tp;
+  vtkTypeUInt32 len;
   if(const unsigned char* data =
-     vtkClientServerStreamInternals::GetValue(*self, midx, 1+argument))
+     vtkClientServerStreamInternals::GetArray(*self, midx, 1+argument,
+                                              &tp, &len))
     {
-    // Get the type of the value in the stream.
-    vtkTypeUInt32 tp;
-    memcpy(&tp, data, sizeof(tp));
-    data += sizeof(tp);
-
-    // If the type and length of the array match, use it.
+    // If the type and length of the array match, copy the value out
+    // of the stream.
     if(static_cast<vtkClientServerStream::Types>(tp) ==
-       vtkClientServerTypeTraits<Type>::Array())
+       vtkClientServerTypeTraits<Type>::Array() && len == length)
       {
-      // Get the length of the value in the stream.
-      vtkTypeUInt32 len;
-      memcpy(&len, data, sizeof(len));
-      data += sizeof(len);
-
-      if(len == length)
-        {
-        // Copy the value out of the stream.
-        memcpy(value, data, len*sizeof(Type));
-        return 1;
-        }
+      memcpy(value, data, len*sizeof(Type));
+      return 1;
       }
     }
   return 0;
@@ -1073,6 +1304,69 @@ VTK_CSS_GET_ARGUMENT_ARRAY(unsigned __int64)
 #endif
 #undef VTK_CSS_GET_ARGUMENT_ARRAY
 
+//----------------------------------------------------------------------------
+// Template and macro to implement all in-place GetArgument methods for
+// arrays in the same way.
+template <class T>
+int
+vtkClientServerStreamGetArgumentArrayPointer(const vtkClientServerStream* self,
+                                             int midx, int argument,
+                                             const T** value,
+                                             vtkTypeUInt32* length)
+{
+  typedef VTK_CSS_TYPENAME vtkTypeTraits<T>::SizedType Type;
+  vtkTypeUInt32 tp;
+  vtkTypeUInt32 len;
+  if(const unsigned char* data =
+     vtkClientServerStreamInternals::GetArray(*self, midx, 1+argument,
+                                              &tp, &len))
+    {
+    // The array must be exactly of the requested type.  Values held
+    // in the stream buffer after referenced values whose size is not
+    // a multiple of their word size are misaligned until the stream
+    // is gathered.
+    if(static_cast<vtkClientServerStream::Types>(tp) ==
+       vtkClientServerTypeTraits<Type>::Array() &&
+       reinterpret_cast<size_t>(data) % sizeof(Type) == 0)
+      {
+      *value = reinterpret_cast<const T*>(data);
+      *length = len;
+      return 1;
+      }
+    }
+  return 0;
+}
+
+#define VTK_CSS_GET_ARGUMENT_ARRAY_POINTER(type)                         \
+  int vtkClientServerStream::GetArgument(int message, int argument,      \
+                                         const type** value,             \
+                                         vtkTypeUInt32* length) const    \
+  {                                                                      \
+    return vtkClientServerStreamGetArgumentArrayPointer(this, message,   \
+                                                        argument, value, \
+                                                        length);         \
+  }
+VTK_CSS_GET_ARGUMENT_ARRAY_POINTER(signed char)
+VTK_CSS_GET_ARGUMENT_ARRAY_POINTER(char)
+VTK_CSS_GET_ARGUMENT_ARRAY_POINTER(int)
+VTK_CSS_GET_ARGUMENT_ARRAY_POINTER(short)
+VTK_CSS_GET_ARGUMENT_ARRAY_POINTER(long)
+VTK_CSS_GET_ARGUMENT_ARRAY_POINTER(unsigned char)
+VTK_CSS_GET_ARGUMENT_ARRAY_POINTER(unsigned int)
+VTK_CSS_GET_ARGUMENT_ARRAY_POINTER(unsigned short)
+VTK_CSS_GET_ARGUMENT_ARRAY_POINTER(unsigned long)
+VTK_CSS_GET_ARGUMENT_ARRAY_POINTER(float)
+VTK_CSS_GET_ARGUMENT_ARRAY_POINTER(double)
+#if defined(VTK_TYPE_USE_LONG_LONG)
+VTK_CSS_GET_ARGUMENT_ARRAY_POINTER(long long)
+VTK_CSS_GET_ARGUMENT_ARRAY_POINTER(unsigned long long)
+#endif
+#if defined(VTK_TYPE_USE___INT64)
+VTK_CSS_GET_ARGUMENT_ARRAY_POINTER(__int64)
+VTK_CSS_GET_ARGUMENT_ARRAY_POINTER(unsigned __int64)
+#endif
+#undef VTK_CSS_GET_ARGUMENT_ARRAY_POINTER
+
 //----------------------------------------------------------------------------
 int vtkClientServerStream::GetArgument(int message, int argument,
                                        const char** value) const
@@ -1407,6 +1701,9 @@ int vtkClientServerStream::GetData(const unsigned char** data,
   // Do not return data unless stream is valid.
   if(!this->Internal->Invalid)
     {
+    // Referenced array data must be stored contiguously first.
+    this->Internal->Gather();
+
     if(data)
       {
       *data = &*this->Internal->Data.begin();
@@ -1434,19 +1731,76 @@ int vtkClientServerStream::GetData(const unsigned char** data,
 }
 
 //----------------------------------------------------------------------------
-int vtkClientServerStream::SetData(const unsigned char* data, size_t length)
+int vtkClientServerStream::GetNumberOfDataSegments() const
 {
-  // Reset and remove the byte order entry from the stream.
-  this->Reset();
-  this->Internal->Data.erase(this->Internal->Data.begin(),
-                             this->Internal->Data.end());
+  if(this->Internal->Invalid)
+    {
+    return 0;
+    }
+
+  // Every external segment is preceded by a piece of the stream
+  // buffer, and the buffer always has a trailing piece.
+  return static_cast<int>(2*this->Internal->ExternalSegments.size() + 1);
+}
+
+//----------------------------------------------------------------------------
+int vtkClientServerStream::GetDataSegment(int index,
+                                          const unsigned char** data,
+                                          size_t* length) const
+{
+  if(index < 0 || index >= this->GetNumberOfDataSegments())
+    {
+    return 0;
+    }
 
+  const vtkClientServerStreamInternals::ExternalSegmentsType& segments =
+    this->Internal->ExternalSegments;
+  const unsigned char* begin = &*this->Internal->Data.begin();
+  vtkClientServerStreamInternals::ExternalSegmentsType::size_type
+    segment = static_cast<size_t>(index/2);
+  if(index % 2)
+    {
+    // Odd indices are the referenced array data.
+    *data = segments[segment].Data;
+    *length = segments[segment].Size;
+    }
+  else
+    {
+    // Even indices are the pieces of the stream buffer between them.
+    size_t first = segment > 0? segments[segment-1].InlineOffset : 0;
+    size_t last = segment < segments.size()?
+      segments[segment].InlineOffset : this->Internal->Data.size();
+    *data = begin + first;
+    *length = last - first;
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkClientServerStream::SetData(const unsigned char* data, size_t length)
+{
   // Store the given data in the stream.
-  if(data)
+  unsigned char* buffer = this->AllocateData(data? length : 0);
+  if(buffer)
     {
-    this->Internal->Data.insert(this->Internal->Data.begin(), data, data+length);
+    memcpy(buffer, data, length);
     }
+  return this->CommitData();
+}
+
+//----------------------------------------------------------------------------
+unsigned char* vtkClientServerStream::AllocateData(size_t length)
+{
+  // Reset and replace the byte order entry with room for the data.
+  // The byte order is part of the data to come.
+  this->Reset();
+  this->Internal->Data.resize(length);
+  return length > 0? &*this->Internal->Data.begin() : 0;
+}
 
+//----------------------------------------------------------------------------
+int vtkClientServerStream::CommitData()
+{
   // Parse the stream to fill in ValueOffsets and MessageIndexes and
   // to perform byte-swapping if necessary.
   if(this->ParseData())
@@ -1512,13 +1866,13 @@ int vtkClientServerStream::ParseData()
           data = this->ParseValue(order, data, end, 1); break;
         case vtkClientServerStream::int8_array:
         case vtkClientServerStream::uint8_array:
-          data = this->ParseArray(order, data, end, 1); break;
+          data = this->ParseArray(order, data, begin, end, 1); break;
         case vtkClientServerStream::int16_value:
         case vtkClientServerStream::uint16_value:
           data = this->ParseValue(order, data, end, 2); break;
         case vtkClientServerStream::int16_array:
         case vtkClientServerStream::uint16_array:
-          data = this->ParseArray(order, data, end, 2); break;
+          data = this->ParseArray(order, data, begin, end, 2); break;
         case vtkClientServerStream::id_value:
         case vtkClientServerStream::int32_value:
         case vtkClientServerStream::uint32_value:
@@ -1527,7 +1881,7 @@ int vtkClientServerStream::ParseData()
         case vtkClientServerStream::int32_array:
         case vtkClientServerStream::uint32_array:
         case vtkClientServerStream::float32_array:
-          data = this->ParseArray(order, data, end, 4); break;
+          data = this->ParseArray(order, data, begin, end, 4); break;
         case vtkClientServerStream::int64_value:
         case vtkClientServerStream::uint64_value:
         case vtkClientServerStream::float64_value:
@@ -1535,11 +1889,11 @@ int vtkClientServerStream::ParseData()
         case vtkClientServerStream::int64_array:
         case vtkClientServerStream::uint64_array:
         case vtkClientServerStream::float64_array:
-          data = this->ParseArray(order, data, end, 8); break;
+          data = this->ParseArray(order, data, begin, end, 8); break;
         case vtkClientServerStream::string_value:
           data = this->ParseString(order, data, end); break;
         case vtkClientServerStream::stream_value:
-          data = this->ParseStream(order, data, end); break;
+          data = this->ParseStream(order, data, begin, end); break;
         case vtkClientServerStream::LastResult:
           // There are no data for this type.  Do nothing.
           break;
@@ -1636,6 +1990,7 @@ unsigned char* vtkClientServerStream::ParseValue(int order,
 //----------------------------------------------------------------------------
 unsigned char* vtkClientServerStream::ParseArray(int order,
                                                  unsigned char* data,
+                                                 unsigned char* begin,
                                                  unsigned char* end,
                                                  unsigned int wordSize)
 {
@@ -1650,6 +2005,16 @@ unsigned char* vtkClientServerStream::ParseArray(int order,
   memcpy(&length, data, sizeof(length));
   data += sizeof(length);
 
+  // Skip the padding that aligns the array data.
+  size_t padding =
+    vtkClientServerStreamInternals::GetArrayPadding(data - begin, wordSize);
+  if(data > end-padding)
+    {
+    /* ERROR */
+    return 0;
+    }
+  data += padding;
+
   // Calculate the size of the array data.
   vtkTypeUInt32 size = length*wordSize;
 
@@ -1695,10 +2060,11 @@ unsigned char* vtkClientServerStream::ParseString(int order,
 //----------------------------------------------------------------------------
 unsigned char* vtkClientServerStream::ParseStream(int order,
                                                   unsigned char* data,
+                                                  unsigned char* begin,
                                                   unsigned char* end)
 {
   // Stream data are represented as an array of bytes.
-  return this->ParseArray(order, data, end, 1);
+  return this->ParseArray(order, data, begin, end, 1);
 }
 
 //----------------------------------------------------------------------------
@@ -1782,13 +2148,13 @@ vtkClientServerStream::GetValue(int message, int value) const
 {
   if(value >= 0 && value < this->GetNumberOfValues(message))
     {
-    // Get the index to the beginning of the requested message.
-    vtkClientServerStreamInternals::ValueOffsetsType::size_type index =
-      this->Internal->MessageIndexes[message];
-
-    // Return a pointer to the value-th value in the message.
+    // Return a pointer to the value-th value in the message.  Only
+    // array values may be referenced outside the stream buffer, so
+    // the value itself is always held in it.
     const unsigned char* data = &*this->Internal->Data.begin();
-    return data + this->Internal->ValueOffsets[index + value];
+    return data + this->Internal->GetInlineOffset(
+      vtkClientServerStreamInternals::GetValueOffset(*this, message,
+                                                     value));
     }
   else
     {
@@ -1812,7 +2178,29 @@ vtkClientServerStream::Argument
 vtkClientServerStream::GetArgument(int message, int argument) const
 {
   // Prepare a return value.
-  vtkClientServerStream::Argument result = {0, 0};
+  vtkClientServerStream::Argument result = {0, 0, 0, 0, 0};
+
+  // Array values are returned separately from their type and length.
+  // The padding before them depends on where they are stored, and
+  // referenced values must stay referenced.
+  vtkClientServerStreamInternals::DataType::difference_type offset =
+    vtkClientServerStreamInternals::GetValueOffset(*this, message,
+                                                   1+argument);
+  vtkTypeUInt32 tp;
+  vtkTypeUInt32 len;
+  if(offset >= 0)
+    {
+    if(const unsigned char* data =
+       this->Internal->GetArray(offset, &tp, &len, &result.ArrayHolder))
+      {
+      result.Data = this->GetValue(message, 1+argument);
+      result.Size = sizeof(tp) + sizeof(len);
+      result.ArrayData = data;
+      result.ArraySize =
+        len*vtkClientServerStreamInternals::GetArrayWordSize(tp);
+      return result;
+      }
+    }
 
   // Get a pointer to the type/value pair in the stream.
   if(const unsigned char* data = this->GetValue(message, 1+argument))
@@ -1821,7 +2209,6 @@ vtkClientServerStream::GetArgument(int message, int argument) const
     result.Data = data;
 
     // Get the type of the value in the stream.
-    vtkTypeUInt32 tp;
     memcpy(&tp, data, sizeof(tp));
     data += sizeof(tp);
 
@@ -1830,8 +2217,6 @@ vtkClientServerStream::GetArgument(int message, int argument) const
       {
       VTK_CSS_TEMPLATE_MACRO(value, result.Size = sizeof(tp) +
                              vtkClientServerStreamValueSize(T));
-      VTK_CSS_TEMPLATE_MACRO(array, result.Size = sizeof(tp) +
-                             vtkClientServerStreamArraySize(data, T));
       case vtkClientServerStream::id_value:
         {
         result.Size = sizeof(tp) + sizeof(vtkClientServerID().ID);
@@ -27,6 +27,7 @@
 #include "vtkClientServerID.h"
 #include "vtkVariant.h"
 
+class vtkAbstractArray;
 class vtkClientServerStreamInternals;
 
 class VTKCLIENTSERVER_EXPORT vtkClientServerStream
@@ -171,6 +172,38 @@ public:
   // number of primitive stream entries required to describe it.
   int GetArgument(int message, int& argument, vtkVariant* value) const;
 
+  // Description:
+  // Get a pointer directly into the stream's memory for an argument
+  // of an array type, along with the array length, without copying
+  // the values.  Values referenced with InsertArrayReference are
+  // returned in their original memory.  The pointer is valid until
+  // the stream is next modified or destroyed.  Array values are
+  // aligned to their word size in the stream, so this succeeds for
+  // any array of exactly the requested type in a stream that was set
+  // or gathered.  Returns 0 if the argument is not such an array, or
+  // if values held in the stream buffer follow a referenced array
+  // whose size is not a multiple of their word size, in which case
+  // the copying form of GetArgument must be used instead.
+  int GetArgument(int message, int argument, const signed char** value, vtkTypeUInt32* length) const;
+  int GetArgument(int message, int argument, const char** value, vtkTypeUInt32* length) const;
+  int GetArgument(int message, int argument, const short** value, vtkTypeUInt32* length) const;
+  int GetArgument(int message, int argument, const int** value, vtkTypeUInt32* length) const;
+  int GetArgument(int message, int argument, const long** value, vtkTypeUInt32* length) const;
+  int GetArgument(int message, int argument, const unsigned char** value, vtkTypeUInt32* length) const;
+  int GetArgument(int message, int argument, const unsigned short** value, vtkTypeUInt32* length) const;
+  int GetArgument(int message, int argument, const unsigned int** value, vtkTypeUInt32* length) const;
+  int GetArgument(int message, int argument, const unsigned long** value, vtkTypeUInt32* length) const;
+  int GetArgument(int message, int argument, const float** value, vtkTypeUInt32* length) const;
+  int GetArgument(int message, int argument, const double** value, vtkTypeUInt32* length) const;
+#if defined(VTK_TYPE_USE_LONG_LONG)
+  int GetArgument(int message, int argument, const long long** value, vtkTypeUInt32* length) const;
+  int GetArgument(int message, int argument, const unsigned long long** value, vtkTypeUInt32* length) const;
+#endif
+#if defined(VTK_TYPE_USE___INT64)
+  int GetArgument(int message, int argument, const __int64** value, vtkTypeUInt32* length) const;
+  int GetArgument(int message, int argument, const unsigned __int64** value, vtkTypeUInt32* length) const;
+#endif
+
   // Description:
   // Get the length of an argument of an array type.  Returns whether
   // the argument is really an array type.
@@ -185,11 +218,18 @@ public:
 
   // Description:
   // Proxy-object returned by the two-argument form of GetArgument.
-  // This is suitable to be stored in another stream.
+  // This is suitable to be stored in another stream.  For a numeric
+  // array, Data and Size cover only its type and length while
+  // ArrayData and ArraySize give its values.  ArrayHolder is set when
+  // the values are referenced by the stream, and they are then
+  // referenced by the stream receiving the argument too.
   struct Argument
   {
     const unsigned char* Data;
     size_t Size;
+    const unsigned char* ArrayData;
+    size_t ArraySize;
+    vtkObjectBase* ArrayHolder;
   };
 
   // Description:
@@ -206,18 +246,35 @@ public:
   // Returns whether the stream is currently valid.
   int GetData(const unsigned char** data, size_t* length) const;
 
+  // Description:
+  // Get the stream data as a sequence of contiguous memory segments
+  // that, written one after another, produce exactly the bytes
+  // returned by GetData.  Array payloads inserted with
+  // InsertArrayReference are returned as their own segments pointing
+  // at the original array memory, so a sender may use vectored writes
+  // without first gathering the stream into one buffer.  Calling
+  // GetData gathers the segments back into a single buffer.  Reading
+  // arguments does not.  GetNumberOfDataSegments returns 0 if the stream
+  // is invalid.  GetDataSegment returns whether the index is valid.
+  int GetNumberOfDataSegments() const;
+  int GetDataSegment(int index, const unsigned char** data,
+                     size_t* length) const;
+
   //--------------------------------------------------------------------------
   // Stream writing methods:
 
   // Description:
   // Proxy-object returned by InsertArray and used to insert
-  // array data into the stream.
+  // array data into the stream.  When Holder is set, the stream
+  // references Data instead of copying it and keeps Holder alive for
+  // as long as the data are needed.
   struct Array
   {
     Types Type;
     vtkTypeUInt32 Length;
     vtkTypeUInt32 Size;
     const void* Data;
+    vtkObjectBase* Holder;
   };
 
   // Description:
@@ -278,12 +335,31 @@ public:
   static vtkClientServerStream::Array InsertArray(const float*, int);
   static vtkClientServerStream::Array InsertArray(const double*, int);
 
+  // Description:
+  // Allow the values of a numeric array to be passed into the stream
+  // without copying them.  The stream keeps a reference to the array
+  // until its contents have been gathered or the stream is reset, so
+  // the array values must not be modified in the meantime.
+  // Non-numeric arrays are inserted as an empty uint8 array.
+  static vtkClientServerStream::Array InsertArrayReference(vtkAbstractArray*);
+
   // Description:
   // Construct the entire stream from the given data.  This destroys
   // any data already in the stream.  Returns whether the stream is
   // deemed valid.  In the case of 0, the stream will have been reset.
   int SetData(const unsigned char* data, size_t length);
 
+  // Description:
+  // Construct the entire stream in place.  AllocateData destroys any
+  // data already in the stream and returns a buffer of the given
+  // length, or NULL if the length is 0, into which a receiver stores
+  // the stream data directly.  CommitData then parses them as SetData
+  // would, without copying, and returns whether the stream is deemed
+  // valid.  The buffer is invalidated by any other modification of
+  // the stream.
+  unsigned char* AllocateData(size_t length);
+  int CommitData();
+
   //--------------------------------------------------------------------------
   // Utility methods:
 
@@ -350,11 +426,12 @@ protected:
   unsigned char* ParseValue(int order, unsigned char* data,
                             unsigned char* end, unsigned int wordSize);
   unsigned char* ParseArray(int order, unsigned char* data,
-                            unsigned char* end, unsigned int wordSize);
+                            unsigned char* begin, unsigned char* end,
+                            unsigned int wordSize);
   unsigned char* ParseString(int order, unsigned char* data,
                              unsigned char* end);
   unsigned char* ParseStream(int order, unsigned char* data,
-                             unsigned char* end);
+                             unsigned char* begin, unsigned char* end);
 
   // Enumeration of possible byte orderings of data in the stream.
   enum { BigEndian, LittleEndian };
@@ -4,6 +4,7 @@
 #include "vtkCommandOptions.h"
 #include "vtkCommandOptionsXMLParser.h"
 #include "vtkPVTestUtilities.h"
+#include "vtkPVTraceEventRecorder.h"
 #include "vtkPVXMLElement.h"
 #include "vtkPVXMLParser.h"
 #include "vtkStringList.h"
@@ -17,6 +18,7 @@ int ParaViewCoreCommonPrintSelf(int, char*[])
   PRINT_SELF(vtkCommandOptions);
   PRINT_SELF(vtkCommandOptionsXMLParser);
   PRINT_SELF(vtkPVTestUtilities);
+  PRINT_SELF(vtkPVTraceEventRecorder);
   PRINT_SELF(vtkPVXMLElement);
   PRINT_SELF(vtkPVXMLParser);
   PRINT_SELF(vtkStringList);
@@ -0,0 +1,218 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVTraceEventRecorder.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVTraceEventRecorder.h"
+
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <deque>
+
+namespace
+{
+  struct vtkRecorderState
+    {
+    vtkRecorderState() : Enabled(0), MaxNumberOfEvents(100000),
+      NumberOfDiscardedEvents(0) {}
+
+    // Enabled is read without locking so that disabled events cost a test.
+    int Enabled;
+    int MaxNumberOfEvents;
+    int NumberOfDiscardedEvents;
+    std::deque<vtkPVTraceEventRecorder::Event> Events;
+    std::vector<vtkMultiThreaderIDType> Threads;
+    vtkSimpleMutexLock Lock;
+
+    // Must be called with the lock held.
+    int GetThreadIndex()
+      {
+      vtkMultiThreaderIDType id = vtkMultiThreader::GetCurrentThreadID();
+      for (size_t cc=0; cc < this->Threads.size(); cc++)
+        {
+        if (vtkMultiThreader::ThreadsEqual(this->Threads[cc], id))
+          {
+          return static_cast<int>(cc);
+          }
+        }
+      this->Threads.push_back(id);
+      return static_cast<int>(this->Threads.size()) - 1;
+      }
+
+    // Must be called with the lock held.
+    void Trim()
+      {
+      while (static_cast<int>(this->Events.size()) > this->MaxNumberOfEvents)
+        {
+        this->Events.pop_front();
+        this->NumberOfDiscardedEvents++;
+        }
+      }
+    };
+
+  vtkRecorderState& GetState()
+    {
+    static vtkRecorderState state;
+    return state;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkPVTraceEventRecorder);
+
+//----------------------------------------------------------------------------
+vtkPVTraceEventRecorder::vtkPVTraceEventRecorder()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkPVTraceEventRecorder::~vtkPVTraceEventRecorder()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceEventRecorder::SetEnabled(int enabled)
+{
+  GetState().Enabled = enabled ? 1 : 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTraceEventRecorder::GetEnabled()
+{
+  return GetState().Enabled;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceEventRecorder::SetMaxNumberOfEvents(int count)
+{
+  vtkRecorderState& state = GetState();
+  state.Lock.Lock();
+  state.MaxNumberOfEvents = count > 0 ? count : 0;
+  state.Trim();
+  state.Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTraceEventRecorder::GetMaxNumberOfEvents()
+{
+  return GetState().MaxNumberOfEvents;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTraceEventRecorder::GetNumberOfEvents()
+{
+  vtkRecorderState& state = GetState();
+  state.Lock.Lock();
+  int count = static_cast<int>(state.Events.size());
+  state.Lock.Unlock();
+  return count;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVTraceEventRecorder::GetNumberOfDiscardedEvents()
+{
+  vtkRecorderState& state = GetState();
+  state.Lock.Lock();
+  int count = state.NumberOfDiscardedEvents;
+  state.Lock.Unlock();
+  return count;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceEventRecorder::ResetEvents()
+{
+  vtkRecorderState& state = GetState();
+  state.Lock.Lock();
+  state.Events.clear();
+  state.NumberOfDiscardedEvents = 0;
+  state.Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+double vtkPVTraceEventRecorder::GetTime()
+{
+  return vtksys::SystemTools::GetTime();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceEventRecorder::AddEvent(const char* category,
+  const char* name, double start, double end, vtkTypeInt64 bytes)
+{
+  vtkRecorderState& state = GetState();
+  if (!state.Enabled)
+    {
+    return;
+    }
+
+  vtkPVTraceEventRecorder::Event event;
+  event.Category = category ? category : "";
+  event.Name = name ? name : "";
+  event.Start = start;
+  event.End = end;
+  event.Bytes = bytes;
+
+  state.Lock.Lock();
+  event.Thread = state.GetThreadIndex();
+  state.Events.push_back(event);
+  state.Trim();
+  state.Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceEventRecorder::GetEvents(
+  std::vector<vtkPVTraceEventRecorder::Event>& events)
+{
+  vtkRecorderState& state = GetState();
+  state.Lock.Lock();
+  events.assign(state.Events.begin(), state.Events.end());
+  state.Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVTraceEventRecorder::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Enabled: " << vtkPVTraceEventRecorder::GetEnabled() << endl;
+  os << indent << "MaxNumberOfEvents: "
+    << vtkPVTraceEventRecorder::GetMaxNumberOfEvents() << endl;
+  os << indent << "NumberOfEvents: "
+    << vtkPVTraceEventRecorder::GetNumberOfEvents() << endl;
+  os << indent << "NumberOfDiscardedEvents: "
+    << vtkPVTraceEventRecorder::GetNumberOfDiscardedEvents() << endl;
+}
+
+//----------------------------------------------------------------------------
+vtkPVTraceEventScope::vtkPVTraceEventScope(const char* category,
+  const char* name, vtkTypeInt64 bytes)
+  : Category(NULL), Start(0.0), Bytes(bytes)
+{
+  if (vtkPVTraceEventRecorder::GetEnabled())
+    {
+    this->Category = category ? category : "";
+    this->Name = name ? name : "";
+    this->Start = vtkPVTraceEventRecorder::GetTime();
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkPVTraceEventScope::~vtkPVTraceEventScope()
+{
+  if (this->Category)
+    {
+    vtkPVTraceEventRecorder::AddEvent(this->Category, this->Name.c_str(),
+      this->Start, vtkPVTraceEventRecorder::GetTime(), this->Bytes);
+    }
+}
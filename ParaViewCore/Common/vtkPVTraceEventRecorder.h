@@ -0,0 +1,143 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVTraceEventRecorder.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVTraceEventRecorder - records timed events of the local process.
+// .SECTION Description
+// vtkPVTraceEventRecorder keeps, for the local process, a list of events with
+// a category, a name, the thread that produced them, their start and end
+// times and the number of bytes they processed or moved. Unlike vtkTimerLog,
+// the events are structured so that the events of the client, data server
+// and render server processes can be put on a common timeline (see
+// vtkPVTraceInformation) and exported as a Chrome trace.
+//
+// Like vtkTimerLog, the recorder is global to the process: all the methods
+// are static and instances only exist so that a proxy can control it on all
+// processes. Recording is off by default and adding an event then does
+// nothing. When the maximum number of events is reached, the oldest events
+// are discarded.
+//
+// vtkPVTraceEventScope records an event that lasts as long as the scope.
+// .SECTION See Also
+// vtkPVTraceInformation vtkTimerLog
+
+#ifndef __vtkPVTraceEventRecorder_h
+#define __vtkPVTraceEventRecorder_h
+
+#include "vtkObject.h"
+#include "vtkPVCommonModule.h" // needed for export macro
+
+//BTX
+#include <string> // for std::string
+#include <vector> // for std::vector
+//ETX
+
+class VTKPVCOMMON_EXPORT vtkPVTraceEventRecorder : public vtkObject
+{
+public:
+  static vtkPVTraceEventRecorder* New();
+  vtkTypeMacro(vtkPVTraceEventRecorder, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Turn recording on/off on the local process. Off by default.
+  static void SetEnabled(int enabled);
+  static int GetEnabled();
+
+  // Description:
+  // Maximum number of events kept. The oldest events are discarded when it
+  // is reached. 100000 by default.
+  static void SetMaxNumberOfEvents(int count);
+  static int GetMaxNumberOfEvents();
+
+  // Description:
+  // Number of events kept and number of events discarded since the last
+  // call to ResetEvents().
+  static int GetNumberOfEvents();
+  static int GetNumberOfDiscardedEvents();
+
+  // Description:
+  // Removes all the events.
+  static void ResetEvents();
+
+  // Description:
+  // Current time, in seconds, used to time the events. This is the wall
+  // clock time so that the events of processes running on different hosts
+  // can be compared, provided their clocks are synchronized.
+  static double GetTime();
+
+  // Description:
+  // Records an event of the calling thread that started and ended at the
+  // given times (see GetTime()). bytes is the amount of data the event
+  // processed or moved, if known. Does nothing when recording is off.
+  static void AddEvent(const char* category, const char* name,
+    double start, double end, vtkTypeInt64 bytes=0);
+
+  //BTX
+  struct Event
+    {
+    std::string Category;
+    std::string Name;
+    double Start;
+    double End;
+    // Index of the thread in the order threads first recorded an event.
+    int Thread;
+    vtkTypeInt64 Bytes;
+    };
+
+  // Description:
+  // Copies the events in the order they ended.
+  static void GetEvents(std::vector<Event>& events);
+  //ETX
+
+protected:
+  vtkPVTraceEventRecorder();
+  ~vtkPVTraceEventRecorder();
+
+private:
+  vtkPVTraceEventRecorder(const vtkPVTraceEventRecorder&); // Not implemented
+  void operator=(const vtkPVTraceEventRecorder&); // Not implemented
+};
+
+//BTX
+// Description:
+// Records an event from its construction to its destruction. The category
+// is not copied and must outlive the scope, e.g. be a literal. The name is
+// only copied when recording is on, so a scope costs little otherwise. Set
+// the number of bytes once known with SetBytes().
+class VTKPVCOMMON_EXPORT vtkPVTraceEventScope
+{
+public:
+  vtkPVTraceEventScope(const char* category, const char* name,
+    vtkTypeInt64 bytes=0);
+  ~vtkPVTraceEventScope();
+
+  void SetBytes(vtkTypeInt64 bytes) { this->Bytes = bytes; }
+
+  // Description:
+  // Returns true when the event is recorded, to skip computing the bytes
+  // otherwise.
+  bool IsRecording() const { return this->Category != NULL; }
+
+private:
+  vtkPVTraceEventScope(const vtkPVTraceEventScope&); // Not implemented
+  void operator=(const vtkPVTraceEventScope&); // Not implemented
+
+  const char* Category;
+  std::string Name;
+  double Start;
+  vtkTypeInt64 Bytes;
+};
+//ETX
+
+#endif
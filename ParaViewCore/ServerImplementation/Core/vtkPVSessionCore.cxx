@@ -29,6 +29,7 @@
 #include "vtkPVOptions.h"
 #include "vtkPVSession.h"
 #include "vtkPVSessionCoreInterpreterHelper.h"
+#include "vtkPVTraceEventRecorder.h"
 #include "vtkProcessModule.h"
 #include "vtkReservedRemoteObjectIds.h"
 #include "vtkSIProxy.h"
@@ -42,6 +43,7 @@
 #include <set>
 #include <string>
 #include <sstream>
+#include <vector>
 
 
 #define LOG(x)\
@@ -416,6 +418,12 @@ vtkObject* vtkPVSessionCore::GetRemoteObject(vtkTypeUInt32 globalid)
 //----------------------------------------------------------------------------
 void vtkPVSessionCore::PushStateInternal(vtkSMMessage* message)
 {
+  vtkPVTraceEventScope traceEvent("message", "PushState");
+  if (traceEvent.IsRecording())
+    {
+    traceEvent.SetBytes(message->ByteSize());
+    }
+
   LOG(
     << "----------------------------------------------------------------\n"
     << "Push State ( " << message->ByteSize() << " bytes )\n"
@@ -559,6 +567,7 @@ void vtkPVSessionCore::PrintSelf(ostream& os, vtkIndent indent)
 //----------------------------------------------------------------------------
 void vtkPVSessionCore::PullState(vtkSMMessage* message)
 {
+  vtkPVTraceEventScope traceEvent("message", "PullState");
   LOG(
     << "----------------------------------------------------------------\n"
     << "Pull State ( " << message->ByteSize() << " bytes )\n"
@@ -644,13 +653,13 @@ void vtkPVSessionCore::ExecuteStreamSatelliteCallback()
 {
   int byte_size[2] = {0, 0};
   this->ParallelController->Broadcast(byte_size, 2, 0);
-  unsigned char *raw_data = new unsigned char[byte_size[0] + 1];
-  this->ParallelController->Broadcast(raw_data, byte_size[0], 0);
 
+  // Receive the stream data in place.
   vtkClientServerStream stream;
-  stream.SetData(raw_data, byte_size[0]);
+  unsigned char *raw_data = stream.AllocateData(byte_size[0]);
+  this->ParallelController->Broadcast(raw_data, byte_size[0], 0);
+  stream.CommitData();
   this->ExecuteStreamInternal(stream, byte_size[1] != 0);
-  delete [] raw_data;
 }
 
 //----------------------------------------------------------------------------
@@ -662,6 +671,21 @@ void vtkPVSessionCore::ExecuteStreamInternal(const vtkClientServerStream& stream
        << stream.StreamToString()
        << "----------------------------------------------------------------\n");
 
+  vtkPVTraceEventScope traceEvent("message", "ExecuteStream");
+  if (traceEvent.IsRecording())
+    {
+    // Sum the segments rather than calling GetData() that would gather them.
+    vtkTypeInt64 bytes = 0;
+    for (int cc=0; cc < stream.GetNumberOfDataSegments(); cc++)
+      {
+      const unsigned char* data;
+      size_t size = 0;
+      stream.GetDataSegment(cc, &data, &size);
+      bytes += static_cast<vtkTypeInt64>(size);
+      }
+    traceEvent.SetBytes(bytes);
+    }
+
   this->Interpreter->ClearLastResult();
 
   int temp = this->Interpreter->GetGlobalWarningDisplay();
@@ -817,6 +841,7 @@ void vtkPVSessionCore::RegisterSIObjectInternal(vtkSMMessage* message)
 bool vtkPVSessionCore::GatherInformationInternal( vtkPVInformation* information,
                                                   vtkTypeUInt32 globalid)
 {
+  vtkPVTraceEventScope traceEvent("information", information->GetClassName());
   if (globalid == 0)
     {
     information->CopyFromObject(NULL);
@@ -930,22 +955,12 @@ void vtkPVSessionCore::GatherInformationStatelliteCallback()
 }
 
 //----------------------------------------------------------------------------
-#define SafeDeleteArray( array_ptr ) { \
-  if( array_ptr != NULL )              \
-    {                                  \
-    delete [] array_ptr;               \
-    array_ptr = NULL;                  \
-    }                                  \
-}
-
 bool vtkPVSessionCore::CollectInformation(vtkPVInformation* info)
 {
-  // Sanity checks
-  assert("pre: NULL PV information!" && (info != NULL) );
-
   // STEP 0: temporary variables
-  int rank   = this->ParallelController->GetLocalProcessId();
-  int nranks = this->ParallelController->GetNumberOfProcesses();
+  vtkMultiProcessController* controller = this->ParallelController;
+  int rank   = controller->GetLocalProcessId();
+  int nranks = controller->GetNumberOfProcesses();
 
   if( nranks == 1 )
     {
@@ -953,83 +968,62 @@ bool vtkPVSessionCore::CollectInformation(vtkPVInformation* info)
     return true;
     }
 
-  vtkIdType *rcvcounts     = NULL;   /* significant only at rank 0 */
-  vtkIdType *offSet        = NULL;   /* significant only at rank 0 */
-  int rbufsize             = 0;      /* significant only at rank 0 */
-  unsigned char* rcvbuffer = NULL;   /* significant only at rank 0 */
-
-  // STEP 1: Initialize data-structures at rank 0
-  if( rank == 0 )
-    {
-    rcvcounts = new vtkIdType[ nranks ];
-    offSet    = new vtkIdType[ nranks ];
-    } // END if rank == 0
-
-  // STEP 2: Serialize the vtkPVInformation object
-  vtkClientServerStream stream;
-  info->CopyToStream( &stream );
-
-  const unsigned char* data;
-  size_t length;
-
-  // Get pointer to the raw stream data. Note, this is a shallow copy, no
-  // need to delete the data.
-  stream.GetData( &data, &length);
-  vtkIdType local_length = static_cast<vtkIdType>( length );
-
-  // STEP 3: Get number of bytes that each process will send
-  this->ParallelController->Gather(&local_length,rcvcounts,1,0);
-
-  // STEP 4: Allocate temporary arrays at rank 0
-  if( rank == 0 )
+  // STEP 1: Reduce the information over a binary tree. At each step, the
+  // ranks with the step's bit set send what they have gathered so far to the
+  // rank without that bit, which adds it to its own. Rank 0 ends up with the
+  // information of all ranks, added in rank order, after log2(nranks) steps
+  // instead of deserializing and adding the information of every rank.
+  // A NULL info (the satellite failed to create it) contributes nothing.
+  for (int step = 1; step < nranks; step <<= 1)
     {
-    // STEP 4.1: Calculate rcvbuffer size & allocate rcvbuffer
-    rbufsize = rcvcounts[0];
-    for( int i=1; i < nranks; ++i )
+    if (rank & step)
       {
-      rbufsize += rcvcounts[ i ];
+      vtkClientServerStream stream;
+      if (info)
+        {
+        info->CopyToStream(&stream);
+        }
+
+      // Get pointer to the raw stream data. Note, this is a shallow copy, no
+      // need to delete the data.
+      const unsigned char* data;
+      size_t length;
+      stream.GetData(&data, &length);
+      vtkIdType local_length = info? static_cast<vtkIdType>(length) : 0;
+      controller->Send(&local_length, 1, rank - step, ROOT_SATELLITE_INFO_TAG);
+      if (local_length > 0)
+        {
+        controller->Send(data, local_length, rank - step,
+          ROOT_SATELLITE_INFO_TAG);
+        }
+      break;
       }
-    rcvbuffer = new unsigned char[ rbufsize ];
 
-    // STEP 4.2: populate offset array
-    offSet[ 0 ] = 0;
-    for( int i=1; i < nranks; ++i )
+    if (rank + step < nranks)
       {
-      offSet[ i ] = offSet[ i-1 ] + rcvcounts[ i-1 ];
+      vtkIdType remote_length = 0;
+      controller->Receive(&remote_length, 1, rank + step,
+        ROOT_SATELLITE_INFO_TAG);
+      if (remote_length > 0)
+        {
+        std::vector<unsigned char> rcvbuffer(remote_length);
+        controller->Receive(&rcvbuffer[0], remote_length, rank + step,
+          ROOT_SATELLITE_INFO_TAG);
+        if (info)
+          {
+          vtkClientServerStream rcvStream;
+          rcvStream.SetData(&rcvbuffer[0], remote_length);
+          vtkPVInformation* tempInfo = info->NewInstance();
+          tempInfo->CopyFromStream( &rcvStream );
+          info->AddInformation( tempInfo );
+          tempInfo->Delete();
+          }
+        }
       }
-    } // END if rank==0
-
-  // STEP 5: GatherV all data from satellites
-  this->ParallelController->GatherV(
-      data, rcvbuffer, local_length, rcvcounts, offSet, 0);
+    }
 
-  // STEP 6: Deserialize data from other ranks at rank 0 and add them to
-  // the information object associated with rank 0.
-  if( rank == 0 )
-    {
-    vtkClientServerStream rcvStream;
-    for( int i=1; i < nranks; ++i )
-      {
-      rcvStream.SetData( &rcvbuffer[ offSet[i] ],rcvcounts[ i ] );
-      vtkPVInformation* tempInfo = info->NewInstance();
-      tempInfo->CopyFromStream( &rcvStream );
-      info->AddInformation( tempInfo );
-      tempInfo->Delete();
-      } // END for all remote ranks
-    } // END if rank == 0
-
-  // STEP 7: De-allocate temporary arrays at rank 0
-  SafeDeleteArray(rcvcounts);
-  SafeDeleteArray(offSet);
-  SafeDeleteArray(rcvbuffer);
-
-  // Sanity checks -- ensure we return all dynamically allocated memory
-  assert( "post: rcvcounts should be NULL" && (rcvcounts == NULL) );
-  assert( "post: offSet should be NULL" && (offSet == NULL) );
-  assert( "post: rcvbuffer should be NULL" && (rcvbuffer == NULL) );
-
-  // STEP 8: Barrier synchronization
-  this->ParallelController->Barrier();
+  // STEP 2: Barrier synchronization
+  controller->Barrier();
   return true;
 }
 
@@ -501,6 +501,26 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
       }
     break;
 
+  case vtkPVSessionServer::PUSH_BATCH:
+      {
+      // Several PUSH messages sent at once, processed in order.
+      int count = 0;
+      stream >> count;
+      for (int cc = 0; cc < count; cc++)
+        {
+        std::string string;
+        stream >> string;
+        vtkSMMessage msg;
+        msg.ParseFromString(string);
+        if(!this->Internal->StoreShareOnly(&msg))
+          {
+          this->PushState(&msg);
+          }
+        this->NotifyOtherClients(&msg);
+        }
+      }
+    break;
+
   case vtkPVSessionServer::PULL:
       {
       std::string string;
@@ -541,16 +561,28 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
 
   case vtkPVSessionServer::EXECUTE_STREAM:
       {
-      int ignore_errors, size;
-      stream >> ignore_errors >> size;
-      unsigned char* css_data = new unsigned char[size+1];
-      this->Internal->GetActiveController()->Receive(css_data, size, 1,
-        vtkPVSessionServer::EXECUTE_STREAM_TAG);
+      int ignore_errors, size, num_segments;
+      stream >> ignore_errors >> size >> num_segments;
       vtkClientServerStream cssStream;
-      cssStream.SetData(css_data, size);
+      unsigned char* css_data = cssStream.AllocateData(size);
+
+      // The client sends the stream as consecutive segments, receive them
+      // directly into the stream so that it is parsed in place.
+      int offset = 0;
+      for (int cc=0; cc < num_segments; cc++)
+        {
+        int segment_size;
+        stream >> segment_size;
+        if (segment_size > 0)
+          {
+          this->Internal->GetActiveController()->Receive(css_data + offset,
+            segment_size, 1, vtkPVSessionServer::EXECUTE_STREAM_TAG);
+          offset += segment_size;
+          }
+        }
+      cssStream.CommitData();
       this->ExecuteStream(vtkPVSession::CLIENT_AND_SERVERS,
         cssStream, ignore_errors != 0);
-      delete [] css_data;
       }
     break;
 
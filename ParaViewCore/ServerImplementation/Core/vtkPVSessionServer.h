@@ -75,6 +75,7 @@ public:
     REGISTER_SI                     = 16,
     UNREGISTER_SI                   = 17,
     LAST_RESULT                     = 18,
+    PUSH_BATCH                      = 19,
     SERVER_NOTIFICATION_MESSAGE_RMI = 55624,
     CLIENT_SERVER_MESSAGE_RMI       = 55625,
     CLOSE_SESSION                   = 55626,
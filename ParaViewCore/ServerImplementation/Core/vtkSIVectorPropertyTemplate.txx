@@ -15,10 +15,13 @@
 #include "vtkSIVectorPropertyTemplate.h"
 
 #include "vtkClientServerStream.h"
+#include "vtkDataArray.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVXMLElement.h"
 #include "vtkSIProxy.h"
 #include "vtkSMMessage.h"
+#include "vtkSmartPointer.h"
+#include "vtkTypeTraits.h"
 
 #include <vector>
 #include <assert.h>
@@ -302,6 +305,19 @@ namespace
     {
     OperatorIdType(arg1, arg2);
     }
+
+  // Insert values in a stream without copying them.  The stream keeps
+  // the array wrapping them alive, the values must outlive the stream.
+  template <class T>
+  void InsertArrayReference(vtkClientServerStream& stream, T* values,
+    int count)
+    {
+    vtkSmartPointer<vtkDataArray> array;
+    array.TakeReference(
+      vtkDataArray::CreateDataArray(vtkTypeTraits<T>::VTK_TYPE_ID));
+    array->SetVoidArray(values, count, 1);
+    stream << vtkClientServerStream::InsertArrayReference(array);
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -429,7 +445,7 @@ bool vtkSIVectorPropertyTemplate<T, force_idtype>::Push(T* values, int number_of
       }
     if (this->ArgumentIsArray)
       {
-      stream << vtkClientServerStream::InsertArray(values, number_of_elements);
+      InsertArrayReference(stream, values, number_of_elements);
       }
     else
       {
@@ -452,7 +468,7 @@ bool vtkSIVectorPropertyTemplate<T, force_idtype>::Push(T* values, int number_of
         }
       if (this->ArgumentIsArray)
         {
-        stream << vtkClientServerStream::InsertArray(
+        InsertArrayReference(stream,
           &(values[i*this->NumberOfElementsPerCommand]),
           this->NumberOfElementsPerCommand);
         }
@@ -1097,10 +1097,10 @@ void vtkLiveInsituLink::OnInsituPostProcess(double time, vtkIdType timeStep)
     // Convert serialized version
     vtkIdType size = 0;
     this->Controller->Receive(&size, 1, 1, 674523);
-    unsigned char* data = new unsigned char[size];
-    this->Controller->Receive((char*)data, size, 1, 674524);
     vtkClientServerStream mainStream;
-    mainStream.SetData(data, size);
+    unsigned char* data = mainStream.AllocateData(size);
+    this->Controller->Receive(data, size, 1, 674524);
+    mainStream.CommitData();
 
     int nbArgs = mainStream.GetNumberOfArguments(0);
     int arg = 0;
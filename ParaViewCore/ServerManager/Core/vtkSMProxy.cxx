@@ -90,6 +90,27 @@ protected:
   vtkSMProxy* Proxy;
 };
 
+//---------------------------------------------------------------------------
+// Writes the properties that have a state into state, in the order of the
+// property map which UpdateVTKObjects() relies on.
+static void vtkSMProxyWritePropertiesState(
+  vtkSMProxyInternals* internals, vtkSMMessage* state)
+{
+  state->ClearExtension(ProxyState::property);
+  vtkSMProxyInternals::PropertyInfoMap::iterator iter;
+  for (iter = internals->Properties.begin();
+       iter != internals->Properties.end(); ++iter)
+    {
+    vtkSMProperty* property = iter->second.Property;
+    if (property && !property->GetInformationOnly() &&
+      !property->GetIsInternal() && !property->IsStateIgnored() &&
+      strcmp(property->GetClassName(), "vtkSMProperty") != 0)
+      {
+      property->WriteTo(state);
+      }
+    }
+}
+
 vtkStandardNewMacro(vtkSMProxy);
 
 vtkCxxSetObjectMacro(vtkSMProxy, XMLElement, vtkPVXMLElement);
@@ -379,32 +400,23 @@ bool vtkSMProxy::UpdateProperty(const char* name, int force)
   it->second.ModifiedFlag = 0;
 
   vtkSMMessage message;
+  it->second.Property->WriteTo(&message);
 
   // Make sure the local state is updated as well
-  if(this->State)
+  if(this->State && message.ExtensionSize(ProxyState::property) > 0)
     {
-    vtkSMMessage oldState;
-    oldState.CopyFrom(*this->State);
-    this->State->ClearExtension(ProxyState::property);
-    int nbProps = oldState.ExtensionSize(ProxyState::property);
+    int nbProps = this->State->ExtensionSize(ProxyState::property);
     for(int cc=0; cc < nbProps; cc++)
       {
-      const ProxyState_Property *oldProperty =
-          &oldState.GetExtension(ProxyState::property, cc);
-
-      if(oldProperty->name() == it->second.Property->GetXMLName())
+      if(this->State->GetExtension(ProxyState::property, cc).name() ==
+         it->second.Property->GetXMLName())
         {
-        it->second.Property->WriteTo(this->State);
-        }
-      else
-        {
-        ProxyState_Property *newProperty = this->State->AddExtension(ProxyState::property);
-        newProperty->CopyFrom(oldState.GetExtension(ProxyState::property, cc));
+        this->State->MutableExtension(ProxyState::property, cc)->CopyFrom(
+          message.GetExtension(ProxyState::property, 0));
         }
       }
     }
 
-  it->second.Property->WriteTo(&message);
   this->PushState(&message);
 
   // Fire event to let everyone know that a property has been updated.
@@ -637,13 +649,11 @@ void vtkSMProxy::UpdateVTKObjects()
     {
     this->InUpdateVTKObjects = 1;
 
-    // Save previous property values and clear the State properties
-    vtkSMMessage oldState;
-    oldState.CopyFrom(*this->State);
-    this->State->ClearExtension(ProxyState::property);
-
-    // iterate over all properties and push modified ones.
+    // iterate over all properties and push modified ones. The state of the
+    // modified properties is replaced in place, the others are left as is.
     vtkSMMessage message;
+    vtkSMMessage propertyState;
+    bool stateOutOfDate = false;
     vtkSMProxyInternals::PropertyInfoMap::iterator iter;
     int cc = 0;
     for (iter = this->Internals->Properties.begin();
@@ -676,34 +686,46 @@ void vtkSMProxy::UpdateVTKObjects()
           // Push only modified properties
           if(iter->second.ModifiedFlag)
             {
-            // Write to state
-            property->WriteTo(this->State);
+            // Write to Push message
+            propertyState.ClearExtension(ProxyState::property);
+            property->WriteTo(&propertyState);
+            ProxyState_Property *prop =
+              message.AddExtension(ProxyState::property);
+            prop->CopyFrom(propertyState.GetExtension(ProxyState::property, 0));
+
+            // Write to state, unless properties were added since it was
+            // built in which case it is written again below.
+            if (cc < this->State->ExtensionSize(ProxyState::property) &&
+              this->State->GetExtension(ProxyState::property, cc).name() ==
+              prop->name())
+              {
+              this->State->MutableExtension(ProxyState::property, cc)->Swap(
+                propertyState.MutableExtension(ProxyState::property, 0));
+              }
+            else
+              {
+              stateOutOfDate = true;
+              }
 
             // the property is no longer dirty.
             iter->second.ModifiedFlag = 0;
 
-            // Write to Push message
-            ProxyState_Property *prop = message.AddExtension(ProxyState::property);
-            prop->CopyFrom(this->State->GetExtension(ProxyState::property, cc));
-
             // Fire event to let everyone know that a property has been updated.
             // This is currently used by vtkSMLink. Need to see if we can avoid this
             // as firing these events ain't inexpensive.
             this->InvokeEvent(vtkCommand::UpdatePropertyEvent,
               const_cast<char*>(iter->first.c_str()));
             }
-          else
-            {
-            // Just copy the previous old value to the state
-            ProxyState_Property *prop = this->State->AddExtension(ProxyState::property);
-            prop->CopyFrom(oldState.GetExtension(ProxyState::property, cc));
-            }
 
           // One more property
           ++cc;
           }
         }
       }
+    if (stateOutOfDate)
+      {
+      vtkSMProxyWritePropertiesState(this->Internals, this->State);
+      }
     this->InUpdateVTKObjects = 0;
     this->PropertiesModified = false;
 
@@ -781,25 +803,7 @@ void vtkSMProxy::CreateVTKObjects()
   this->State->CopyFrom(message);
 
   // Add Empty property into state to keep track of index later on
-  vtkSMProxyInternals::PropertyInfoMap::iterator iter;
-  for (iter = this->Internals->Properties.begin();
-       iter != this->Internals->Properties.end(); ++iter)
-    {
-    vtkSMProperty* property = iter->second.Property;
-    if (property && !property->GetInformationOnly())
-      {
-      if (property->GetIsInternal() || property->IsStateIgnored() ||
-        strcmp(property->GetClassName(), "vtkSMProperty") == 0)
-        {
-        // No state for vtkSMProperty
-        }
-      else
-        {
-        // Write empty property inside state
-        property->WriteTo(this->State);
-        }
-      }
-    }
+  vtkSMProxyWritePropertiesState(this->Internals, this->State);
 
   // Even if the Proxy was marked as Created, we went so far to build correctly
   // the state and this is the same case for prototype.
@@ -76,6 +76,7 @@ vtkSMSession::vtkSMSession(bool initialize_during_constructor/*=true*/,
   this->SessionProxyManager = NULL;
   this->StateLocator = vtkSMStateLocator::New();
   this->IsAutoMPI = false;
+  this->PushBatchDepth = 0;
 
   // Create and setup deserializer for the local ProxyLocator
   vtkNew<vtkSMDeserializerProtobuf> deserializer;
@@ -135,6 +136,26 @@ void vtkSMSession::PushState(vtkSMMessage* msg)
   this->Superclass::PushState(msg);
 }
 
+//----------------------------------------------------------------------------
+void vtkSMSession::BeginPushBatch()
+{
+  this->PushBatchDepth++;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSession::EndPushBatch()
+{
+  if (this->PushBatchDepth == 0)
+    {
+    vtkWarningMacro("EndPushBatch() called without BeginPushBatch().");
+    return;
+    }
+  if (--this->PushBatchDepth == 0)
+    {
+    this->FlushPushBatch();
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkSMSession::UpdateStateHistory(vtkSMMessage* msg)
 {
@@ -248,6 +269,7 @@ bool vtkSMSession::IsMPIInitialized(vtkTypeUInt32)
 void vtkSMSession::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "PushBatchDepth: " << this->PushBatchDepth << endl;
 }
 
 //----------------------------------------------------------------------------
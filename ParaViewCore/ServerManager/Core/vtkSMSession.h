@@ -140,6 +140,17 @@ public:
     { /* nothing to do. */ }
 //ETX
 
+  // Description:
+  // While a push batch is open, a session connected to servers may hold back
+  // the state messages PushState() sends to them and send them together, as
+  // one message per server, when the outermost batch ends or as soon as
+  // something needs the servers to be up to date (pulling a state, executing
+  // a stream, gathering information...). Batches nest. Applications should
+  // use vtkSMSessionProxyManager::BeginPushTransaction() instead.
+  void BeginPushBatch();
+  void EndPushBatch();
+  vtkGetMacro(PushBatchDepth, int);
+
   //---------------------------------------------------------------------------
   // API for Collaboration management
   //---------------------------------------------------------------------------
@@ -244,11 +255,18 @@ protected:
   // maintain the UndoRedo mecanisme.
   void UpdateStateHistory(vtkSMMessage* msg);
 
+  // Description:
+  // Sends the messages held back by an open push batch. Called when the
+  // outermost batch ends. The default implementation does nothing since
+  // nothing is held back.
+  virtual void FlushPushBatch() {}
+
   vtkSMSessionProxyManager* SessionProxyManager;
   vtkSMStateLocator* StateLocator;
   vtkSMProxyLocator* ProxyLocator;
 
   bool IsAutoMPI;
+  int PushBatchDepth;
 
 private:
   vtkSMSession(const vtkSMSession&); // Not implemented
@@ -28,6 +28,7 @@
 #include "vtkPVOptions.h"
 #include "vtkPVServerInformation.h"
 #include "vtkPVSessionServer.h"
+#include "vtkPVTraceEventRecorder.h"
 #include "vtkSMSettings.h"
 #include "vtkReservedRemoteObjectIds.h"
 #include "vtkSMCollaborationManager.h"
@@ -456,6 +457,7 @@ bool vtkSMSessionClient::IsMPIInitialized(vtkTypeUInt32 servers)
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::CloseSession()
 {
+  this->FlushPushBatch();
   if (this->DataServerController)
     {
     this->DataServerController->TriggerRMIOnAllChildren(
@@ -512,24 +514,37 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
   message->set_location(location);
   int num_controllers=0;
   vtkMultiProcessController* controllers[2] = {NULL, NULL};
+  std::vector<std::string>* batches[2] = {NULL, NULL};
 
   if ( (location &
         (vtkPVSession::DATA_SERVER|vtkPVSession::DATA_SERVER_ROOT)) != 0)
     {
+    batches[num_controllers] = &this->DataServerPushBatch;
     controllers[num_controllers++] = this->DataServerController;
     }
   if ((location &
        (vtkPVSession::RENDER_SERVER|vtkPVSession::RENDER_SERVER_ROOT)) != 0)
     {
+    batches[num_controllers] = &this->RenderServerPushBatch;
     controllers[num_controllers++] = this->RenderServerController;
     }
-  if (num_controllers > 0)
+  if (num_controllers > 0 && this->PushBatchDepth > 0)
+    {
+    std::string serialized = message->SerializeAsString();
+    for (int cc=0; cc < num_controllers; cc++)
+      {
+      batches[cc]->push_back(serialized);
+      }
+    }
+  else if (num_controllers > 0)
     {
     vtkMultiProcessStream stream;
     stream << static_cast<int>(vtkPVSessionServer::PUSH);
     stream << message->SerializeAsString();
     std::vector<unsigned char> raw_message;
     stream.GetRawData(raw_message);
+    vtkPVTraceEventScope traceEvent("message", "Send PushState",
+      num_controllers * static_cast<vtkTypeInt64>(raw_message.size()));
     for (int cc=0; cc < num_controllers; cc++)
       {
       controllers[cc]->TriggerRMIOnAllChildren(
@@ -571,6 +586,8 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
         stream << msg.SerializeAsString();
         std::vector<unsigned char> raw_message;
         stream.GetRawData(raw_message);
+        // Held back messages for this proxy must reach the server first.
+        this->FlushPushBatch();
         this->DataServerController->TriggerRMIOnAllChildren(
             &raw_message[0], static_cast<int>(raw_message.size()),
             vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
@@ -599,6 +616,7 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PullState(vtkSMMessage* message)
 {
+  this->FlushPushBatch();
   this->StartBusyWork();
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
@@ -629,6 +647,8 @@ void vtkSMSessionClient::PullState(vtkSMMessage* message)
     stream << message->SerializeAsString();
     std::vector<unsigned char> raw_message;
     stream.GetRawData(raw_message);
+    vtkPVTraceEventScope traceEvent("message", "Send PullState",
+      static_cast<vtkTypeInt64>(raw_message.size()));
     controller->TriggerRMIOnAllChildren(
       &raw_message[0], static_cast<int>(raw_message.size()),
       vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
@@ -659,6 +679,7 @@ void vtkSMSessionClient::ExecuteStream(
     return;
     }
 
+  this->FlushPushBatch();
   location = this->GetRealLocation(location);
 
   vtkMultiProcessController* controllers[2] = {NULL, NULL};
@@ -676,23 +697,46 @@ void vtkSMSessionClient::ExecuteStream(
 
   if ( num_controllers > 0)
     {
-    const unsigned char* data;
-    size_t size;
-    cssstream.GetData(&data, &size);
+    // Send the stream as the sequence of segments it is stored in so that
+    // large arrays inserted by reference are not gathered into a single
+    // buffer on the client first.
+    int num_segments = cssstream.GetNumberOfDataSegments();
+    std::vector<const unsigned char*> segment_data(num_segments);
+    std::vector<size_t> segment_size(num_segments);
+    size_t size = 0;
+    for (int cc=0; cc < num_segments; cc++)
+      {
+      cssstream.GetDataSegment(cc, &segment_data[cc], &segment_size[cc]);
+      size += segment_size[cc];
+      }
 
     vtkMultiProcessStream stream;
     stream << static_cast<int>(vtkPVSessionServer::EXECUTE_STREAM)
-      << static_cast<int>(ignore_errors) << static_cast<int>(size);
+      << static_cast<int>(ignore_errors) << static_cast<int>(size)
+      << num_segments;
+    for (int cc=0; cc < num_segments; cc++)
+      {
+      stream << static_cast<int>(segment_size[cc]);
+      }
     std::vector<unsigned char> raw_message;
     stream.GetRawData(raw_message);
+    vtkPVTraceEventScope traceEvent("message", "Send ExecuteStream",
+      num_controllers * static_cast<vtkTypeInt64>(size));
 
     for (int cc=0; cc < num_controllers; cc++)
       {
       controllers[cc]->TriggerRMIOnAllChildren(
         &raw_message[0], static_cast<int>(raw_message.size()),
         vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
-      controllers[cc]->Send(data, static_cast<int>(size), 1,
-        vtkPVSessionServer::EXECUTE_STREAM_TAG);
+      for (int kk=0; kk < num_segments; kk++)
+        {
+        if (segment_size[kk] > 0)
+          {
+          controllers[cc]->Send(segment_data[kk],
+            static_cast<int>(segment_size[kk]), 1,
+            vtkPVSessionServer::EXECUTE_STREAM_TAG);
+          }
+        }
       }
     }
 
@@ -705,6 +749,7 @@ void vtkSMSessionClient::ExecuteStream(
 //----------------------------------------------------------------------------
 const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 location)
 {
+  this->FlushPushBatch();
   this->StartBusyWork();
   location = this->GetRealLocation(location);
 
@@ -755,6 +800,7 @@ const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 loc
 bool vtkSMSessionClient::GatherInformation(
   vtkTypeUInt32 location, vtkPVInformation* information, vtkTypeUInt32 globalid)
 {
+  this->FlushPushBatch();
   this->StartBusyWork();
   if (this->RenderServerController == NULL)
     {
@@ -810,12 +856,14 @@ bool vtkSMSessionClient::GatherInformation(
 
   if (controller)
     {
+    vtkPVTraceEventScope traceEvent("information", information->GetClassName());
     controller->TriggerRMIOnAllChildren(
       &raw_message[0], static_cast<int>(raw_message.size()),
       vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
 
     int length2 = 0;
     controller->Receive(&length2, 1, 1, vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG);
+    traceEvent.SetBytes(length2);
     if (length2 <= 0)
       {
       vtkErrorMacro("Server failed to gather information.");
@@ -858,6 +906,7 @@ void vtkSMSessionClient::UnRegisterSIObject(vtkSMMessage* message)
     return;
     }
 
+  this->FlushPushBatch();
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
   message->set_client_id(this->GetServerInformation()->GetClientId());
@@ -902,6 +951,7 @@ void vtkSMSessionClient::RegisterSIObject(vtkSMMessage* message)
     return;
     }
 
+  this->FlushPushBatch();
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
   message->set_client_id(this->GetServerInformation()->GetClientId());
@@ -942,10 +992,46 @@ void vtkSMSessionClient::RegisterSIObject(vtkSMMessage* message)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::FlushPushBatch()
+{
+  vtkMultiProcessController* controllers[2] = {
+    this->DataServerController, this->RenderServerController };
+  std::vector<std::string>* batches[2] = {
+    &this->DataServerPushBatch, &this->RenderServerPushBatch };
+  for (int cc=0; cc < 2; cc++)
+    {
+    if (batches[cc]->empty())
+      {
+      continue;
+      }
+    if (controllers[cc])
+      {
+      vtkMultiProcessStream stream;
+      stream << static_cast<int>(vtkPVSessionServer::PUSH_BATCH)
+        << static_cast<int>(batches[cc]->size());
+      for (size_t kk=0; kk < batches[cc]->size(); kk++)
+        {
+        stream << (*batches[cc])[kk];
+        }
+      std::vector<unsigned char> raw_message;
+      stream.GetRawData(raw_message);
+      vtkPVTraceEventScope traceEvent("message", "Send PushState batch",
+        static_cast<vtkTypeInt64>(raw_message.size()));
+      controllers[cc]->TriggerRMIOnAllChildren(
+        &raw_message[0], static_cast<int>(raw_message.size()),
+        vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+      }
+    batches[cc]->clear();
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "Held back pushes: " << this->DataServerPushBatch.size()
+     << " " << this->RenderServerPushBatch.size() << endl;
 }
 //----------------------------------------------------------------------------
 vtkTypeUInt32 vtkSMSessionClient::GetNextGlobalUniqueIdentifier()
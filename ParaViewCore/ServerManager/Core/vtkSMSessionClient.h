@@ -24,6 +24,9 @@
 #include "vtkPVServerManagerCoreModule.h" //needed for exports
 #include "vtkSMSession.h"
 
+#include <string> // for std::string
+#include <vector> // for std::vector
+
 class vtkMultiProcessController;
 class vtkPVServerInformation;
 class vtkSMCollaborationManager;
@@ -89,7 +92,8 @@ public:
 
 //BTX
   // Description:
-  // Push the state.
+  // Push the state. While a push batch is open the messages for the servers
+  // are held back and sent together by FlushPushBatch().
   virtual void PushState(vtkSMMessage* msg);
   virtual void PullState(vtkSMMessage* message);
   virtual void ExecuteStream(
@@ -195,6 +199,11 @@ protected:
   // Notify server side object that it is used by one more client. (SIObject)
   virtual void RegisterSIObject(vtkSMMessage* msg);
 
+  // Description:
+  // Sends the messages held back for each server as a single PUSH_BATCH
+  // message. Called before anything else is sent to the servers.
+  virtual void FlushPushBatch();
+
   // Description:
   // Translates the location to a real location based on whether a separate
   // render-server exists.
@@ -241,6 +250,11 @@ private:
   int NotBusy;
   vtkTypeUInt32 LastGlobalID;
   vtkTypeUInt32 LastGlobalIDAvailable;
+
+  // Serialized messages held back by an open push batch for the data-server
+  // and the render-server.
+  std::vector<std::string> DataServerPushBatch;
+  std::vector<std::string> RenderServerPushBatch;
 //ETX
 };
 
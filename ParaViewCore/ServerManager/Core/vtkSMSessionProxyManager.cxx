@@ -886,10 +886,31 @@ void vtkSMSessionProxyManager::RegisterProxy(const char* groupname,
   this->InvokeEvent(vtkCommand::RegisterEvent, &info);
 }
 
+//---------------------------------------------------------------------------
+void vtkSMSessionProxyManager::BeginPushTransaction()
+{
+  if (this->GetSession())
+    {
+    this->GetSession()->BeginPushBatch();
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkSMSessionProxyManager::EndPushTransaction()
+{
+  if (this->GetSession())
+    {
+    this->GetSession()->EndPushBatch();
+    }
+}
+
 //---------------------------------------------------------------------------
 void vtkSMSessionProxyManager::UpdateRegisteredProxies(const char* groupname,
   int modified_only /*=1*/)
 {
+  // Push all the proxies at once, then get their pipeline information.
+  std::vector<vtkSmartPointer<vtkSMProxy> > updated;
+  this->BeginPushTransaction();
   vtkSMSessionProxyManagerInternals::ProxyGroupType::iterator it =
     this->Internals->RegisteredProxyMap.find(groupname);
   if ( it != this->Internals->RegisteredProxyMap.end() )
@@ -906,11 +927,16 @@ void vtkSMSessionProxyManager::UpdateRegisteredProxies(const char* groupname,
           != this->Internals->ModifiedProxies.end())
           {
           it3->GetPointer()->Proxy.GetPointer()->UpdateVTKObjects();
-          it3->GetPointer()->Proxy.GetPointer()->UpdatePipelineInformation();
+          updated.push_back(it3->GetPointer()->Proxy);
           }
         }
       }
     }
+  this->EndPushTransaction();
+  for (size_t cc = 0; cc < updated.size(); cc++)
+    {
+    updated[cc]->UpdatePipelineInformation();
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -918,6 +944,10 @@ void vtkSMSessionProxyManager::UpdateRegisteredProxies(int modified_only /*=1*/)
 {
   vtksys::RegularExpression prototypesRe("_prototypes$");
 
+  // Push all the proxies at once, then get their pipeline information.
+  std::vector<vtkSmartPointer<vtkSMProxy> > updated;
+  this->BeginPushTransaction();
+
   vtkSMSessionProxyManagerInternals::ProxyGroupType::iterator it =
     this->Internals->RegisteredProxyMap.begin();
   for (; it != this->Internals->RegisteredProxyMap.end(); it++)
@@ -941,11 +971,16 @@ void vtkSMSessionProxyManager::UpdateRegisteredProxies(int modified_only /*=1*/)
           != this->Internals->ModifiedProxies.end())
           {
           it3->GetPointer()->Proxy.GetPointer()->UpdateVTKObjects();
-          it3->GetPointer()->Proxy.GetPointer()->UpdatePipelineInformation();
+          updated.push_back(it3->GetPointer()->Proxy);
           }
         }
       }
     }
+  this->EndPushTransaction();
+  for (size_t cc = 0; cc < updated.size(); cc++)
+    {
+    updated[cc]->UpdatePipelineInformation();
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -1199,7 +1234,10 @@ void vtkSMSessionProxyManager::LoadXMLState( vtkPVXMLElement* rootElement,
     {
     spLoader = loader;
     }
-  if (spLoader->LoadState(rootElement, keepOriginalIds))
+  this->BeginPushTransaction();
+  int loaded = spLoader->LoadState(rootElement, keepOriginalIds);
+  this->EndPushTransaction();
+  if (loaded)
     {
     vtkSMProxyManager::LoadStateInformation info;
     info.RootElement = rootElement;
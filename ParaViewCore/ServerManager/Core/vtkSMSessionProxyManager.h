@@ -281,6 +281,17 @@ public:
   void UpdateRegisteredProxiesInOrder(int modified_only=1);
   void UpdateProxyInOrder(vtkSMProxy* proxy);
 
+  // Description:
+  // Property push transaction. The properties that all proxies push between
+  // BeginPushTransaction() and the matching EndPushTransaction() are sent
+  // to the servers together, as one message per server, rather than one
+  // message per proxy. They are sent earlier if something needs the servers
+  // to be up to date, e.g. gathering information, so the order of operations
+  // is kept. Transactions nest and the messages are sent when the outermost
+  // one ends. LoadXMLState() and UpdateRegisteredProxies() use one.
+  void BeginPushTransaction();
+  void EndPushTransaction();
+
   // Description:
   // Get the number of registered links with the server manager.
   int GetNumberOfLinks();
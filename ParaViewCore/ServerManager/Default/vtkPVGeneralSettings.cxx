@@ -142,6 +142,38 @@ void vtkPVGeneralSettings::SetAnimationGeometryCacheLimit(unsigned long val)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkPVGeneralSettings::SetAnimationGeometryCacheEvictionPolicy(int val)
+{
+  if (this->GetAnimationGeometryCacheEvictionPolicy() != val)
+    {
+    vtkCacheSizeKeeper::GetInstance()->SetEvictionPolicy(val);
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVGeneralSettings::GetAnimationGeometryCacheEvictionPolicy()
+{
+  return vtkCacheSizeKeeper::GetInstance()->GetEvictionPolicy();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVGeneralSettings::SetCompressAnimationGeometryCache(bool val)
+{
+  if (this->GetCompressAnimationGeometryCache() != val)
+    {
+    vtkCacheSizeKeeper::GetInstance()->SetCompressCacheEntries(val? 1 : 0);
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVGeneralSettings::GetCompressAnimationGeometryCache()
+{
+  return vtkCacheSizeKeeper::GetInstance()->GetCompressCacheEntries() != 0;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVGeneralSettings::SetScalarBarMode(int val)
 {
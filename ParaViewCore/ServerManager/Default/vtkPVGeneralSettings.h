@@ -123,6 +123,18 @@ public:
   void SetAnimationGeometryCacheLimit(unsigned long val);
   vtkGetMacro(AnimationGeometryCacheLimit, unsigned long);
 
+  // Description:
+  // Set the policy used to evict cached geometry once the animation cache
+  // limit is reached. See vtkCacheSizeKeeper::EvictionPolicies.
+  void SetAnimationGeometryCacheEvictionPolicy(int val);
+  int GetAnimationGeometryCacheEvictionPolicy();
+
+  // Description:
+  // Set whether cached geometry for animations is stored compressed.
+  // Forwarded to vtkCacheSizeKeeper::SetCompressCacheEntries.
+  void SetCompressAnimationGeometryCache(bool val);
+  bool GetCompressAnimationGeometryCache();
+
   // Description:
   // Forwarded for vtkSMParaViewPipelineControllerWithRendering.
   void SetInheritRepresentationProperties(bool val);
@@ -293,6 +293,34 @@ void vtkSMViewProxy::Update()
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkSMViewProxy::Prefetch(double time)
+{
+  if (this->ObjectsCreated)
+    {
+    vtkClientServerStream stream;
+    stream << vtkClientServerStream::Invoke
+           << VTKOBJECT(this)
+           << "Prefetch" << time
+           << vtkClientServerStream::End;
+    this->ExecuteStream(stream);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSMViewProxy::CancelPrefetch(double time)
+{
+  if (this->ObjectsCreated)
+    {
+    vtkClientServerStream stream;
+    stream << vtkClientServerStream::Invoke
+           << VTKOBJECT(this)
+           << "CancelPrefetch" << time
+           << vtkClientServerStream::End;
+    this->ExecuteStream(stream);
+    }
+}
+
 //----------------------------------------------------------------------------
 vtkSMRepresentationProxy* vtkSMViewProxy::CreateDefaultRepresentation(
   vtkSMProxy* proxy, int outputPort)
@@ -65,6 +65,16 @@ public:
   // Called vtkPVView::Update on the server-side.
   virtual void Update();
 
+  // Description:
+  // Calls vtkPVView::Prefetch on the server-side. This does not wait for the
+  // server to finish prefetching, so that the client can carry on, for
+  // example with the display of the current frame, in the meantime.
+  virtual void Prefetch(double time);
+
+  // Description:
+  // Calls vtkPVView::CancelPrefetch on the server-side.
+  virtual void CancelPrefetch(double time);
+
   // Description:
   // Returns true if the view can display the data produced by the producer's
   // port. Internally calls GetRepresentationType() and returns true only if the
@@ -0,0 +1,278 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkLZ4Codec.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLZ4Codec.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkType.h"
+
+#include <string.h>
+#include <vector>
+
+namespace
+{
+  // Constants of the LZ4 block format.
+  const size_t MIN_MATCH = 4;
+  // The last match must start at least this many bytes before the end.
+  const size_t MF_LIMIT = 12;
+  // The last bytes of a block are always literals.
+  const size_t LAST_LITERALS = 5;
+  const size_t MAX_OFFSET = 65535;
+  const int HASH_LOG = 16;
+  // After this many consecutive misses the search step grows, so that
+  // incompressible regions are skipped quickly.
+  const int SKIP_TRIGGER = 6;
+
+  inline vtkTypeUInt32 Read32(const unsigned char* ptr)
+    {
+    vtkTypeUInt32 value;
+    memcpy(&value, ptr, sizeof(value));
+    return value;
+    }
+
+  inline vtkTypeUInt32 Hash(vtkTypeUInt32 sequence)
+    {
+    return (sequence * 2654435761U) >> (32 - HASH_LOG);
+    }
+
+  inline unsigned char* WriteLength(unsigned char* op, size_t length)
+    {
+    while (length >= 255)
+      {
+      *op++ = 255;
+      length -= 255;
+      }
+    *op++ = static_cast<unsigned char>(length);
+    return op;
+    }
+
+  // Reads an extended length field. Returns false on truncated input.
+  inline bool ReadLength(const unsigned char*& ip, const unsigned char* iend,
+    size_t& length)
+    {
+    unsigned char s;
+    do
+      {
+      if (ip >= iend)
+        {
+        return false;
+        }
+      s = *ip++;
+      length += s;
+      }
+    while (s == 255);
+    return true;
+    }
+
+  // Emits a sequence made of the literals in [anchor, anchor+numLiterals)
+  // optionally followed by a match.
+  inline unsigned char* WriteSequence(unsigned char* op,
+    const unsigned char* anchor, size_t numLiterals,
+    bool hasMatch, size_t offset, size_t matchLength)
+    {
+    unsigned char* token = op++;
+    if (numLiterals >= 15)
+      {
+      *token = 15 << 4;
+      op = WriteLength(op, numLiterals - 15);
+      }
+    else
+      {
+      *token = static_cast<unsigned char>(numLiterals << 4);
+      }
+    if (numLiterals > 0)
+      {
+      memcpy(op, anchor, numLiterals);
+      op += numLiterals;
+      }
+
+    if (hasMatch)
+      {
+      *op++ = static_cast<unsigned char>(offset & 0xff);
+      *op++ = static_cast<unsigned char>((offset >> 8) & 0xff);
+      size_t length = matchLength - MIN_MATCH;
+      if (length >= 15)
+        {
+        *token |= 15;
+        op = WriteLength(op, length - 15);
+        }
+      else
+        {
+        *token |= static_cast<unsigned char>(length);
+        }
+      }
+    return op;
+    }
+}
+
+vtkStandardNewMacro(vtkLZ4Codec);
+//----------------------------------------------------------------------------
+vtkLZ4Codec::vtkLZ4Codec()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkLZ4Codec::~vtkLZ4Codec()
+{
+}
+
+//----------------------------------------------------------------------------
+size_t vtkLZ4Codec::GetMaximumCompressedSize(size_t inputSize)
+{
+  return inputSize + inputSize / 255 + 16;
+}
+
+//----------------------------------------------------------------------------
+size_t vtkLZ4Codec::Compress(const unsigned char* input, size_t inputSize,
+  unsigned char* output, size_t outputCapacity)
+{
+  if (outputCapacity < vtkLZ4Codec::GetMaximumCompressedSize(inputSize))
+    {
+    return 0;
+    }
+
+  const unsigned char* ip = input;
+  const unsigned char* anchor = input;
+  const unsigned char* const iend = input + inputSize;
+  unsigned char* op = output;
+
+  if (inputSize > MF_LIMIT)
+    {
+    const unsigned char* const mflimit = iend - MF_LIMIT;
+    const unsigned char* const matchlimit = iend - LAST_LITERALS;
+
+    // Most recent position of each hashed 4 byte sequence.
+    std::vector<vtkTypeUInt32> table(static_cast<size_t>(1) << HASH_LOG, 0);
+
+    unsigned int misses = 0;
+    while (ip < mflimit)
+      {
+      vtkTypeUInt32 sequence = Read32(ip);
+      vtkTypeUInt32& entry = table[Hash(sequence)];
+      const unsigned char* ref = input + entry;
+      entry = static_cast<vtkTypeUInt32>(ip - input);
+
+      if (ref >= ip || static_cast<size_t>(ip - ref) > MAX_OFFSET ||
+        Read32(ref) != sequence)
+        {
+        ip += 1 + (misses++ >> SKIP_TRIGGER);
+        continue;
+        }
+      misses = 0;
+
+      // Extend the match forward.
+      const unsigned char* matchStart = ip;
+      size_t offset = static_cast<size_t>(ip - ref);
+      ip += MIN_MATCH;
+      ref += MIN_MATCH;
+      while (ip < matchlimit && *ip == *ref)
+        {
+        ++ip;
+        ++ref;
+        }
+
+      op = WriteSequence(op, anchor, static_cast<size_t>(matchStart - anchor),
+        true, offset, static_cast<size_t>(ip - matchStart));
+      anchor = ip;
+      }
+    }
+
+  // Remaining bytes are emitted as literals.
+  op = WriteSequence(op, anchor, static_cast<size_t>(iend - anchor),
+    false, 0, 0);
+  return static_cast<size_t>(op - output);
+}
+
+//----------------------------------------------------------------------------
+size_t vtkLZ4Codec::Decompress(const unsigned char* input, size_t inputSize,
+  unsigned char* output, size_t outputCapacity)
+{
+  const unsigned char* ip = input;
+  const unsigned char* const iend = input + inputSize;
+  unsigned char* op = output;
+  unsigned char* const oend = output + outputCapacity;
+
+  while (ip < iend)
+    {
+    unsigned char token = *ip++;
+
+    // Literals.
+    size_t length = token >> 4;
+    if (length == 15 && !ReadLength(ip, iend, length))
+      {
+      return 0;
+      }
+    if (length > static_cast<size_t>(iend - ip) ||
+      length > static_cast<size_t>(oend - op))
+      {
+      return 0;
+      }
+    memcpy(op, ip, length);
+    op += length;
+    ip += length;
+
+    // The last sequence has no match.
+    if (ip >= iend)
+      {
+      break;
+      }
+
+    // Match.
+    if (iend - ip < 2)
+      {
+      return 0;
+      }
+    size_t offset = static_cast<size_t>(ip[0]) |
+      (static_cast<size_t>(ip[1]) << 8);
+    ip += 2;
+    if (offset == 0 || offset > static_cast<size_t>(op - output))
+      {
+      return 0;
+      }
+    length = token & 15;
+    if (length == 15 && !ReadLength(ip, iend, length))
+      {
+      return 0;
+      }
+    length += MIN_MATCH;
+    if (length > static_cast<size_t>(oend - op))
+      {
+      return 0;
+      }
+
+    // Matches may overlap the bytes being written, copy byte by byte in
+    // that case.
+    const unsigned char* match = op - offset;
+    if (offset >= length)
+      {
+      memcpy(op, match, length);
+      op += length;
+      }
+    else
+      {
+      for (size_t cc = 0; cc < length; ++cc)
+        {
+        *op++ = *match++;
+        }
+      }
+    }
+
+  return static_cast<size_t>(op - output);
+}
+
+//----------------------------------------------------------------------------
+void vtkLZ4Codec::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
@@ -0,0 +1,70 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkLZ4Codec.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkLZ4Codec - fast loss-less compression of byte buffers.
+// .SECTION Description
+// vtkLZ4Codec is a collection of routines to compress and decompress raw
+// memory buffers using the LZ4 block format. The encoder favors speed over
+// compression ratio which makes it suitable for compressing data that is
+// produced and consumed at interactive rates (rendered images, cached or
+// delivered geometry) where zlib is too slow. The implementation is self
+// contained and does not depend on an external LZ4 library.
+//
+// Compressed blocks do not record the size of the uncompressed data, the
+// caller must store it alongside the compressed block.
+
+#ifndef __vtkLZ4Codec_h
+#define __vtkLZ4Codec_h
+
+#include "vtkObject.h"
+#include "vtkPVVTKExtensionsCoreModule.h" // needed for export macro
+
+class VTKPVVTKEXTENSIONSCORE_EXPORT vtkLZ4Codec : public vtkObject
+{
+public:
+  static vtkLZ4Codec* New();
+  vtkTypeMacro(vtkLZ4Codec, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Returns the size of the buffer needed to hold the compressed form of
+  // \c inputSize bytes in the worst case (incompressible input).
+  static size_t GetMaximumCompressedSize(size_t inputSize);
+
+  // Description:
+  // Compress \c inputSize bytes from \c input into \c output which must be
+  // at least \c outputCapacity bytes long. Returns the number of bytes
+  // written to \c output or 0 if \c outputCapacity is too small.
+  static size_t Compress(const unsigned char* input, size_t inputSize,
+    unsigned char* output, size_t outputCapacity);
+
+  // Description:
+  // Decompress the block of \c inputSize bytes in \c input into \c output
+  // which can hold \c outputCapacity bytes. Returns the number of bytes
+  // written to \c output or 0 if the block is corrupted or does not fit.
+  static size_t Decompress(const unsigned char* input, size_t inputSize,
+    unsigned char* output, size_t outputCapacity);
+
+//BTX
+protected:
+  vtkLZ4Codec();
+  ~vtkLZ4Codec();
+
+private:
+  vtkLZ4Codec(const vtkLZ4Codec&); // Not implemented
+  void operator=(const vtkLZ4Codec&); // Not implemented
+//ETX
+};
+
+#endif
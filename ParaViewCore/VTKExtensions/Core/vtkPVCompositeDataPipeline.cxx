@@ -24,6 +24,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVPostFilterExecutive.h"
+#include "vtkPVTraceEventRecorder.h"
 
 #include <assert.h>
 
@@ -97,6 +98,31 @@ void vtkPVCompositeDataPipeline::ResetPipelineInformation(
   this->Superclass::ResetPipelineInformation(port, info);
 }
 
+//----------------------------------------------------------------------------
+int vtkPVCompositeDataPipeline::ExecuteData(vtkInformation* request,
+  vtkInformationVector** inInfoVec, vtkInformationVector* outInfoVec)
+{
+  vtkPVTraceEventScope traceEvent("pipeline",
+    this->Algorithm ? this->Algorithm->GetClassName() : "ExecuteData");
+  int result = this->Superclass::ExecuteData(request, inInfoVec, outInfoVec);
+  if (traceEvent.IsRecording())
+    {
+    // Report the size of the outputs, in bytes.
+    vtkTypeInt64 bytes = 0;
+    for (int cc=0; cc < outInfoVec->GetNumberOfInformationObjects(); cc++)
+      {
+      vtkDataObject* output = outInfoVec->GetInformationObject(cc)->Get(
+        vtkDataObject::DATA_OBJECT());
+      if (output)
+        {
+        bytes += 1024 * static_cast<vtkTypeInt64>(output->GetActualMemorySize());
+        }
+      }
+    traceEvent.SetBytes(bytes);
+    }
+  return result;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVCompositeDataPipeline::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -47,6 +47,11 @@ protected:
   // Remove update/whole extent when resetting pipeline information.
   virtual void ResetPipelineInformation(int port, vtkInformation*);
 
+  // Records the execution of the algorithm with vtkPVTraceEventRecorder.
+  virtual int ExecuteData(vtkInformation* request,
+                          vtkInformationVector** inInfoVec,
+                          vtkInformationVector* outInfoVec);
+
 private:
   vtkPVCompositeDataPipeline(const vtkPVCompositeDataPipeline&);  // Not implemented.
   void operator=(const vtkPVCompositeDataPipeline&);  // Not implemented.
@@ -27,6 +27,8 @@
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTable.h"
@@ -275,6 +277,111 @@ inline int vtkExtractHistogramClamp(int value, int min, int max)
   return value;
 }
 
+namespace
+{
+  // Bins a component of an array and, when averages are requested, sums the
+  // values of the other arrays per bin. Each thread bins a range of tuples in
+  // its own bins which are then added to Counts and Totals.
+  template <class T>
+  class vtkExtractHistogramBinner
+    {
+  public:
+    const T* Data;
+    int NumberOfComponents;
+    int Component;
+    double Min;
+    double BinDelta;
+    int BinCount;
+
+    // Arrays to average and offset of their totals in Totals, the last
+    // offset is the size of Totals.
+    const std::vector<vtkDataArray*>* Arrays;
+    const std::vector<vtkIdType>* Offsets;
+
+    std::vector<vtkIdType>* Counts;
+    std::vector<double>* Totals;
+
+    vtkSMPThreadLocal<std::vector<vtkIdType> > LocalCounts;
+    vtkSMPThreadLocal<std::vector<double> > LocalTotals;
+
+    void Initialize()
+      {
+      this->LocalCounts.Local().assign(this->BinCount, 0);
+      this->LocalTotals.Local().assign(this->Offsets->back(), 0.0);
+      }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      std::vector<vtkIdType>& counts = this->LocalCounts.Local();
+      std::vector<double>& totals = this->LocalTotals.Local();
+      const size_t numArrays = this->Arrays->size();
+      const T* ptr =
+        this->Data + begin * this->NumberOfComponents + this->Component;
+      for (vtkIdType i = begin; i < end; ++i, ptr += this->NumberOfComponents)
+        {
+        int index = static_cast<int>(
+          (static_cast<double>(*ptr) - this->Min) / this->BinDelta);
+        // If the value is equal to max, include it in the last bin.
+        index = ::vtkExtractHistogramClamp(index, 0, this->BinCount-1);
+        counts[index]++;
+        for (size_t cc = 0; cc < numArrays; ++cc)
+          {
+          vtkDataArray* array = (*this->Arrays)[cc];
+          const int numComps = array->GetNumberOfComponents();
+          double* total = &totals[(*this->Offsets)[cc] + index * numComps];
+          for (int comp = 0; comp < numComps; comp++)
+            {
+            total[comp] += array->GetComponent(i, comp);
+            }
+          }
+        }
+      }
+
+    void Reduce()
+      {
+      typename vtkSMPThreadLocal<std::vector<vtkIdType> >::iterator citer;
+      for (citer = this->LocalCounts.begin();
+        citer != this->LocalCounts.end(); ++citer)
+        {
+        for (int cc = 0; cc < this->BinCount; ++cc)
+          {
+          (*this->Counts)[cc] += (*citer)[cc];
+          }
+        }
+      typename vtkSMPThreadLocal<std::vector<double> >::iterator titer;
+      for (titer = this->LocalTotals.begin();
+        titer != this->LocalTotals.end(); ++titer)
+        {
+        for (size_t cc = 0; cc < titer->size(); ++cc)
+          {
+          (*this->Totals)[cc] += (*titer)[cc];
+          }
+        }
+      }
+    };
+
+  template <class T>
+  void vtkExtractHistogramBin(const T* data, vtkIdType numTuples,
+    int numComps, int component, double min, double binDelta, int binCount,
+    const std::vector<vtkDataArray*>& arrays,
+    const std::vector<vtkIdType>& offsets, vtkIdType grain,
+    std::vector<vtkIdType>& counts, std::vector<double>& totals)
+    {
+    vtkExtractHistogramBinner<T> binner;
+    binner.Data = data;
+    binner.NumberOfComponents = numComps;
+    binner.Component = component;
+    binner.Min = min;
+    binner.BinDelta = binDelta;
+    binner.BinCount = binCount;
+    binner.Arrays = &arrays;
+    binner.Offsets = &offsets;
+    binner.Counts = &counts;
+    binner.Totals = &totals;
+    vtkSMPTools::For(0, numTuples, grain, binner);
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkExtractHistogram::BinAnArray(vtkDataArray *data_array,
                                      vtkIntArray *bin_values,
@@ -290,46 +397,83 @@ void vtkExtractHistogram::BinAnArray(vtkDataArray *data_array,
     return;
     }
 
-  int num_of_tuples = data_array->GetNumberOfTuples();
-  double bin_delta = (max-min)/this->BinCount;
-  for(int i = 0; i != num_of_tuples; ++i)
+  vtkIdType num_of_tuples = data_array->GetNumberOfTuples();
+  if (num_of_tuples == 0)
     {
-    if (i%1000 == 0)
+    return;
+    }
+  this->UpdateProgress(0.10);
+
+  // For each bin, we will need the total of the values of all other arrays,
+  // at the end, each total is divided by the number of elements in the bin.
+  std::vector<vtkDataArray*> arrays;
+  std::vector<vtkIdType> offsets(1, 0);
+  bool threadSafe = true;
+  if (this->CalculateAverages)
+    {
+    int num_arrays = field->GetNumberOfArrays();
+    for (int idx=0; idx<num_arrays; idx++)
       {
-      this->UpdateProgress(0.10 + 0.90*i/num_of_tuples);
+      vtkDataArray* array = field->GetArray(idx);
+      if (array && array != data_array && array->GetName() &&
+        array->GetNumberOfTuples() >= num_of_tuples)
+        {
+        arrays.push_back(array);
+        offsets.push_back(offsets.back() +
+          static_cast<vtkIdType>(this->BinCount) *
+          array->GetNumberOfComponents());
+        // Arrays with a non-standard memory layout may not support
+        // concurrent reads.
+        threadSafe = threadSafe && array->HasStandardMemoryLayout();
+        }
       }
-    const double value = data_array->GetComponent(i, this->Component);
-    int index = static_cast<int>((value - min) / bin_delta);
-    // If the value is equal to max, include it in the last bin.
-    index = ::vtkExtractHistogramClamp(index, 0, this->BinCount-1);
-    bin_values->SetValue(index, bin_values->GetValue(index)+1);
+    }
 
-    if (this->CalculateAverages)
+  vtkSmartPointer<vtkDataArray> values = data_array;
+  if (!data_array->HasStandardMemoryLayout())
+    {
+    values.TakeReference(vtkDoubleArray::New());
+    values->DeepCopy(data_array);
+    }
+
+  std::vector<vtkIdType> counts(this->BinCount, 0);
+  std::vector<double> totals(offsets.back(), 0.0);
+  const vtkIdType grain = threadSafe? 0 : num_of_tuples;
+  const double bin_delta = (max-min)/this->BinCount;
+  switch (values->GetDataType())
+    {
+    vtkTemplateMacro(
+      vtkExtractHistogramBin(
+        static_cast<VTK_TT*>(values->GetVoidPointer(0)), num_of_tuples,
+        values->GetNumberOfComponents(), this->Component, min, bin_delta,
+        this->BinCount, arrays, offsets, grain, counts, totals));
+    default:
+      vtkErrorMacro("Unsupported array type " << values->GetDataTypeAsString());
+      return;
+    }
+
+  for (int i = 0; i < this->BinCount; ++i)
+    {
+    bin_values->SetValue(i,
+      bin_values->GetValue(i) + static_cast<int>(counts[i]));
+    }
+  for (size_t cc = 0; cc < arrays.size(); ++cc)
+    {
+    vtkEHInternals::ArrayValuesType& arrayValues =
+      this->Internal->ArrayValues[arrays[cc]->GetName()];
+    arrayValues.TotalValues.resize(this->BinCount);
+    int numComps = arrays[cc]->GetNumberOfComponents();
+    const double* total = &totals[offsets[cc]];
+    for (int i = 0; i < this->BinCount; ++i)
       {
-      // Get all other arrays, add their value to the bin
-      // For each bin, we will need 2 values per array ->
-      // total, num. elements
-      // at the end, divide each total by num. elements
-      int num_arrays = field->GetNumberOfArrays();
-      for (int idx=0; idx<num_arrays; idx++)
+      arrayValues.TotalValues[i].resize(numComps);
+      for (int comp = 0; comp < numComps; ++comp, ++total)
         {
-        vtkDataArray* array = field->GetArray(idx);
-        if (array && array != data_array && array->GetName())
-          {
-          vtkEHInternals::ArrayValuesType& arrayValues =
-            this->Internal->ArrayValues[array->GetName()];
-          arrayValues.TotalValues.resize(this->BinCount);
-          int numComps = array->GetNumberOfComponents();
-          arrayValues.TotalValues[index].resize(numComps);
-          for (int comp=0; comp<numComps; comp++)
-            {
-            arrayValues.TotalValues[index][comp] +=
-              array->GetComponent(i, comp);
-            }
-          }
+        arrayValues.TotalValues[i][comp] += *total;
         }
       }
     }
+  this->UpdateProgress(1.0);
 }
 
 //-----------------------------------------------------------------------------
@@ -27,17 +27,22 @@
 #include "vtkClientServerInterpreterInitializer.h"
 #include "vtkClientServerInterpreter.h"
 #include "vtkClientServerStream.h"
+#include "vtkCommunicator.h"
+#include "vtkDoubleArray.h"
 #include "vtkGenericDataObjectReader.h"
 #include "vtkInformation.h"
 #include "vtkInformationIntegerKey.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
 #include "vtkTypeTraits.h"
 
+#include <vtksys/SystemTools.hxx>
+
 #include "vtkSmartPointer.h"
 #define VTK_CREATE(type, name) \
   vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
@@ -45,9 +50,11 @@
 #include <algorithm>
 #include <map>
 #include <set>
+#include <sstream>
 #include <string>
 #include <vector>
 #include <ctype.h> // for isprint().
+#include <stdio.h> // for rename().
 
 //=============================================================================
 vtkStandardNewMacro(vtkFileSeriesReader);
@@ -316,6 +323,205 @@ std::vector<double> vtkFileSeriesReaderTimeRanges::GetTimesForInput(
   return times;
 }
 
+//=============================================================================
+// Internal class for the persistent time index: the time information reported
+// by each file of a series along with the modification time and size of the
+// file when it was read.
+class vtkFileSeriesReaderTimeIndex
+{
+public:
+  struct Entry
+    {
+    long MTime;
+    unsigned long Size;
+    std::vector<double> TimeSteps;
+    bool HasTimeRange;
+    double TimeRange[2];
+
+    Entry() : MTime(0), Size(0), HasTimeRange(false)
+      {
+      this->TimeRange[0] = this->TimeRange[1] = 0.0;
+      }
+
+    void Stat(const std::string& fname)
+      {
+      this->MTime = vtksys::SystemTools::ModifiedTime(fname.c_str());
+      this->Size = vtksys::SystemTools::FileLength(fname.c_str());
+      }
+
+    bool SameFile(const Entry& other) const
+      {
+      return this->MTime == other.MTime && this->Size == other.Size;
+      }
+
+    void SetTimeInformation(vtkInformation* info);
+    void GetTimeInformation(vtkInformation* info) const;
+    void Serialize(vtkDoubleArray* buffer) const;
+    bool Deserialize(const double* buffer, vtkIdType size, vtkIdType& pos);
+    };
+
+  bool Read(const std::string& indexName, const std::string& readerName);
+  bool Write(const std::string& indexName, const std::string& readerName);
+
+  std::map<std::string, Entry> Entries;
+};
+
+namespace
+{
+  const char* TIME_INDEX_HEADER = "vtkFileSeriesReader time index 1";
+}
+
+//-----------------------------------------------------------------------------
+void vtkFileSeriesReaderTimeIndex::Entry::SetTimeInformation(
+  vtkInformation* info)
+{
+  this->TimeSteps.clear();
+  if (info->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()))
+    {
+    double* timeSteps = info->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    int numTimeSteps =
+      info->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    this->TimeSteps.assign(timeSteps, timeSteps + numTimeSteps);
+    }
+  this->HasTimeRange =
+    info->Has(vtkStreamingDemandDrivenPipeline::TIME_RANGE()) != 0;
+  if (this->HasTimeRange)
+    {
+    info->Get(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), this->TimeRange);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkFileSeriesReaderTimeIndex::Entry::GetTimeInformation(
+  vtkInformation* info) const
+{
+  if (!this->TimeSteps.empty())
+    {
+    info->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(),
+      &this->TimeSteps[0], static_cast<int>(this->TimeSteps.size()));
+    }
+  if (this->HasTimeRange)
+    {
+    info->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(),
+      this->TimeRange, 2);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkFileSeriesReaderTimeIndex::Entry::Serialize(
+  vtkDoubleArray* buffer) const
+{
+  buffer->InsertNextValue(this->MTime);
+  buffer->InsertNextValue(this->Size);
+  buffer->InsertNextValue(static_cast<double>(this->TimeSteps.size()));
+  for (size_t cc = 0; cc < this->TimeSteps.size(); ++cc)
+    {
+    buffer->InsertNextValue(this->TimeSteps[cc]);
+    }
+  buffer->InsertNextValue(this->HasTimeRange? 1 : 0);
+  buffer->InsertNextValue(this->TimeRange[0]);
+  buffer->InsertNextValue(this->TimeRange[1]);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkFileSeriesReaderTimeIndex::Entry::Deserialize(
+  const double* buffer, vtkIdType size, vtkIdType& pos)
+{
+  if (pos + 3 > size)
+    {
+    return false;
+    }
+  this->MTime = static_cast<long>(buffer[pos++]);
+  this->Size = static_cast<unsigned long>(buffer[pos++]);
+  vtkIdType numTimeSteps = static_cast<vtkIdType>(buffer[pos++]);
+  if (numTimeSteps < 0 || pos + numTimeSteps + 3 > size)
+    {
+    return false;
+    }
+  this->TimeSteps.assign(buffer + pos, buffer + pos + numTimeSteps);
+  pos += numTimeSteps;
+  this->HasTimeRange = buffer[pos++] != 0;
+  this->TimeRange[0] = buffer[pos++];
+  this->TimeRange[1] = buffer[pos++];
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkFileSeriesReaderTimeIndex::Read(const std::string& indexName,
+  const std::string& readerName)
+{
+  this->Entries.clear();
+  ifstream file(indexName.c_str());
+  std::string line;
+  if (!std::getline(file, line) || line != TIME_INDEX_HEADER ||
+    !std::getline(file, line) || line != readerName)
+    {
+    return false;
+    }
+
+  // Each file takes two lines: its name and its time information.
+  std::string fname;
+  while (std::getline(file, fname) && std::getline(file, line))
+    {
+    std::istringstream values(line);
+    Entry entry;
+    size_t numTimeSteps = 0;
+    values >> entry.MTime >> entry.Size >> numTimeSteps;
+    for (size_t cc = 0; values && cc < numTimeSteps; ++cc)
+      {
+      double time;
+      values >> time;
+      entry.TimeSteps.push_back(time);
+      }
+    values >> entry.HasTimeRange >> entry.TimeRange[0] >> entry.TimeRange[1];
+    if (!values)
+      {
+      // Truncated or corrupted index, ignore it.
+      this->Entries.clear();
+      return false;
+      }
+    this->Entries[fname] = entry;
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkFileSeriesReaderTimeIndex::Write(const std::string& indexName,
+  const std::string& readerName)
+{
+  // Write to a temporary file first so that readers never see a partial
+  // index.
+  std::string tmpName = indexName + ".tmp";
+  ofstream file(tmpName.c_str());
+  if (!file)
+    {
+    return false;
+    }
+  file.precision(17);
+  file << TIME_INDEX_HEADER << "\n" << readerName << "\n";
+  std::map<std::string, Entry>::const_iterator iter;
+  for (iter = this->Entries.begin(); iter != this->Entries.end(); ++iter)
+    {
+    const Entry& entry = iter->second;
+    file << iter->first << "\n"
+      << entry.MTime << " " << entry.Size << " " << entry.TimeSteps.size();
+    for (size_t cc = 0; cc < entry.TimeSteps.size(); ++cc)
+      {
+      file << " " << entry.TimeSteps[cc];
+      }
+    file << " " << entry.HasTimeRange << " " << entry.TimeRange[0] << " "
+      << entry.TimeRange[1] << "\n";
+    }
+  file.close();
+  if (!file)
+    {
+    vtksys::SystemTools::RemoveFile(tmpName.c_str());
+    return false;
+    }
+  vtksys::SystemTools::RemoveFile(indexName.c_str());
+  return rename(tmpName.c_str(), indexName.c_str()) == 0;
+}
+
 namespace
 {
   // Helper class used to ensure that ProcessRequest() never results in change
@@ -388,6 +594,9 @@ vtkFileSeriesReader::vtkFileSeriesReader()
   this->UseMetaFile = 0;
 
   this->IgnoreReaderTime = 0;
+  this->UseTimeIndex = 0;
+  this->TimeIndexFileName = NULL;
+  this->DistributeTimeDiscovery = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -395,6 +604,7 @@ vtkFileSeriesReader::~vtkFileSeriesReader()
 {
   delete this->Internal->TimeRanges;
   delete this->Internal;
+  this->SetTimeIndexFileName(NULL);
 }
 
 
@@ -592,11 +802,18 @@ int vtkFileSeriesReader::RequestInformation(
     // Record the reported file time info.
     this->Internal->TimeRanges->AddTimeRange(0, outInfo);
 
-    // Query all the other files for time info.
-    for (int i = 1; i < numFiles; i++)
+    if (this->UseTimeIndex || this->DistributeTimeDiscovery)
       {
-      this->RequestInformationForInput(i, request, outputVector);
-      this->Internal->TimeRanges->AddTimeRange(i, outInfo);
+      this->CollectTimeInformation(requestFromPort, outInfo);
+      }
+    else
+      {
+      // Query all the other files for time info.
+      for (int i = 1; i < numFiles; i++)
+        {
+        this->RequestInformationForInput(i, request, outputVector);
+        this->Internal->TimeRanges->AddTimeRange(i, outInfo);
+        }
       }
     }
 
@@ -730,6 +947,152 @@ int vtkFileSeriesReader::RequestInformationForInput(
   return 1;
 }
 
+//-----------------------------------------------------------------------------
+void vtkFileSeriesReader::ProbeTimeInformation(int index, int port,
+                                               vtkInformation* timeInfo)
+{
+  VTK_CREATE(vtkInformationVector, outputVector);
+  for (int cc=0; cc < this->GetNumberOfOutputPorts(); ++cc)
+    {
+    VTK_CREATE(vtkInformation, outInfo);
+    outputVector->Append(outInfo);
+    }
+  this->RequestInformationForInput(index, NULL, outputVector);
+
+  vtkInformation* outInfo = outputVector->GetInformationObject(port);
+  if (outInfo->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()))
+    {
+    timeInfo->CopyEntry(outInfo, vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    }
+  if (outInfo->Has(vtkStreamingDemandDrivenPipeline::TIME_RANGE()))
+    {
+    timeInfo->CopyEntry(outInfo, vtkStreamingDemandDrivenPipeline::TIME_RANGE());
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkFileSeriesReader::CollectTimeInformation(int port,
+                                                 vtkInformation* firstTimeInfo)
+{
+  typedef vtkFileSeriesReaderTimeIndex::Entry EntryType;
+  const int numFiles = static_cast<int>(this->GetNumberOfFileNames());
+  const std::string readerName = this->Reader->GetClassName();
+
+  std::string indexName;
+  vtkFileSeriesReaderTimeIndex index;
+  if (this->UseTimeIndex)
+    {
+    if (this->TimeIndexFileName && this->TimeIndexFileName[0])
+      {
+      indexName = this->TimeIndexFileName;
+      }
+    else
+      {
+      std::string series = (this->UseMetaFile && this->_MetaFileName)?
+        this->_MetaFileName : this->GetFileName(0);
+      std::string path = vtksys::SystemTools::GetFilenamePath(series);
+      indexName = (path.empty()? std::string() : path + "/") + "." +
+        vtksys::SystemTools::GetFilenameName(series) + ".timeindex";
+      }
+    index.Read(indexName, readerName);
+    }
+
+  vtkMultiProcessController* controller = this->DistributeTimeDiscovery?
+    vtkMultiProcessController::GetGlobalController() : NULL;
+  const int numProcs = controller? controller->GetNumberOfProcesses() : 1;
+  const int myId = controller? controller->GetLocalProcessId() : 0;
+
+  // The files but the first one are split in contiguous ranges among the
+  // processes. Each process looks up its files in the index, reads the time
+  // information of the ones that are not in it or changed since, and sends
+  // the results to all the others.
+  const int numOthers = numFiles - 1;
+  const int begin = 1 + static_cast<int>(
+    static_cast<vtkTypeInt64>(numOthers) * myId / numProcs);
+  const int end = 1 + static_cast<int>(
+    static_cast<vtkTypeInt64>(numOthers) * (myId + 1) / numProcs);
+  VTK_CREATE(vtkDoubleArray, localBuffer);
+  int numRead = 0;
+  for (int i = begin; i < end; i++)
+    {
+    const std::string fname = this->GetFileName(i);
+    EntryType entry;
+    entry.Stat(fname);
+    std::map<std::string, EntryType>::const_iterator iter =
+      index.Entries.find(fname);
+    if (iter != index.Entries.end() && iter->second.SameFile(entry))
+      {
+      entry = iter->second;
+      }
+    else
+      {
+      VTK_CREATE(vtkInformation, timeInfo);
+      this->ProbeTimeInformation(i, port, timeInfo);
+      entry.SetTimeInformation(timeInfo);
+      numRead++;
+      }
+    localBuffer->InsertNextValue(i);
+    entry.Serialize(localBuffer);
+    }
+
+  vtkSmartPointer<vtkDoubleArray> buffer = localBuffer;
+  if (numProcs > 1)
+    {
+    buffer = vtkSmartPointer<vtkDoubleArray>::New();
+    controller->AllGatherV(localBuffer.GetPointer(), buffer.GetPointer());
+    int totalRead = 0;
+    controller->AllReduce(&numRead, &totalRead, 1, vtkCommunicator::SUM_OP);
+    numRead = totalRead;
+    }
+
+  std::vector<EntryType> entries(numFiles);
+  entries[0].Stat(this->GetFileName(0));
+  entries[0].SetTimeInformation(firstTimeInfo);
+  const double* values = buffer->GetPointer(0);
+  const vtkIdType size = buffer->GetNumberOfTuples();
+  vtkIdType pos = 0;
+  while (pos < size)
+    {
+    int i = static_cast<int>(values[pos++]);
+    if (i < 1 || i >= numFiles || !entries[i].Deserialize(values, size, pos))
+      {
+      vtkErrorMacro("Invalid time information received.");
+      break;
+      }
+    }
+
+  for (int i = 1; i < numFiles; i++)
+    {
+    VTK_CREATE(vtkInformation, timeInfo);
+    entries[i].GetTimeInformation(timeInfo);
+    this->Internal->TimeRanges->AddTimeRange(i, timeInfo);
+    }
+
+  if (indexName.empty() || myId != 0)
+    {
+    return;
+    }
+
+  // Update the index if any file was read or the series changed.
+  std::map<std::string, EntryType>::const_iterator first =
+    index.Entries.find(this->GetFileName(0));
+  if (numRead == 0 &&
+    index.Entries.size() == static_cast<size_t>(numFiles) &&
+    first != index.Entries.end() && first->second.SameFile(entries[0]))
+    {
+    return;
+    }
+  index.Entries.clear();
+  for (int i = 0; i < numFiles; i++)
+    {
+    index.Entries[this->GetFileName(i)] = entries[i];
+    }
+  if (!index.Write(indexName, readerName))
+    {
+    vtkWarningMacro("Could not write the time index " << indexName);
+    }
+}
+
 //-----------------------------------------------------------------------------
 int vtkFileSeriesReader::FillOutputPortInformation(int port,
                                                    vtkInformation* info)
@@ -818,6 +1181,11 @@ void vtkFileSeriesReader::PrintSelf(ostream& os, vtkIndent indent)
      << (this->_MetaFileName?this->_MetaFileName:"(none)") << endl;
   os << indent << "UseMetaFile: " << this->UseMetaFile << endl;
   os << indent << "IgnoreReaderTime: " << this->IgnoreReaderTime << endl;
+  os << indent << "UseTimeIndex: " << this->UseTimeIndex << endl;
+  os << indent << "TimeIndexFileName: "
+     << (this->TimeIndexFileName? this->TimeIndexFileName : "(none)") << endl;
+  os << indent << "DistributeTimeDiscovery: "
+     << this->DistributeTimeDiscovery << endl;
 }
 
 //-----------------------------------------------------------------------------
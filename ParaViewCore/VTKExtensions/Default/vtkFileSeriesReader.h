@@ -108,6 +108,31 @@ public:
   vtkSetMacro(IgnoreReaderTime, int);
   vtkBooleanMacro(IgnoreReaderTime, int);
 
+  // Description:
+  // If true, the time values reported by the files of the series are saved
+  // to a time index file the first time the series is opened and reused the
+  // next times for the files that did not change since (based on their
+  // modification time and size). False by default.
+  vtkGetMacro(UseTimeIndex, int);
+  vtkSetMacro(UseTimeIndex, int);
+  vtkBooleanMacro(UseTimeIndex, int);
+
+  // Description:
+  // Name of the time index file used when UseTimeIndex is true. When not set,
+  // ".<name>.timeindex" is used, where <name> is the name of the meta file or
+  // of the first file of the series, in the same directory.
+  vtkSetStringMacro(TimeIndexFileName);
+  vtkGetStringMacro(TimeIndexFileName);
+
+  // Description:
+  // If true, the processes of the global controller split among themselves
+  // the files whose time values need to be read and share the results, in
+  // which case RequestInformation must be called on all the processes at the
+  // same time. False by default.
+  vtkGetMacro(DistributeTimeDiscovery, int);
+  vtkSetMacro(DistributeTimeDiscovery, int);
+  vtkBooleanMacro(DistributeTimeDiscovery, int);
+
 protected:
   vtkFileSeriesReader();
   ~vtkFileSeriesReader();
@@ -163,6 +188,21 @@ protected:
   void AddFileNameInternal(const char*);
 
   int IgnoreReaderTime;
+  int UseTimeIndex;
+  char* TimeIndexFileName;
+  int DistributeTimeDiscovery;
+
+  // Description:
+  // Collects the time information of the files of the series but the first
+  // one using the time index and/or the other processes, as requested by
+  // UseTimeIndex and DistributeTimeDiscovery. \c firstTimeInfo is the time
+  // information of the first file on output port \c port.
+  void CollectTimeInformation(int port, vtkInformation* firstTimeInfo);
+
+  // Description:
+  // Copies the time information reported by the reader for a file on output
+  // port \c port to \c timeInfo.
+  void ProbeTimeInformation(int index, int port, vtkInformation* timeInfo);
 
   int ChooseInput(vtkInformation*);
 private:
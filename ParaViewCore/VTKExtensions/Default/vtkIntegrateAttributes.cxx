@@ -16,24 +16,36 @@
 
 #include "vtkCellData.h"
 #include "vtkCellType.h"
+#include "vtkCharArray.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataPipeline.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkMultiProcessController.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
-#include "vtkPointData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkTriangle.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <utility>
+#include <vector>
 
 vtkStandardNewMacro(vtkIntegrateAttributes);
 
@@ -41,9 +53,278 @@ class vtkIntegrateAttributes::vtkFieldList :
   public vtkDataSetAttributes::FieldList
 {
 public:
-  vtkFieldList(int numInputs) : vtkDataSetAttributes::FieldList(numInputs) { }
+  vtkFieldList(int numInputs) :
+    vtkDataSetAttributes::FieldList(numInputs), NumberOfValues(0) { }
   void SetFieldIndex(int i, int index)
       { this->vtkDataSetAttributes::FieldList::SetFieldIndex(i, index); }
+
+  // Offset of the integrals of each field in the values of a vtkAccumulator,
+  // -1 for the fields that are not integrated.
+  std::vector<int> Offsets;
+  int NumberOfValues;
+};
+
+class vtkIntegrateAttributes::vtkAccumulator
+{
+public:
+  int Dimension;
+  double Sum;
+  double SumCenter[3];
+  std::vector<double> PointValues;
+  std::vector<double> CellValues;
+  // Cells that could not be integrated. They are counted, not reported, by
+  // the threads and are not reset along with the integrals.
+  vtkIdType NumberOfSkippedCells;
+
+  vtkAccumulator() : Dimension(0), Sum(0.0), NumberOfSkippedCells(0)
+    {
+    this->SumCenter[0] = this->SumCenter[1] = this->SumCenter[2] = 0.0;
+    }
+
+  void Initialize(int numPointValues, int numCellValues)
+    {
+    this->Dimension = 0;
+    this->Sum = 0.0;
+    this->SumCenter[0] = this->SumCenter[1] = this->SumCenter[2] = 0.0;
+    this->PointValues.assign(numPointValues, 0.0);
+    this->CellValues.assign(numCellValues, 0.0);
+    }
+
+  double* GetPointValues()
+    {
+    return this->PointValues.empty()? NULL : &this->PointValues[0];
+    }
+  double* GetCellValues()
+    {
+    return this->CellValues.empty()? NULL : &this->CellValues[0];
+    }
+
+  // Higher dimension prevails: integrals of a lower dimension are thrown out
+  // and cells of a lower dimension are skipped.
+  bool CompareDimension(int dim)
+    {
+    if (this->Dimension < dim)
+      {
+      this->Initialize(static_cast<int>(this->PointValues.size()),
+        static_cast<int>(this->CellValues.size()));
+      this->Dimension = dim;
+      return true;
+      }
+    return (this->Dimension == dim);
+    }
+
+  void Add(const vtkAccumulator& other)
+    {
+    const vtkIdType numSkipped =
+      this->NumberOfSkippedCells + other.NumberOfSkippedCells;
+    if (other.Dimension > this->Dimension)
+      {
+      *this = other;
+      }
+    else if (other.Dimension == this->Dimension)
+      {
+      this->Sum += other.Sum;
+      for (int i = 0; i < 3; ++i)
+        {
+        this->SumCenter[i] += other.SumCenter[i];
+        }
+      for (size_t i = 0; i < this->PointValues.size(); ++i)
+        {
+        this->PointValues[i] += other.PointValues[i];
+        }
+      for (size_t i = 0; i < this->CellValues.size(); ++i)
+        {
+        this->CellValues[i] += other.CellValues[i];
+        }
+      }
+    this->NumberOfSkippedCells = numSkipped;
+    }
+};
+
+// Integrates a range of cells of a block into an accumulator per thread.
+class vtkIntegrateAttributes::vtkIntegrateCellsFunctor
+{
+public:
+  vtkIntegrateAttributes* Self;
+  vtkDataSet* Input;
+  vtkUnsignedCharArray* GhostArray;
+  vtkAccumulator* Result;
+
+  vtkSMPThreadLocal<vtkAccumulator> Accumulators;
+  vtkSMPThreadLocalObject<vtkIdList> CellPointIds;
+  vtkSMPThreadLocalObject<vtkPoints> CellPoints;
+  vtkSMPThreadLocalObject<vtkGenericCell> Cells;
+
+  void Initialize()
+    {
+    this->Accumulators.Local().Initialize(
+      this->Self->PointFieldList->NumberOfValues,
+      this->Self->CellFieldList->NumberOfValues);
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkIntegrateAttributes* self = this->Self;
+    vtkDataSet* input = this->Input;
+    vtkAccumulator& acc = this->Accumulators.Local();
+    vtkIdList* cellPtIds = this->CellPointIds.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      // Make sure we are not integrating ghost/blanked cells.
+      if (this->GhostArray &&
+          (this->GhostArray->GetValue(cellId) &
+           (vtkDataSetAttributes::DUPLICATECELL |
+            vtkDataSetAttributes::HIDDENCELL)))
+        {
+        continue;
+        }
+
+      switch (input->GetCellType(cellId))
+        {
+        // skip empty or 0D Cells
+        case VTK_EMPTY_CELL:
+        case VTK_VERTEX:
+        case VTK_POLY_VERTEX:
+          break;
+
+        case VTK_POLY_LINE:
+        case VTK_LINE:
+        {
+        if (acc.CompareDimension(1))
+          {
+          input->GetCellPoints(cellId, cellPtIds);
+          self->IntegratePolyLine(input, acc, cellId, cellPtIds);
+          }
+        }
+        break;
+
+        case VTK_TRIANGLE:
+        {
+        if (acc.CompareDimension(2))
+          {
+          input->GetCellPoints(cellId, cellPtIds);
+          self->IntegrateTriangle(input, acc, cellId, cellPtIds->GetId(0),
+                                  cellPtIds->GetId(1), cellPtIds->GetId(2));
+          }
+        }
+        break;
+
+        case VTK_TRIANGLE_STRIP:
+        {
+        if (acc.CompareDimension(2))
+          {
+          input->GetCellPoints(cellId, cellPtIds);
+          self->IntegrateTriangleStrip(input, acc, cellId, cellPtIds);
+          }
+        }
+        break;
+
+        case VTK_POLYGON:
+        {
+        if (acc.CompareDimension(2))
+          {
+          input->GetCellPoints(cellId, cellPtIds);
+          self->IntegratePolygon(input, acc, cellId, cellPtIds);
+          }
+        }
+        break;
+
+        case VTK_PIXEL:
+        {
+        if (acc.CompareDimension(2))
+          {
+          input->GetCellPoints(cellId, cellPtIds);
+          self->IntegratePixel(input, acc, cellId, cellPtIds);
+          }
+        }
+        break;
+
+        case VTK_QUAD:
+        {
+        if (acc.CompareDimension(2))
+          {
+          vtkIdType pt1Id, pt2Id, pt3Id;
+          input->GetCellPoints(cellId, cellPtIds);
+          pt1Id = cellPtIds->GetId(0);
+          pt2Id = cellPtIds->GetId(1);
+          pt3Id = cellPtIds->GetId(2);
+          self->IntegrateTriangle(input, acc, cellId, pt1Id, pt2Id, pt3Id);
+          pt2Id = cellPtIds->GetId(3);
+          self->IntegrateTriangle(input, acc, cellId, pt1Id, pt2Id, pt3Id);
+          }
+        }
+        break;
+
+        case VTK_VOXEL:
+        {
+        if (acc.CompareDimension(3))
+          {
+          input->GetCellPoints(cellId, cellPtIds);
+          self->IntegrateVoxel(input, acc, cellId, cellPtIds);
+          }
+        }
+        break;
+
+        case VTK_TETRA:
+        {
+        if (acc.CompareDimension(3))
+          {
+          vtkIdType pt1Id, pt2Id, pt3Id, pt4Id;
+          input->GetCellPoints(cellId, cellPtIds);
+          pt1Id = cellPtIds->GetId(0);
+          pt2Id = cellPtIds->GetId(1);
+          pt3Id = cellPtIds->GetId(2);
+          pt4Id = cellPtIds->GetId(3);
+          self->IntegrateTetrahedron(input, acc, cellId, pt1Id, pt2Id,
+                                     pt3Id, pt4Id);
+          }
+        }
+        break;
+
+        default:
+        {
+        // We need to explicitly get the cell
+        vtkGenericCell* cell = this->Cells.Local();
+        input->GetCell(cellId, cell);
+        int cellDim = cell->GetCellDimension();
+        if (cellDim == 0)
+          {
+          continue;
+          }
+        if (!acc.CompareDimension(cellDim))
+          {
+          continue;
+          }
+
+        cell->Triangulate(1, cellPtIds, this->CellPoints.Local());
+        switch (cellDim)
+          {
+          case 1:
+            self->IntegrateGeneral1DCell(input, acc, cellId, cellPtIds);
+            break;
+          case 2:
+            self->IntegrateGeneral2DCell(input, acc, cellId, cellPtIds);
+            break;
+          case 3:
+            self->IntegrateGeneral3DCell(input, acc, cellId, cellPtIds);
+            break;
+          default:
+            ++acc.NumberOfSkippedCells;
+          }
+        }
+        }
+      }
+    }
+
+  void Reduce()
+    {
+    vtkSMPThreadLocal<vtkAccumulator>::iterator iter;
+    for (iter = this->Accumulators.begin();
+      iter != this->Accumulators.end(); ++iter)
+      {
+      this->Result->Add(*iter);
+      }
+    }
 };
 
 //-----------------------------------------------------------------------------
@@ -105,32 +386,18 @@ int vtkIntegrateAttributes::FillInputPortInformation(int port,
   return 1;
 }
 
-//-----------------------------------------------------------------------------
-int vtkIntegrateAttributes::CompareIntegrationDimension(vtkDataSet* output,
-                                                        int dim)
-{
-  // higher dimension prevails
-  if (this->IntegrationDimension < dim)
-    { // Throw out results from lower dimension.
-    this->Sum = 0;
-    this->SumCenter[0] = this->SumCenter[1] = this->SumCenter[2] = 0.0;
-    this->ZeroAttributes(output->GetPointData());
-    this->ZeroAttributes(output->GetCellData());
-    this->IntegrationDimension = dim;
-    return 1;
-    }
-  // Skip this cell if we are inetrgrting a higher dimension.
-  return (this->IntegrationDimension == dim);
-}
-
 //----------------------------------------------------------------------------
 void vtkIntegrateAttributes::ExecuteBlock(
-  vtkDataSet* input, vtkUnstructuredGrid* output,
+  vtkDataSet* input, vtkAccumulator& acc,
   int fieldset_index,
   vtkIntegrateAttributes::vtkFieldList& pdList,
   vtkIntegrateAttributes::vtkFieldList& cdList)
 {
-  vtkUnsignedCharArray* ghostArray = input->GetCellGhostArray();
+  vtkIdType numCells = input->GetNumberOfCells();
+  if (numCells == 0)
+    {
+    return;
+    }
 
   // This is sort of a hack since it's incredibly painful to change all the
   // signatures to take the pdList, cdList and fieldset_index.
@@ -138,169 +405,23 @@ void vtkIntegrateAttributes::ExecuteBlock(
   this->CellFieldList = &cdList;
   this->FieldListIndex = fieldset_index;
 
-  vtkIdList* cellPtIds = vtkIdList::New();
-  vtkIdType numCells = input->GetNumberOfCells();
-  vtkIdType cellId;
-  vtkPoints *cellPoints = 0; // needed if we need to split 3D cells
-  int cellType;
-  for (cellId = 0; cellId < numCells; ++cellId)
+  // Getting a cell once builds the cell structures of the data set (e.g. the
+  // cells of a vtkPolyData) which may then be accessed from several threads.
+  vtkNew<vtkGenericCell> cell;
+  input->GetCell(0, cell.GetPointer());
+
+  vtkIntegrateCellsFunctor functor;
+  functor.Self = this;
+  functor.Input = input;
+  functor.GhostArray = input->GetCellGhostArray();
+  functor.Result = &acc;
+  const vtkIdType numSkipped = acc.NumberOfSkippedCells;
+  vtkSMPTools::For(0, numCells, functor);
+  if (acc.NumberOfSkippedCells > numSkipped)
     {
-    cellType = input->GetCellType(cellId);
-    // Make sure we are not integrating ghost/blanked cells.
-    if (ghostArray &&
-        (ghostArray->GetValue(cellId) &
-         (vtkDataSetAttributes::DUPLICATECELL |
-          vtkDataSetAttributes::HIDDENCELL)))
-      {
-      continue;
-      }
-
-    switch (cellType)
-      {
-      // skip empty or 0D Cells
-      case VTK_EMPTY_CELL:
-      case VTK_VERTEX:
-      case VTK_POLY_VERTEX:
-        break;
-
-      case VTK_POLY_LINE:
-      case VTK_LINE:
-      {
-      if (this->CompareIntegrationDimension(output, 1))
-        {
-        input->GetCellPoints(cellId, cellPtIds);
-        this->IntegratePolyLine(input, output, cellId, cellPtIds);
-        }
-      }
-      break;
-
-      case VTK_TRIANGLE:
-      {
-      if (this->CompareIntegrationDimension(output, 2))
-        {
-        input->GetCellPoints(cellId, cellPtIds);
-        this->IntegrateTriangle(input,output,cellId,cellPtIds->GetId(0),
-                                cellPtIds->GetId(1),cellPtIds->GetId(2));
-        }
-      }
-      break;
-
-      case VTK_TRIANGLE_STRIP:
-      {
-      if (this->CompareIntegrationDimension(output, 2))
-        {
-        input->GetCellPoints(cellId, cellPtIds);
-        this->IntegrateTriangleStrip(input, output, cellId, cellPtIds);
-        }
-      }
-      break;
-
-      case VTK_POLYGON:
-      {
-      if (this->CompareIntegrationDimension(output, 2))
-        {
-        input->GetCellPoints(cellId, cellPtIds);
-        this->IntegratePolygon(input, output, cellId, cellPtIds);
-        }
-      }
-      break;
-
-      case VTK_PIXEL:
-      {
-      if (this->CompareIntegrationDimension(output, 2))
-        {
-        input->GetCellPoints(cellId, cellPtIds);
-        this->IntegratePixel(input, output, cellId, cellPtIds);
-        }
-      }
-      break;
-
-      case VTK_QUAD:
-      {
-      if (this->CompareIntegrationDimension(output, 2))
-        {
-        vtkIdType pt1Id, pt2Id, pt3Id;
-        input->GetCellPoints(cellId, cellPtIds);
-        pt1Id = cellPtIds->GetId(0);
-        pt2Id = cellPtIds->GetId(1);
-        pt3Id = cellPtIds->GetId(2);
-        this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
-        pt2Id = cellPtIds->GetId(3);
-        this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
-        }
-      }
-      break;
-
-      case VTK_VOXEL:
-      {
-      if (this->CompareIntegrationDimension(output, 3))
-        {
-        input->GetCellPoints(cellId, cellPtIds);
-        this->IntegrateVoxel(input, output, cellId, cellPtIds);
-        }
-      }
-      break;
-
-      case VTK_TETRA:
-      {
-      if (this->CompareIntegrationDimension(output, 3))
-        {
-        vtkIdType pt1Id, pt2Id, pt3Id, pt4Id;
-        input->GetCellPoints(cellId, cellPtIds);
-        pt1Id = cellPtIds->GetId(0);
-        pt2Id = cellPtIds->GetId(1);
-        pt3Id = cellPtIds->GetId(2);
-        pt4Id = cellPtIds->GetId(3);
-        this->IntegrateTetrahedron(input, output, cellId, pt1Id, pt2Id,
-                                   pt3Id, pt4Id);
-        }
-      }
-      break;
-
-      default:
-      {
-      // We need to explicitly get the cell
-      vtkCell *cell = input->GetCell(cellId);
-      int cellDim = cell->GetCellDimension();
-      if (cellDim == 0)
-        {
-        continue;
-        }
-      if (!this->CompareIntegrationDimension(output, cellDim))
-        {
-        continue;
-        }
-
-      // We will need a place to store points from the cell's
-      // triangulate function
-      if (!cellPoints)
-        {
-        cellPoints = vtkPoints::New();
-        }
-
-      cell->Triangulate(1, cellPtIds, cellPoints);
-      switch (cellDim)
-        {
-        case 1:
-          this->IntegrateGeneral1DCell(input, output, cellId, cellPtIds);
-          break;
-        case 2:
-          this->IntegrateGeneral2DCell(input, output, cellId, cellPtIds);
-          break;
-        case 3:
-          this->IntegrateGeneral3DCell(input, output, cellId, cellPtIds);
-          break;
-        default:
-          vtkWarningMacro("Unsupported Cell Dimension = "
-                          << cellDim);
-        }
-      }
-      }
-    }
-  cellPtIds->Delete();
-  if (cellPoints)
-    {
-    cellPoints->Delete();
+    vtkWarningMacro("Skipped " << acc.NumberOfSkippedCells - numSkipped
+                    << " cells of " << numCells << " whose triangulation has"
+                    << " an unexpected number of points.");
     }
 
   this->PointFieldList = NULL;
@@ -330,6 +451,7 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
   vtkDataObject* input = inInfo->Get(vtkDataObject::DATA_OBJECT());
   vtkCompositeDataSet *compositeInput = vtkCompositeDataSet::SafeDownCast(input);
   vtkDataSet *dsInput = vtkDataSet::SafeDownCast(input);
+  vtkAccumulator total;
   if (compositeInput)
     {
     vtkCompositeDataIterator* iter = compositeInput->NewIterator();
@@ -401,6 +523,7 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
     // Now initialize the output for the intersected set of arrays.
     this->AllocateAttributes(pdList, output->GetPointData());
     this->AllocateAttributes(cdList, output->GetCellData());
+    total.Initialize(pdList.NumberOfValues, cdList.NumberOfValues);
 
     index = 0;
     // Now execute for each block.
@@ -411,11 +534,16 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
       vtkDataSet* ds = vtkDataSet::SafeDownCast(dobj);
       if (ds && ds->GetNumberOfPoints() > 0)
         {
-        this->ExecuteBlock(ds, output, index, pdList, cdList);
+        this->ExecuteBlock(ds, total, index, pdList, cdList);
         index++;
         }
       }
     iter->Delete();
+
+    this->SetAttributes(pdList, total.GetPointValues(),
+      output->GetPointData());
+    this->SetAttributes(cdList, total.GetCellValues(),
+      output->GetCellData());
     }
   else if (dsInput)
     {
@@ -428,7 +556,12 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
     cdList.InitializeFieldList(dsInput->GetCellData());
     this->AllocateAttributes(pdList, output->GetPointData());
     this->AllocateAttributes(cdList, output->GetCellData());
-    this->ExecuteBlock(dsInput, output, 0, pdList, cdList);
+    total.Initialize(pdList.NumberOfValues, cdList.NumberOfValues);
+    this->ExecuteBlock(dsInput, total, 0, pdList, cdList);
+    this->SetAttributes(pdList, total.GetPointValues(),
+      output->GetPointData());
+    this->SetAttributes(cdList, total.GetCellValues(),
+      output->GetCellData());
     }
   else
     {
@@ -440,11 +573,31 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
     return 0;
     }
 
+  this->IntegrationDimension = total.Dimension;
+  this->Sum = total.Sum;
+  this->SumCenter[0] = total.SumCenter[0];
+  this->SumCenter[1] = total.SumCenter[1];
+  this->SumCenter[2] = total.SumCenter[2];
+
+  if (this->Controller && this->Controller->GetNumberOfProcesses() > 1)
+    {
+    if (!this->ReduceAcrossProcesses(output))
+      {
+      return 0;
+      }
+    if (this->Controller->GetLocalProcessId() > 0)
+      {
+      // Only the first process produces the result, satellites have empty
+      // data.
+      output->Initialize();
+      return 1;
+      }
+    }
+
   // Here is the trick:  The satellites need a point and vertex to
   // marshal the attributes.
 
   // Generate point and vertex.  Add extra attributes for area too.
-  // Satellites do not need the area attribute, but it does not hurt.
   double pt[3];
   vtkPoints* newPoints = vtkPoints::New();
   newPoints->SetNumberOfPoints(1);
@@ -493,128 +646,155 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
     }
   sumArray->Delete();
 
-  int globalMin = this->PieceNodeMinToNode0 (output);
-  int processId = this->Controller->GetLocalProcessId();
-  int numProcs = this->Controller->GetNumberOfProcesses();
-  if (globalMin == numProcs)
-    {
-    // there is no data in any of the processors
-    return 1;
-    }
-  if (processId > 0)
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+// The integrals are sums, so instead of sending the output of each process to
+// the first one, all of them are summed with a single all-reduce. The
+// processes first agree on the arrays to sum: each process describes its
+// integration dimension and its arrays, and, as before, the arrays of the
+// first process that has some are used while the integrals of a lower
+// dimension are discarded.
+int vtkIntegrateAttributes::ReduceAcrossProcesses(vtkUnstructuredGrid* output)
+{
+  typedef std::vector<std::pair<std::string, int> > vtkLayout;
+  vtkDataSetAttributes* attributes[2] =
+    { output->GetPointData(), output->GetCellData() };
+  const char kinds[2] = { 'P', 'C' };
+
+  // Each process sends "D<dimension>" followed by "<kind><components> <name>"
+  // for each of its arrays, all null terminated.
+  std::ostringstream localLayout;
+  localLayout << 'D' << this->IntegrationDimension << '\0';
+  for (int a = 0; a < 2; ++a)
     {
-    if (processId != globalMin)
+    int numArrays = attributes[a]->GetNumberOfArrays();
+    for (int i = 0; i < numArrays; ++i)
       {
-      this->SendPiece (output);
+      vtkDataArray* array = attributes[a]->GetArray(i);
+      const char* name = array? array->GetName() : NULL;
+      if (name && name[0] != '\0')
+        {
+        localLayout << kinds[a] << array->GetNumberOfComponents() << ' '
+          << name << '\0';
+        }
       }
     }
-  else
+  const std::string localBuffer = localLayout.str();
+  vtkSmartPointer<vtkCharArray> sendLayout =
+    vtkSmartPointer<vtkCharArray>::New();
+  sendLayout->SetNumberOfTuples(static_cast<vtkIdType>(localBuffer.size()));
+  memcpy(sendLayout->GetPointer(0), localBuffer.c_str(), localBuffer.size());
+  vtkSmartPointer<vtkCharArray> layouts = vtkSmartPointer<vtkCharArray>::New();
+  if (!this->Controller->AllGatherV(sendLayout.GetPointer(),
+      layouts.GetPointer()))
     {
-    for (int id = 1; id < numProcs; ++id)
+    vtkErrorMacro("Parallel communication error. Could not gather arrays.");
+    return 0;
+    }
+
+  int dimension = 0;
+  vtkLayout layout[2];
+  vtkLayout current[2];
+  const char* buffer = layouts->GetPointer(0);
+  const char* bufferEnd = buffer + layouts->GetNumberOfTuples();
+  while (buffer <= bufferEnd)
+    {
+    // A new process starts with its dimension.
+    if (buffer == bufferEnd || buffer[0] == 'D')
       {
-      if (id != globalMin)
+      for (int a = 0; a < 2; ++a)
         {
-        this->ReceivePiece (output, id);
+        if (layout[a].empty())
+          {
+          layout[a].swap(current[a]);
+          }
+        current[a].clear();
         }
-      }
-
-    // now that we have all of the sums from each process
-    // set the point location with the global value
-    if (this->Sum != 0.0)
-      {
-      pt[0] = this->SumCenter[0] / this->Sum;
-      pt[1] = this->SumCenter[1] / this->Sum;
-      pt[2] = this->SumCenter[2] / this->Sum;
+      if (buffer == bufferEnd)
+        {
+        break;
+        }
+      int processDimension = atoi(buffer + 1);
+      dimension = processDimension > dimension? processDimension : dimension;
       }
     else
       {
-      pt[0] = this->SumCenter[0];
-      pt[1] = this->SumCenter[1];
-      pt[2] = this->SumCenter[2];
+      char* name = NULL;
+      int numComponents = static_cast<int>(strtol(buffer + 1, &name, 10));
+      current[buffer[0] == 'P'? 0 : 1].push_back(
+        std::make_pair(std::string(name + 1), numComponents));
       }
-    output->GetPoints()->SetPoint(0, pt);
+    buffer += strlen(buffer) + 1;
     }
 
-  return 1;
-}
-
-int vtkIntegrateAttributes::PieceNodeMinToNode0(vtkUnstructuredGrid *data)
-{
-  int numProcs = this->Controller->GetNumberOfProcesses();
-  int processId = this->Controller->GetLocalProcessId();
-  int localMin = (data->GetNumberOfCells() == 0 ? numProcs : processId);
-  int globalMin = numProcs;
-  if (numProcs == 1)
+  // Processes that integrated a lower dimension only contribute zeros.
+  const bool contributes = (this->IntegrationDimension == dimension);
+  std::vector<double> localValues;
+  localValues.push_back(contributes? this->Sum : 0.0);
+  for (int i = 0; i < 3; ++i)
     {
-    return 0;
+    localValues.push_back(contributes? this->SumCenter[i] : 0.0);
     }
-  this->Controller->AllReduce (&localMin, &globalMin, 1,
-                               vtkCommunicator::MIN_OP);
-  if (globalMin == 0 || globalMin == numProcs)
+  for (int a = 0; a < 2; ++a)
     {
-    return globalMin;
-    }
-  if (processId == 0)
-    {
-    this->ReceivePiece(data, globalMin);
+    for (size_t i = 0; i < layout[a].size(); ++i)
+      {
+      vtkDataArray* array =
+        attributes[a]->GetArray(layout[a][i].first.c_str());
+      int numComponents = layout[a][i].second;
+      bool valid = contributes && array &&
+        array->GetNumberOfComponents() == numComponents;
+      for (int j = 0; j < numComponents; ++j)
+        {
+        localValues.push_back(valid? array->GetComponent(0, j) : 0.0);
+        }
+      }
     }
-  else if (processId == globalMin)
+  std::vector<double> values(localValues.size(), 0.0);
+  if (!this->Controller->AllReduce(&localValues[0], &values[0],
+      static_cast<vtkIdType>(values.size()), vtkCommunicator::SUM_OP))
     {
-    this->SendPiece (data);
+    vtkErrorMacro("Parallel communication error. Could not sum integrals.");
+    return 0;
     }
-  return globalMin;
-}
-
-void vtkIntegrateAttributes::SendPiece(vtkUnstructuredGrid *src)
-{
-  double msg[5];
-  msg[0] = (double)(this->IntegrationDimension);
-  msg[1] = this->Sum;
-  msg[2] = this->SumCenter[0];
-  msg[3] = this->SumCenter[1];
-  msg[4] = this->SumCenter[2];
-  this->Controller->Send(msg, 5, 0, vtkIntegrateAttributes::IntegrateAttrInfo);
-  this->Controller->Send(src, 0, vtkIntegrateAttributes::IntegrateAttrData);
-  // Done sending.  Reset src so satellites will have empty data.
-  src->Initialize();
-}
 
-void vtkIntegrateAttributes::ReceivePiece (vtkUnstructuredGrid *mergeTo,
-                                           int fromId)
-{
-  double msg[5];
-  this->Controller->Receive(msg,
-                            5,
-                            fromId,
-                            vtkIntegrateAttributes::IntegrateAttrInfo);
-  vtkUnstructuredGrid* tmp = vtkUnstructuredGrid::New();
-  this->Controller->Receive(tmp,
-                            fromId,
-                            vtkIntegrateAttributes::IntegrateAttrData);
-  if (this->CompareIntegrationDimension(mergeTo, (int)(msg[0])))
+  this->IntegrationDimension = dimension;
+  this->Sum = values[0];
+  this->SumCenter[0] = values[1];
+  this->SumCenter[1] = values[2];
+  this->SumCenter[2] = values[3];
+  size_t next = 4;
+  for (int a = 0; a < 2; ++a)
     {
-    this->Sum += msg[1];
-    this->SumCenter[0] += msg[2];
-    this->SumCenter[1] += msg[3];
-    this->SumCenter[2] += msg[4];
-    this->IntegrateSatelliteData(tmp->GetPointData(),
-                                 mergeTo->GetPointData());
-    this->IntegrateSatelliteData(tmp->GetCellData(),
-                                 mergeTo->GetCellData());
+    attributes[a]->Initialize();
+    for (size_t i = 0; i < layout[a].size(); ++i)
+      {
+      int numComponents = layout[a][i].second;
+      vtkDoubleArray* outArray = vtkDoubleArray::New();
+      outArray->SetNumberOfComponents(numComponents);
+      outArray->SetNumberOfTuples(1);
+      outArray->SetName(layout[a][i].first.c_str());
+      for (int j = 0; j < numComponents; ++j)
+        {
+        outArray->SetComponent(0, j, values[next++]);
+        }
+      attributes[a]->AddArray(outArray);
+      outArray->Delete();
+      }
     }
-  tmp->Delete();
-  tmp = 0;
+  return 1;
 }
 
-
-
-
 //-----------------------------------------------------------------------------
 void vtkIntegrateAttributes::AllocateAttributes(
   vtkIntegrateAttributes::vtkFieldList& fieldList,
   vtkDataSetAttributes* outda)
 {
   int numArrays = fieldList.GetNumberOfFields();
+  fieldList.Offsets.assign(numArrays, -1);
+  fieldList.NumberOfValues = 0;
   for (int i = 0; i < numArrays; ++i)
     {
     if (fieldList.GetFieldIndex(i) < 0)
@@ -633,122 +813,123 @@ void vtkIntegrateAttributes::AllocateAttributes(
       outArray->SetComponent(0, j, 0.0);
       }
     fieldList.SetFieldIndex(i, outda->AddArray(outArray));
+    fieldList.Offsets[i] = fieldList.NumberOfValues;
+    fieldList.NumberOfValues += numComponents;
     outArray->Delete();
     // Should we set scalars, vectors ...
     }
 }
 
 //-----------------------------------------------------------------------------
-void vtkIntegrateAttributes::ZeroAttributes(vtkDataSetAttributes* outda)
+void vtkIntegrateAttributes::SetAttributes(
+  vtkIntegrateAttributes::vtkFieldList& fieldList, const double* values,
+  vtkDataSetAttributes* outda)
 {
-  int numArrays, i, numComponents, j;
-  vtkDataArray* outArray;
-  numArrays = outda->GetNumberOfArrays();
-  for (i = 0; i < numArrays; ++i)
+  int numArrays = fieldList.GetNumberOfFields();
+  for (int i = 0; i < numArrays; ++i)
     {
-    outArray = outda->GetArray(i);
-    numComponents = outArray->GetNumberOfComponents();
-    for (j = 0; j < numComponents; ++j)
+    if (fieldList.Offsets[i] < 0)
       {
-      outArray->SetComponent(0, j, 0.0);
+      continue;
+      }
+    vtkDataArray* outArray = outda->GetArray(fieldList.GetFieldIndex(i));
+    int numComponents = outArray->GetNumberOfComponents();
+    for (int j = 0; j < numComponents; ++j)
+      {
+      outArray->SetComponent(0, j, values[fieldList.Offsets[i] + j]);
       }
     }
 }
+
 //-----------------------------------------------------------------------------
 void vtkIntegrateAttributes::IntegrateData1(vtkDataSetAttributes* inda,
-  vtkDataSetAttributes* outda,
+  double* values,
   vtkIdType pt1Id, double k,
   vtkIntegrateAttributes::vtkFieldList& fieldList, int index)
 {
   int numArrays, i, numComponents, j;
   vtkDataArray* inArray;
-  vtkDataArray* outArray;
+  double* outValues;
   numArrays = fieldList.GetNumberOfFields();
-  double vIn1, dv, vOut;
+  double vIn1, dv;
   for (i = 0; i < numArrays; ++i)
     {
-    if (fieldList.GetFieldIndex(i) < 0)
+    if (fieldList.Offsets[i] < 0)
       {
       continue;
       }
     // We could template for speed.
     inArray = inda->GetArray(fieldList.GetDSAIndex(index, i));
-    outArray = outda->GetArray(fieldList.GetFieldIndex(i));
+    outValues = values + fieldList.Offsets[i];
     numComponents = inArray->GetNumberOfComponents();
     for (j = 0; j < numComponents; ++j)
       {
       vIn1 = inArray->GetComponent(pt1Id, j);
-      vOut = outArray->GetComponent(0, j);
       dv = vIn1;
-      vOut += dv*k;
-      outArray->SetComponent(0, j, vOut);
+      outValues[j] += dv*k;
       }
     }
 }
 //-----------------------------------------------------------------------------
 void vtkIntegrateAttributes::IntegrateData2(vtkDataSetAttributes* inda,
-  vtkDataSetAttributes* outda,
+  double* values,
   vtkIdType pt1Id, vtkIdType pt2Id, double k,
   vtkIntegrateAttributes::vtkFieldList& fieldList, int index)
 {
   int numArrays, i, numComponents, j;
   vtkDataArray* inArray;
-  vtkDataArray* outArray;
+  double* outValues;
   numArrays = fieldList.GetNumberOfFields();
-  double vIn1, vIn2, dv, vOut;
+  double vIn1, vIn2, dv;
   for (i = 0; i < numArrays; ++i)
     {
-    if (fieldList.GetFieldIndex(i) < 0)
+    if (fieldList.Offsets[i] < 0)
       {
       continue;
       }
     // We could template for speed.
     inArray = inda->GetArray(fieldList.GetDSAIndex(index, i));
-    outArray = outda->GetArray(fieldList.GetFieldIndex(i));
+    outValues = values + fieldList.Offsets[i];
     numComponents = inArray->GetNumberOfComponents();
     for (j = 0; j < numComponents; ++j)
       {
       vIn1 = inArray->GetComponent(pt1Id, j);
       vIn2 = inArray->GetComponent(pt2Id, j);
-      vOut = outArray->GetComponent(0, j);
       dv = 0.5*(vIn1+vIn2);
-      vOut += dv*k;
-      outArray->SetComponent(0, j, vOut);
+      outValues[j] += dv*k;
       }
     }
 }
 //-----------------------------------------------------------------------------
 // Is the extra performance worth duplicating this code with IntergrateData2.
 void vtkIntegrateAttributes::IntegrateData3(vtkDataSetAttributes* inda,
-  vtkDataSetAttributes* outda,
+  double* values,
   vtkIdType pt1Id, vtkIdType pt2Id,
   vtkIdType pt3Id, double k,
   vtkIntegrateAttributes::vtkFieldList& fieldList, int index)
 {
   int numArrays, i, numComponents, j;
   vtkDataArray* inArray;
-  vtkDataArray* outArray;
+  double* outValues;
   numArrays = fieldList.GetNumberOfFields();
-  double vIn1, vIn2, vIn3, dv, vOut;
+  double vIn1, vIn2, vIn3, dv;
   for (i = 0; i < numArrays; ++i)
     {
-    if (fieldList.GetFieldIndex(i) < 0)
+    if (fieldList.Offsets[i] < 0)
       {
       continue;
       }
     // We could template for speed.
     inArray = inda->GetArray(fieldList.GetDSAIndex(index, i));
-    outArray = outda->GetArray(fieldList.GetFieldIndex(i));
+    outValues = values + fieldList.Offsets[i];
     numComponents = inArray->GetNumberOfComponents();
     for (j = 0; j < numComponents; ++j)
       {
       vIn1 = inArray->GetComponent(pt1Id, j);
       vIn2 = inArray->GetComponent(pt2Id, j);
       vIn3 = inArray->GetComponent(pt3Id, j);
-      vOut = outArray->GetComponent(0, j);
       dv = (vIn1+vIn2+vIn3)/3.0;
-      vOut += dv*k;
-      outArray->SetComponent(0, j, vOut);
+      outValues[j] += dv*k;
       }
     }
 }
@@ -756,7 +937,7 @@ void vtkIntegrateAttributes::IntegrateData3(vtkDataSetAttributes* inda,
 //-----------------------------------------------------------------------------
 // Is the extra performance worth duplicating this code with IntergrateData2.
 void vtkIntegrateAttributes::IntegrateData4(vtkDataSetAttributes* inda,
-  vtkDataSetAttributes* outda,
+  double* values,
   vtkIdType pt1Id, vtkIdType pt2Id,
   vtkIdType pt3Id, vtkIdType pt4Id,
   double k,
@@ -764,18 +945,18 @@ void vtkIntegrateAttributes::IntegrateData4(vtkDataSetAttributes* inda,
 {
   int numArrays, i, numComponents, j;
   vtkDataArray* inArray;
-  vtkDataArray* outArray;
+  double* outValues;
   numArrays = fieldList.GetNumberOfFields();
-  double vIn1, vIn2, vIn3, vIn4, dv, vOut;
+  double vIn1, vIn2, vIn3, vIn4, dv;
   for (i = 0; i < numArrays; ++i)
     {
-    if (fieldList.GetFieldIndex(i) < 0)
+    if (fieldList.Offsets[i] < 0)
       {
       continue;
       }
     // We could template for speed.
     inArray = inda->GetArray(fieldList.GetDSAIndex(index, i));
-    outArray = outda->GetArray(fieldList.GetFieldIndex(i));
+    outValues = values + fieldList.Offsets[i];
     numComponents = inArray->GetNumberOfComponents();
     for (j = 0; j < numComponents; ++j)
       {
@@ -783,65 +964,15 @@ void vtkIntegrateAttributes::IntegrateData4(vtkDataSetAttributes* inda,
       vIn2 = inArray->GetComponent(pt2Id, j);
       vIn3 = inArray->GetComponent(pt3Id, j);
       vIn4 = inArray->GetComponent(pt4Id, j);
-      vOut = outArray->GetComponent(0, j);
       dv = (vIn1+vIn2+vIn3+vIn4) * 0.25;
-      vOut += dv*k;
-      outArray->SetComponent(0, j, vOut);
-      }
-    }
-}
-
-//-----------------------------------------------------------------------------
-// Used to sum arrays from all processes.
-void vtkIntegrateAttributes::IntegrateSatelliteData(
-  vtkDataSetAttributes* sendingProcAttributes,
-  vtkDataSetAttributes* proc0Attributes)
-{
-  // if the sending processor has no data
-  if (sendingProcAttributes->GetNumberOfArrays() == 0)
-    {
-    return;
-    }
-
-  // when processor 0 that has no data, receives data from the min
-  // processor that has data
-  if (proc0Attributes->GetNumberOfArrays() == 0)
-    {
-    proc0Attributes->DeepCopy (sendingProcAttributes);
-    return;
-    }
-
-  int numArrays, i, numComponents, j;
-  vtkDataArray* inArray;
-  vtkDataArray* outArray;
-  numArrays = proc0Attributes->GetNumberOfArrays();
-  double vIn, vOut;
-  for (i = 0; i < numArrays; ++i)
-    {
-    outArray = proc0Attributes->GetArray(i);
-    numComponents = outArray->GetNumberOfComponents();
-    // Protect against arrays in a different order.
-    const char* name = outArray->GetName();
-    if (name && name[0] != '\0')
-      {
-      inArray = sendingProcAttributes->GetArray(name);
-      if (inArray && inArray->GetNumberOfComponents() == numComponents)
-        {
-        // We could template for speed.
-        for (j = 0; j < numComponents; ++j)
-          {
-          vIn = inArray->GetComponent(0, j);
-          vOut = outArray->GetComponent(0, j);
-          outArray->SetComponent(0,j,vOut+vIn);
-          }
-        }
+      outValues[j] += dv*k;
       }
     }
 }
 
 //-----------------------------------------------------------------------------
 void vtkIntegrateAttributes::IntegratePolyLine(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
+                                               vtkAccumulator& acc,
                                                vtkIdType cellId,
                                                vtkIdList* ptIds)
 {
@@ -860,22 +991,22 @@ void vtkIntegrateAttributes::IntegratePolyLine(vtkDataSet* input,
 
     // Compute the length of the line.
     length = sqrt(vtkMath::Distance2BetweenPoints(pt1, pt2));
-    this->Sum += length;
+    acc.Sum += length;
 
     // Compute the middle, which is really just another attribute.
     mid[0] = (pt1[0]+pt2[0])*0.5;
     mid[1] = (pt1[1]+pt2[1])*0.5;
     mid[2] = (pt1[2]+pt2[2])*0.5;
     // Add weighted to sumCenter.
-    this->SumCenter[0] += mid[0]*length;
-    this->SumCenter[1] += mid[1]*length;
-    this->SumCenter[2] += mid[2]*length;
+    acc.SumCenter[0] += mid[0]*length;
+    acc.SumCenter[1] += mid[1]*length;
+    acc.SumCenter[2] += mid[2]*length;
 
     // Now integrate the rest of the attributes.
-    this->IntegrateData2(input->GetPointData(), output->GetPointData(),
+    this->IntegrateData2(input->GetPointData(), acc.GetPointValues(),
                          pt1Id, pt2Id, length,
                          *this->PointFieldList, this->FieldListIndex);
-    this->IntegrateData1(input->GetCellData(), output->GetCellData(),
+    this->IntegrateData1(input->GetCellData(), acc.GetCellValues(),
                          cellId, length,
                          *this->CellFieldList, this->FieldListIndex);
     }
@@ -884,7 +1015,7 @@ void vtkIntegrateAttributes::IntegratePolyLine(vtkDataSet* input,
 //-----------------------------------------------------------------------------
 void
 vtkIntegrateAttributes::IntegrateGeneral1DCell(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
+                                               vtkAccumulator& acc,
                                                vtkIdType cellId,
                                                vtkIdList* ptIds)
 {
@@ -893,9 +1024,7 @@ vtkIntegrateAttributes::IntegrateGeneral1DCell(vtkDataSet* input,
   // There should be an even number of points from the triangulation
   if (nPnts % 2)
     {
-    vtkWarningMacro("Odd number of points("
-                    << nPnts << ")  encountered - skipping "
-                    << " 1D Cell: " << cellId);
+    ++acc.NumberOfSkippedCells;
     return;
     }
 
@@ -913,22 +1042,22 @@ vtkIntegrateAttributes::IntegrateGeneral1DCell(vtkDataSet* input,
 
     // Compute the length of the line.
     length = sqrt(vtkMath::Distance2BetweenPoints(pt1, pt2));
-    this->Sum += length;
+    acc.Sum += length;
 
     // Compute the middle, which is really just another attribute.
     mid[0] = (pt1[0]+pt2[0])*0.5;
     mid[1] = (pt1[1]+pt2[1])*0.5;
     mid[2] = (pt1[2]+pt2[2])*0.5;
     // Add weighted to sumCenter.
-    this->SumCenter[0] += mid[0]*length;
-    this->SumCenter[1] += mid[1]*length;
-    this->SumCenter[2] += mid[2]*length;
+    acc.SumCenter[0] += mid[0]*length;
+    acc.SumCenter[1] += mid[1]*length;
+    acc.SumCenter[2] += mid[2]*length;
 
     // Now integrate the rest of the attributes.
-    this->IntegrateData2(input->GetPointData(), output->GetPointData(),
+    this->IntegrateData2(input->GetPointData(), acc.GetPointValues(),
                          pt1Id, pt2Id, length,
                          *this->PointFieldList, this->FieldListIndex);
-    this->IntegrateData1(input->GetCellData(), output->GetCellData(),
+    this->IntegrateData1(input->GetCellData(), acc.GetCellValues(),
                          cellId, length,
                          *this->CellFieldList, this->FieldListIndex);
     }
@@ -936,7 +1065,7 @@ vtkIntegrateAttributes::IntegrateGeneral1DCell(vtkDataSet* input,
 
 //-----------------------------------------------------------------------------
 void vtkIntegrateAttributes::IntegrateTriangleStrip(vtkDataSet* input,
-                                                    vtkUnstructuredGrid* output,
+                                                    vtkAccumulator& acc,
                                                     vtkIdType cellId,
                                                     vtkIdList* ptIds)
 {
@@ -949,14 +1078,14 @@ void vtkIntegrateAttributes::IntegrateTriangleStrip(vtkDataSet* input,
     pt1Id = ptIds->GetId(triIdx);
     pt2Id = ptIds->GetId(triIdx+1);
     pt3Id = ptIds->GetId(triIdx+2);
-    this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
+    this->IntegrateTriangle(input, acc, cellId, pt1Id, pt2Id, pt3Id);
     }
 }
 
 //-----------------------------------------------------------------------------
 // Works for convex polygons, and interpoaltion is not correct.
 void vtkIntegrateAttributes::IntegratePolygon(vtkDataSet* input,
-                                              vtkUnstructuredGrid* output,
+                                              vtkAccumulator& acc,
                                               vtkIdType cellId,
                                               vtkIdList* ptIds)
 {
@@ -969,14 +1098,14 @@ void vtkIntegrateAttributes::IntegratePolygon(vtkDataSet* input,
     {
     pt2Id = ptIds->GetId(triIdx+1);
     pt3Id = ptIds->GetId(triIdx+2);
-    this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
+    this->IntegrateTriangle(input, acc, cellId, pt1Id, pt2Id, pt3Id);
     }
 }
 
 //-----------------------------------------------------------------------------
 // For axis alligned rectangular cells
 void vtkIntegrateAttributes::IntegratePixel(vtkDataSet* input,
-                                            vtkUnstructuredGrid* output,
+                                            vtkAccumulator& acc,
                                             vtkIdType cellId,
                                             vtkIdList* cellPtIds)
 {
@@ -1002,27 +1131,27 @@ void vtkIntegrateAttributes::IntegratePixel(vtkDataSet* input,
       (pts[0][2] - pts[2][2]);
 
   a = fabs(l*w);
-  this->Sum += a;
+  acc.Sum += a;
   // Compute the middle, which is really just another attribute.
   mid[0] = (pts[0][0]+pts[1][0]+pts[2][0]+pts[3][0])*0.25;
   mid[1] = (pts[0][1]+pts[1][1]+pts[2][1]+pts[3][1])*0.25;
   mid[2] = (pts[0][2]+pts[1][2]+pts[2][2]+pts[3][2])*0.25;
   // Add weighted to sumCenter.
-  this->SumCenter[0] += mid[0]*a;
-  this->SumCenter[1] += mid[1]*a;
-  this->SumCenter[2] += mid[2]*a;
+  acc.SumCenter[0] += mid[0]*a;
+  acc.SumCenter[1] += mid[1]*a;
+  acc.SumCenter[2] += mid[2]*a;
 
   // Now integrate the rest of the attributes.
-  this->IntegrateData4(input->GetPointData(), output->GetPointData(),
+  this->IntegrateData4(input->GetPointData(), acc.GetPointValues(),
                        pt1Id, pt2Id, pt3Id, pt4Id, a,
                        *this->PointFieldList, this->FieldListIndex);
-  this->IntegrateData1(input->GetCellData(), output->GetCellData(), cellId, a,
+  this->IntegrateData1(input->GetCellData(), acc.GetCellValues(), cellId, a,
     *this->CellFieldList, this->FieldListIndex);
 }
 
 //-----------------------------------------------------------------------------
 void vtkIntegrateAttributes::IntegrateTriangle(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
+                                               vtkAccumulator& acc,
                                                vtkIdType cellId,
                                                vtkIdType pt1Id,
                                                vtkIdType pt2Id,
@@ -1053,29 +1182,29 @@ void vtkIntegrateAttributes::IntegrateTriangle(vtkDataSet* input,
     {
     return;
     }
-  this->Sum += k;
+  acc.Sum += k;
 
   // Compute the middle, which is really just another attribute.
   mid[0] = (pt1[0]+pt2[0]+pt3[0])/3.0;
   mid[1] = (pt1[1]+pt2[1]+pt3[1])/3.0;
   mid[2] = (pt1[2]+pt2[2]+pt3[2])/3.0;
   // Add weighted to sumCenter.
-  this->SumCenter[0] += mid[0]*k;
-  this->SumCenter[1] += mid[1]*k;
-  this->SumCenter[2] += mid[2]*k;
+  acc.SumCenter[0] += mid[0]*k;
+  acc.SumCenter[1] += mid[1]*k;
+  acc.SumCenter[2] += mid[2]*k;
 
   // Now integrate the rest of the attributes.
-  this->IntegrateData3(input->GetPointData(), output->GetPointData(),
+  this->IntegrateData3(input->GetPointData(), acc.GetPointValues(),
                        pt1Id, pt2Id, pt3Id, k,
                        *this->PointFieldList, this->FieldListIndex);
-  this->IntegrateData1(input->GetCellData(), output->GetCellData(), cellId, k,
+  this->IntegrateData1(input->GetCellData(), acc.GetCellValues(), cellId, k,
     *this->CellFieldList, this->FieldListIndex);
 }
 
 //-----------------------------------------------------------------------------
 void
 vtkIntegrateAttributes::IntegrateGeneral2DCell(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
+                                               vtkAccumulator& acc,
                                                vtkIdType cellId,
                                                vtkIdList* ptIds)
 {
@@ -1084,9 +1213,7 @@ vtkIntegrateAttributes::IntegrateGeneral2DCell(vtkDataSet* input,
   // from the triangulation
   if (nPnts % 3)
     {
-    vtkWarningMacro("Number of points ("
-                    << nPnts << ") is not divisiable by 3 - skipping "
-                    << " 2D Cell: " << cellId);
+    ++acc.NumberOfSkippedCells;
     return;
     }
 
@@ -1098,14 +1225,14 @@ vtkIntegrateAttributes::IntegrateGeneral2DCell(vtkDataSet* input,
     pt1Id = ptIds->GetId(triIdx++);
     pt2Id = ptIds->GetId(triIdx++);
     pt3Id = ptIds->GetId(triIdx++);
-    this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
+    this->IntegrateTriangle(input, acc, cellId, pt1Id, pt2Id, pt3Id);
     }
 }
 
 //-----------------------------------------------------------------------------
 // For Tetrahedral cells
 void vtkIntegrateAttributes::IntegrateTetrahedron(vtkDataSet* input,
-                                                  vtkUnstructuredGrid* output,
+                                                  vtkAccumulator& acc,
                                                   vtkIdType cellId,
                                                   vtkIdType pt1Id,
                                                   vtkIdType pt2Id,
@@ -1134,19 +1261,19 @@ void vtkIntegrateAttributes::IntegrateTetrahedron(vtkDataSet* input,
   // Calulate the volume of the tet which is 1/6 * the box product
   vtkMath::Cross(a,b,n);
   v = vtkMath::Dot(c, n) / 6.0;
-  this->Sum += v;
+  acc.Sum += v;
 
   // Add weighted to sumCenter.
-  this->SumCenter[0] += mid[0]*v;
-  this->SumCenter[1] += mid[1]*v;
-  this->SumCenter[2] += mid[2]*v;
+  acc.SumCenter[0] += mid[0]*v;
+  acc.SumCenter[1] += mid[1]*v;
+  acc.SumCenter[2] += mid[2]*v;
 
   // Integrate the attributes on the cell itself
-  this->IntegrateData1(input->GetCellData(), output->GetCellData(), cellId, v,
+  this->IntegrateData1(input->GetCellData(), acc.GetCellValues(), cellId, v,
     *this->CellFieldList, this->FieldListIndex);
 
   // Integrate the attributes associated with the points
-  this->IntegrateData4(input->GetPointData(), output->GetPointData(),
+  this->IntegrateData4(input->GetPointData(), acc.GetPointValues(),
                        pt1Id, pt2Id, pt3Id, pt4Id, v,
                        *this->PointFieldList, this->FieldListIndex);
 
@@ -1155,7 +1282,7 @@ void vtkIntegrateAttributes::IntegrateTetrahedron(vtkDataSet* input,
 //-----------------------------------------------------------------------------
 // For axis alligned hexahedral cells
 void vtkIntegrateAttributes::IntegrateVoxel(vtkDataSet* input,
-                                            vtkUnstructuredGrid* output,
+                                            vtkAccumulator& acc,
                                             vtkIdType cellId,
                                             vtkIdList* cellPtIds)
 {
@@ -1179,7 +1306,7 @@ void vtkIntegrateAttributes::IntegrateVoxel(vtkDataSet* input,
   w = pts[2][1] - pts[0][1];
   h = pts[4][2] - pts[0][2];
   v = fabs(l*w*h);
-  this->Sum += v;
+  acc.Sum += v;
 
   // Partially Compute the middle, which is really just another attribute.
   mid[0] = (pts[0][0]+pts[1][0]+pts[2][0]+pts[3][0])*0.125;
@@ -1187,14 +1314,14 @@ void vtkIntegrateAttributes::IntegrateVoxel(vtkDataSet* input,
   mid[2] = (pts[0][2]+pts[1][2]+pts[2][2]+pts[3][2])*0.125;
 
   // Integrate the attributes on the cell itself
-  this->IntegrateData1(input->GetCellData(), output->GetCellData(), cellId, v,
+  this->IntegrateData1(input->GetCellData(), acc.GetCellValues(), cellId, v,
     *this->CellFieldList, this->FieldListIndex);
 
   // Integrate the attributes associated with the points on the bottom face
   // note that since IntegrateData4 is going to weigh everything by 1/4
   // we need to pass down 1/2 the volume so they will be weighted by 1/8
 
-  this->IntegrateData4(input->GetPointData(), output->GetPointData(),
+  this->IntegrateData4(input->GetPointData(), acc.GetPointValues(),
                        pt1Id, pt2Id, pt3Id, pt4Id, v*0.5,
                        *this->PointFieldList, this->FieldListIndex);
 
@@ -1212,14 +1339,14 @@ void vtkIntegrateAttributes::IntegrateVoxel(vtkDataSet* input,
 
 
   // Add weighted to sumCenter.
-  this->SumCenter[0] += mid[0]*v;
-  this->SumCenter[1] += mid[1]*v;
-  this->SumCenter[2] += mid[2]*v;
+  acc.SumCenter[0] += mid[0]*v;
+  acc.SumCenter[1] += mid[1]*v;
+  acc.SumCenter[2] += mid[2]*v;
 
   // Integrate the attributes associated with the points on the top face
   // note that since IntegrateData4 is going to weigh everything by 1/4
   // we need to pass down 1/2 the volume so they will be weighted by 1/8
-  this->IntegrateData4(input->GetPointData(), output->GetPointData(),
+  this->IntegrateData4(input->GetPointData(), acc.GetPointValues(),
                        pt1Id, pt2Id, pt3Id, pt5Id, v*0.5,
                        *this->PointFieldList, this->FieldListIndex);
 }
@@ -1227,7 +1354,7 @@ void vtkIntegrateAttributes::IntegrateVoxel(vtkDataSet* input,
 //-----------------------------------------------------------------------------
 void
 vtkIntegrateAttributes::IntegrateGeneral3DCell(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
+                                               vtkAccumulator& acc,
                                                vtkIdType cellId,
                                                vtkIdList* ptIds)
 {
@@ -1237,9 +1364,7 @@ vtkIntegrateAttributes::IntegrateGeneral3DCell(vtkDataSet* input,
   // from the triangulation
   if (nPnts % 4)
     {
-    vtkWarningMacro("Number of points ("
-                    << nPnts << ") is not divisiable by 4 - skipping "
-                    << " 3D Cell: " << cellId);
+    ++acc.NumberOfSkippedCells;
     return;
     }
 
@@ -1252,7 +1377,7 @@ vtkIntegrateAttributes::IntegrateGeneral3DCell(vtkDataSet* input,
     pt2Id = ptIds->GetId(tetIdx++);
     pt3Id = ptIds->GetId(tetIdx++);
     pt4Id = ptIds->GetId(tetIdx++);
-    this->IntegrateTetrahedron(input, output, cellId, pt1Id, pt2Id, pt3Id,
+    this->IntegrateTetrahedron(input, acc, cellId, pt1Id, pt2Id, pt3Id,
                                pt4Id);
     }
 }
@@ -1267,4 +1392,3 @@ void vtkIntegrateAttributes::PrintSelf(ostream& os, vtkIndent indent)
      << this->IntegrationDimension << endl;
 
 }
-
@@ -21,6 +21,9 @@
 // The output of this filter is a single point and vertex.  The attributes
 // for this point and cell will contain the integration results
 // for the corresponding input attributes.
+// The cells are integrated in parallel with vtkSMPTools. In parallel, the
+// integrals of all processes are summed and the result is produced on the
+// first process only.
 
 #ifndef __vtkIntegrateAttributes_h
 #define __vtkIntegrateAttributes_h
@@ -61,7 +64,10 @@ protected:
   virtual int FillInputPortInformation(int, vtkInformation*);
 
 
-  int CompareIntegrationDimension(vtkDataSet* output, int dim);
+  // Integrals of the length, area or volume, of the location of the output
+  // point and of the attributes. There is one for each thread.
+  class vtkAccumulator;
+
   int IntegrationDimension;
 
   // The length, area or volume of the data set.  Computed by Execute;
@@ -70,47 +76,46 @@ protected:
   double SumCenter[3];
 
   void IntegratePolyLine(vtkDataSet* input,
-                         vtkUnstructuredGrid* output,
+                         vtkAccumulator& acc,
                          vtkIdType cellId, vtkIdList* cellPtIds);
   void IntegratePolygon(vtkDataSet* input,
-                         vtkUnstructuredGrid* output,
+                         vtkAccumulator& acc,
                          vtkIdType cellId, vtkIdList* cellPtIds);
   void IntegrateTriangleStrip(vtkDataSet* input,
-                         vtkUnstructuredGrid* output,
+                         vtkAccumulator& acc,
                          vtkIdType cellId, vtkIdList* cellPtIds);
   void IntegrateTriangle(vtkDataSet* input,
-                         vtkUnstructuredGrid* output,
+                         vtkAccumulator& acc,
                          vtkIdType cellId, vtkIdType pt1Id,
                          vtkIdType pt2Id, vtkIdType pt3Id);
   void IntegrateTetrahedron(vtkDataSet* input,
-                            vtkUnstructuredGrid* output,
+                            vtkAccumulator& acc,
                             vtkIdType cellId, vtkIdType pt1Id,
                             vtkIdType pt2Id, vtkIdType pt3Id,
                             vtkIdType pt4Id);
   void IntegratePixel(vtkDataSet* input,
-                      vtkUnstructuredGrid* output,
+                      vtkAccumulator& acc,
                       vtkIdType cellId, vtkIdList* cellPtIds);
   void IntegrateVoxel(vtkDataSet* input,
-                      vtkUnstructuredGrid* output,
+                      vtkAccumulator& acc,
                       vtkIdType cellId, vtkIdList* cellPtIds);
   void IntegrateGeneral1DCell(vtkDataSet* input,
-                              vtkUnstructuredGrid* output,
+                              vtkAccumulator& acc,
                               vtkIdType cellId,
                               vtkIdList* cellPtIds);
   void IntegrateGeneral2DCell(vtkDataSet* input,
-                              vtkUnstructuredGrid* output,
+                              vtkAccumulator& acc,
                               vtkIdType cellId,
                               vtkIdList* cellPtIds);
   void IntegrateGeneral3DCell(vtkDataSet* input,
-                              vtkUnstructuredGrid* output,
+                              vtkAccumulator& acc,
                               vtkIdType cellId,
                               vtkIdList* cellPtIds);
-  void IntegrateSatelliteData(vtkDataSetAttributes* inda,
-                              vtkDataSetAttributes* outda);
-  void ZeroAttributes(vtkDataSetAttributes* outda);
-  int PieceNodeMinToNode0 (vtkUnstructuredGrid *data);
-  void SendPiece(vtkUnstructuredGrid *src);
-  void ReceivePiece (vtkUnstructuredGrid *mergeTo, int fromId);
+
+  // Description:
+  // Sums the integrals of all processes with an all-reduce and rebuilds the
+  // attributes of the output from the result.
+  int ReduceAcrossProcesses(vtkUnstructuredGrid* output);
 
 private:
   vtkIntegrateAttributes(const vtkIntegrateAttributes&);  // Not implemented.
@@ -121,28 +126,33 @@ private:
   vtkFieldList* PointFieldList;
   int FieldListIndex;
 
+  class vtkIntegrateCellsFunctor;
+  friend class vtkIntegrateCellsFunctor;
+
   void AllocateAttributes(
     vtkFieldList& fieldList, vtkDataSetAttributes* outda);
-  void ExecuteBlock(vtkDataSet* input, vtkUnstructuredGrid* output,
+  void SetAttributes(vtkFieldList& fieldList, const double* values,
+    vtkDataSetAttributes* outda);
+  void ExecuteBlock(vtkDataSet* input, vtkAccumulator& acc,
     int fieldset_index, vtkFieldList& pdList, vtkFieldList& cdList);
 
   void IntegrateData1(vtkDataSetAttributes* inda,
-                      vtkDataSetAttributes* outda,
+                      double* values,
                       vtkIdType pt1Id, double k,
                       vtkFieldList& fieldlist,
                       int fieldlist_index);
   void IntegrateData2(vtkDataSetAttributes* inda,
-                      vtkDataSetAttributes* outda,
+                      double* values,
                       vtkIdType pt1Id, vtkIdType pt2Id, double k,
                       vtkFieldList& fieldlist,
                       int fieldlist_index);
   void IntegrateData3(vtkDataSetAttributes* inda,
-                      vtkDataSetAttributes* outda, vtkIdType pt1Id,
+                      double* values, vtkIdType pt1Id,
                       vtkIdType pt2Id, vtkIdType pt3Id, double k,
                       vtkFieldList& fieldlist,
                       int fieldlist_index);
   void IntegrateData4(vtkDataSetAttributes* inda,
-                      vtkDataSetAttributes* outda, vtkIdType pt1Id,
+                      double* values, vtkIdType pt1Id,
                       vtkIdType pt2Id, vtkIdType pt3Id, vtkIdType pt4Id,
                       double k,
                       vtkFieldList& fieldlist,
@@ -29,13 +29,291 @@
 #include "vtkCompositeDataIterator.h"
 
 #include "vtkMultiProcessController.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkTypeTraits.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <assert.h>
+#include <string.h>
+#include <vector>
 
 vtkStandardNewMacro(vtkMinMax);
+vtkCxxSetObjectMacro(vtkMinMax, Controller, vtkMultiProcessController);
+
+namespace
+{
+  // Arrays shorter than this are not worth splitting among threads.
+  const vtkIdType VTK_MIN_MAX_THREADED_TUPLES = 65536;
+
+  // The operations, written so that the result of comparisons with NaN
+  // matches the one of the former per tuple implementation.
+  struct vtkMinMaxMinOp
+    {
+    template <class T>
+    static T Apply(T result, T value)
+      {
+      return value < result ? value : result;
+      }
+    };
+
+  struct vtkMinMaxMaxOp
+    {
+    template <class T>
+    static T Apply(T result, T value)
+      {
+      return value > result ? value : result;
+      }
+    };
+
+  struct vtkMinMaxSumOp
+    {
+    template <class T>
+    static T Apply(T result, T value)
+      {
+      return static_cast<T>(result + value);
+      }
+    };
 
-template <class T>
-void vtkMinMaxExecute(
-  vtkMinMax *self,int numComp,int compIdx,T* idata,T* odata
-  );
+  template <class T>
+  T vtkMinMaxApply(int operation, T result, T value)
+    {
+    switch (operation)
+      {
+      case vtkMinMax::MIN:
+        return vtkMinMaxMinOp::Apply(result, value);
+      case vtkMinMax::MAX:
+        return vtkMinMaxMaxOp::Apply(result, value);
+      case vtkMinMax::SUM:
+        return vtkMinMaxSumOp::Apply(result, value);
+      default:
+        return value;
+      }
+    }
+
+  // Accumulates the tuples [begin, end) of data into result, which already
+  // holds a valid value for each component. Tuples flagged as duplicates in
+  // ghosts are skipped. The loops work on the raw pointers so that the
+  // compiler can vectorize them, the single component one in particular.
+  template <class Op, class T>
+  void vtkMinMaxAccumulate(const T* data, const unsigned char* ghosts,
+    int numComp, vtkIdType begin, vtkIdType end, T* result)
+    {
+    if (!ghosts && numComp == 1)
+      {
+      T value = result[0];
+      for (vtkIdType idx = begin; idx < end; ++idx)
+        {
+        value = Op::Apply(value, data[idx]);
+        }
+      result[0] = value;
+      return;
+      }
+
+    const T* tuple = data + begin * numComp;
+    for (vtkIdType idx = begin; idx < end; ++idx, tuple += numComp)
+      {
+      if (ghosts && (ghosts[idx] & vtkDataSetAttributes::DUPLICATECELL))
+        {
+        continue;
+        }
+      for (int jdx = 0; jdx < numComp; ++jdx)
+        {
+        result[jdx] = Op::Apply(result[jdx], tuple[jdx]);
+        }
+      }
+    }
+
+  // vtkSMPTools functor computing the result of the operation over all of
+  // the tuples of an array that are not duplicates.
+  template <class T>
+  class vtkMinMaxFunctor
+  {
+  public:
+    const T* Data;
+    const unsigned char* Ghosts;
+    int NumberOfComponents;
+    int Operation;
+
+    // Set to true when at least one tuple was used, Result is only valid
+    // then.
+    bool Found;
+    std::vector<T> Result;
+
+    vtkSMPThreadLocal<std::vector<T> > LocalResult;
+    vtkSMPThreadLocal<bool> LocalFound;
+
+    void Initialize()
+      {
+      this->LocalResult.Local().resize(this->NumberOfComponents);
+      this->LocalFound.Local() = false;
+      }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      const int numComp = this->NumberOfComponents;
+      T* result = &this->LocalResult.Local()[0];
+      bool& found = this->LocalFound.Local();
+      if (!found)
+        {
+        // The first tuple this thread uses initializes its result.
+        while (begin < end && this->Ghosts &&
+          (this->Ghosts[begin] & vtkDataSetAttributes::DUPLICATECELL))
+          {
+          ++begin;
+          }
+        if (begin == end)
+          {
+          return;
+          }
+        const T* tuple = this->Data + begin * numComp;
+        for (int jdx = 0; jdx < numComp; ++jdx)
+          {
+          result[jdx] = tuple[jdx];
+          }
+        found = true;
+        ++begin;
+        }
+
+      switch (this->Operation)
+        {
+        case vtkMinMax::MIN:
+          vtkMinMaxAccumulate<vtkMinMaxMinOp>(
+            this->Data, this->Ghosts, numComp, begin, end, result);
+          break;
+        case vtkMinMax::MAX:
+          vtkMinMaxAccumulate<vtkMinMaxMaxOp>(
+            this->Data, this->Ghosts, numComp, begin, end, result);
+          break;
+        case vtkMinMax::SUM:
+          vtkMinMaxAccumulate<vtkMinMaxSumOp>(
+            this->Data, this->Ghosts, numComp, begin, end, result);
+          break;
+        }
+      }
+
+    void Reduce()
+      {
+      this->Found = false;
+      this->Result.resize(this->NumberOfComponents);
+      typename vtkSMPThreadLocal<std::vector<T> >::iterator riter =
+        this->LocalResult.begin();
+      typename vtkSMPThreadLocal<bool>::iterator fiter =
+        this->LocalFound.begin();
+      for (; riter != this->LocalResult.end(); ++riter, ++fiter)
+        {
+        if (!*fiter)
+          {
+          continue;
+          }
+        for (int jdx = 0; jdx < this->NumberOfComponents; ++jdx)
+          {
+          this->Result[jdx] = this->Found ?
+            vtkMinMaxApply(this->Operation, this->Result[jdx], (*riter)[jdx]) :
+            (*riter)[jdx];
+          }
+        this->Found = true;
+        }
+      }
+  };
+
+  // Performs the operation on all of the tuples of idata and merges the
+  // result into the single tuple odata.
+  template <class T>
+  void vtkMinMaxExecute(vtkMinMax* self, const T* idata,
+    const unsigned char* ghosts, vtkIdType numTuples, int numComp,
+    int compIdx, T* odata)
+    {
+    vtkMinMaxFunctor<T> functor;
+    functor.Data = idata;
+    functor.Ghosts = ghosts;
+    functor.NumberOfComponents = numComp;
+    functor.Operation = self->GetOperation();
+    if (numTuples < VTK_MIN_MAX_THREADED_TUPLES)
+      {
+      functor.Initialize();
+      functor(0, numTuples);
+      functor.Reduce();
+      }
+    else
+      {
+      vtkSMPTools::For(0, numTuples, functor);
+      }
+    if (!functor.Found)
+      {
+      return;
+      }
+
+    char* firstPasses = self->GetFirstPasses();
+    for (int jdx = 0; jdx < numComp; ++jdx)
+      {
+      if (firstPasses[compIdx + jdx])
+        {
+        firstPasses[compIdx + jdx] = 0;
+        odata[jdx] = functor.Result[jdx];
+        }
+      else
+        {
+        odata[jdx] = vtkMinMaxApply(
+          self->GetOperation(), odata[jdx], functor.Result[jdx]);
+        }
+      }
+    }
+
+  // Replaces the components that were never initialized with the identity
+  // of the operation so that they do not change the result of a reduction
+  // among processes.
+  template <class T>
+  void vtkMinMaxSetIdentity(int operation, const char* firstPasses,
+    int numComp, T* data)
+    {
+    for (int jdx = 0; jdx < numComp; ++jdx)
+      {
+      if (!firstPasses[jdx])
+        {
+        continue;
+        }
+      switch (operation)
+        {
+        case vtkMinMax::MIN:
+          data[jdx] = vtkTypeTraits<T>::Max();
+          break;
+        case vtkMinMax::MAX:
+          data[jdx] = vtkTypeTraits<T>::Min();
+          break;
+        default:
+          data[jdx] = 0;
+          break;
+        }
+      }
+    }
+
+  // Returns true when both fields have the same arrays.
+  bool vtkMinMaxSameArrays(vtkFieldData* a, vtkFieldData* b)
+    {
+    int numArrays = a->GetNumberOfArrays();
+    if (numArrays != b->GetNumberOfArrays())
+      {
+      return false;
+      }
+    for (int idx = 0; idx < numArrays; idx++)
+      {
+      vtkAbstractArray* aa = a->GetAbstractArray(idx);
+      vtkAbstractArray* ba = b->GetAbstractArray(idx);
+      const char* aname = aa->GetName() ? aa->GetName() : "";
+      const char* bname = ba->GetName() ? ba->GetName() : "";
+      if (aa->GetDataType() != ba->GetDataType() ||
+        aa->GetNumberOfComponents() != ba->GetNumberOfComponents() ||
+        strcmp(aname, bname) != 0)
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+}
 
 //-----------------------------------------------------------------------------
 vtkMinMax::vtkMinMax()
@@ -45,6 +323,9 @@ vtkMinMax::vtkMinMax()
   this->PFirstPass = NULL;
   this->FirstPasses = NULL;
   this->MismatchOccurred = 0;
+  this->DistributedReduction = 0;
+  this->Controller = NULL;
+  this->SetController(vtkMultiProcessController::GetGlobalController());
 }
 
 //-----------------------------------------------------------------------------
@@ -58,6 +339,7 @@ vtkMinMax::~vtkMinMax()
     {
     delete[] this->PFirstPass;
     }
+  this->SetController(NULL);
 }
 
 //-----------------------------------------------------------------------------
@@ -103,7 +385,7 @@ int vtkMinMax::RequestData(vtkInformation* vtkNotUsed(reqInfo),
                              vtkInformationVector* outputVector)
 {
   int numInputs;
-  int idx, numArrays;
+  int idx;
   vtkCompositeDataSet *cdobj = NULL;
 
   //get hold of input, output
@@ -129,7 +411,11 @@ int vtkMinMax::RequestData(vtkInformation* vtkNotUsed(reqInfo),
       cdit->Delete();
       }
     }
-  if (!input0)
+  //a process without data still has to take part in the reduction among
+  //processes, it gets the shape of the attributes from the others
+  const bool distributed = this->DistributedReduction && this->Controller &&
+    this->Controller->GetNumberOfProcesses() > 1;
+  if (!input0 && !distributed)
     {
     vtkErrorMacro("Can't find a dataset to get attribute shape from.");
     return 0;
@@ -137,45 +423,15 @@ int vtkMinMax::RequestData(vtkInformation* vtkNotUsed(reqInfo),
 
   //make output arrays of same type and width as input, but make them just one 
   //element long
-  vtkFieldData *icd = input0->GetCellData();
   vtkFieldData *ocd = output->GetCellData();
-  ocd->CopyStructure(icd);
-  numArrays = icd->GetNumberOfArrays();
-  for (idx = 0; idx < numArrays; idx++)
-    {
-    ocd->GetArray(idx)->SetNumberOfTuples(1);
-    }
-  vtkFieldData *ipd = input0->GetPointData();
   vtkFieldData *opd = output->GetPointData();
-  opd->CopyStructure(ipd);
-  numArrays = ipd->GetNumberOfArrays();
-  for (idx = 0; idx < numArrays; idx++)
-    {
-    opd->GetArray(idx)->SetNumberOfTuples(1);
-    }
-
-  //initialize first pass flags for the cell data
-  int numComp;
-  numComp = ocd->GetNumberOfComponents();
-  if (this->CFirstPass)
-    {
-    delete[] this->CFirstPass;
-    }
-  this->CFirstPass = new char[numComp];
-  for (idx = 0; idx < numComp; idx++)
-    {
-    this->CFirstPass[idx] = 1;
-    }
-  numComp = ipd->GetNumberOfComponents();
-  if (this->PFirstPass)
-    {
-    delete[] this->PFirstPass;
-    }
-  this->PFirstPass = new char[numComp];
-  for (idx = 0; idx < numComp; idx++)
+  if (input0)
     {
-    this->PFirstPass[idx] = 1;
+    ocd->CopyStructure(input0->GetCellData());
+    opd->CopyStructure(input0->GetPointData());
     }
+  this->InitializeField(ocd, this->CFirstPass);
+  this->InitializeField(opd, this->PFirstPass);
 
   
   //make output 1 point and cell in the output as placeholders for the results
@@ -201,7 +457,7 @@ int vtkMinMax::RequestData(vtkInformation* vtkNotUsed(reqInfo),
   vtkInformation *inInfo;
   vtkDataSet *inputN;
 
-  for (idx = 0; idx < numInputs; ++idx)
+  for (idx = 0; input0 && idx < numInputs; ++idx)
     {
     inInfo = inputVector[0]->GetInformationObject(idx);
     if (!cdobj)
@@ -244,9 +500,149 @@ int vtkMinMax::RequestData(vtkInformation* vtkNotUsed(reqInfo),
       }
     }
 
+  if (distributed)
+    {
+    //a process without any array, e.g. with an empty piece, adopts the
+    //arrays of the others without that counting as a mismatch
+    this->ReduceAmongProcesses(output, input0 &&
+      (ocd->GetNumberOfArrays() > 0 || opd->GetNumberOfArrays() > 0));
+    }
+
   return 1;
 }
 
+//-----------------------------------------------------------------------------
+void vtkMinMax::InitializeField(vtkFieldData *ofd, char *&firstPasses)
+{
+  int numArrays = ofd->GetNumberOfArrays();
+  for (int idx = 0; idx < numArrays; idx++)
+    {
+    ofd->GetAbstractArray(idx)->SetNumberOfTuples(1);
+    }
+
+  //initialize first pass flags for the field
+  int numComp = ofd->GetNumberOfComponents();
+  if (firstPasses)
+    {
+    delete[] firstPasses;
+    }
+  firstPasses = new char[numComp];
+  for (int idx = 0; idx < numComp; idx++)
+    {
+    firstPasses[idx] = 1;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkMinMax::ReduceAmongProcesses(vtkPolyData *output, bool hasData)
+{
+  vtkMultiProcessController *controller = this->Controller;
+  int myId = controller->GetLocalProcessId();
+  int numProcs = controller->GetNumberOfProcesses();
+
+  //the first process with data defines the arrays to reduce, the others
+  //conform to it so that every process reduces the same values
+  int localOwner = hasData ? myId : numProcs;
+  int owner = numProcs;
+  controller->AllReduce(&localOwner, &owner, 1, vtkCommunicator::MIN_OP);
+  if (owner == numProcs)
+    {
+    //nobody has data
+    return;
+    }
+
+  vtkSmartPointer<vtkPolyData> shape = vtkSmartPointer<vtkPolyData>::New();
+  if (myId == owner)
+    {
+    shape->ShallowCopy(output);
+    }
+  controller->Broadcast(shape, owner);
+  if (myId != owner)
+    {
+    if (!vtkMinMaxSameArrays(shape->GetCellData(), output->GetCellData()))
+      {
+      if (hasData)
+        {
+        this->MismatchOccurred = 1;
+        }
+      output->GetCellData()->CopyStructure(shape->GetCellData());
+      this->InitializeField(output->GetCellData(), this->CFirstPass);
+      }
+    if (!vtkMinMaxSameArrays(shape->GetPointData(), output->GetPointData()))
+      {
+      if (hasData)
+        {
+        this->MismatchOccurred = 1;
+        }
+      output->GetPointData()->CopyStructure(shape->GetPointData());
+      this->InitializeField(output->GetPointData(), this->PFirstPass);
+      }
+    }
+
+  this->ReduceField(output->GetCellData(), this->CFirstPass);
+  this->ReduceField(output->GetPointData(), this->PFirstPass);
+
+  int mismatch = this->MismatchOccurred;
+  controller->AllReduce(
+    &mismatch, &this->MismatchOccurred, 1, vtkCommunicator::MAX_OP);
+}
+
+//-----------------------------------------------------------------------------
+void vtkMinMax::ReduceField(vtkFieldData *ofd, char *firstPasses)
+{
+  vtkMultiProcessController *controller = this->Controller;
+  int numComp = ofd->GetNumberOfComponents();
+  if (numComp == 0)
+    {
+    return;
+    }
+
+  //a component stays uninitialized only when it is on every process
+  std::vector<int> localFlags(firstPasses, firstPasses + numComp);
+  std::vector<int> flags(numComp);
+  controller->AllReduce(
+    &localFlags[0], &flags[0], numComp, vtkCommunicator::MIN_OP);
+
+  int operation = vtkCommunicator::MIN_OP;
+  if (this->Operation == vtkMinMax::MAX)
+    {
+    operation = vtkCommunicator::MAX_OP;
+    }
+  else if (this->Operation == vtkMinMax::SUM)
+    {
+    operation = vtkCommunicator::SUM_OP;
+    }
+
+  int compIdx = 0;
+  int numArrays = ofd->GetNumberOfArrays();
+  for (int idx = 0; idx < numArrays; idx++)
+    {
+    vtkAbstractArray *oa = ofd->GetAbstractArray(idx);
+    vtkDataArray *da = vtkDataArray::SafeDownCast(oa);
+    int arrayComp = oa->GetNumberOfComponents();
+    if (da)
+      {
+      switch (da->GetDataType())
+        {
+        vtkTemplateMacro(
+          vtkMinMaxSetIdentity(this->Operation, firstPasses + compIdx,
+            arrayComp, static_cast<VTK_TT *>(da->GetVoidPointer(0))));
+        }
+      vtkSmartPointer<vtkDataArray> result;
+      result.TakeReference(da->NewInstance());
+      controller->AllReduce(da, result, operation);
+      memcpy(da->GetVoidPointer(0), result->GetVoidPointer(0),
+        arrayComp * da->GetDataTypeSize());
+      }
+    compIdx += arrayComp;
+    }
+
+  for (int idx = 0; idx < numComp; idx++)
+    {
+    firstPasses[idx] = static_cast<char>(flags[idx]);
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkMinMax::FlagsForPoints()
 {
@@ -306,95 +702,37 @@ void vtkMinMax::OperateOnArray(vtkAbstractArray *ia, vtkAbstractArray *oa)
   int datatype = ia->GetDataType();
 
   this->Name = ia->GetName();      
-
-  //go over each tuple
-  for (vtkIdType idx = 0; idx < numTuples; idx++)
+  this->Idx = numTuples;
+  if (numTuples == 0)
     {
-    this->Idx = idx;
-
-    if (
-      (this->GhostArray != NULL) &&
-      (this->GhostArray->GetValue(idx) & vtkDataSetAttributes::DUPLICATECELL)
-      )
-      {
-      //skip cell and point attributes that don't belong to me
-      continue;
-      }
-
-    //get type agnostic access to the tuple
-    void *idata = ia->GetVoidPointer(idx*numComp);
-    void *odata = oa->GetVoidPointer(0);
-
-    //go over each component in the tuple (jdx)
-    // perform odata[jdx] = operation(idata[jdx],odata[jdx])
-    switch (datatype)
-      {
-      vtkTemplateMacro(
-        vtkMinMaxExecute(this, numComp, this->ComponentIdx, 
-                         static_cast<VTK_TT *>(idata),
-                         static_cast<VTK_TT *>(odata)
-          ));
-
-      //if you can make an operator for things like strings etc,
-      //put the cases for those strings here
-
-      default:
-        vtkErrorMacro(<< "Unknown data type refusing to operate on this array" );
-        this->MismatchOccurred = 1;
-      }
+    return;
     }
-}
 
-//-----------------------------------------------------------------------------
-// This templated function performs the operation on any type of data.
-template <class T>
-void vtkMinMaxExecute(vtkMinMax *self,
-                        int numComp,
-                        int compIdx,
-                        T* idata,
-                        T* odata
-                        )
-{
-
-  //go over each component of the tuple
-  for (int jdx = 0; jdx < numComp; jdx++)
+  //skip cell and point attributes that don't belong to me
+  const unsigned char *ghosts = NULL;
+  if (this->GhostArray &&
+      this->GhostArray->GetNumberOfTuples() >= numTuples)
     {
-      
-    T *ivalue = idata + jdx;
-    T *ovalue = odata + jdx;
-
-    char *FirstPasses = self->GetFirstPasses();
-    if (FirstPasses[compIdx+jdx])
-      {
-      FirstPasses[compIdx+jdx] = 0;
-      *ovalue = *ivalue;
-      continue;
-      }
-    
-    switch (self->GetOperation()) 
-      {
-      case vtkMinMax::MIN: 
-      {
-      if (*ivalue < *ovalue) *ovalue = *ivalue;
-      break;
-      }
-      case vtkMinMax::MAX:
-      {
-      if (*ivalue > *ovalue) *ovalue = *ivalue;
-      break;
-      }
-      case vtkMinMax::SUM:
-      {
-      *ovalue += *ivalue;
-      break;
-      }
-      default:
-      {
-      *ovalue = *ivalue;
-      break;
-      }
-      }    
+    ghosts = this->GhostArray->GetPointer(0);
+    }
 
+  //perform odata[jdx] = operation(idata[jdx],odata[jdx]) over all tuples
+  //directly on the contiguous values of the array
+  switch (datatype)
+    {
+    vtkTemplateMacro(
+      vtkMinMaxExecute(this,
+                       static_cast<VTK_TT *>(ia->GetVoidPointer(0)),
+                       ghosts, numTuples, numComp, this->ComponentIdx,
+                       static_cast<VTK_TT *>(oa->GetVoidPointer(0))
+        ));
+
+    //if you can make an operator for things like strings etc,
+    //put the cases for those strings here
+
+    default:
+      vtkErrorMacro(<< "Unknown data type refusing to operate on this array" );
+      this->MismatchOccurred = 1;
     }
 }
 
@@ -406,5 +744,8 @@ void vtkMinMax::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "FirstPasses: "
      << (this->FirstPasses ? this->FirstPasses : "None") << endl;
   os << indent << "MismatchOccurred: " << this->MismatchOccurred << endl;
+  os << indent << "DistributedReduction: " << this->DistributedReduction
+     << endl;
+  os << indent << "Controller: " << this->Controller << endl;
 
 }
@@ -25,12 +25,19 @@
 // runs this filter REQUIRES ghost arrays to skip redundant 
 // information. The output of this filter will always be a single vtkPolyData 
 // that contains exactly one point and one cell (a VTK_VERTEX).
+//
+// The operation runs directly on the values of the arrays and large arrays
+// are split among threads with vtkSMPTools. When DistributedReduction is on,
+// the results of all processes are also combined with collective operations
+// so that every process gets the global result without having to gather the
+// intermediate outputs to the root node and run the filter again there.
 
 #include "vtkPVVTKExtensionsDefaultModule.h" //needed for exports
 #include "vtkPolyDataAlgorithm.h"
 
 class vtkFieldData;
 class vtkAbstractArray;
+class vtkMultiProcessController;
 class vtkUnsignedCharArray;
 
 class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkMinMax : public vtkPolyDataAlgorithm
@@ -67,6 +74,20 @@ public:
   void FlagsForPoints();
   void FlagsForCells();
 
+  //Description:
+  //When on, the results of all the processes of Controller are reduced
+  //together and every process produces the global result. All processes
+  //must execute the filter then. Off by default.
+  vtkSetMacro(DistributedReduction, int);
+  vtkGetMacro(DistributedReduction, int);
+  vtkBooleanMacro(DistributedReduction, int);
+
+  //Description:
+  //The controller used by the distributed reduction. The global controller
+  //by default.
+  void SetController(vtkMultiProcessController*);
+  vtkGetObjectMacro(Controller, vtkMultiProcessController);
+
   //temp for debugging
   const char *Name;
   vtkIdType Idx;
@@ -86,6 +107,11 @@ protected:
   //helper methods to break up the work
   void OperateOnField(vtkFieldData *id, vtkFieldData *od);
   void OperateOnArray(vtkAbstractArray *ia, vtkAbstractArray *oa);
+  void InitializeField(vtkFieldData *od, char *&firstPasses);
+
+  //combines the results of all processes
+  void ReduceAmongProcesses(vtkPolyData *output, bool hasData);
+  void ReduceField(vtkFieldData *od, char *firstPasses);
 
   //choice of operation to perform
   int Operation;
@@ -102,6 +128,9 @@ protected:
   //a flag that indicates if values computed could be inaccurate
   int MismatchOccurred;
 
+  int DistributedReduction;
+  vtkMultiProcessController *Controller;
+
 private:
   vtkMinMax(const vtkMinMax&); // Not implemented.
   void operator=(const vtkMinMax&); // Not implemented.
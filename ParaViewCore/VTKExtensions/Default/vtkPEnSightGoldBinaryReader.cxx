@@ -16,7 +16,9 @@
 
 #include <sys/stat.h>
 #include <ctype.h>
+#include <algorithm>
 #include <string>
+#include <vector>
 
 vtkStandardNewMacro(vtkPEnSightGoldBinaryReader);
 
@@ -33,15 +35,12 @@ vtkPEnSightGoldBinaryReader::vtkPEnSightGoldBinaryReader()
   this->NodeIdsListed = 0;
   this->ElementIdsListed = 0;
 
-  this->FloatBufferSize = 1000;
+  this->IFileBuffer = NULL;
+  this->IFileBufferSize = 4 * 1024 * 1024;
 
-  this->FloatBuffer = (float **) malloc( 3 * sizeof(float *) );
-  this->FloatBuffer[0] = new float[this->FloatBufferSize];
-  this->FloatBuffer[1] = new float[this->FloatBufferSize];
-  this->FloatBuffer[2] = new float[this->FloatBufferSize];
-  this->FloatBufferIndexBegin = -1;
-  this->FloatBufferFilePosition =  0;
-  this->FloatBufferNumberOfVectors = 0;
+  // Both buffers are allocated on first use.
+  this->FloatBuffer = NULL;
+  this->FloatBufferSize = 256 * 1024;
 }
 
 //----------------------------------------------------------------------------
@@ -53,10 +52,8 @@ vtkPEnSightGoldBinaryReader::~vtkPEnSightGoldBinaryReader()
     delete this->IFile;
     this->IFile = NULL;
     }
-  delete [] this->FloatBuffer[2];
-  delete [] this->FloatBuffer[1];
-  delete [] this->FloatBuffer[0];
-  free( this->FloatBuffer );
+  delete [] this->IFileBuffer;
+  delete [] this->FloatBuffer;
 }
 
 //----------------------------------------------------------------------------
@@ -84,10 +81,17 @@ int vtkPEnSightGoldBinaryReader::OpenFile(const char* filename)
     // Find out how big the file is.
     this->FileSize = (long)(fs.st_size);
 
+    // The buffer must be given to the stream before the file is opened.
+    if (!this->IFileBuffer)
+      {
+      this->IFileBuffer = new char[this->IFileBufferSize];
+      }
+    this->IFile = new ifstream;
+    this->IFile->rdbuf()->pubsetbuf(this->IFileBuffer, this->IFileBufferSize);
 #ifdef _WIN32
-    this->IFile = new ifstream(filename, ios::in | ios::binary);
+    this->IFile->open(filename, ios::in | ios::binary);
 #else
-    this->IFile = new ifstream(filename, ios::in);
+    this->IFile->open(filename, ios::in);
 #endif
     }
   else
@@ -3844,29 +3848,17 @@ int vtkPEnSightGoldBinaryReader::CreateStructuredGridOutput(
   output->SetDimensions(newDimensions);
 //   output->SetWholeExtent(
 //                          0, newDimensions[0]-1, 0, newDimensions[1]-1, 0, newDimensions[2]-1);
-  points->Allocate(this->GetPointIds(partId)->GetLocalNumberOfIds());
-
-  long currentPositionInFile = this->IFile->tellg();
-
-  // Buffer Read.
-  this->FloatBufferFilePosition = currentPositionInFile;
-  this->FloatBufferIndexBegin = 0;
-  this->FloatBufferNumberOfVectors = numPts;
-  long endFilePosition = currentPositionInFile + 3 * numPts * sizeof(float);
-  if (this->Fortran)
-    endFilePosition += 24; // 4 * (begin + end) * number of components (3)
-  this->UpdateFloatBuffer();
-  this->IFile->seekg(endFilePosition);
-
-  for (i = 0; i < numPts; i++)
+  points->SetDataTypeToFloat();
+  points->SetNumberOfPoints(this->GetPointIds(partId)->GetLocalNumberOfIds());
+  if (!this->ReadCoordinates(points, numPts, this->GetPointIds(partId), true))
     {
-    int realPointId = this->GetPointIds(partId)->GetId(i);
-    if( realPointId != -1 )
+    if (pointGhostArray)
       {
-      float vec[3];
-      this->GetVectorFromFloatBuffer(i,vec);
-      points->InsertNextPoint(vec[0], vec[1], vec[2]);
+      pointGhostArray->Delete();
+      cellGhostArray->Delete();
       }
+    points->Delete();
+    return -1;
     }
   output->SetPoints(points);
   if (iblanked)
@@ -4410,11 +4402,6 @@ int vtkPEnSightGoldBinaryReader::ReadOrSkipCoordinates(vtkPoints* points, long o
 
   long currentPositionInFile = this->IFile->tellg();
 
-  this->FloatBufferFilePosition = currentPositionInFile;
-  this->FloatBufferIndexBegin = 0;
-  this->FloatBufferNumberOfVectors = numPts;
-  this->UpdateFloatBuffer();
-
   // Position to reach at the end of this method
   long endFilePosition = currentPositionInFile + 3 * numPts * sizeof(float);
   if (this->Fortran)
@@ -4438,34 +4425,20 @@ int vtkPEnSightGoldBinaryReader::ReadOrSkipCoordinates(vtkPoints* points, long o
       {
       // No Point was injected at all For this Part. There is clearly a problem...
       // TODO: Do something ?
-      //delete [] xCoords;
-      //delete [] yCoords;
-      //delete [] zCoords;
       this->IFile->seekg(endFilePosition);
       return 0;
       }
     else
       {
       // Inject really needed points
-      int i;
       int localNumberOfIds = this->GetPointIds(partId)->GetLocalNumberOfIds();
-      points->Allocate(localNumberOfIds);
+      points->SetDataTypeToFloat();
       points->SetNumberOfPoints(localNumberOfIds);
-      int maxId = -1;
-      int minId = -1;
-      for (i = 0; i < numPts; i++)
+      // The coordinates are read sequentially, the stream is already at the
+      // end of the section afterwards.
+      if (!this->ReadCoordinates(points, numPts, this->GetPointIds(partId), false))
         {
-        float vec[3];
-        int id = this->GetPointIds(partId)->GetId(i);
-        if( id != -1 )
-          {
-          if( (minId == -1 ) || (minId > id) )
-            minId = id;
-          if( (maxId == -1 ) || (maxId < id) )
-            maxId = id;
-          this->GetVectorFromFloatBuffer(i,vec);
-          points->SetPoint(id, vec[0], vec[1], vec[2]);
-          }
+        return -1;
         }
 
       // Inject real Number of points, as we cannot take the size of the vector as a reference
@@ -4474,15 +4447,105 @@ int vtkPEnSightGoldBinaryReader::ReadOrSkipCoordinates(vtkPoints* points, long o
       // In case read has never been skipped, we do this again here
       this->GetPointIds(partId)->SetNumberOfIds(numPts);
 
-      //delete [] xCoords;
-      //delete [] yCoords;
-      //delete [] zCoords;
-      this->IFile->seekg(endFilePosition);
       return localNumberOfIds;
       }
     }
 }
 
+//----------------------------------------------------------------------------
+int vtkPEnSightGoldBinaryReader::ReadCoordinates(vtkPoints* points,
+  int numPts, vtkPEnSightReaderCellIds* pointIds, bool append)
+{
+  if (numPts <= 0)
+    {
+    return 1;
+    }
+  if (!this->FloatBuffer)
+    {
+    this->FloatBuffer = new float[this->FloatBufferSize];
+    }
+
+  // The x, y and z arrays follow each other in the file. Each one is read
+  // in large blocks without seeking, which would drop the stream buffer. The
+  // ids of the points kept by this process are looked up once, while the x
+  // array is read, and reused for the other two.
+  float* coords = static_cast<float*>(points->GetVoidPointer(0));
+  std::vector<int> keptIndices;
+  std::vector<int> keptIds;
+  keptIndices.reserve(points->GetNumberOfPoints());
+  keptIds.reserve(points->GetNumberOfPoints());
+  char dummy[4];
+  for (int comp = 0; comp < 3; comp++)
+    {
+    if (this->Fortran)
+      {
+      if (!this->IFile->read(dummy, 4).good())
+        {
+        vtkErrorMacro("Read (fortran) failed.");
+        return 0;
+        }
+      }
+
+    size_t kept = 0;
+    for (int begin = 0; begin < numPts; begin += this->FloatBufferSize)
+      {
+      int size = std::min(this->FloatBufferSize, numPts - begin);
+      if (!this->IFile->read((char*)this->FloatBuffer,
+                             sizeof(float)*size).good())
+        {
+        vtkErrorMacro("Read failed");
+        return 0;
+        }
+
+      if (this->ByteOrder == FILE_LITTLE_ENDIAN)
+        {
+        vtkByteSwap::Swap4LERange(this->FloatBuffer, size);
+        }
+      else
+        {
+        vtkByteSwap::Swap4BERange(this->FloatBuffer, size);
+        }
+
+      if (comp == 0)
+        {
+        for (int i = 0; i < size; i++)
+          {
+          int id = pointIds->GetId(begin + i);
+          if (id != -1)
+            {
+            if (append)
+              {
+              id = static_cast<int>(keptIds.size());
+              }
+            keptIndices.push_back(begin + i);
+            keptIds.push_back(id);
+            coords[3 * id] = this->FloatBuffer[i];
+            }
+          }
+        }
+      else
+        {
+        for (; kept < keptIndices.size() && keptIndices[kept] < begin + size;
+             kept++)
+          {
+          coords[3 * keptIds[kept] + comp] =
+            this->FloatBuffer[keptIndices[kept] - begin];
+          }
+        }
+      }
+
+    if (this->Fortran)
+      {
+      if (!this->IFile->read(dummy, 4).good())
+        {
+        vtkErrorMacro("Read (fortran) failed.");
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 int vtkPEnSightGoldBinaryReader::InjectCoordinatesAtEnd(vtkUnstructuredGrid* output, long coordinatesOffset, int partId )
 {
@@ -4527,65 +4590,6 @@ int vtkPEnSightGoldBinaryReader::InjectCoordinatesAtEnd(vtkUnstructuredGrid* out
   return pointsRead;
 }
 
-//----------------------------------------------------------------------------
-void vtkPEnSightGoldBinaryReader::GetVectorFromFloatBuffer(int i, float *vector)
-{
-  // We assume FloatBufferIndexBegin, FloatBufferFilePosition, and FloatBufferNumberOfVectors
-  // were previously set.
-  int closestBufferBegin = (i / this->FloatBufferSize) * this->FloatBufferSize;
-  if( (this->FloatBufferIndexBegin == -1 ) || (closestBufferBegin != this->FloatBufferIndexBegin ) )
-    {
-    this->FloatBufferIndexBegin = closestBufferBegin;
-    this->UpdateFloatBuffer();
-    }
-
-  int index = i - this->FloatBufferIndexBegin;
-  vector[0] = this->FloatBuffer[0][index];
-  vector[1] = this->FloatBuffer[1][index];
-  vector[2] = this->FloatBuffer[2][index];
-}
-
-//----------------------------------------------------------------------------
-void vtkPEnSightGoldBinaryReader::UpdateFloatBuffer()
-{
-  long currentPosition = this->IFile->tellg();
-
-  int sizeToRead;
-  if( this->FloatBufferIndexBegin + this->FloatBufferSize > this->FloatBufferNumberOfVectors )
-    {
-    sizeToRead = this->FloatBufferNumberOfVectors - this->FloatBufferIndexBegin;
-    }
-  else
-    {
-    sizeToRead = this->FloatBufferSize;
-    }
-
-  for(int i = 0; i < 3; i++)
-    {
-    // We cannot use ReadFloatArray method, because Fortran format has dummy things
-    if( this->Fortran )
-      this->IFile->seekg(this->FloatBufferFilePosition + 4 + i * (this->FloatBufferNumberOfVectors * sizeof(float) + 8) + this->FloatBufferIndexBegin * sizeof(float) );
-    else
-      this->IFile->seekg(this->FloatBufferFilePosition + i * this->FloatBufferNumberOfVectors * sizeof(float) + this->FloatBufferIndexBegin * sizeof(float) );
-
-    if (!this->IFile->read((char*)this->FloatBuffer[i], sizeof(float)*sizeToRead).good())
-      {
-      vtkErrorMacro("Read failed");
-      }
-
-    if (this->ByteOrder == FILE_LITTLE_ENDIAN)
-      {
-      vtkByteSwap::Swap4LERange(this->FloatBuffer[i], sizeToRead);
-      }
-    else
-      {
-      vtkByteSwap::Swap4BERange(this->FloatBuffer[i], sizeToRead);
-      }
-    }
-
-  this->IFile->seekg(currentPosition);
-}
-
 //----------------------------------------------------------------------------
 void vtkPEnSightGoldBinaryReader::PrintSelf(ostream& os, vtkIndent indent)
 {
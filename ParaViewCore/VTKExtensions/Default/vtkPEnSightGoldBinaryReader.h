@@ -166,6 +166,15 @@ class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkPEnSightGoldBinaryReader : public vtkP
   // Read Coordinates, or just skip the part in the file.
   int ReadOrSkipCoordinates(vtkPoints* points, long offset, int partId, bool skip);
 
+  // Description:
+  // Internal function to read the coordinates of numPts points, one
+  // component after the other, in blocks of FloatBufferSize values. Points
+  // kept by this process are stored at their local id in points, or in file
+  // order when append is true. points must hold floats and be large enough.
+  // Returns zero if there was an error.
+  int ReadCoordinates(vtkPoints* points, int numPts,
+                      vtkPEnSightReaderCellIds* pointIds, bool append);
+
   // Description:
   // Internal method to inject Coordinates and Global Ids at the end
   // of a part read for Unstructured data.
@@ -194,20 +203,15 @@ class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkPEnSightGoldBinaryReader : public vtkP
   // The size of the file could be used to choose byte order.
   long FileSize;
 
-  // Float Vector Buffer utils
-  void GetVectorFromFloatBuffer(int i, float *vector);
-  void UpdateFloatBuffer();
-  // The buffer
-  float **FloatBuffer;
-  // The buffer size. Default is 1000
+  // Buffer of IFile, so that the file system is read in large blocks
+  // instead of many small requests. Default is 4 MB.
+  char *IFileBuffer;
+  int IFileBufferSize;
+
+  // Buffer used to read coordinates block by block.
+  float *FloatBuffer;
+  // The buffer size, in floats. Default is 256k.
   int FloatBufferSize;
-  // The FloatBuffer store the vectors
-  // from FloatBufferIndexBegin to FloatBufferIndexBegin + FloatBufferSize
-  int FloatBufferIndexBegin;
-  // X variable positions of vector number 0 in file
-  long FloatBufferFilePosition;
-  // Total number of vectors;
-  int FloatBufferNumberOfVectors;
 
  private:
   vtkPEnSightGoldBinaryReader(const vtkPEnSightGoldBinaryReader&);  // Not implemented.
@@ -14,8 +14,7 @@
 =========================================================================*/
 #include "vtkPExtractHistogram.h"
 
-#include "vtkAttributeDataReductionFilter.h"
-#include "vtkCellData.h"
+#include "vtkCharArray.h"
 #include "vtkCommunicator.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
@@ -24,13 +23,15 @@
 #include "vtkIntArray.h"
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
-#include "vtkReductionFilter.h"
 #include "vtkSmartPointer.h"
 #include "vtkTable.h"
 
-
+#include <map>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
 #include <string>
-#include <vtksys/RegularExpression.hxx>
+#include <vector>
 
 vtkStandardNewMacro(vtkPExtractHistogram);
 vtkCxxSetObjectMacro(vtkPExtractHistogram, Controller, vtkMultiProcessController);
@@ -91,73 +92,137 @@ int vtkPExtractHistogram::RequestData(vtkInformation *request,
     }
 
   vtkTable* output = vtkTable::GetData(outputVector, 0);
-  vtkSmartPointer<vtkDataArray> oldExtents = 
-    output->GetRowData()->GetArray((int)0);
-  if (oldExtents == NULL)
+  vtkIntArray* bin_values = vtkIntArray::SafeDownCast(
+    output->GetRowData()->GetArray("bin_values"));
+  if (bin_values == NULL)
     {
-    // Nothing to do if there is no data
+    // Nothing to do if there is no data. Since the bin ranges are reduced
+    // among all processes, this is the case on all processes.
     return 1;
     }
-  // Now we need to collect and reduce data from all nodes on the root.
-  vtkSmartPointer<vtkReductionFilter> reduceFilter = 
-    vtkSmartPointer<vtkReductionFilter>::New();
-  reduceFilter->SetController(this->Controller);
 
-  bool isRoot = (this->Controller->GetLocalProcessId() ==0);
-  if (isRoot)
+  // The bin counts and the totals of the averaged arrays are summed directly
+  // on the root node, averages are computed from the reduced totals.
+  const bool isRoot = (this->Controller->GetLocalProcessId() == 0);
+  std::vector<int> counts(this->BinCount, 0);
+  if (!this->Controller->Reduce(bin_values->GetPointer(0), &counts[0],
+      this->BinCount, vtkCommunicator::SUM_OP, 0))
     {
-    // PostGatherHelper needs to be set only on the root node.
-    vtkSmartPointer<vtkAttributeDataReductionFilter> rf = 
-      vtkSmartPointer<vtkAttributeDataReductionFilter>::New();
-    rf->SetAttributeType(vtkAttributeDataReductionFilter::ROW_DATA);
-    rf->SetReductionType(vtkAttributeDataReductionFilter::ADD);
-    reduceFilter->SetPostGatherHelper(rf);
+    vtkErrorMacro("Parallel communication error. Could not reduce bins.");
+    return 0;
     }
 
-  vtkSmartPointer<vtkTable> copy = vtkSmartPointer<vtkTable>::New();
-  copy->ShallowCopy(output);
-  reduceFilter->SetInputData(copy);
-  reduceFilter->Update();
-  if (isRoot)
+  // Arrays averaged on some processes may be missing on others, so agree on
+  // the union of the averaged arrays first.
+  std::map<std::string, int> averaged;
+  if (this->CalculateAverages)
     {
-    // We save the old bin_extents and then revert to be restored later since
-    // the reduction reduces the bin_extents as well.
-    output->ShallowCopy(reduceFilter->GetOutput());
-    if (output->GetRowData()->GetNumberOfArrays() == 0)
+    std::ostringstream localNames;
+    int numArrays = output->GetRowData()->GetNumberOfArrays();
+    for (int i = 0; i < numArrays; i++)
+      {
+      vtkDataArray* array = output->GetRowData()->GetArray(i);
+      const char* name = array? array->GetName() : NULL;
+      size_t length = name? strlen(name) : 0;
+      if (length > 6 && strcmp(name + length - 6, "_total") == 0)
+        {
+        localNames << std::string(name, length - 6) << '\0'
+          << array->GetNumberOfComponents() << '\0';
+        }
+      }
+    const std::string localBuffer = localNames.str();
+    vtkSmartPointer<vtkCharArray> sendNames =
+      vtkSmartPointer<vtkCharArray>::New();
+    sendNames->SetNumberOfTuples(static_cast<vtkIdType>(localBuffer.size()));
+    if (!localBuffer.empty())
+      {
+      memcpy(sendNames->GetPointer(0), localBuffer.c_str(), localBuffer.size());
+      }
+    vtkSmartPointer<vtkCharArray> names = vtkSmartPointer<vtkCharArray>::New();
+    if (!this->Controller->AllGatherV(sendNames.GetPointer(), names.GetPointer()))
       {
-      vtkErrorMacro(<<"Reduced data has 0 arrays");
+      vtkErrorMacro("Parallel communication error. Could not gather arrays.");
       return 0;
       }
-    output->GetRowData()->GetArray((int)0)->DeepCopy(oldExtents);
-    if (this->CalculateAverages)
+    const char* buffer = names->GetPointer(0);
+    const char* bufferEnd = buffer + names->GetNumberOfTuples();
+    while (buffer < bufferEnd)
       {
-      vtkDataArray* bin_values = 
-        output->GetRowData()->GetArray("bin_values");
-      vtksys::RegularExpression reg_ex("^(.*)_average$");
-      int numArrays = output->GetRowData()->GetNumberOfArrays();
-      for (int i=0; i<numArrays; i++)
+      std::string name = buffer;
+      buffer += name.size() + 1;
+      int numComps = atoi(buffer);
+      buffer += strlen(buffer) + 1;
+      int& comps = averaged[name];
+      comps = numComps > comps? numComps : comps;
+      }
+    }
+
+  std::vector<double> localTotals;
+  std::map<std::string, int>::iterator iter;
+  for (iter = averaged.begin(); iter != averaged.end(); ++iter)
+    {
+    std::string name = iter->first + "_total";
+    vtkDataArray* array = output->GetRowData()->GetArray(name.c_str());
+    for (vtkIdType idx = 0; idx < this->BinCount; idx++)
+      {
+      for (int j = 0; j < iter->second; j++)
         {
-        vtkDataArray* array = output->GetRowData()->GetArray(i);
-        if (array && reg_ex.find(array->GetName()))
-          {
-          int numComps = array->GetNumberOfComponents();
-          std::string name = reg_ex.match(1) + "_total";
-          vtkDataArray* tarray = output->GetRowData()->GetArray(name.c_str());
-          for (vtkIdType idx=0; idx<this->BinCount; idx++)
-            {
-            for (int j=0; j<numComps; j++)
-              {
-              array->SetComponent(idx, j,
-                tarray->GetComponent(idx, j)/bin_values->GetTuple1(idx));
-              }
-            }
-          }
+        localTotals.push_back(
+          (array && j < array->GetNumberOfComponents())?
+          array->GetComponent(idx, j) : 0.0);
         }
       }
     }
-  else
+  std::vector<double> totals(localTotals.size(), 0.0);
+  if (!localTotals.empty() &&
+    !this->Controller->Reduce(&localTotals[0], &totals[0],
+      static_cast<vtkIdType>(localTotals.size()), vtkCommunicator::SUM_OP, 0))
+    {
+    vtkErrorMacro("Parallel communication error. Could not reduce averages.");
+    return 0;
+    }
+
+  if (!isRoot)
     {
     output->Initialize();
+    return 1;
+    }
+
+  vtkSmartPointer<vtkDataArray> bin_extents =
+    output->GetRowData()->GetArray("bin_extents");
+  vtkSmartPointer<vtkIntArray> reduced_values = bin_values;
+  output->Initialize();
+  output->GetRowData()->AddArray(bin_extents);
+  output->GetRowData()->AddArray(reduced_values);
+  for (vtkIdType idx = 0; idx < this->BinCount; idx++)
+    {
+    reduced_values->SetValue(idx, counts[idx]);
+    }
+
+  const double* total = totals.empty()? NULL : &totals[0];
+  for (iter = averaged.begin(); iter != averaged.end(); ++iter)
+    {
+    const int numComps = iter->second;
+    vtkSmartPointer<vtkDoubleArray> da = vtkSmartPointer<vtkDoubleArray>::New();
+    std::string newname = iter->first + "_total";
+    da->SetName(newname.c_str());
+    da->SetNumberOfComponents(numComps);
+    da->SetNumberOfTuples(this->BinCount);
+    vtkSmartPointer<vtkDoubleArray> aa = vtkSmartPointer<vtkDoubleArray>::New();
+    std::string newname2 = iter->first + "_average";
+    aa->SetName(newname2.c_str());
+    aa->SetNumberOfComponents(numComps);
+    aa->SetNumberOfTuples(this->BinCount);
+    for (vtkIdType idx = 0; idx < this->BinCount; idx++)
+      {
+      for (int j = 0; j < numComps; j++, total++)
+        {
+        da->SetValue(idx*numComps+j, *total);
+        aa->SetValue(idx*numComps+j, counts[idx]? *total / counts[idx] : 0.0);
+        }
+      }
+    output->GetRowData()->AddArray(da);
+    output->GetRowData()->AddArray(aa);
     }
 
   return 1;
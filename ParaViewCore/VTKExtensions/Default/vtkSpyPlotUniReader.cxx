@@ -8,6 +8,9 @@
 #include "vtkIntArray.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkByteSwap.h"
+#include "vtkSMPTools.h"
+#include <algorithm>
+#include <utility>
 #include <vector>
 #include <sstream>
 #include <vtksys/RegularExpression.hxx>
@@ -18,6 +21,121 @@
 vtkStandardNewMacro(vtkSpyPlotUniReader);
 vtkCxxSetObjectMacro(vtkSpyPlotUniReader, CellArraySelection, vtkDataArraySelection);
 
+template<class t>
+int vtkSpyPlotUniReaderRunLengthDataDecode(vtkSpyPlotUniReader* self,
+                                           const unsigned char* in,
+                                           int inSize, t* out,
+                                           int outSize, t scale=1);
+
+//-----------------------------------------------------------------------------
+// Decodes the planes of the blocks of a variable concurrently. The run-length
+// encoded planes are read one after the other into a single buffer, then
+// decoded directly into the arrays of the blocks.
+class vtkSpyPlotPlanesDecoder
+{
+public:
+  struct Plane
+    {
+    size_t Offset;
+    int NumberOfBytes;
+    float* FloatOut;
+    unsigned char* UnsignedCharOut;
+    int Size;
+    };
+
+  vtkSpyPlotPlanesDecoder(bool concurrent) : Concurrent(concurrent) {}
+
+  bool Concurrent;
+  std::vector<unsigned char> Buffer;
+  std::vector<Plane> Planes;
+  std::vector<char> Decoded;
+
+  // Reads the next plane from the stream, it will be decoded into either out
+  // array.
+  bool ReadPlane(vtkSpyPlotIStream* spis, int numBytes, float* floatOut,
+    unsigned char* unsignedCharOut, int size)
+    {
+    Plane plane;
+    plane.Offset = this->Buffer.size();
+    plane.NumberOfBytes = numBytes;
+    plane.FloatOut = floatOut;
+    plane.UnsignedCharOut = unsignedCharOut;
+    plane.Size = size;
+    if (numBytes > 0)
+      {
+      this->Buffer.resize(plane.Offset + numBytes);
+      if (!spis->ReadString(&this->Buffer[plane.Offset], numBytes))
+        {
+        return false;
+        }
+      }
+    this->Planes.push_back(plane);
+    return true;
+    }
+
+  // Returns the number of bytes waiting to be decoded.
+  size_t GetBufferSize() { return this->Buffer.size(); }
+
+  // Decodes all the planes read so far. Returns false if any plane is invalid.
+  bool Decode()
+    {
+    vtkIdType numPlanes = static_cast<vtkIdType>(this->Planes.size());
+    this->Decoded.assign(this->Planes.size(), 1);
+    if (this->Concurrent)
+      {
+      vtkSMPTools::For(0, numPlanes, *this);
+      }
+    else
+      {
+      (*this)(0, numPlanes);
+      }
+    bool status = std::find(this->Decoded.begin(), this->Decoded.end(), 0) ==
+      this->Decoded.end();
+    this->Buffer.clear();
+    this->Planes.clear();
+    return status;
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType cc = begin; cc < end; ++cc)
+      {
+      const Plane& plane = this->Planes[cc];
+      const unsigned char* in = plane.NumberOfBytes > 0?
+        &this->Buffer[plane.Offset] : NULL;
+      // Errors are reported by the caller, not from the threads.
+      if (plane.FloatOut)
+        {
+        this->Decoded[cc] = static_cast<char>(
+          ::vtkSpyPlotUniReaderRunLengthDataDecode(NULL, in,
+            plane.NumberOfBytes, plane.FloatOut, plane.Size));
+        }
+      else if (plane.UnsignedCharOut)
+        {
+        this->Decoded[cc] = static_cast<char>(
+          ::vtkSpyPlotUniReaderRunLengthDataDecode(NULL, in,
+            plane.NumberOfBytes, plane.UnsignedCharOut, plane.Size,
+            static_cast<unsigned char>(255)));
+        }
+      }
+    }
+};
+
+// Decoding is started whenever that many bytes are waiting, to bound the
+// memory used by the buffer.
+static const size_t VTK_SPY_PLOT_DECODE_BUFFER_SIZE = 64 * 1024 * 1024;
+
+// Deletes the arrays of a variable that were not completely read.
+static void vtkSpyPlotUniReaderDeleteArrays(
+  std::vector<std::pair<int, vtkDataArray*> >& arrays)
+{
+  for (size_t cc = 0; cc < arrays.size(); ++cc)
+    {
+    arrays[cc].second->Delete();
+    }
+  arrays.clear();
+}
+
 class vtkSpyPlotWriteString
 {
 public:
@@ -76,6 +194,7 @@ vtkSpyPlotUniReader::vtkSpyPlotUniReader()
   this->NumberOfCellFields = 0;
   this->HaveInformation = 0;
   this->DownConvertVolumeFraction = 1;
+  this->ConcurrentDecoding = 1;
   this->DataTypeChanged = 0;
   this->GeomTimeStep = -1; // Indicate that geometry will have to be loaded
   this->NeedToCheck = 1; // Indicates non-geometric data needs to be checked
@@ -391,6 +510,10 @@ int vtkSpyPlotUniReader::MakeCurrent()
     // << " [" << var->Name << "]" );
     //vtkDebugMacro( "    Jump to: " << dp->SavedVariableOffsets[fieldCnt] );
     spis.Seek(dp->SavedVariableOffsets[fieldCnt]);
+    vtkSpyPlotPlanesDecoder decoder(this->ConcurrentDecoding != 0);
+    // The new arrays are only kept once all their planes are decoded, so
+    // that an error does not leave partly decoded arrays behind.
+    std::vector<std::pair<int, vtkDataArray*> > newArrays;
     int numBytes;
     int block;
     int actualBlockId = 0;
@@ -422,6 +545,8 @@ int vtkSpyPlotUniReader::MakeCurrent()
           dataArray->SetName(var->Name);
           //vtkDebugMacro( "*** Create data array: " 
           // << dataArray->GetNumberOfTuples() );
+          newArrays.push_back(std::make_pair(actualBlockId, dataArray));
+          actualBlockId++;
           }
         int zax;
         int bdims[3];
@@ -432,48 +557,48 @@ int vtkSpyPlotUniReader::MakeCurrent()
           if ( !spis.ReadInt32s(&numBytes, 1) )
             {
             vtkErrorMacro( "Problem reading the number of bytes" );
+            vtkSpyPlotUniReaderDeleteArrays(newArrays);
             return 0;
             }
-          if ( static_cast<int>(arrayBuffer.size()) < numBytes )
+          if ( !dataArray )
             {
-            arrayBuffer.resize(numBytes);
+            // Skip the planes of the blocks that are already loaded.
+            spis.Seek(numBytes, true);
+            continue;
             }
-          if ( !spis.ReadString(&*arrayBuffer.begin(), numBytes) )
+          if ( !decoder.ReadPlane(&spis, numBytes,
+                 floatArray? floatArray->GetPointer(zax * planeSize) : NULL,
+                 unsignedCharArray?
+                 unsignedCharArray->GetPointer(zax * planeSize) : NULL,
+                 planeSize) )
             {
             vtkErrorMacro( "Problem reading the bytes" );
+            vtkSpyPlotUniReaderDeleteArrays(newArrays);
             return 0;
             }
-          if ( floatArray )
-            {
-            float* ptr = floatArray->GetPointer(zax * planeSize);
-            if ( !this->RunLengthDataDecode(&*arrayBuffer.begin(), 
-                                            numBytes, ptr, planeSize) )
-              {
-              vtkErrorMacro( "Problem RLD decoding float data array" );
-              return 0;
-              }
-            }
-          if ( unsignedCharArray )
-            {
-            unsigned char* ptr = unsignedCharArray->GetPointer(zax * planeSize);
-            if ( !this->RunLengthDataDecode(&*arrayBuffer.begin(), numBytes,
-                                            ptr, planeSize) )
-              {
-              vtkErrorMacro( "Problem RLD decoding unsigned char data array" );
-              return 0;
-              }
-            }
           }
-        if ( dataArray )
+        if ( decoder.GetBufferSize() >= VTK_SPY_PLOT_DECODE_BUFFER_SIZE &&
+             !decoder.Decode() )
           {
-          var->DataBlocks[actualBlockId] = dataArray;
-          var->GhostCellsFixed[actualBlockId] = 0;
-          vtkDebugMacro( " " << dataArray << " initialized: " 
-                         << dataArray->GetName() );
-          actualBlockId++;
+          vtkErrorMacro( "Problem RLD decoding data array: " << var->Name );
+          vtkSpyPlotUniReaderDeleteArrays(newArrays);
+          return 0;
           }
         }
       }
+    if ( !decoder.Decode() )
+      {
+      vtkErrorMacro( "Problem RLD decoding data array: " << var->Name );
+      vtkSpyPlotUniReaderDeleteArrays(newArrays);
+      return 0;
+      }
+    for ( size_t cc = 0; cc < newArrays.size(); ++cc )
+      {
+      var->DataBlocks[newArrays[cc].first] = newArrays[cc].second;
+      var->GhostCellsFixed[newArrays[cc].first] = 0;
+      vtkDebugMacro( " " << newArrays[cc].second << " initialized: " 
+                     << newArrays[cc].second->GetName() );
+      }
     }
 
   if (blocksUpdated && needMarkers)
@@ -688,11 +813,12 @@ void vtkSpyPlotUniReader::PrintInformation()
 
 
 //-----------------------------------------------------------------------------
+// self is used to report errors, it may be NULL when decoding in a thread.
 template<class t>
 int vtkSpyPlotUniReaderRunLengthDataDecode(vtkSpyPlotUniReader* self, 
                                            const unsigned char* in, 
                                            int inSize, t* out, 
-                                           int outSize, t scale=1)
+                                           int outSize, t scale)
 {
   int outIndex = 0, inIndex = 0;
 
@@ -716,9 +842,12 @@ int vtkSpyPlotUniReaderRunLengthDataDecode(vtkSpyPlotUniReader* self,
         {
         if ( outIndex >= outSize )
           {
-          vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
-                                  << "Too much data generated. Excpected: " 
-                                  << outSize );
+          if ( self )
+            {
+            vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
+                                    << "Too much data generated. Excpected: " 
+                                    << outSize );
+            }
           return 0;
           }
         out[outIndex] = static_cast<t>(val*scale);
@@ -733,9 +862,12 @@ int vtkSpyPlotUniReaderRunLengthDataDecode(vtkSpyPlotUniReader* self,
         {
         if ( outIndex >= outSize )
           {
-          vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
-                                  << "Too much data generated. Excpected: " 
-                                  << outSize );
+          if ( self )
+            {
+            vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
+                                    << "Too much data generated. Excpected: " 
+                                    << outSize );
+            }
           return 0;
           }
         float val;
@@ -1394,6 +1526,7 @@ void vtkSpyPlotUniReader::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "DataTypeChanged: " << this->DataTypeChanged << endl;
   os << indent << "NumberOfCellFields: " << this->NumberOfCellFields << endl;
   os << indent << "NeedToCheck: " << this->NeedToCheck << endl;
+  os << indent << "ConcurrentDecoding: " << this->ConcurrentDecoding << endl;
 }
 
 
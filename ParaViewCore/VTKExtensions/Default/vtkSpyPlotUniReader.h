@@ -208,6 +208,13 @@ public:
   vtkSetMacro(DataTypeChanged, int);
   void SetDownConvertVolumeFraction(int vf);
 
+  // Description:
+  // When on (the default), the planes of the cell variables are decoded
+  // concurrently with vtkSMPTools, otherwise one after the other.
+  vtkSetMacro(ConcurrentDecoding, int);
+  vtkGetMacro(ConcurrentDecoding, int);
+  vtkBooleanMacro(ConcurrentDecoding, int);
+
 protected:
   vtkSpyPlotUniReader();
   ~vtkSpyPlotUniReader();
@@ -287,6 +294,7 @@ private:
 
   int DataTypeChanged;
   int DownConvertVolumeFraction;
+  int ConcurrentDecoding;
 
   int NumberOfCellFields;
   
@@ -28,6 +28,7 @@
 #include "vtkOpenGLError.h"
 #include "vtkOpenGLRenderWindow.h"
 #include "vtkPKdTree.h"
+#include "vtkPVTraceEventRecorder.h"
 #include "vtkPixelBufferObject.h"
 #include "vtkRenderState.h"
 #include "vtkRenderWindow.h"
@@ -464,6 +465,7 @@ void vtkIceTCompositePass::Render(const vtkRenderState* render_state)
 
   this->IceTContext->MakeCurrent();
   this->SetupContext(render_state);
+  double traceStart = vtkPVTraceEventRecorder::GetTime();
 
 #ifdef VTKGL2
   icetDrawCallback(IceTDrawCallback);
@@ -500,6 +502,10 @@ void vtkIceTCompositePass::Render(const vtkRenderState* render_state)
   // isolate vtk from IceT OpenGL errors
   vtkOpenGLClearErrorMacro();
 
+  // The frame includes the local rendering done by the draw callback.
+  vtkPVTraceEventRecorder::AddEvent("compositing", "IceT draw frame",
+    traceStart, vtkPVTraceEventRecorder::GetTime());
+
   if (render_state->GetRenderer()->GetRenderWindow()->GetStereoRender() == 1)
     {
     //if we are doing a stereo render we need to know
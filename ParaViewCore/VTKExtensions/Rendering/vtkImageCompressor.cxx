@@ -17,10 +17,54 @@
 
 #include "vtkUnsignedCharArray.h"
 #include "vtkCommand.h"
+#include "vtkLZ4ImageCompressor.h"
 #include "vtkMultiProcessStream.h"
+#include "vtkSimpleCriticalSection.h"
+#include "vtkSquirtCompressor.h"
+#include "vtkZlibImageCompressor.h"
+#include <iterator>
+#include <map>
 #include <string>
 #include <sstream>
 
+namespace
+{
+  vtkImageCompressor* NewSquirtCompressor()
+    {
+    return vtkSquirtCompressor::New();
+    }
+  vtkImageCompressor* NewZlibImageCompressor()
+    {
+    return vtkZlibImageCompressor::New();
+    }
+  vtkImageCompressor* NewLZ4ImageCompressor()
+    {
+    return vtkLZ4ImageCompressor::New();
+    }
+
+  typedef std::map<std::string, vtkImageCompressor::NewCompressorFunction>
+    RegistryType;
+
+  // Guards the registry since compressors are created by the rendering
+  // threads while plugins may register theirs.
+  vtkSimpleCriticalSection RegistryLock;
+
+  // Registry of compressors known by name, populated with the compressors
+  // distributed with ParaView on first use. Must be called with the lock
+  // held.
+  RegistryType& GetRegistry()
+    {
+    static RegistryType registry;
+    if (registry.empty())
+      {
+      registry["vtkSquirtCompressor"] = NewSquirtCompressor;
+      registry["vtkZlibImageCompressor"] = NewZlibImageCompressor;
+      registry["vtkLZ4ImageCompressor"] = NewLZ4ImageCompressor;
+      }
+    return registry;
+    }
+}
+
 
 //-----------------------------------------------------------------------------
 vtkCxxSetObjectMacro(vtkImageCompressor, Output, vtkUnsignedCharArray);
@@ -104,6 +148,73 @@ const char *vtkImageCompressor::RestoreConfiguration(const char *stream)
   return 0;
 }
 
+//-----------------------------------------------------------------------------
+vtkImageCompressor* vtkImageCompressor::NewCompressor(const char* className)
+{
+  if (!className)
+    {
+    return NULL;
+    }
+  vtkImageCompressor::NewCompressorFunction function = NULL;
+  RegistryLock.Lock();
+  RegistryType& registry = GetRegistry();
+  RegistryType::iterator iter = registry.find(className);
+  if (iter != registry.end())
+    {
+    function = iter->second;
+    }
+  RegistryLock.Unlock();
+  return function? (*function)() : NULL;
+}
+
+//-----------------------------------------------------------------------------
+int vtkImageCompressor::GetNumberOfRegisteredCompressors()
+{
+  RegistryLock.Lock();
+  int count = static_cast<int>(GetRegistry().size());
+  RegistryLock.Unlock();
+  return count;
+}
+
+//-----------------------------------------------------------------------------
+const char* vtkImageCompressor::GetRegisteredCompressorName(int index)
+{
+  const char* name = NULL;
+  RegistryLock.Lock();
+  RegistryType& registry = GetRegistry();
+  if (index >= 0 && index < static_cast<int>(registry.size()))
+    {
+    RegistryType::iterator iter = registry.begin();
+    std::advance(iter, index);
+    name = iter->first.c_str();
+    }
+  RegistryLock.Unlock();
+  return name;
+}
+
+//-----------------------------------------------------------------------------
+void vtkImageCompressor::RegisterCompressor(const char* className,
+  NewCompressorFunction function)
+{
+  if (className && function)
+    {
+    RegistryLock.Lock();
+    GetRegistry()[className] = function;
+    RegistryLock.Unlock();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkImageCompressor::UnRegisterCompressor(const char* className)
+{
+  if (className)
+    {
+    RegistryLock.Lock();
+    GetRegistry().erase(className);
+    RegistryLock.Unlock();
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkImageCompressor::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -87,6 +87,34 @@ public:
   // an error.
   virtual const char *RestoreConfiguration(const char *stream);
 
+  // Description:
+  // Create a new compressor from the class name used in its configuration
+  // stream. Returns NULL if no compressor is registered under that name.
+  // The caller is responsible for deleting the returned compressor.
+  static vtkImageCompressor* NewCompressor(const char* className);
+
+  // Description:
+  // Access the names of all registered compressors. A name stays valid until
+  // its compressor is unregistered.
+  static int GetNumberOfRegisteredCompressors();
+  static const char* GetRegisteredCompressorName(int index);
+
+  //BTX
+  // Description:
+  // Function used to instantiate a registered compressor.
+  typedef vtkImageCompressor* (*NewCompressorFunction)();
+
+  // Description:
+  // Register a compressor under the given class name so that it can be
+  // created by NewCompressor, and hence selected through the configuration
+  // stream. vtkSquirtCompressor, vtkZlibImageCompressor and
+  // vtkLZ4ImageCompressor are always registered. The registry is thread
+  // safe, so plugins may register compressors while images are compressed.
+  static void RegisterCompressor(const char* className,
+    NewCompressorFunction function);
+  static void UnRegisterCompressor(const char* className);
+  //ETX
+
 protected:
   // Description:
   // Construct with NULL input array and empty but allocated output array.
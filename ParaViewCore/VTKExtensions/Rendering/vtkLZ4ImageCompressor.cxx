@@ -0,0 +1,329 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkLZ4ImageCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLZ4ImageCompressor.h"
+
+#include "vtkLZ4Codec.h"
+#include "vtkMultiProcessStream.h"
+#include "vtkObjectFactory.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string.h>
+#include <vector>
+
+vtkStandardNewMacro(vtkLZ4ImageCompressor);
+
+namespace
+{
+  // Number of pixels in a delta tile.
+  const size_t TILE_PIXELS = 4096;
+
+  enum FrameType
+    {
+    KEY_FRAME = 0,
+    DELTA_FRAME = 1
+    };
+
+  // Header: components, frame type, payload size. Delta frames add the tile
+  // size, the number of tiles and a bit per tile telling if it is present.
+  const size_t HEADER_SIZE = 6;
+  const size_t DELTA_HEADER_SIZE = 8;
+
+  // Sizes are stored little-endian so that client and server may differ.
+  inline void WriteUInt32(unsigned char* ptr, size_t value)
+    {
+    ptr[0] = static_cast<unsigned char>(value & 0xff);
+    ptr[1] = static_cast<unsigned char>((value >> 8) & 0xff);
+    ptr[2] = static_cast<unsigned char>((value >> 16) & 0xff);
+    ptr[3] = static_cast<unsigned char>((value >> 24) & 0xff);
+    }
+
+  inline size_t ReadUInt32(const unsigned char* ptr)
+    {
+    return static_cast<size_t>(ptr[0]) |
+      (static_cast<size_t>(ptr[1]) << 8) |
+      (static_cast<size_t>(ptr[2]) << 16) |
+      (static_cast<size_t>(ptr[3]) << 24);
+    }
+}
+
+//-----------------------------------------------------------------------------
+vtkLZ4ImageCompressor::vtkLZ4ImageCompressor()
+    :
+  DeltaMode(0)
+{
+  this->LossLessMode = 1;
+  this->PreviousImage = vtkUnsignedCharArray::New();
+}
+
+//-----------------------------------------------------------------------------
+vtkLZ4ImageCompressor::~vtkLZ4ImageCompressor()
+{
+  this->PreviousImage->Delete();
+}
+
+//-----------------------------------------------------------------------------
+void vtkLZ4ImageCompressor::SetDeltaMode(int mode)
+{
+  if (this->DeltaMode != mode)
+    {
+    this->DeltaMode = mode;
+    this->PreviousImage->Initialize();
+    this->Modified();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkLZ4ImageCompressor::KeepPreviousImage(vtkUnsignedCharArray* image)
+{
+  if (image == this->PreviousImage)
+    {
+    return;
+    }
+  this->PreviousImage->SetNumberOfComponents(image->GetNumberOfComponents());
+  this->PreviousImage->SetNumberOfTuples(image->GetNumberOfTuples());
+  memcpy(this->PreviousImage->GetPointer(0), image->GetPointer(0),
+    image->GetNumberOfTuples() * image->GetNumberOfComponents());
+}
+
+//-----------------------------------------------------------------------------
+int vtkLZ4ImageCompressor::Compress()
+{
+  if (!(this->Input && this->Output))
+    {
+    vtkWarningMacro("Cannot compress empty input or output detected.");
+    return VTK_ERROR;
+    }
+
+  vtkUnsignedCharArray* input = this->Input;
+  const int numComps = input->GetNumberOfComponents();
+  const size_t inSize =
+    static_cast<size_t>(input->GetNumberOfTuples()) * numComps;
+  const unsigned char* in = input->GetPointer(0);
+
+  const bool delta = this->DeltaMode &&
+    this->PreviousImage->GetNumberOfComponents() == numComps &&
+    static_cast<size_t>(this->PreviousImage->GetNumberOfTuples()) * numComps
+      == inSize;
+
+  // In delta mode gather the tiles that changed since the previous image.
+  const size_t tileSize = TILE_PIXELS * numComps;
+  const size_t numTiles = delta? (inSize + tileSize - 1) / tileSize : 0;
+  std::vector<unsigned char> tileMask((numTiles + 7) / 8, 0);
+  std::vector<unsigned char> changedTiles;
+  const unsigned char* payload = in;
+  size_t payloadSize = inSize;
+  if (delta)
+    {
+    const unsigned char* previous = this->PreviousImage->GetPointer(0);
+    for (size_t tile = 0; tile < numTiles; ++tile)
+      {
+      size_t begin = tile * tileSize;
+      size_t size = std::min(tileSize, inSize - begin);
+      if (memcmp(in + begin, previous + begin, size) != 0)
+        {
+        tileMask[tile / 8] |= static_cast<unsigned char>(1 << (tile % 8));
+        changedTiles.insert(changedTiles.end(), in + begin, in + begin + size);
+        }
+      }
+    payload = changedTiles.empty()? NULL : &changedTiles[0];
+    payloadSize = changedTiles.size();
+    }
+
+  size_t headerSize = HEADER_SIZE +
+    (delta? DELTA_HEADER_SIZE + tileMask.size() : 0);
+  size_t capacity = vtkLZ4Codec::GetMaximumCompressedSize(payloadSize);
+  this->Output->SetNumberOfComponents(1);
+  unsigned char* out = this->Output->WritePointer(0,
+    static_cast<vtkIdType>(headerSize + capacity));
+
+  out[0] = static_cast<unsigned char>(numComps);
+  out[1] = static_cast<unsigned char>(delta? DELTA_FRAME : KEY_FRAME);
+  WriteUInt32(out + 2, payloadSize);
+  if (delta)
+    {
+    WriteUInt32(out + HEADER_SIZE, tileSize);
+    WriteUInt32(out + HEADER_SIZE + 4, numTiles);
+    if (!tileMask.empty())
+      {
+      memcpy(out + HEADER_SIZE + DELTA_HEADER_SIZE, &tileMask[0],
+        tileMask.size());
+      }
+    }
+
+  size_t compressedSize = vtkLZ4Codec::Compress(payload, payloadSize,
+    out + headerSize, capacity);
+  this->Output->SetNumberOfTuples(
+    static_cast<vtkIdType>(headerSize + compressedSize));
+
+  if (this->DeltaMode)
+    {
+    this->KeepPreviousImage(input);
+    }
+  return VTK_OK;
+}
+
+//-----------------------------------------------------------------------------
+int vtkLZ4ImageCompressor::Decompress()
+{
+  if (!(this->Input && this->Output))
+    {
+    vtkWarningMacro("Cannot decompress empty input or output detected.");
+    return VTK_ERROR;
+    }
+
+  const unsigned char* in = this->Input->GetPointer(0);
+  const size_t inSize = static_cast<size_t>(this->Input->GetNumberOfTuples());
+  vtkUnsignedCharArray* output = this->Output;
+  const int numComps = output->GetNumberOfComponents();
+  const size_t outSize =
+    static_cast<size_t>(output->GetNumberOfTuples()) * numComps;
+  unsigned char* out = output->GetPointer(0);
+
+  if (inSize < HEADER_SIZE || in[0] != numComps)
+    {
+    vtkErrorMacro("Compressed image does not match the output image.");
+    return VTK_ERROR;
+    }
+  const size_t payloadSize = ReadUInt32(in + 2);
+
+  if (in[1] == KEY_FRAME)
+    {
+    if (payloadSize != outSize ||
+      vtkLZ4Codec::Decompress(in + HEADER_SIZE, inSize - HEADER_SIZE,
+        out, outSize) != outSize)
+      {
+      vtkErrorMacro("Corrupted LZ4 image.");
+      return VTK_ERROR;
+      }
+    }
+  else
+    {
+    if (inSize < HEADER_SIZE + DELTA_HEADER_SIZE ||
+      this->PreviousImage->GetNumberOfComponents() != numComps ||
+      static_cast<size_t>(this->PreviousImage->GetNumberOfTuples()) *
+        numComps != outSize)
+      {
+      vtkErrorMacro("Received a delta image without a matching previous image.");
+      return VTK_ERROR;
+      }
+    const size_t tileSize = ReadUInt32(in + HEADER_SIZE);
+    const size_t numTiles = ReadUInt32(in + HEADER_SIZE + 4);
+    const unsigned char* tileMask = in + HEADER_SIZE + DELTA_HEADER_SIZE;
+    const size_t headerSize =
+      HEADER_SIZE + DELTA_HEADER_SIZE + (numTiles + 7) / 8;
+    if (tileSize == 0 || numTiles != (outSize + tileSize - 1) / tileSize ||
+      inSize < headerSize)
+      {
+      vtkErrorMacro("Corrupted LZ4 delta image.");
+      return VTK_ERROR;
+      }
+
+    std::vector<unsigned char> changedTiles(payloadSize);
+    if (payloadSize > 0 &&
+      vtkLZ4Codec::Decompress(in + headerSize, inSize - headerSize,
+        &changedTiles[0], payloadSize) != payloadSize)
+      {
+      vtkErrorMacro("Corrupted LZ4 delta image.");
+      return VTK_ERROR;
+      }
+
+    // Start from the previous image and replace the tiles that changed.
+    memcpy(out, this->PreviousImage->GetPointer(0), outSize);
+    size_t offset = 0;
+    for (size_t tile = 0; tile < numTiles; ++tile)
+      {
+      if (tileMask[tile / 8] & (1 << (tile % 8)))
+        {
+        size_t begin = tile * tileSize;
+        size_t size = std::min(tileSize, outSize - begin);
+        if (offset + size > payloadSize)
+          {
+          vtkErrorMacro("Corrupted LZ4 delta image.");
+          return VTK_ERROR;
+          }
+        memcpy(out + begin, &changedTiles[offset], size);
+        offset += size;
+        }
+      }
+    }
+
+  if (this->DeltaMode)
+    {
+    this->KeepPreviousImage(output);
+    }
+  return VTK_OK;
+}
+
+//-----------------------------------------------------------------------------
+void vtkLZ4ImageCompressor::SaveConfiguration(vtkMultiProcessStream *stream)
+{
+  vtkImageCompressor::SaveConfiguration(stream);
+  *stream
+    << this->DeltaMode;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkLZ4ImageCompressor::RestoreConfiguration(vtkMultiProcessStream *stream)
+{
+  if (vtkImageCompressor::RestoreConfiguration(stream))
+    {
+    int deltaMode;
+    *stream
+      >> deltaMode;
+    this->SetDeltaMode(deltaMode);
+    this->PreviousImage->Initialize();
+    return true;
+    }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+const char *vtkLZ4ImageCompressor::SaveConfiguration()
+{
+  std::ostringstream oss;
+  oss
+    << vtkImageCompressor::SaveConfiguration()
+    << " "
+    << this->DeltaMode;
+
+  this->SetConfiguration(oss.str().c_str());
+
+  return this->Configuration;
+}
+
+//-----------------------------------------------------------------------------
+const char *vtkLZ4ImageCompressor::RestoreConfiguration(const char *stream)
+{
+  stream=vtkImageCompressor::RestoreConfiguration(stream);
+  if (stream)
+    {
+    std::istringstream iss(stream);
+    int deltaMode = 0;
+    iss >> deltaMode;
+    this->SetDeltaMode(deltaMode);
+    this->PreviousImage->Initialize();
+    return stream+iss.tellg();
+    }
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkLZ4ImageCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "DeltaMode: " << this->DeltaMode << endl;
+}
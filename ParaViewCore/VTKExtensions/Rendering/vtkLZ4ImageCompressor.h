@@ -0,0 +1,88 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkLZ4ImageCompressor.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkLZ4ImageCompressor - Image compressor/decompressor using LZ4.
+// .SECTION Description
+// This class compresses image data using the LZ4 block format (see
+// vtkLZ4Codec). LZ4 is loss-less and considerably faster than zlib, at the
+// cost of a lower compression ratio, which makes it a good fit for high
+// resolution remote rendering over fast networks.
+//
+// When DeltaMode is enabled, the image is split into tiles of consecutive
+// pixels and only the tiles that differ from the previously compressed image
+// are sent. Both the compressing and the decompressing side keep a copy of
+// the last image, hence DeltaMode must be enabled on both sides and every
+// compressed image must be decompressed in order. A complete image is sent
+// whenever the image size changes.
+//
+// The configuration stream format is:
+// [vtkLZ4ImageCompressor, LossLessMode, DeltaMode].
+
+#ifndef __vtkLZ4ImageCompressor_h
+#define __vtkLZ4ImageCompressor_h
+
+#include "vtkImageCompressor.h"
+#include "vtkPVVTKExtensionsRenderingModule.h" // needed for export macro
+
+class vtkMultiProcessStream;
+class vtkUnsignedCharArray;
+
+class VTKPVVTKEXTENSIONSRENDERING_EXPORT vtkLZ4ImageCompressor : public vtkImageCompressor
+{
+public:
+  static vtkLZ4ImageCompressor* New();
+  vtkTypeMacro(vtkLZ4ImageCompressor, vtkImageCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // When set, only the tiles that changed since the previous image are
+  // compressed and sent. Changing this resets the previous image.
+  void SetDeltaMode(int mode);
+  vtkGetMacro(DeltaMode, int);
+  vtkBooleanMacro(DeltaMode, int);
+
+  // Description:
+  // Compress/Decompress data array on the objects input with results
+  // in the objects output. See also Set/GetInput/Output.
+  virtual int Compress();
+  virtual int Decompress();
+
+  //BTX
+  // Description:
+  // Serialize/Restore compressor configuration (but not the data) into the stream.
+  virtual void SaveConfiguration(vtkMultiProcessStream *stream);
+  virtual bool RestoreConfiguration(vtkMultiProcessStream *stream);
+  //ETX
+  virtual const char *SaveConfiguration();
+  virtual const char *RestoreConfiguration(const char *stream);
+
+protected:
+  vtkLZ4ImageCompressor();
+  virtual ~vtkLZ4ImageCompressor();
+
+  // Description:
+  // Remember the given image as the reference for the next delta.
+  void KeepPreviousImage(vtkUnsignedCharArray* image);
+
+  int DeltaMode;
+
+  // Last image compressed or decompressed, used in DeltaMode.
+  vtkUnsignedCharArray* PreviousImage;
+
+private:
+  vtkLZ4ImageCompressor(const vtkLZ4ImageCompressor&); // Not implemented.
+  void operator=(const vtkLZ4ImageCompressor&); // Not implemented.
+};
+
+#endif
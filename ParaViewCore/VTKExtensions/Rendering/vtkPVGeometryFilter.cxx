@@ -26,8 +26,10 @@
 #include "vtkCommand.h"
 #include "vtkCompositeDataPipeline.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkDataArray.h"
 #include "vtkDataObjectTreeIterator.h"
 #include "vtkDataSetSurfaceFilter.h"
+#include "vtkFieldData.h"
 #include "vtkFloatArray.h"
 #include "vtkGarbageCollector.h"
 #include "vtkGenericDataSet.h"
@@ -39,6 +41,7 @@
 #include "vtkHyperOctreeSurfaceFilter.h"
 #include "vtkHyperTreeGrid.h"
 #include "vtkHyperTreeGridGeometry.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationIntegerVectorKey.h"
@@ -51,6 +54,8 @@
 #include "vtkObjectFactory.h"
 #include "vtkOutlineSource.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
 #include "vtkPVRecoverGeometryWireframe.h"
@@ -58,6 +63,9 @@
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearGridOutlineFilter.h"
 #include "vtkSelectionNode.h"
+#include "vtkSimpleCriticalSection.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStripper.h"
@@ -78,6 +86,7 @@
 #include <math.h>
 #include <set>
 #include <algorithm>
+#include <string.h>
 
 
 vtkStandardNewMacro(vtkPVGeometryFilter);
@@ -141,6 +150,446 @@ public:
     }
 };
 
+// Surfaces of vtkUnstructuredGrid previously extracted, keyed on a hash of
+// their topology: the connectivity, the cell types, the faces of the
+// polyhedra and the ghost cells. For each surface, the cells are kept along
+// with the input point and cell each output point and cell comes from. When
+// the topology of an input did not change, e.g. when only the points or the
+// attributes of a static mesh change over time, the surface is produced by
+// gathering the points and attributes through these maps instead of
+// extracting it again.
+class vtkPVGeometryFilter::vtkSurfaceCache
+{
+public:
+  typedef vtkTypeUInt64 vtkHashType;
+
+  struct vtkEntry
+    {
+    vtkIdType NumberOfPoints;
+    vtkIdType NumberOfCells;
+    vtkSmartPointer<vtkCellArray> Verts;
+    vtkSmartPointer<vtkCellArray> Lines;
+    vtkSmartPointer<vtkCellArray> Polys;
+    vtkSmartPointer<vtkCellArray> Strips;
+    vtkSmartPointer<vtkIdTypeArray> OriginalPointIds;
+    vtkSmartPointer<vtkIdTypeArray> OriginalCellIds;
+    int LastExecution;
+    };
+
+  // Hash of a topology already seen, to avoid hashing arrays that did not
+  // change. The arrays are held so that their addresses are not reused.
+  struct vtkKnownHash
+    {
+    vtkSmartPointer<vtkCellArray> Cells;
+    vtkSmartPointer<vtkUnsignedCharArray> Types;
+    vtkSmartPointer<vtkUnsignedCharArray> Ghosts;
+    vtkSmartPointer<vtkIdTypeArray> Faces;
+    vtkSmartPointer<vtkIdTypeArray> FaceLocations;
+    unsigned long MTime;
+    vtkHashType Hash;
+    };
+
+  std::map<vtkHashType, vtkEntry> Entries;
+  std::map<vtkCellArray*, vtkKnownHash> KnownHashes;
+  int Execution;
+
+  vtkSurfaceCache() : Execution(0) { }
+
+  // Called before each execution of the filter: drops the surfaces that were
+  // not used by the previous one.
+  void Prune()
+    {
+    std::map<vtkHashType, vtkEntry>::iterator iter = this->Entries.begin();
+    while (iter != this->Entries.end())
+      {
+      if (iter->second.LastExecution < this->Execution)
+        {
+        this->Entries.erase(iter++);
+        }
+      else
+        {
+        ++iter;
+        }
+      }
+    std::map<vtkCellArray*, vtkKnownHash>::iterator known =
+      this->KnownHashes.begin();
+    while (known != this->KnownHashes.end())
+      {
+      if (this->Entries.find(known->second.Hash) == this->Entries.end())
+        {
+        this->KnownHashes.erase(known++);
+        }
+      else
+        {
+        ++known;
+        }
+      }
+    this->Execution++;
+    }
+
+  vtkHashType ComputeKey(vtkUnstructuredGrid* input)
+    {
+    vtkCellArray* cells = input->GetCells();
+    vtkUnsignedCharArray* types = input->GetCellTypesArray();
+    vtkUnsignedCharArray* ghosts = input->GetCellGhostArray();
+    vtkIdTypeArray* faces = input->GetFaces();
+    vtkIdTypeArray* faceLocations = input->GetFaceLocations();
+    unsigned long mtime = cells->GetMTime();
+    mtime = std::max(mtime, types? types->GetMTime() : 0);
+    mtime = std::max(mtime, ghosts? ghosts->GetMTime() : 0);
+    mtime = std::max(mtime, faces? faces->GetMTime() : 0);
+    mtime = std::max(mtime, faceLocations? faceLocations->GetMTime() : 0);
+
+    std::map<vtkCellArray*, vtkKnownHash>::iterator known =
+      this->KnownHashes.find(cells);
+    if (known != this->KnownHashes.end() && known->second.MTime == mtime &&
+      known->second.Types == types && known->second.Ghosts == ghosts &&
+      known->second.Faces == faces &&
+      known->second.FaceLocations == faceLocations)
+      {
+      return known->second.Hash;
+      }
+
+    vtkIdType counts[2] =
+      { input->GetNumberOfPoints(), input->GetNumberOfCells() };
+    vtkHashType hash = vtkSurfaceCache::Hash(counts, sizeof(counts),
+      vtkSurfaceCache::OffsetBasis());
+    hash = vtkSurfaceCache::Hash(cells->GetPointer(),
+      cells->GetNumberOfConnectivityEntries() * sizeof(vtkIdType), hash);
+    if (types)
+      {
+      hash = vtkSurfaceCache::Hash(types->GetPointer(0),
+        types->GetNumberOfTuples(), hash);
+      }
+    if (ghosts)
+      {
+      hash = vtkSurfaceCache::Hash(ghosts->GetPointer(0),
+        ghosts->GetNumberOfTuples(), hash);
+      }
+    // Polyhedra list their points in the connectivity and their faces in
+    // separate arrays.
+    if (faces && faceLocations)
+      {
+      hash = vtkSurfaceCache::Hash(faces->GetPointer(0),
+        faces->GetNumberOfTuples() * sizeof(vtkIdType), hash);
+      hash = vtkSurfaceCache::Hash(faceLocations->GetPointer(0),
+        faceLocations->GetNumberOfTuples() * sizeof(vtkIdType), hash);
+      }
+    vtkKnownHash& entry = this->KnownHashes[cells];
+    entry.Cells = cells;
+    entry.Types = types;
+    entry.Ghosts = ghosts;
+    entry.Faces = faces;
+    entry.FaceLocations = faceLocations;
+    entry.MTime = mtime;
+    entry.Hash = hash;
+    return hash;
+    }
+
+  // Produces the surface of \c input from a surface previously extracted
+  // from a dataset with the same topology. Returns false if there is none.
+  bool Extract(vtkHashType key, vtkUnstructuredGrid* input,
+    vtkPolyData* output, bool passCellIds, bool passPointIds)
+    {
+    std::map<vtkHashType, vtkEntry>::iterator iter = this->Entries.find(key);
+    if (iter == this->Entries.end() ||
+      iter->second.NumberOfPoints != input->GetNumberOfPoints() ||
+      iter->second.NumberOfCells != input->GetNumberOfCells())
+      {
+      return false;
+      }
+    vtkEntry& entry = iter->second;
+    entry.LastExecution = this->Execution;
+
+    vtkPoints* inPoints = input->GetPoints();
+    vtkPointData* inPD = input->GetPointData();
+    vtkCellData* inCD = input->GetCellData();
+    const vtkIdType* pointIds = entry.OriginalPointIds->GetPointer(0);
+    const vtkIdType* cellIds = entry.OriginalCellIds->GetPointer(0);
+    const vtkIdType numPoints = entry.OriginalPointIds->GetNumberOfTuples();
+    const vtkIdType numCells = entry.OriginalCellIds->GetNumberOfTuples();
+
+    vtkNew<vtkPoints> points;
+    points->SetDataType(inPoints->GetDataType());
+    points->SetNumberOfPoints(numPoints);
+    vtkDataArray* pointsData = points->GetData();
+    vtkDataArray* inPointsData = inPoints->GetData();
+    for (vtkIdType cc = 0; cc < numPoints; cc++)
+      {
+      pointsData->SetTuple(cc, pointIds[cc], inPointsData);
+      }
+    output->SetPoints(points.GetPointer());
+    output->SetVerts(entry.Verts);
+    output->SetLines(entry.Lines);
+    output->SetPolys(entry.Polys);
+    output->SetStrips(entry.Strips);
+
+    // Same attributes as vtkDataSetSurfaceFilter produces.
+    vtkPointData* outPD = output->GetPointData();
+    outPD->CopyGlobalIdsOn();
+    outPD->CopyAllocate(inPD, numPoints);
+    for (vtkIdType cc = 0; cc < numPoints; cc++)
+      {
+      outPD->CopyData(inPD, pointIds[cc], cc);
+      }
+    vtkCellData* outCD = output->GetCellData();
+    outCD->CopyGlobalIdsOn();
+    outCD->CopyAllocate(inCD, numCells);
+    for (vtkIdType cc = 0; cc < numCells; cc++)
+      {
+      outCD->CopyData(inCD, cellIds[cc], cc);
+      }
+    if (passPointIds)
+      {
+      outPD->AddArray(entry.OriginalPointIds);
+      }
+    if (passCellIds)
+      {
+      outCD->AddArray(entry.OriginalCellIds);
+      }
+    return true;
+    }
+
+  // Keeps the surface extracted from \c input. The surface must have the
+  // vtkOriginalPointIds and vtkOriginalCellIds arrays, which are removed
+  // unless requested.
+  void Add(vtkHashType key, vtkUnstructuredGrid* input, vtkPolyData* output,
+    bool passCellIds, bool passPointIds)
+    {
+    vtkIdTypeArray* pointIds = vtkIdTypeArray::SafeDownCast(
+      output->GetPointData()->GetArray("vtkOriginalPointIds"));
+    vtkIdTypeArray* cellIds = vtkIdTypeArray::SafeDownCast(
+      output->GetCellData()->GetArray("vtkOriginalCellIds"));
+    if (pointIds && cellIds &&
+      pointIds->GetNumberOfTuples() == output->GetNumberOfPoints() &&
+      cellIds->GetNumberOfTuples() == output->GetNumberOfCells() &&
+      vtkSurfaceCache::IsValidMap(pointIds, input->GetNumberOfPoints()) &&
+      vtkSurfaceCache::IsValidMap(cellIds, input->GetNumberOfCells()))
+      {
+      vtkEntry& entry = this->Entries[key];
+      entry.NumberOfPoints = input->GetNumberOfPoints();
+      entry.NumberOfCells = input->GetNumberOfCells();
+      entry.Verts = output->GetVerts();
+      entry.Lines = output->GetLines();
+      entry.Polys = output->GetPolys();
+      entry.Strips = output->GetStrips();
+      entry.OriginalPointIds = pointIds;
+      entry.OriginalCellIds = cellIds;
+      entry.LastExecution = this->Execution;
+      }
+    if (!passPointIds)
+      {
+      output->GetPointData()->RemoveArray("vtkOriginalPointIds");
+      }
+    if (!passCellIds)
+      {
+      output->GetCellData()->RemoveArray("vtkOriginalCellIds");
+      }
+    }
+
+private:
+  // Points or cells created by the extraction (e.g. when subdividing) have no
+  // original id, such surfaces cannot be gathered.
+  static bool IsValidMap(vtkIdTypeArray* ids, vtkIdType numIds)
+    {
+    const vtkIdType* ptr = ids->GetPointer(0);
+    const vtkIdType* end = ptr + ids->GetNumberOfTuples();
+    for (; ptr != end; ++ptr)
+      {
+      if (*ptr < 0 || *ptr >= numIds)
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  // 64-bit FNV-1a, applied to 64-bit words rather than bytes for speed.
+  static vtkHashType OffsetBasis()
+    {
+    return (static_cast<vtkHashType>(0xcbf29ce4) << 32) | 0x84222325;
+    }
+  static vtkHashType Hash(const void* data, size_t size, vtkHashType hash)
+    {
+    const vtkHashType prime =
+      (static_cast<vtkHashType>(0x00000100) << 32) | 0x000001b3;
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    const size_t numWords = size / sizeof(vtkHashType);
+    for (size_t cc = 0; cc < numWords; ++cc)
+      {
+      vtkHashType word;
+      memcpy(&word, bytes + cc * sizeof(vtkHashType), sizeof(vtkHashType));
+      hash = (hash ^ word) * prime;
+      }
+    for (size_t cc = numWords * sizeof(vtkHashType); cc < size; ++cc)
+      {
+      hash = (hash ^ bytes[cc]) * prime;
+      }
+    return hash;
+    }
+};
+
+namespace
+{
+  void vtkCollectArrays(vtkFieldData* fd, std::set<vtkDataArray*>& visited,
+    std::vector<vtkDataArray*>& arrays)
+    {
+    int num = fd? fd->GetNumberOfArrays() : 0;
+    for (int cc = 0; cc < num; ++cc)
+      {
+      vtkDataArray* array = fd->GetArray(cc);
+      if (array && visited.insert(array).second)
+        {
+        arrays.push_back(array);
+        }
+      }
+    }
+
+  // Computes, and thereby caches, the ranges of the arrays.
+  class vtkComputeArrayRanges
+    {
+  public:
+    vtkDataArray** Arrays;
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      double range[2];
+      for (vtkIdType cc = begin; cc < end; ++cc)
+        {
+        vtkDataArray* array = this->Arrays[cc];
+        int numComps = array->GetNumberOfComponents();
+        if (numComps > 1)
+          {
+          array->GetRange(range, -1);
+          }
+        for (int comp = 0; comp < numComps; ++comp)
+          {
+          array->GetRange(range, comp);
+          }
+        }
+      }
+    };
+
+  class vtkComputePointsBounds
+    {
+  public:
+    vtkPoints** Points;
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType cc = begin; cc < end; ++cc)
+        {
+        this->Points[cc]->GetBounds();
+        }
+      }
+    };
+
+  // Blocks may share their points and arrays, whose bounds and ranges are
+  // cached when first asked for. Compute them up front so that the blocks
+  // can then be extracted concurrently without racing to cache them.
+  void vtkComputeSharedBoundsAndRanges(
+    const std::vector<vtkDataObject*>& blocks)
+    {
+    std::set<vtkDataArray*> visitedArrays;
+    std::vector<vtkDataArray*> arrays;
+    std::set<vtkPoints*> visitedPoints;
+    std::vector<vtkPoints*> points;
+    for (size_t cc = 0; cc < blocks.size(); ++cc)
+      {
+      vtkDataSet* ds = vtkDataSet::SafeDownCast(blocks[cc]);
+      if (!ds)
+        {
+        continue;
+        }
+      vtkCollectArrays(ds->GetPointData(), visitedArrays, arrays);
+      vtkCollectArrays(ds->GetCellData(), visitedArrays, arrays);
+      vtkCollectArrays(ds->GetFieldData(), visitedArrays, arrays);
+      vtkPointSet* ps = vtkPointSet::SafeDownCast(ds);
+      if (ps && ps->GetPoints() &&
+        visitedPoints.insert(ps->GetPoints()).second)
+        {
+        points.push_back(ps->GetPoints());
+        if (visitedArrays.insert(ps->GetPoints()->GetData()).second)
+          {
+          arrays.push_back(ps->GetPoints()->GetData());
+          }
+        }
+      }
+    if (!arrays.empty())
+      {
+      vtkComputeArrayRanges functor;
+      functor.Arrays = &arrays[0];
+      vtkSMPTools::For(0, static_cast<vtkIdType>(arrays.size()), functor);
+      }
+    if (!points.empty())
+      {
+      vtkComputePointsBounds functor;
+      functor.Points = &points[0];
+      vtkSMPTools::For(0, static_cast<vtkIdType>(points.size()), functor);
+      }
+    }
+}
+
+// Extracts the surface of a range of blocks of a composite dataset. Each
+// thread uses its own vtkPVGeometryFilter, set up like the filter executing,
+// since the internal filters of a vtkPVGeometryFilter cannot be shared.
+class vtkPVGeometryFilter::vtkBlocksFunctor
+{
+public:
+  vtkPVGeometryFilter* Self;
+  const std::vector<vtkDataObject*>* Blocks;
+  const std::vector<int>* FirstOccurrences;
+  std::vector<vtkSmartPointer<vtkPolyData> >* Outputs;
+  std::vector<int>* OutlineFlags;
+  const int* WholeExtent;
+
+  vtkSMPThreadLocalObject<vtkPVGeometryFilter> Workers;
+  vtkSimpleCriticalSection Lock;
+
+  void Initialize()
+    {
+    // Reference counts are not atomic: the filters are created and
+    // registered with the controller one at a time.
+    this->Lock.Lock();
+    vtkPVGeometryFilter* self = this->Self;
+    vtkPVGeometryFilter* worker = this->Workers.Local();
+    worker->SetController(self->Controller);
+    worker->UseOutline = self->UseOutline;
+    worker->SetUseStrips(self->UseStrips);
+    worker->GenerateCellNormals = self->GenerateCellNormals;
+    worker->Triangulate = self->Triangulate;
+    worker->SetNonlinearSubdivisionLevel(self->NonlinearSubdivisionLevel);
+    worker->SetPassThroughCellIds(self->PassThroughCellIds);
+    worker->SetPassThroughPointIds(self->PassThroughPointIds);
+    worker->GenerateProcessIds = self->GenerateProcessIds;
+    // The workers only live for one execution.
+    worker->UseSurfaceCache = false;
+    this->Lock.Unlock();
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkPVGeometryFilter* worker = this->Workers.Local();
+    for (vtkIdType cc = begin; cc < end; ++cc)
+      {
+      // Blocks that appear several times are only extracted once.
+      if ((*this->FirstOccurrences)[cc] != cc)
+        {
+        continue;
+        }
+      vtkPolyData* output = (*this->Outputs)[cc];
+      // -1 tells that the block did not change the outline flag.
+      worker->OutlineFlag = -1;
+      worker->ExecuteBlock((*this->Blocks)[cc], output, 0, 0, 1, 0,
+        this->WholeExtent);
+      worker->CleanupOutputData(output, 0);
+      (*this->OutlineFlags)[cc] = worker->OutlineFlag;
+      }
+    }
+
+  void Reduce()
+    {
+    }
+};
+
 //----------------------------------------------------------------------------
 vtkPVGeometryFilter::vtkPVGeometryFilter ()
 {
@@ -185,6 +634,9 @@ vtkPVGeometryFilter::vtkPVGeometryFilter ()
 
   this->HideInternalAMRFaces = true;
   this->UseNonOverlappingAMRMetaDataForOutlines = true;
+  this->UseThreadedBlockExecution = false;
+  this->UseSurfaceCache = true;
+  this->SurfaceCache = new vtkSurfaceCache();
 }
 
 //----------------------------------------------------------------------------
@@ -219,6 +671,7 @@ vtkPVGeometryFilter::~vtkPVGeometryFilter ()
   this->OutlineSource->Delete();
   this->InternalProgressObserver->Delete();
   this->SetController(0);
+  delete this->SurfaceCache;
 }
 
 //----------------------------------------------------------------------------
@@ -520,6 +973,7 @@ int vtkPVGeometryFilter::RequestData(vtkInformation* request,
                                      vtkInformationVector* outputVector)
 {
   vtkDataObject* input = vtkDataObject::GetData(inputVector[0], 0);
+  this->SurfaceCache->Prune();
   if (vtkCompositeDataSet::SafeDownCast(input))
     {
     vtkTimerLog::MarkStartEvent("vtkPVGeometryFilter::RequestData");
@@ -910,20 +1364,75 @@ int vtkPVGeometryFilter::RequestCompositeData(vtkInformation*,
   vtkSmartPointer<vtkCompositeDataIterator> iter;
   iter.TakeReference(input->NewIterator());
 
-  unsigned int totNumBlocks=0;
+  // Extract the blocks first, then add them to the output in the order of the
+  // iterator, whether they are extracted one after the other or in parallel.
+  std::vector<vtkDataObject*> blocks;
   for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
     {
     // iter skips empty blocks automatically.
-    totNumBlocks++;
+    blocks.push_back(iter->GetCurrentDataObject());
+    }
+  const vtkIdType numBlocks = static_cast<vtkIdType>(blocks.size());
+  std::vector<vtkSmartPointer<vtkPolyData> > outputs(blocks.size());
+  for (size_t cc = 0; cc < outputs.size(); cc++)
+    {
+    outputs[cc] = vtkSmartPointer<vtkPolyData>::New();
     }
-
-  std::vector<unsigned char> non_null_leaves;
-  non_null_leaves.reserve(totNumBlocks); //just an estimate.
   int* wholeExtent = vtkStreamingDemandDrivenPipeline::GetWholeExtent(
     inputVector[0]->GetInformationObject(0));
-  int numInputs = 0;
+
+  if (this->UseThreadedBlockExecution && numBlocks > 1)
+    {
+    std::map<vtkDataObject*, int> indices;
+    std::vector<int> firstOccurrences(blocks.size());
+    for (size_t cc = 0; cc < blocks.size(); cc++)
+      {
+      firstOccurrences[cc] = indices.insert(
+        std::make_pair(blocks[cc], static_cast<int>(cc))).first->second;
+      }
+    std::vector<int> outlineFlags(blocks.size(), -1);
+    vtkComputeSharedBoundsAndRanges(blocks);
+
+    vtkBlocksFunctor functor;
+    functor.Self = this;
+    functor.Blocks = &blocks;
+    functor.FirstOccurrences = &firstOccurrences;
+    functor.Outputs = &outputs;
+    functor.OutlineFlags = &outlineFlags;
+    functor.WholeExtent = wholeExtent;
+    // Blocks vary in size, so they are handed out one at a time.
+    vtkSMPTools::For(0, numBlocks, 1, functor);
+
+    for (size_t cc = 0; cc < blocks.size(); cc++)
+      {
+      int first = firstOccurrences[cc];
+      if (first != static_cast<int>(cc))
+        {
+        outputs[cc]->ShallowCopy(outputs[first].GetPointer());
+        }
+      // Same outline flag as if the blocks were extracted in order.
+      if (outlineFlags[first] != -1)
+        {
+        this->OutlineFlag = outlineFlags[first];
+        }
+      }
+    this->UpdateProgress(1.0);
+    }
+  else
+    {
+    for (vtkIdType cc = 0; cc < numBlocks; cc++)
+      {
+      this->ExecuteBlock(blocks[cc], outputs[cc], 0, 0, 1, 0, wholeExtent);
+      this->CleanupOutputData(outputs[cc], 0);
+      this->UpdateProgress(static_cast<float>(cc + 1)/numBlocks);
+      }
+    }
+
+  std::vector<unsigned char> non_null_leaves;
+  non_null_leaves.reserve(blocks.size()); //just an estimate.
 
   unsigned int block_id = 0;
+  size_t next_output = 0;
   iter->SkipEmptyNodesOff(); // since we want to a get an accurtate block-id count to
                              // set vtkBlockColors correctly.
   for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem(), ++block_id)
@@ -934,9 +1443,7 @@ int vtkPVGeometryFilter::RequestCompositeData(vtkInformation*,
       continue;
       }
 
-    vtkPolyData* tmpOut = vtkPolyData::New();
-    this->ExecuteBlock(block, tmpOut, 0, 0, 1, 0, wholeExtent);
-    this->CleanupOutputData(tmpOut, 0);
+    vtkPolyData* tmpOut = outputs[next_output++];
     //skip empty nodes.
     if (tmpOut->GetNumberOfPoints() > 0)
       {
@@ -944,20 +1451,12 @@ int vtkPVGeometryFilter::RequestCompositeData(vtkInformation*,
       non_null_leaves.resize(current_flat_index+1);
       non_null_leaves[current_flat_index] = 1;
       output->SetDataSet(iter, tmpOut);
-      tmpOut->FastDelete();
 
       this->AddCompositeIndex(tmpOut, current_flat_index);
       this->AddBlockColors(tmpOut, block_id);
       }
-    else
-      {
-      tmpOut->Delete();
-      tmpOut = NULL;
-      }
-
-    numInputs++;
-    this->UpdateProgress(static_cast<float>(numInputs)/totNumBlocks);
     }
+  outputs.clear();
   vtkTimerLog::MarkEndEvent("vtkPVGeometryFilter::ExecuteCompositeDataSet");
 
   // Merge mutli-pieces to avoid efficiency setbacks when ordered
@@ -1408,6 +1907,24 @@ void vtkPVGeometryFilter::UnstructuredGridExecute(
         }
       }
 
+    // Surfaces of linear cells only are made of points and cells of the
+    // input, they can be gathered from a surface previously extracted from
+    // the same topology.
+    vtkUnstructuredGrid* grid = vtkUnstructuredGrid::SafeDownCast(input);
+    bool useCache = this->UseSurfaceCache && !handleSubdivision &&
+      !this->Triangulate && grid && grid->GetNumberOfCells() > 0 &&
+      grid->GetCells() && grid->GetPoints();
+    vtkSurfaceCache::vtkHashType cacheKey = 0;
+    if (useCache)
+      {
+      cacheKey = this->SurfaceCache->ComputeKey(grid);
+      if (this->SurfaceCache->Extract(cacheKey, grid, output,
+          this->PassThroughCellIds != 0, this->PassThroughPointIds != 0))
+        {
+        return;
+        }
+      }
+
     vtkSmartPointer<vtkIdTypeArray> facePtIds2OriginalPtIds;
 
     vtkSmartPointer<vtkUnstructuredGridBase> inputClone =
@@ -1476,6 +1993,22 @@ void vtkPVGeometryFilter::UnstructuredGridExecute(
         }
       }
 
+    if (useCache)
+      {
+      // The maps to the input points and cells are needed to reuse the
+      // surface.
+      this->DataSetSurfaceFilter->PassThroughCellIdsOn();
+      this->DataSetSurfaceFilter->PassThroughPointIdsOn();
+      this->DataSetSurfaceFilter->UnstructuredGridExecute(input, output);
+      this->DataSetSurfaceFilter->SetPassThroughCellIds(
+                                                      this->PassThroughCellIds);
+      this->DataSetSurfaceFilter->SetPassThroughPointIds(
+                                                     this->PassThroughPointIds);
+      this->SurfaceCache->Add(cacheKey, grid, output,
+        this->PassThroughCellIds != 0, this->PassThroughPointIds != 0);
+      return;
+      }
+
     if (input->GetNumberOfCells() > 0)
       {
       this->DataSetSurfaceFilter->UnstructuredGridExecute(input, output);
@@ -1771,6 +2304,10 @@ void vtkPVGeometryFilter::PrintSelf(ostream& os, vtkIndent indent)
      << (this->PassThroughCellIds ? "On\n" : "Off\n");
   os << indent << "PassThroughPointIds: "
      << (this->PassThroughPointIds ? "On\n" : "Off\n");
+  os << indent << "UseThreadedBlockExecution: "
+     << (this->UseThreadedBlockExecution ? "On\n" : "Off\n");
+  os << indent << "UseSurfaceCache: "
+     << (this->UseSurfaceCache ? "On\n" : "Off\n");
 }
 
 //----------------------------------------------------------------------------
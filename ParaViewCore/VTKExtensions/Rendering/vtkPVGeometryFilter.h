@@ -153,6 +153,29 @@ public:
   vtkGetMacro(UseNonOverlappingAMRMetaDataForOutlines, bool);
   vtkBooleanMacro(UseNonOverlappingAMRMetaDataForOutlines, bool);
 
+  // Description:
+  // When set to true, the blocks of a composite dataset are extracted
+  // concurrently with vtkSMPTools, each thread using its own internal filters.
+  // The output is the same as when the blocks are extracted one after the
+  // other. Blocks that appear several times in the input are extracted once.
+  // Blocks may share their points and attribute arrays: their bounds and
+  // ranges are computed before the blocks are extracted. Off by default.
+  vtkSetMacro(UseThreadedBlockExecution, bool);
+  vtkGetMacro(UseThreadedBlockExecution, bool);
+  vtkBooleanMacro(UseThreadedBlockExecution, bool);
+
+  // Description:
+  // When set to true (default), the surfaces extracted from unstructured
+  // grids made of linear cells are kept along with the input points and cells
+  // they come from. When the next execution gets an unstructured grid with the
+  // same topology, e.g. a static mesh whose points or attributes change over
+  // time, its surface is produced by gathering its points and attributes
+  // instead of being extracted again. The surfaces not used by an execution
+  // are released by the next one.
+  vtkSetMacro(UseSurfaceCache, bool);
+  vtkGetMacro(UseSurfaceCache, bool);
+  vtkBooleanMacro(UseSurfaceCache, bool);
+
   // These keys are put in the output composite-data metadata for multipieces
   // since this filter merges multipieces together.
   static vtkInformationIntegerVectorKey* POINT_OFFSETS();
@@ -306,6 +329,8 @@ protected:
 
   bool HideInternalAMRFaces;
   bool UseNonOverlappingAMRMetaDataForOutlines;
+  bool UseThreadedBlockExecution;
+  bool UseSurfaceCache;
 
 private:
   vtkPVGeometryFilter(const vtkPVGeometryFilter&); // Not implemented
@@ -320,6 +345,10 @@ private:
   void AddBlockColors(vtkPolyData* pd, unsigned int index);
   void AddHierarchicalIndex(vtkPolyData* pd, unsigned int level, unsigned int index);
   class BoundsReductionOperation;
+  class vtkBlocksFunctor;
+  friend class vtkBlocksFunctor;
+  class vtkSurfaceCache;
+  vtkSurfaceCache* SurfaceCache;
 //ETX
 };
 
@@ -358,6 +358,19 @@ void vtkReductionFilter::Reduce(vtkDataObject* input, vtkDataObject* output)
     }
 
   std::vector<vtkSmartPointer<vtkDataObject> > data_sets;
+  if (this->PassThrough == 0)
+    {
+    // The root node only needs its own data, nothing has to be gathered.
+    // This is the case of pre-gather helpers that already produce the
+    // global result on every process.
+    if (preOutput)
+      {
+      data_sets.push_back(preOutput);
+      this->PostProcess(output, &data_sets[0], 1);
+      }
+    return;
+    }
+
   std::vector<vtkSmartPointer<vtkDataObject> > receiveData(
     controller->GetNumberOfProcesses());
   if (myId == 0 && preOutput)
@@ -66,7 +66,8 @@ public:
   //Get/Set the PassThrough flag which (when set to a nonnegative number N) 
   //tells the filter to produce results that come from node N only. The 
   //data from that node still runs through the PreReduction and 
-  //PostGatherHelper algorithms.
+  //PostGatherHelper algorithms. When N is 0, nothing is gathered since
+  //the root node already has the data it needs.
   vtkSetMacro(PassThrough, int);
   vtkGetMacro(PassThrough, int);
 
@@ -397,7 +397,8 @@ public:
         {
         // Need to differentiate the same scalar value in some way
         // otherwise those values will be removed in the sorting process.
-        return a.OriginalIndex > b.OriginalIndex;
+        // Equal values keep their original order, as in Descendent.
+        return a.OriginalIndex < b.OriginalIndex;
         }
       return a.Value > b.Value;
       }
@@ -570,6 +571,51 @@ public:
         }
       }
   };
+  // Sampled value of a locally sorted array. Whatever the order of the
+  // values, equal values are ordered by process id, then by their index in
+  // the locally sorted array of their process. The keys are then all
+  // distinct, so that many equal values can be split between buckets.
+  class SampleKey
+  {
+  public:
+    double Value;
+    int ProcessId;
+    vtkIdType LocalIndex;
+  };
+  class SampleKeyOrder
+  {
+  public:
+    bool Inverted;
+
+    SampleKeyOrder(bool inverted) : Inverted(inverted) {}
+
+    bool operator()(const SampleKey& a, const SampleKey& b) const
+      {
+      if (a.Value != b.Value)
+        {
+        return this->Inverted ? a.Value > b.Value : a.Value < b.Value;
+        }
+      if (a.ProcessId != b.ProcessId)
+        {
+        return a.ProcessId < b.ProcessId;
+        }
+      return a.LocalIndex < b.LocalIndex;
+      }
+
+    // Compare the items of a sorted array with a value, for std::lower_bound
+    // and std::upper_bound.
+    bool operator()(const SortableArrayItem& a, double value) const
+      {
+      double itemValue = static_cast<double>(a.Value);
+      return this->Inverted ? itemValue > value : itemValue < value;
+      }
+
+    bool operator()(double value, const SortableArrayItem& a) const
+      {
+      double itemValue = static_cast<double>(a.Value);
+      return this->Inverted ? value > itemValue : value < itemValue;
+      }
+  };
 
 public:
 
@@ -577,7 +623,6 @@ public:
     {
     // Only used for testing
     this->LocalSorter = 0;
-    this->GlobalHistogram = 0;
     this->Debug = false;
     }
 
@@ -603,13 +648,11 @@ public:
 
     // Create internal objects
     this->LocalSorter = new ArraySorter();
-    this->GlobalHistogram = new Histogram(HISTOGRAM_SIZE);
     }
 
   virtual ~Internals()
     {
     if (this->LocalSorter)     delete this->LocalSorter;
-    if (this->GlobalHistogram) delete this->GlobalHistogram;
     }
 
   // --------------------------------------------------------------------------
@@ -682,9 +725,6 @@ public:
     // We are building the cache so no need to build it next time
     this->NeedToBuildCache = false;
 
-    // Communication buffer
-    vtkIdType* bufferHistogramValues = new vtkIdType[this->NumProcs *  HISTOGRAM_SIZE];
-
     // Is there something to sort ???
     if(!sortableArray)
       {
@@ -716,28 +756,107 @@ public:
         this->LocalSorter->Histo->Inverted = invertOrder;
         }
 
-      // Initialize the global histogram with same range
-      this->LocalSorter->Histo->CopyRangeTo(*this->GlobalHistogram);
+      // Split the globally sorted order into buckets
+      this->BuildBuckets(invertOrder);
+      }
+
+    return 1;
+    }
+
+  // --------------------------------------------------------------------------
+  // Sample sort partition of the global order. Every process picks regular
+  // samples of its locally sorted array and all of them are exchanged once.
+  // Every OVERSAMPLING-th sample of the sorted set becomes a splitter, which
+  // cuts the global order into buckets of about BUCKET_SIZE rows. Each
+  // process stores where the buckets start in its local array and how many
+  // rows precede each bucket globally, so that any block of the global order
+  // can then be located without communication.
+  void BuildBuckets(bool invertOrder)
+    {
+    vtkIdType localSize =
+        this->LocalSorter->Array ? this->LocalSorter->ArraySize : 0;
+    SortableArrayItem* sorted = this->LocalSorter->Array;
 
-      // Make sure that the global histogram is properly initialized
-      this->GlobalHistogram->ClearHistogramValues();
-      this->GlobalHistogram->Inverted = invertOrder;
+    // Regular samples of the local array. The sample number k of a process
+    // is its item at index (k + 1) * sampleStep - 1.
+    std::vector<double> samples;
+    const vtkIdType sampleStep = BUCKET_SIZE / OVERSAMPLING;
+    for(vtkIdType idx = sampleStep - 1; idx < localSize; idx += sampleStep)
+      {
+      samples.push_back(static_cast<double>(sorted[idx].Value));
+      }
 
-      // Send local histogram and receive every histogram from everybody
-      this->MPI->AllGather(this->LocalSorter->Histo->Values,
-                           bufferHistogramValues,
-                           HISTOGRAM_SIZE);
+    // Exchange the samples
+    vtkIdType nbSamples = static_cast<vtkIdType>(samples.size());
+    std::vector<vtkIdType> sampleCounts(this->NumProcs);
+    std::vector<vtkIdType> sampleOffsets(this->NumProcs);
+    this->MPI->AllGather(&nbSamples, &sampleCounts[0], 1);
+    vtkIdType nbGlobalSamples = 0;
+    for(int pid=0; pid < this->NumProcs; pid++)
+      {
+      sampleOffsets[pid] = nbGlobalSamples;
+      nbGlobalSamples += sampleCounts[pid];
+      }
+    std::vector<SampleKey> keys;
+    if(nbGlobalSamples > 0)
+      {
+      std::vector<double> globalSamples(nbGlobalSamples);
+      samples.resize(nbSamples + 1); // Valid pointer even without samples
+      this->MPI->AllGatherV(&samples[0], &globalSamples[0], nbSamples,
+                            &sampleCounts[0], &sampleOffsets[0]);
+      keys.resize(nbGlobalSamples);
+      for(int pid=0; pid < this->NumProcs; pid++)
+        {
+        for(vtkIdType idx=0; idx < sampleCounts[pid]; idx++)
+          {
+          keys[sampleOffsets[pid] + idx].Value =
+              globalSamples[sampleOffsets[pid] + idx];
+          keys[sampleOffsets[pid] + idx].ProcessId = pid;
+          keys[sampleOffsets[pid] + idx].LocalIndex =
+              (idx + 1) * sampleStep - 1;
+          }
+        }
+      }
+    SampleKeyOrder order(invertOrder);
+    std::sort(keys.begin(), keys.end(), order);
 
-      // Merge all histogram into the GlobalHistogram
-      for(int idx=0, nb=this->NumProcs*HISTOGRAM_SIZE; idx < nb; ++idx)
+    // Locate every splitter in the local array. Local values equal to the
+    // splitter precede it when this process precedes the splitter process,
+    // and on the splitter process, when they precede the splitter itself.
+    this->LocalOffsets.clear();
+    this->LocalOffsets.push_back(0);
+    for(size_t idx = OVERSAMPLING; idx < keys.size(); idx += OVERSAMPLING)
+      {
+      const SampleKey& splitter = keys[idx];
+      if(this->Me == splitter.ProcessId)
         {
-        this->GlobalHistogram->TotalValues += bufferHistogramValues[idx];
-        this->GlobalHistogram->Values[idx % HISTOGRAM_SIZE] += bufferHistogramValues[idx];
+        this->LocalOffsets.push_back(splitter.LocalIndex);
+        continue;
         }
+      SortableArrayItem* location = (this->Me < splitter.ProcessId) ?
+          std::upper_bound(sorted, sorted + localSize, splitter.Value, order) :
+          std::lower_bound(sorted, sorted + localSize, splitter.Value, order);
+      this->LocalOffsets.push_back(location - sorted);
       }
+    this->LocalOffsets.push_back(localSize);
 
-    delete[] bufferHistogramValues;
-    return 1;
+    // Global number of rows before each bucket
+    size_t nbBuckets = this->LocalOffsets.size() - 1;
+    std::vector<vtkIdType> localCounts(nbBuckets);
+    std::vector<vtkIdType> globalCounts(nbBuckets);
+    for(size_t idx=0; idx < nbBuckets; idx++)
+      {
+      localCounts[idx] = this->LocalOffsets[idx + 1] - this->LocalOffsets[idx];
+      }
+    this->MPI->AllReduce(&localCounts[0], &globalCounts[0],
+                         static_cast<vtkIdType>(nbBuckets),
+                         vtkCommunicator::SUM_OP);
+    this->GlobalOffsets.resize(nbBuckets + 1);
+    this->GlobalOffsets[0] = 0;
+    for(size_t idx=0; idx < nbBuckets; idx++)
+      {
+      this->GlobalOffsets[idx + 1] = this->GlobalOffsets[idx] + globalCounts[idx];
+      }
     }
 
   // --------------------------------------------------------------------------
@@ -896,46 +1015,36 @@ public:
     //    This will sort the local array, that's why we don't want to do it
     //    at each execution. Specialy when we only change the requested block.
     // ------------------------------------------------------------------------
-    if(this->NeedToBuildCache)
+    if(this->NeedToBuildCache || this->GlobalOffsets.empty())
       {
       this->BuildCache(true, revertOrder);
       }
 
     // ------------------------------------------------------------------------
-    // Search for lower bound
+    // Find the buckets that hold the requested rows of the global order
     // ------------------------------------------------------------------------
+    vtkIdType globalBegin = block * blockSize;
+    vtkIdType globalEnd = globalBegin + blockSize;
+    vtkIdType globalSize = this->GlobalOffsets.back();
+    globalEnd = (globalEnd > globalSize) ? globalSize : globalEnd;
+
     vtkIdType nbElementsToRemoveFromHead = 0;
     vtkIdType localOffset = 0;
-    vtkIdType nbElementsInBar = 0;
-    this->SearchGlobalIndexLocation( (block * blockSize),
-                                     this->LocalSorter->Histo,
-                                     this->GlobalHistogram,
-                                     nbElementsToRemoveFromHead,
-                                     localOffset,
-                                     nbElementsInBar);
-
-
-
-    // ------------------------------------------------------------------------
-    // Search for upper bound
-    // ------------------------------------------------------------------------
-    vtkIdType upperOffset = 0;
-    vtkIdType globalUpperOffset = 0;
-    vtkIdType searchIdx =
-        (this->GlobalHistogram->TotalValues < (block + 1) * blockSize) ?
-        this->GlobalHistogram->TotalValues : ((block + 1) * blockSize);
-    searchIdx--; // It is not a size it is an index (so -1)
-
-    this->SearchGlobalIndexLocation( searchIdx,
-                                     this->LocalSorter->Histo,
-                                     this->GlobalHistogram,
-                                     globalUpperOffset,
-                                     upperOffset,
-                                     nbElementsInBar );
-
+    vtkIdType localSize = 0;
+    if(globalBegin < globalEnd)
+      {
+      std::vector<vtkIdType>::iterator first =
+          std::upper_bound(this->GlobalOffsets.begin(),
+                           this->GlobalOffsets.end(), globalBegin) - 1;
+      std::vector<vtkIdType>::iterator last =
+          std::lower_bound(first + 1, this->GlobalOffsets.end(), globalEnd);
+      size_t firstBucket = first - this->GlobalOffsets.begin();
+      size_t lastBucket = last - this->GlobalOffsets.begin();
 
-    // We have to include our searched index (so +1)
-    vtkIdType localSize = (upperOffset + nbElementsInBar) - localOffset + 1;
+      nbElementsToRemoveFromHead = globalBegin - *first;
+      localOffset = this->LocalOffsets[firstBucket];
+      localSize = this->LocalOffsets[lastBucket] - localOffset;
+      }
 
     // ------------------------------------------------------------------------
     // Build local subset table
@@ -951,22 +1060,6 @@ public:
     // ------------------------------------------------------------------------
     int mergePid = GetMergingProcessId(localSubset.GetPointer());
 
-    // ------------------------------------------------------------------------
-    // Add local meta-data in case of merge process
-    // ------------------------------------------------------------------------
-    if(this->NumProcs > 1 && this->Me == mergePid)
-      {
-      vtkSmartPointer<vtkIdTypeArray> processIdArray = vtkSmartPointer<vtkIdTypeArray>::New();
-      processIdArray->SetName("vtkOriginalProcessIds");
-      processIdArray->SetNumberOfComponents(1);
-      processIdArray->Allocate( (blockSize<localSize) ? localSize : blockSize);
-      for(vtkIdType idx=0; idx < localSubset->GetNumberOfRows(); idx++)
-        {
-        processIdArray->InsertNextTuple1(mergePid);
-        }
-      localSubset->GetRowData()->AddArray(processIdArray);
-      }
-
     // ------------------------------------------------------------------------
     // Send local subset array to process mergePid
     // ------------------------------------------------------------------------
@@ -980,15 +1073,35 @@ public:
     // ------------------------------------------------------------------------
     if( this->Me == mergePid)
       {
+      // Merge the subsets in process order: equal values, which keep the
+      // order of the rows, are then sorted by process and by local order,
+      // like they are split between the buckets.
+      vtkSmartPointer<vtkTable> merged = vtkSmartPointer<vtkTable>::New();
+      vtkSmartPointer<vtkIdTypeArray> processIdArray =
+          vtkSmartPointer<vtkIdTypeArray>::New();
+      processIdArray->SetName("vtkOriginalProcessIds");
+      processIdArray->SetNumberOfComponents(1);
+      processIdArray->Allocate( (blockSize<localSize) ? localSize : blockSize);
       vtkSmartPointer<vtkTable> tmp = vtkSmartPointer<vtkTable>::New();
       for(int i=0; i < this->NumProcs; i++)
         {
-        if(i == mergePid)
-          continue;
-
-        this->MPI->Receive(tmp.GetPointer(), i, VTK_TABLE_EXCHANGE_TAG);
-        this->MergeTable(i,tmp.GetPointer(),localSubset.GetPointer(),blockSize);
+        vtkTable* subset = localSubset.GetPointer();
+        if(i != mergePid)
+          {
+          this->MPI->Receive(tmp.GetPointer(), i, VTK_TABLE_EXCHANGE_TAG);
+          subset = tmp.GetPointer();
+          }
+        this->MergeTable(-1, subset, merged.GetPointer(), blockSize);
+        for(vtkIdType idx=0; idx < subset->GetNumberOfRows(); idx++)
+          {
+          processIdArray->InsertNextTuple1(i);
+          }
         }
+      if(this->NumProcs > 1)
+        {
+        merged->GetRowData()->AddArray(processIdArray);
+        }
+      localSubset = merged;
 
       // Sort new table/array
       if(!this->DataToSort)
@@ -1036,81 +1149,6 @@ public:
     return 1;
     }
 
-  // --------------------------------------------------------------------------
-  // nbGlobalToSkip is the number of elements that should be skiped at the end
-  // if you exactly want to reach the searchedGlobalIndex.
-  // localOffset is the corresponding local index in the sorted table to the
-  // global index of (searchedGlobalIndex - nbGlobalToSkip)
-  // nbInLocalBar is the local number of elements that are available
-  // in the hitogram bar where the searchedGlobalIndex has been found.
-  // nbInLocalBar is used when you want to get an upper bound that
-  // will include the searchedGlobalIndex.
-  void SearchGlobalIndexLocation(vtkIdType searchedGlobalIndex,
-                                 Histogram* localHistogram,
-                                 Histogram* globalHistogram,
-                                 vtkIdType& nbGlobalToSkip,
-                                 vtkIdType& localOffset,
-                                 vtkIdType& nbInLocalBar)
-    {
-    // Communication buffer
-    vtkIdType* bufferHistogramValues = new vtkIdType[this->NumProcs *  HISTOGRAM_SIZE];
-
-    // Local internal working var
-    vtkIdType histogramBarIdx = -1;
-    double currentRange[2];
-    vtkIdType idx, idxEnd;
-
-    // Setup inital hitogram range and values
-    Histogram _globalHistogram;
-    Histogram _localHistogram;
-    localHistogram->CopyTo(_localHistogram);
-    globalHistogram->CopyTo(_globalHistogram);
-
-    // Reset local offsets
-    localOffset = 0;
-    nbGlobalToSkip = searchedGlobalIndex;
-
-    do
-      {
-      nbGlobalToSkip -= _globalHistogram.GetNewRange(nbGlobalToSkip,
-                                                     histogramBarIdx,
-                                                     currentRange);
-
-      localOffset += _localHistogram.GetNumberOfElements(0, histogramBarIdx);
-      nbInLocalBar = _localHistogram.GetNumberOfElements(histogramBarIdx,
-                                                         histogramBarIdx+1);
-
-      // Based on a narrowed range, build local histogram to get closer to the
-      // real index of the object
-      _localHistogram.SetScalarRange(currentRange);
-      _localHistogram.ClearHistogramValues();
-
-      idxEnd = localOffset + nbInLocalBar;
-      for(idx = localOffset; idx < idxEnd; ++idx)
-        {
-        _localHistogram.AddValue(this->LocalSorter->Array[idx].Value);
-        }
-
-      // Exchange local histo with everyone
-      this->MPI->AllGather( _localHistogram.Values,
-                            bufferHistogramValues, HISTOGRAM_SIZE);
-
-      // Build global histogram
-      _globalHistogram.SetScalarRange(currentRange);
-      _globalHistogram.ClearHistogramValues();
-
-      idxEnd = this->NumProcs * HISTOGRAM_SIZE;
-      for(idx = 0; idx < idxEnd; ++idx)
-        {
-        _globalHistogram.TotalValues += bufferHistogramValues[idx];
-        _globalHistogram.Values[idx % HISTOGRAM_SIZE] += bufferHistogramValues[idx];
-        }
-      }
-    while(nbGlobalToSkip > 0 && _globalHistogram.CanBeReduced());
-
-    delete[] bufferHistogramValues;
-    }
-
   // --------------------------------------------------------------------------
   static vtkTable* NewSubsetTable( vtkTable* srcTable,
                             ArraySorter* sorter,
@@ -1397,7 +1435,8 @@ private:
   unsigned long int DataMTime;  // Keep the original data MTime
   vtkDataArray* DataToSort;   // DataArray to sort
   ArraySorter* LocalSorter;   // Local ArraySorter based on global range
-  Histogram* GlobalHistogram; // Globaly merged Histogram based on global range
+  std::vector<vtkIdType> LocalOffsets;  // Local start of each bucket
+  std::vector<vtkIdType> GlobalOffsets; // Global start of each bucket
   double CommonRange[2];      // Scalar range used across processes
   int Me;                     // Current process ID
   int NumProcs;               // Number of processes involved
@@ -1414,6 +1453,10 @@ private:
   // Maybe make some test on huge cluster to see which histogram size is
   // the best.
   const static int HISTOGRAM_SIZE = 256;
+  // Expected number of rows in a bucket of the global order, and number of
+  // samples taken per bucket to find the splitters.
+  const static int BUCKET_SIZE = 16384;
+  const static int OVERSAMPLING = 8;
 };
 //****************************************************************************
 vtkStandardNewMacro(vtkSortedTableStreamer);
@@ -1429,6 +1472,8 @@ vtkSortedTableStreamer::vtkSortedTableStreamer()
   this->BlockSize = 1024;
   this->Internal = 0;
   this->SelectedComponent = 0;
+  this->CompositeInputTable = 0;
+  this->CompositeInputMTime = 0;
   this->SetController(vtkMultiProcessController::GetGlobalController());
 }
 
@@ -1442,6 +1487,11 @@ vtkSortedTableStreamer::~vtkSortedTableStreamer()
     delete this->Internal;
     this->Internal = 0;
     }
+  if(this->CompositeInputTable)
+    {
+    this->CompositeInputTable->Delete();
+    this->CompositeInputTable = 0;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -1467,8 +1517,15 @@ int vtkSortedTableStreamer::RequestData( vtkInformation* vtkNotUsed(request),
 
   bool orderInverted = this->InvertOrder > 0;
 
-  // Convert a composite dataset into a vtkTable input.
-  if(!input)
+  // Convert a composite dataset into a vtkTable input. The table is kept
+  // while the input is unchanged, so that the sort done on it is reused when
+  // only the requested block changes.
+  if(!input && this->CompositeInputTable &&
+     this->CompositeInputMTime == inputDO->GetMTime())
+    {
+    input = this->CompositeInputTable;
+    }
+  else if(!input)
     {
     vtkSmartPointer<vtkCompositeDataSet> inputCompositeDS =
         vtkCompositeDataSet::SafeDownCast(inputDO);
@@ -1554,6 +1611,14 @@ int vtkSortedTableStreamer::RequestData( vtkInformation* vtkNotUsed(request),
         }
       }
     iter->Delete();
+
+    if(this->CompositeInputTable)
+      {
+      this->CompositeInputTable->Delete();
+      }
+    this->CompositeInputTable = input;
+    this->CompositeInputTable->Register(this);
+    this->CompositeInputMTime = inputDO->GetMTime();
     }
 
   // Get input data
@@ -104,6 +104,12 @@ protected:
   char* ColumnToSort;
   int SelectedComponent;
   int InvertOrder;
+
+  // Description:
+  // Table built from a composite input and the MTime of that input. It is
+  // reused while the input is unchanged so that the sort stays cached.
+  vtkTable* CompositeInputTable;
+  unsigned long CompositeInputMTime;
 private:
   vtkSortedTableStreamer(const vtkSortedTableStreamer&); // Not implemented
   void operator=(const vtkSortedTableStreamer&);   // Not implemented
@@ -20,10 +20,226 @@
 #include "vtkObjectFactory.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkMultiProcessStream.h"
+#include "vtkSMPTools.h"
 #include <sstream>
+#include <string.h>
+#include <vector>
 
 vtkStandardNewMacro(vtkSquirtCompressor);
 
+namespace
+{
+  // Images are split in horizontal bands of consecutive pixels that are
+  // encoded independently, in parallel. A banded stream starts with this
+  // marker followed by the number of bands and, for each band, the number of
+  // pixels and the number of compressed words. The run length encoded bands
+  // follow. Streams without the marker are single band streams as produced by
+  // older versions.
+  const unsigned char BANDED_MARKER[4] = { 'S', 'Q', 'B', '1' };
+
+  // Bands smaller than this are not worth a task of their own.
+  const vtkIdType MINIMUM_BAND_PIXELS = 131072;
+  const vtkIdType MAXIMUM_NUMBER_OF_BANDS = 64;
+
+  const unsigned char COMPRESS_MASKS[6][4] = {  {0xFF, 0xFF, 0xFF, 0xFF},
+      {0xFE, 0xFF, 0xFE, 0xFF},
+      {0xFC, 0xFE, 0xFC, 0xFF},
+      {0xF8, 0xFC, 0xF8, 0xFF},
+      {0xF0, 0xF8, 0xF0, 0xFF},
+      {0xE0, 0xF0, 0xE0, 0xFF}};
+
+  // The band table is stored little-endian.
+  inline void WriteUInt32(unsigned char* ptr, vtkIdType value)
+    {
+    ptr[0] = static_cast<unsigned char>(value & 0xff);
+    ptr[1] = static_cast<unsigned char>((value >> 8) & 0xff);
+    ptr[2] = static_cast<unsigned char>((value >> 16) & 0xff);
+    ptr[3] = static_cast<unsigned char>((value >> 24) & 0xff);
+    }
+
+  inline vtkIdType ReadUInt32(const unsigned char* ptr)
+    {
+    return static_cast<vtkIdType>(ptr[0]) |
+      (static_cast<vtkIdType>(ptr[1]) << 8) |
+      (static_cast<vtkIdType>(ptr[2]) << 16) |
+      (static_cast<vtkIdType>(ptr[3]) << 24);
+    }
+
+  inline unsigned int PackRGB(const unsigned char* rgb)
+    {
+    unsigned int color;
+    unsigned char* p = (unsigned char*)&color;
+    p[0] = rgb[0];
+    p[1] = rgb[1];
+    p[2] = rgb[2];
+    p[3] = 0x0;
+    return color;
+    }
+
+  // Run length encodes RGBA pixels. Returns the number of words written,
+  // which never exceeds the number of pixels.
+  vtkIdType EncodeRGBA(const unsigned int* input, vtkIdType numPixels,
+    unsigned int compressMask, unsigned int* output)
+    {
+    vtkIdType index = 0;
+    vtkIdType compIndex = 0;
+    while (index < numPixels)
+      {
+      // Record color
+      unsigned int currentColor = output[compIndex] = input[index];
+      index++;
+
+      // Compute Run
+      int count = 0;
+      while ((index < numPixels) && (count < 0x7F) &&
+        ((currentColor&compressMask) == (input[index]&compressMask)))
+        {
+        index++; count++;
+        }
+      if (*(((unsigned char*)&currentColor)+3) > 0)
+        {
+        count |= 0x80;
+        }
+
+      // Record Run length
+      *((unsigned char*)output+compIndex*4+3) = (unsigned char)count;
+      compIndex++;
+      }
+    return compIndex;
+    }
+
+  // Same as EncodeRGBA for RGB pixels, runs can be up to 256 pixels long.
+  vtkIdType EncodeRGB(const unsigned char* input, vtkIdType numPixels,
+    unsigned int compressMask, unsigned int* output)
+    {
+    vtkIdType index = 0;
+    vtkIdType compIndex = 0;
+    while (index < numPixels)
+      {
+      unsigned int currentColor = output[compIndex] = PackRGB(input + 3*index);
+      index++;
+
+      int count = 0;
+      while ((index < numPixels) && (count < 255) &&
+        ((currentColor&compressMask) ==
+         (PackRGB(input + 3*index)&compressMask)))
+        {
+        index++; count++;
+        }
+
+      *((unsigned char*)output+compIndex*4+3) = (unsigned char)count;
+      compIndex++;
+      }
+    return compIndex;
+    }
+
+  // Expands numWords run length encoded words into at most maxPixels pixels.
+  // Returns the number of pixels written or -1 if the runs overflow.
+  vtkIdType Decode(const unsigned int* input, vtkIdType numWords,
+    int numComps, unsigned char* output, vtkIdType maxPixels)
+    {
+    vtkIdType index = 0;
+    for (vtkIdType i = 0; i < numWords; i++)
+      {
+      // Get color and count
+      unsigned int currentColor = input[i];
+
+      // Get run length count;
+      int count = *((unsigned char*)&currentColor+3);
+
+      if (numComps == 4)
+        {
+        *((unsigned char*)&currentColor+3) = (count & 0x80) != 0? 0xff : 0;
+        count &= 0x7f;
+        }
+      else
+        {
+        *((unsigned char*)&currentColor+3) = 0xff;
+        }
+
+      if (index + count + 1 > maxPixels)
+        {
+        return -1;
+        }
+
+      // Blast color into color buffer
+      if (numComps == 4)
+        {
+        unsigned int* colorBuffer = (unsigned int*)output + index;
+        for (int j = 0; j <= count; j++)
+          {
+          colorBuffer[j] = currentColor;
+          }
+        }
+      else
+        {
+        unsigned char* colorBuffer = output + 3*index;
+        for (int j = 0; j <= count; j++, colorBuffer += 3)
+          {
+          memcpy(colorBuffer, &currentColor, 3);
+          }
+        }
+      index += count + 1;
+      }
+    return index;
+    }
+
+  // Encodes bands in place: band i is written at the word offset of its first
+  // pixel, which is safe since a band never produces more words than pixels.
+  class vtkSquirtEncodeBands
+  {
+  public:
+    const unsigned char* Input;
+    int NumberOfComponents;
+    vtkIdType NumberOfPixels;
+    vtkIdType BandSize;
+    unsigned int CompressMask;
+    unsigned int* Output;
+    vtkIdType* BandWords;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType band = begin; band < end; ++band)
+        {
+        vtkIdType first = band * this->BandSize;
+        vtkIdType numPixels = this->NumberOfPixels - first;
+        numPixels = numPixels < this->BandSize? numPixels : this->BandSize;
+        this->BandWords[band] = (this->NumberOfComponents == 4)?
+          EncodeRGBA((const unsigned int*)this->Input + first, numPixels,
+            this->CompressMask, this->Output + first) :
+          EncodeRGB(this->Input + 3*first, numPixels,
+            this->CompressMask, this->Output + first);
+        }
+      }
+  };
+
+  class vtkSquirtDecodeBands
+  {
+  public:
+    const unsigned int* Input;
+    int NumberOfComponents;
+    unsigned char* Output;
+    const vtkIdType* PixelOffsets;
+    const vtkIdType* WordOffsets;
+    vtkIdType* BandPixels;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType band = begin; band < end; ++band)
+        {
+        vtkIdType numPixels =
+          this->PixelOffsets[band+1] - this->PixelOffsets[band];
+        this->BandPixels[band] = Decode(
+          this->Input + this->WordOffsets[band],
+          this->WordOffsets[band+1] - this->WordOffsets[band],
+          this->NumberOfComponents,
+          this->Output + this->PixelOffsets[band] * this->NumberOfComponents,
+          numPixels);
+        }
+      }
+  };
+}
+
 
 //-----------------------------------------------------------------------------
 vtkSquirtCompressor::vtkSquirtCompressor()
@@ -52,19 +268,7 @@ int vtkSquirtCompressor::Compress()
     return VTK_ERROR;
     }
 
-  int count=0;
-  int index=0;
-  int comp_index=0;
-  int end_index;
   int compress_level = this->LossLessMode?0:this->SquirtLevel;
-  unsigned int current_color;
-  unsigned char compress_masks[6][4] = {  {0xFF, 0xFF, 0xFF, 0xFF},
-      {0xFE, 0xFF, 0xFE, 0xFF},
-      {0xFC, 0xFE, 0xFC, 0xFF},
-      {0xF8, 0xFC, 0xF8, 0xFF},
-      {0xF0, 0xF8, 0xF0, 0xFF},
-      {0xE0, 0xF0, 0xE0, 0xFF}};
-
   if (compress_level < 0 || compress_level > 5)
     {
     vtkErrorMacro("Squirt compression level (" << compress_level 
@@ -75,101 +279,61 @@ int vtkSquirtCompressor::Compress()
   // Set bitmask based on compress_level
   unsigned int compress_mask;
   // I shifted the level by one so that 0 means no compression.
-  memcpy(&compress_mask, &compress_masks[compress_level], 4);
+  memcpy(&compress_mask, &COMPRESS_MASKS[compress_level], 4);
+
+  // Split the image in bands.
+  const vtkIdType numPixels = input->GetNumberOfTuples();
+  vtkIdType numBands = numPixels / MINIMUM_BAND_PIXELS;
+  numBands = numBands < 1? 1 : numBands;
+  numBands = numBands > MAXIMUM_NUMBER_OF_BANDS?
+    MAXIMUM_NUMBER_OF_BANDS : numBands;
+  const vtkIdType bandSize = (numPixels + numBands - 1) / numBands;
+  if (bandSize > 0)
+    {
+    numBands = (numPixels + bandSize - 1) / bandSize;
+    }
+  const vtkIdType headerWords = 2 + 2*numBands;
 
   // Access raw arrays directly
-  if (input->GetNumberOfComponents() == 4)
+  this->Output->SetNumberOfComponents(1);
+  unsigned char* header =
+    this->Output->WritePointer(0, 4*(headerWords + numPixels));
+  unsigned int* bands = (unsigned int*)header + headerWords;
+
+  std::vector<vtkIdType> bandWords(numBands, 0);
+  vtkSquirtEncodeBands encoder;
+  encoder.Input = input->GetPointer(0);
+  encoder.NumberOfComponents = input->GetNumberOfComponents();
+  encoder.NumberOfPixels = numPixels;
+  encoder.BandSize = bandSize;
+  encoder.CompressMask = compress_mask;
+  encoder.Output = bands;
+  encoder.BandWords = &bandWords[0];
+  if (bandSize > 0)
     {
-    unsigned int* _rawColorBuffer;
-    unsigned int* _rawCompressedBuffer;
-    int numPixels = input->GetNumberOfTuples();
-    _rawColorBuffer = (unsigned int*)input->GetPointer(0);
-    _rawCompressedBuffer = (unsigned int*)this->Output->WritePointer(0,numPixels*4);
-    end_index = numPixels;
-
-    // Go through color buffer and put RLE format into compressed buffer
-    while((index < end_index) && (comp_index < end_index)) 
-      {
-
-      // Record color
-      current_color = _rawCompressedBuffer[comp_index] =_rawColorBuffer[index];
-      index++;
-
-      // Compute Run
-      while((index<end_index) && (count<0x7F) &&
-        ((current_color&compress_mask) == (_rawColorBuffer[index]&compress_mask)))
-        { 
-        index++; count++;   
-        }
-      if (*(((unsigned char*)&current_color)+3) > 0)
-        {
-        count |= 0x80;
-        }
-
-      // Record Run length
-      *((unsigned char*)_rawCompressedBuffer+comp_index*4+3) =(unsigned char)count;
-      comp_index++;
-
-      count = 0;
-
-      }
+    vtkSMPTools::For(0, numBands, 1, encoder);
     }
-  else if (input->GetNumberOfComponents() == 3)
+
+  // Fill the band table and pack the bands one after the other.
+  memcpy(header, BANDED_MARKER, 4);
+  WriteUInt32(header + 4, numBands);
+  vtkIdType comp_index = 0;
+  for (vtkIdType band = 0; band < numBands; ++band)
     {
-    unsigned char* _rawColorBuffer;
-    unsigned int* _rawCompressedBuffer;
-    int numPixels = input->GetNumberOfTuples();
-    _rawColorBuffer = (unsigned char*)input->GetPointer(0);
-    _rawCompressedBuffer = (unsigned int*)this->Output->WritePointer(0,numPixels*4);
-    end_index = numPixels;
-
-    // Go through color buffer and put RLE format into compressed buffer
-    while((index < 3*numPixels) && (comp_index < end_index)) 
+    vtkIdType first = band * bandSize;
+    vtkIdType bandPixels = numPixels - first;
+    bandPixels = bandPixels < bandSize? bandPixels : bandSize;
+    WriteUInt32(header + 8 + 8*band, bandPixels);
+    WriteUInt32(header + 12 + 8*band, bandWords[band]);
+    if (comp_index != first)
       {
-
-      int next_color = 0;
-      // Record color
-      unsigned char* p = (unsigned char*)&current_color;
-      *p++ = _rawColorBuffer[index];
-      *p++ = _rawColorBuffer[index+1];
-      *p++ = _rawColorBuffer[index+2];
-      *p = 0x0;
-      
-      _rawCompressedBuffer[comp_index] = current_color;
-      index+=3;
-      
-      p = (unsigned char*)&next_color;
-      *p++ = _rawColorBuffer[index];
-      *p++ = _rawColorBuffer[index+1];
-      *p++ = _rawColorBuffer[index+2];
-      *p = 0x0;
-    
-      // Compute Run
-      while(((current_color&compress_mask) == (next_color&compress_mask)) &&
-        (index < 3*numPixels) && (count<255))
-        { 
-        index+=3; count++;   
-        if (index < 3*numPixels)
-          {
-          p = (unsigned char*)&next_color;
-          *p++ = _rawColorBuffer[index];
-          *p++ = _rawColorBuffer[index+1];
-          *p++ = _rawColorBuffer[index+2];
-          *p = 0x0;
-          }
-        }
-
-      // Record Run length
-      *((unsigned char*)_rawCompressedBuffer+comp_index*4+3) =(unsigned char)count;
-      comp_index++;
-
-      count = 0;
+      memmove(bands + comp_index, bands + first, 4*bandWords[band]);
       }
+    comp_index += bandWords[band];
     }
 
   // Back to vtk arrays :)
-  this->Output->SetNumberOfComponents(1);
-  this->Output->SetNumberOfTuples(4*comp_index);
+  this->Output->SetNumberOfTuples(4*(headerWords + comp_index));
 
   return VTK_OK;
 }
@@ -185,44 +349,60 @@ int vtkSquirtCompressor::Decompress()
 
   vtkUnsignedCharArray* in = this->GetInput();
   vtkUnsignedCharArray* out = this->GetOutput();
-  int count=0;
-  int index=0;
-  unsigned int current_color;
-  unsigned int* _rawColorBuffer;
-  unsigned int* _rawCompressedBuffer;
+  const unsigned char* inPtr = in->GetPointer(0);
+  const vtkIdType inSize = in->GetNumberOfTuples();
+  const int numComps = out->GetNumberOfComponents();
+  const vtkIdType numPixels = out->GetNumberOfTuples();
 
-  // Get compressed buffer size
-  int CompSize = in->GetNumberOfTuples()/4; /// NOTE 1->4
-
-  // Access raw arrays directly
-  _rawColorBuffer = (unsigned int*)out->GetPointer(0);
-  _rawCompressedBuffer = (unsigned int*)in->GetPointer(0);
-
-  // Go through compress buffer and extract RLE format into color buffer
-  for(int i=0; i<CompSize; i++)
+  if (inSize >= 8 && memcmp(inPtr, BANDED_MARKER, 4) == 0)
     {
-    // Get color and count
-    current_color = _rawCompressedBuffer[i];
-
-    // Get run length count;
-    count = *((unsigned char*)&current_color+3);
-
-    if (out->GetNumberOfComponents() == 4)
+    // Validate the band table, a stream that does not match it is a single
+    // band stream that happens to start with the marker.
+    const vtkIdType numBands = ReadUInt32(inPtr + 4);
+    const vtkIdType headerWords = 2 + 2*numBands;
+    bool valid = numBands > 0 && numBands <= (inSize / 8);
+    std::vector<vtkIdType> pixelOffsets(valid? numBands + 1 : 0, 0);
+    std::vector<vtkIdType> wordOffsets(valid? numBands + 1 : 0, 0);
+    for (vtkIdType band = 0; valid && band < numBands; ++band)
       {
-      *((unsigned char*)&current_color+3) = (count & 0x80) != 0? 0xff : 0;
-      count &= 0x7f;
+      pixelOffsets[band+1] = pixelOffsets[band] +
+        ReadUInt32(inPtr + 8 + 8*band);
+      wordOffsets[band+1] = wordOffsets[band] +
+        ReadUInt32(inPtr + 12 + 8*band);
       }
-    else
+    valid = valid && pixelOffsets[numBands] == numPixels &&
+      4*(headerWords + wordOffsets[numBands]) == inSize;
+    if (valid)
       {
-      *((unsigned char*)&current_color+3) = 0xff;
+      std::vector<vtkIdType> bandPixels(numBands, 0);
+      vtkSquirtDecodeBands decoder;
+      decoder.Input = (const unsigned int*)inPtr + headerWords;
+      decoder.NumberOfComponents = numComps;
+      decoder.Output = out->GetPointer(0);
+      decoder.PixelOffsets = &pixelOffsets[0];
+      decoder.WordOffsets = &wordOffsets[0];
+      decoder.BandPixels = &bandPixels[0];
+      vtkSMPTools::For(0, numBands, 1, decoder);
+      for (vtkIdType band = 0; band < numBands; ++band)
+        {
+        if (bandPixels[band] != pixelOffsets[band+1] - pixelOffsets[band])
+          {
+          vtkErrorMacro("Corrupted Squirt image.");
+          return VTK_ERROR;
+          }
+        }
+      return VTK_OK;
       }
+    }
 
-    // Set color
-    _rawColorBuffer[index++] = current_color;
-
-    // Blast color into color buffer
-    for(int j=0; j< count; j++)
-      _rawColorBuffer[index++] = current_color;
+  // Single band stream.
+  // Get compressed buffer size
+  vtkIdType CompSize = inSize/4; /// NOTE 1->4
+  if (Decode((const unsigned int*)inPtr, CompSize, numComps,
+      out->GetPointer(0), numPixels) < 0)
+    {
+    vtkErrorMacro("Corrupted Squirt image.");
+    return VTK_ERROR;
     }
   return VTK_OK;
 }
@@ -39,6 +39,12 @@
 // example when a run starts in one actor whose reduced color matches the
 // background the background is colored with the actor color.
 //
+// The image is split into horizontal bands that are encoded and decoded
+// independently in parallel using vtkSMPTools. The compressed stream starts
+// with a table giving the size of each band. Streams produced by older
+// versions, made of a single band without such a table, can still be
+// decompressed.
+//
 // .SECTION Thanks
 // Thanks to Sandia National Laboratories for this compression technique
 
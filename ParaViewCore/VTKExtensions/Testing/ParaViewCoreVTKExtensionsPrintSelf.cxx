@@ -54,6 +54,8 @@
 #include "vtkIsoVolume.h"
 #include "vtkKdTreeGenerator.h"
 #include "vtkKdTreeManager.h"
+#include "vtkLZ4Codec.h"
+#include "vtkLZ4ImageCompressor.h"
 #include "vtkMarkSelectedRows.h"
 #include "vtkMaterialInterfaceCommBuffer.h"
 #include "vtkMaterialInterfaceFilter.h"
@@ -237,6 +239,8 @@ int ParaViewCoreVTKExtensionsPrintSelf(int , char *[])
   PRINT_SELF(vtkIsoVolume);
   PRINT_SELF(vtkKdTreeGenerator);
   PRINT_SELF(vtkKdTreeManager);
+  PRINT_SELF(vtkLZ4Codec);
+  PRINT_SELF(vtkLZ4ImageCompressor);
   PRINT_SELF(vtkMarkSelectedRows);
   //PRINT_SELF(vtkMaterialInterfaceCommBuffer);
   PRINT_SELF(vtkMaterialInterfaceFilter);
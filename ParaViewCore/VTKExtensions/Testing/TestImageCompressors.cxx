@@ -0,0 +1,314 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestImageCompressors.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Round trips a sequence of frames through every loss-less image compressor
+// configuration and reports compression/decompression throughput and ratio.
+// Recorded frames can be benchmarked by passing PNG files on the command
+// line, otherwise a synthetic animation is used. Also checks the Squirt
+// single band format, RGB images and corrupted Squirt band tables.
+
+#include "vtkImageCompressor.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPNGReader.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+  // Simple animation: a gradient background with a moving square.
+  vtkSmartPointer<vtkUnsignedCharArray> MakeFrame(int width, int height,
+    int frame)
+    {
+    vtkSmartPointer<vtkUnsignedCharArray> image =
+      vtkSmartPointer<vtkUnsignedCharArray>::New();
+    image->SetNumberOfComponents(4);
+    image->SetNumberOfTuples(width * height);
+    unsigned char* ptr = image->GetPointer(0);
+    int x0 = (frame * 16) % (width / 2);
+    int y0 = height / 4;
+    for (int y = 0; y < height; ++y)
+      {
+      for (int x = 0; x < width; ++x, ptr += 4)
+        {
+        bool inside = (x >= x0 && x < x0 + width / 4 &&
+          y >= y0 && y < y0 + height / 4);
+        ptr[0] = inside? 200 : static_cast<unsigned char>(y * 255 / height);
+        ptr[1] = inside? 40 : static_cast<unsigned char>(y * 255 / height);
+        ptr[2] = inside? 40 : 128;
+        ptr[3] = 0xff;
+        }
+      }
+    return image;
+    }
+
+  vtkSmartPointer<vtkUnsignedCharArray> ReadFrame(const char* filename)
+    {
+    vtkNew<vtkPNGReader> reader;
+    reader->SetFileName(filename);
+    reader->Update();
+    vtkUnsignedCharArray* scalars = vtkUnsignedCharArray::SafeDownCast(
+      reader->GetOutput()->GetPointData()->GetScalars());
+    if (!scalars || scalars->GetNumberOfComponents() < 3)
+      {
+      return NULL;
+      }
+    vtkSmartPointer<vtkUnsignedCharArray> image =
+      vtkSmartPointer<vtkUnsignedCharArray>::New();
+    image->DeepCopy(scalars);
+    return image;
+    }
+
+  bool Benchmark(const char* configuration,
+    const std::vector<vtkSmartPointer<vtkUnsignedCharArray> >& frames)
+    {
+    std::string className(configuration, strcspn(configuration, " "));
+    vtkSmartPointer<vtkImageCompressor> compressor;
+    compressor.TakeReference(
+      vtkImageCompressor::NewCompressor(className.c_str()));
+    vtkSmartPointer<vtkImageCompressor> decompressor;
+    decompressor.TakeReference(
+      vtkImageCompressor::NewCompressor(className.c_str()));
+    if (!compressor || !decompressor ||
+      !compressor->RestoreConfiguration(configuration) ||
+      !decompressor->RestoreConfiguration(configuration))
+      {
+      cerr << "ERROR: Cannot create compressor " << configuration << endl;
+      return false;
+      }
+
+    vtkNew<vtkTimerLog> timer;
+    double compressTime = 0.0;
+    double decompressTime = 0.0;
+    double rawBytes = 0.0;
+    double compressedBytes = 0.0;
+    vtkNew<vtkUnsignedCharArray> compressed;
+    vtkNew<vtkUnsignedCharArray> decompressed;
+    for (size_t cc = 0; cc < frames.size(); ++cc)
+      {
+      vtkUnsignedCharArray* frame = frames[cc];
+      compressor->SetLossLessMode(1);
+      compressor->SetInput(frame);
+      timer->StartTimer();
+      compressor->Compress();
+      timer->StopTimer();
+      compressTime += timer->GetElapsedTime();
+      compressed->DeepCopy(compressor->GetOutput());
+
+      decompressed->SetNumberOfComponents(frame->GetNumberOfComponents());
+      decompressed->SetNumberOfTuples(frame->GetNumberOfTuples());
+      decompressor->SetLossLessMode(1);
+      decompressor->SetInput(compressed.GetPointer());
+      decompressor->SetOutput(decompressed.GetPointer());
+      timer->StartTimer();
+      decompressor->Decompress();
+      timer->StopTimer();
+      decompressTime += timer->GetElapsedTime();
+
+      size_t size = static_cast<size_t>(frame->GetNumberOfTuples()) *
+        frame->GetNumberOfComponents();
+      if (memcmp(frame->GetPointer(0), decompressed->GetPointer(0), size) != 0)
+        {
+        cerr << "ERROR: " << configuration << " did not reproduce frame "
+          << cc << endl;
+        return false;
+        }
+      rawBytes += size;
+      compressedBytes += compressed->GetNumberOfTuples();
+      }
+
+    const double mb = rawBytes / (1024.0 * 1024.0);
+    cout << configuration << ":" << endl
+      << "  compress:   " << (compressTime > 0? mb / compressTime : 0.0)
+      << " MB/s" << endl
+      << "  decompress: " << (decompressTime > 0? mb / decompressTime : 0.0)
+      << " MB/s" << endl
+      << "  ratio:      "
+      << (compressedBytes > 0? rawBytes / compressedBytes : 0.0) << endl;
+    return true;
+    }
+
+  // Appends a Squirt run of count pixels of the given opaque color, as
+  // the single band format stores it.
+  void AppendSquirtRun(std::vector<unsigned char>& stream,
+    unsigned char r, unsigned char g, unsigned char b, int count)
+    {
+    stream.push_back(r);
+    stream.push_back(g);
+    stream.push_back(b);
+    stream.push_back(static_cast<unsigned char>((count - 1) | 0x80));
+    }
+
+  int Decompress(vtkImageCompressor* decompressor,
+    const unsigned char* data, vtkIdType size, vtkUnsignedCharArray* output)
+    {
+    vtkNew<vtkUnsignedCharArray> input;
+    input->SetNumberOfComponents(1);
+    input->SetNumberOfTuples(size);
+    memcpy(input->GetPointer(0), data, size);
+    decompressor->SetInput(input.GetPointer());
+    decompressor->SetOutput(output);
+    return decompressor->Decompress();
+    }
+
+  // Checks the Squirt streams that the benchmark does not produce: the
+  // single band format of older versions, RGB images and corrupted band
+  // tables.
+  bool TestSquirtFormats()
+    {
+    vtkSmartPointer<vtkImageCompressor> squirt;
+    squirt.TakeReference(
+      vtkImageCompressor::NewCompressor("vtkSquirtCompressor"));
+    squirt->SetLossLessMode(1);
+
+    // 100 red pixels followed by 200 blue pixels, in runs of at most 128.
+    std::vector<unsigned char> single;
+    AppendSquirtRun(single, 255, 0, 0, 100);
+    AppendSquirtRun(single, 0, 0, 255, 128);
+    AppendSquirtRun(single, 0, 0, 255, 72);
+    vtkNew<vtkUnsignedCharArray> image;
+    image->SetNumberOfComponents(4);
+    image->SetNumberOfTuples(300);
+    if (Decompress(squirt, &single[0], static_cast<vtkIdType>(single.size()),
+        image.GetPointer()) != VTK_OK)
+      {
+      cerr << "ERROR: Single band stream was not decoded." << endl;
+      return false;
+      }
+    for (vtkIdType cc = 0; cc < 300; ++cc)
+      {
+      const unsigned char* pixel = image->GetPointer(4 * cc);
+      unsigned char red = cc < 100? 255 : 0;
+      if (pixel[0] != red || pixel[1] != 0 || pixel[2] != 255 - red ||
+        pixel[3] != 0xff)
+        {
+        cerr << "ERROR: Wrong pixel " << cc << " in single band stream."
+          << endl;
+        return false;
+        }
+      }
+
+    // RGB images are decoded with three bytes per pixel. The frame is
+    // large enough to be split in several bands.
+    vtkSmartPointer<vtkUnsignedCharArray> rgba = MakeFrame(1920, 1080, 3);
+    vtkNew<vtkUnsignedCharArray> rgb;
+    rgb->SetNumberOfComponents(3);
+    rgb->SetNumberOfTuples(rgba->GetNumberOfTuples());
+    for (vtkIdType cc = 0; cc < rgb->GetNumberOfTuples(); ++cc)
+      {
+      memcpy(rgb->GetPointer(3 * cc), rgba->GetPointer(4 * cc), 3);
+      }
+    vtkSmartPointer<vtkImageCompressor> compressor;
+    compressor.TakeReference(
+      vtkImageCompressor::NewCompressor("vtkSquirtCompressor"));
+    compressor->SetLossLessMode(1);
+    compressor->SetInput(rgb.GetPointer());
+    if (compressor->Compress() != VTK_OK)
+      {
+      cerr << "ERROR: RGB image was not compressed." << endl;
+      return false;
+      }
+    vtkUnsignedCharArray* compressed = compressor->GetOutput();
+    vtkNew<vtkUnsignedCharArray> decompressed;
+    decompressed->SetNumberOfComponents(3);
+    decompressed->SetNumberOfTuples(rgb->GetNumberOfTuples());
+    if (Decompress(squirt, compressed->GetPointer(0),
+        compressed->GetNumberOfTuples(), decompressed.GetPointer()) !=
+      VTK_OK || memcmp(rgb->GetPointer(0), decompressed->GetPointer(0),
+        3 * rgb->GetNumberOfTuples()) != 0)
+      {
+      cerr << "ERROR: RGB image was not reproduced." << endl;
+      return false;
+      }
+
+    // The band table holds the number of bands, then the number of pixels
+    // and of words of each band, as little-endian 32 bit integers.
+    std::vector<unsigned char> banded(compressed->GetPointer(0),
+      compressed->GetPointer(0) + compressed->GetNumberOfTuples());
+    if (banded.size() < 24 || banded[4] < 2)
+      {
+      cerr << "ERROR: RGB image was not split in bands." << endl;
+      return false;
+      }
+
+    // A table whose pixel counts add up but do not match the runs of the
+    // bands must be reported. Move 256 pixels from the second band to the
+    // first, bands hold far more pixels than that.
+    std::vector<unsigned char> corrupted(banded);
+    corrupted[9]++;
+    corrupted[17]--;
+    if (Decompress(squirt, &corrupted[0],
+        static_cast<vtkIdType>(corrupted.size()), decompressed.GetPointer())
+      != VTK_ERROR)
+      {
+      cerr << "ERROR: Corrupted band table was not detected." << endl;
+      return false;
+      }
+
+    // A table that does not match the stream size is decoded as a single
+    // band stream, which must stay within the output.
+    corrupted = banded;
+    corrupted[4] = 0xff;
+    Decompress(squirt, &corrupted[0],
+      static_cast<vtkIdType>(corrupted.size()), decompressed.GetPointer());
+    corrupted.resize(8);
+    Decompress(squirt, &corrupted[0],
+      static_cast<vtkIdType>(corrupted.size()), decompressed.GetPointer());
+    return true;
+    }
+}
+
+int TestImageCompressors(int argc, char* argv[])
+{
+  std::vector<vtkSmartPointer<vtkUnsignedCharArray> > frames;
+  for (int cc = 1; cc < argc; ++cc)
+    {
+    std::string arg = argv[cc];
+    if (arg.size() > 4 && arg.substr(arg.size() - 4) == ".png")
+      {
+      vtkSmartPointer<vtkUnsignedCharArray> frame = ReadFrame(argv[cc]);
+      if (frame)
+        {
+        frames.push_back(frame);
+        }
+      }
+    }
+  if (frames.empty())
+    {
+    for (int cc = 0; cc < 10; ++cc)
+      {
+      frames.push_back(MakeFrame(1920, 1080, cc));
+      }
+    }
+
+  const char* configurations[] = {
+    "vtkSquirtCompressor 1 0",
+    "vtkZlibImageCompressor 1 1 0 0",
+    "vtkLZ4ImageCompressor 1 0",
+    "vtkLZ4ImageCompressor 1 1",
+    NULL
+  };
+  bool success = TestSquirtFormats();
+  for (int cc = 0; configurations[cc] != NULL; ++cc)
+    {
+    success = Benchmark(configurations[cc], frames) && success;
+    }
+  return success? 0 : 1;
+}
@@ -0,0 +1,263 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestIntegrateAttributes.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Integrates a multiblock dataset mixing voxels, hexahedra, polygons and
+// lines, and an unstructured grid whose first cells are lines followed by
+// surface cells, and checks the results of the cells integrated in parallel
+// against the results of the same cells integrated one at a time. Only the
+// cells of the highest dimension are integrated, even by the threads that
+// only see lines.
+
+#include "vtkAppendFilter.h"
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCylinderSource.h"
+#include "vtkDataArray.h"
+#include "vtkElevationFilter.h"
+#include "vtkExtractCells.h"
+#include "vtkImageData.h"
+#include "vtkIntegrateAttributes.h"
+#include "vtkLineSource.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPointDataToCellData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+
+namespace
+{
+  // A grid of n^3 hexahedra, integrated as general 3D cells.
+  vtkSmartPointer<vtkUnstructuredGrid> CreateHexahedra(int n)
+    {
+    vtkNew<vtkPoints> points;
+    for (int k = 0; k <= n; ++k)
+      {
+      for (int j = 0; j <= n; ++j)
+        {
+        for (int i = 0; i <= n; ++i)
+          {
+          points->InsertNextPoint(i, j + 0.1 * i, k + 0.2 * j);
+          }
+        }
+      }
+    vtkSmartPointer<vtkUnstructuredGrid> grid =
+      vtkSmartPointer<vtkUnstructuredGrid>::New();
+    grid->SetPoints(points.GetPointer());
+    grid->Allocate(n * n * n);
+    const vtkIdType row = n + 1;
+    const vtkIdType slice = row * row;
+    for (int k = 0; k < n; ++k)
+      {
+      for (int j = 0; j < n; ++j)
+        {
+        for (int i = 0; i < n; ++i)
+          {
+          vtkIdType p = i + j * row + k * slice;
+          vtkIdType ids[8] = { p, p + 1, p + row + 1, p + row,
+            p + slice, p + slice + 1, p + slice + row + 1, p + slice + row };
+          grid->InsertNextCell(VTK_HEXAHEDRON, 8, ids);
+          }
+        }
+      }
+    return grid;
+    }
+
+  // A row of n lines.
+  vtkSmartPointer<vtkUnstructuredGrid> CreateLines(int n)
+    {
+    vtkNew<vtkPoints> points;
+    vtkSmartPointer<vtkUnstructuredGrid> grid =
+      vtkSmartPointer<vtkUnstructuredGrid>::New();
+    grid->Allocate(n);
+    for (int i = 0; i < n; ++i)
+      {
+      vtkIdType ids[2] = { points->InsertNextPoint(i, -3, 0),
+        points->InsertNextPoint(i + 0.5, -3, 0.5) };
+      grid->InsertNextCell(VTK_LINE, 2, ids);
+      }
+    grid->SetPoints(points.GetPointer());
+    return grid;
+    }
+
+  // Adds point and cell attributes to every block.
+  vtkSmartPointer<vtkDataObject> AddAttributes(vtkDataObject* input)
+    {
+    vtkNew<vtkElevationFilter> elevation;
+    elevation->SetInputData(input);
+    elevation->SetLowPoint(0, 0, -1);
+    elevation->SetHighPoint(1, 2, 10);
+    vtkNew<vtkPointDataToCellData> cellData;
+    cellData->SetInputConnection(elevation->GetOutputPort());
+    cellData->PassPointDataOn();
+    cellData->Update();
+    return cellData->GetOutputDataObject(0);
+    }
+
+  // Moves every cell to a block of its own: each block is then integrated
+  // by a single thread whatever the vtkSMPTools backend.
+  void SplitCells(vtkDataSet* input, vtkMultiBlockDataSet* output)
+    {
+    for (vtkIdType cc = 0; cc < input->GetNumberOfCells(); ++cc)
+      {
+      vtkNew<vtkExtractCells> extract;
+      extract->SetInputData(input);
+      extract->AddCellRange(cc, cc);
+      extract->Update();
+      output->SetBlock(output->GetNumberOfBlocks(), extract->GetOutput());
+      }
+    }
+
+  vtkSmartPointer<vtkMultiBlockDataSet> SplitCells(vtkDataObject* input)
+    {
+    vtkSmartPointer<vtkMultiBlockDataSet> output =
+      vtkSmartPointer<vtkMultiBlockDataSet>::New();
+    vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(input);
+    if (!cd)
+      {
+      SplitCells(vtkDataSet::SafeDownCast(input), output);
+      return output;
+      }
+    vtkSmartPointer<vtkCompositeDataIterator> iter;
+    iter.TakeReference(cd->NewIterator());
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      SplitCells(vtkDataSet::SafeDownCast(iter->GetCurrentDataObject()),
+        output);
+      }
+    return output;
+    }
+
+  vtkSmartPointer<vtkUnstructuredGrid> Integrate(vtkDataObject* input)
+    {
+    vtkNew<vtkIntegrateAttributes> integrate;
+    integrate->SetController(NULL);
+    integrate->SetInputData(input);
+    integrate->Update();
+    return integrate->GetOutput();
+    }
+
+  bool SameValues(vtkDataArray* array, vtkDataArray* expected)
+    {
+    if (!expected ||
+      expected->GetNumberOfComponents() != array->GetNumberOfComponents())
+      {
+      cerr << "Unexpected array " << array->GetName() << endl;
+      return false;
+      }
+    for (int cc = 0; cc < array->GetNumberOfComponents(); ++cc)
+      {
+      double value = array->GetComponent(0, cc);
+      double reference = expected->GetComponent(0, cc);
+      if (fabs(value - reference) > 1e-9 * (1.0 + fabs(reference)))
+        {
+        cerr << array->GetName() << "[" << cc << "] is " << value
+          << ", expected " << reference << endl;
+        return false;
+        }
+      }
+    return true;
+    }
+
+  // Integrates the cells of input in parallel and one at a time, checks that
+  // the results match and that the length, area or volume is named after
+  // the expected dimension.
+  bool CheckIntegration(vtkDataObject* input, const char* sumName)
+    {
+    vtkSmartPointer<vtkUnstructuredGrid> result = Integrate(input);
+    vtkSmartPointer<vtkUnstructuredGrid> expected =
+      Integrate(SplitCells(input));
+    if (result->GetNumberOfPoints() != 1 ||
+      expected->GetNumberOfPoints() != 1 ||
+      !result->GetCellData()->GetArray(sumName))
+      {
+      cerr << "No " << sumName << " integrated." << endl;
+      return false;
+      }
+    if (!SameValues(result->GetPoints()->GetData(),
+        expected->GetPoints()->GetData()))
+      {
+      return false;
+      }
+    vtkDataSetAttributes* attributes[2] =
+      { result->GetPointData(), result->GetCellData() };
+    vtkDataSetAttributes* expectedAttributes[2] =
+      { expected->GetPointData(), expected->GetCellData() };
+    for (int a = 0; a < 2; ++a)
+      {
+      if (attributes[a]->GetNumberOfArrays() == 0)
+        {
+        cerr << "No attributes integrated." << endl;
+        return false;
+        }
+      for (int cc = 0; cc < attributes[a]->GetNumberOfArrays(); ++cc)
+        {
+        vtkDataArray* array = attributes[a]->GetArray(cc);
+        if (!SameValues(array,
+            expectedAttributes[a]->GetArray(array->GetName())))
+          {
+          return false;
+          }
+        }
+      }
+    return true;
+    }
+}
+
+int TestIntegrateAttributes(int, char*[])
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(12, 12, 12);
+  image->SetOrigin(-20, 0, 0);
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(40);
+  sphere->SetPhiResolution(40);
+  sphere->Update();
+  vtkNew<vtkLineSource> line;
+  line->SetResolution(500);
+  line->Update();
+  vtkNew<vtkCylinderSource> cylinder;
+  cylinder->SetResolution(30);
+  cylinder->Update();
+
+  vtkNew<vtkMultiBlockDataSet> blocks;
+  blocks->SetBlock(0, line->GetOutput());
+  blocks->SetBlock(1, image.GetPointer());
+  blocks->SetBlock(2, sphere->GetOutput());
+  blocks->SetBlock(3, CreateHexahedra(10));
+  blocks->SetBlock(4, cylinder->GetOutput());
+  if (!CheckIntegration(AddAttributes(blocks.GetPointer()), "Volume"))
+    {
+    cerr << "Wrong integrals of the multiblock dataset." << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Lines first, so that some threads only see cells of a lower dimension.
+  vtkNew<vtkAppendFilter> append;
+  append->AddInputData(CreateLines(2000));
+  append->AddInputConnection(sphere->GetOutputPort());
+  append->AddInputConnection(cylinder->GetOutputPort());
+  append->Update();
+  if (!CheckIntegration(AddAttributes(append->GetOutput()), "Area"))
+    {
+    cerr << "Wrong integrals of the mixed-dimension grid." << endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
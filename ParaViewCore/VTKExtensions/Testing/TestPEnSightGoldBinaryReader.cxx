@@ -0,0 +1,433 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPEnSightGoldBinaryReader.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Writes EnSight Gold binary cases made of an iblanked structured part and
+// a hexahedral part, in C and in Fortran binary, reads them back with
+// vtkPEnSightGoldBinaryReader on all processes, checks the cells, points and
+// blanking that were read and reports the time the read takes.
+//
+// The number of points along each side of the hexahedral part can be given
+// with "--points-per-side <n>". The default writes about 40 MB; 400 writes a
+// case of about 2.8 GB, which is the size the reader is meant to handle
+// quickly.
+
+#include "vtkCellData.h"
+#include "vtkDataSet.h"
+#include "vtkMPIController.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPEnSightGoldBinaryReader.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
+#include "vtkStructuredGrid.h"
+#include "vtkTestUtilities.h"
+#include "vtkTimerLog.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  // Points along each side of the structured part.
+  const int STRUCTURED_SIDE = 20;
+
+  // Writes the records of a C or a Fortran binary file. Each Fortran record
+  // is enclosed in its size.
+  class EnSightFile
+    {
+  public:
+    EnSightFile(const std::string& name, bool fortran) :
+      File(name.c_str(), ios::out | ios::binary), Fortran(fortran) {}
+
+    void WriteMarker(size_t size)
+      {
+      if (this->Fortran)
+        {
+        int marker = static_cast<int>(size);
+        this->File.write(reinterpret_cast<const char*>(&marker),
+          sizeof(int));
+        }
+      }
+
+    void Write(const void* data, size_t size)
+      {
+      this->File.write(static_cast<const char*>(data), size);
+      }
+
+    void WriteString(const char* value)
+      {
+      char line[80];
+      memset(line, 0, 80);
+      strncpy(line, value, 79);
+      this->WriteMarker(80);
+      this->Write(line, 80);
+      this->WriteMarker(80);
+      }
+
+    void WriteInts(const int* values, int count)
+      {
+      this->WriteMarker(count * sizeof(int));
+      this->Write(values, count * sizeof(int));
+      this->WriteMarker(count * sizeof(int));
+      }
+
+    void WriteInt(int value)
+      {
+      this->WriteInts(&value, 1);
+      }
+
+    bool Good() { return this->File.good(); }
+
+  private:
+    std::ofstream File;
+    bool Fortran;
+    };
+
+  // The point (i, j, k) of the structured part is blanked when this is true.
+  bool IsBlanked(int i, int j, int k)
+    {
+    return (i + 2 * j + 3 * k) % 7 == 0;
+    }
+
+  // The point (i, j, k) of the structured part is at (n + 1 + i, j, k), the
+  // point (i, j, k) of the hexahedral part is at (i, j, k).
+  bool WriteCase(const std::string& directory, const std::string& name,
+    bool fortran, int n)
+    {
+    std::string caseName = directory + "/" + name + ".case";
+    std::ofstream caseFile(caseName.c_str());
+    caseFile << "FORMAT\n"
+             << "type: ensight gold\n\n"
+             << "GEOMETRY\n"
+             << "model: " << name << ".geo\n";
+    if (!caseFile)
+      {
+      return false;
+      }
+
+    EnSightFile geo(directory + "/" + name + ".geo", fortran);
+    geo.WriteString(fortran ? "Fortran Binary" : "C Binary");
+    geo.WriteString(name.c_str());
+    geo.WriteString("structured and hexahedral blocks");
+    geo.WriteString("node id off");
+    geo.WriteString("element id off");
+
+    // The structured part comes first, so that the hexahedral part is only
+    // found if its coordinates and iblanks were read to the end.
+    const int s = STRUCTURED_SIDE;
+    geo.WriteString("part");
+    geo.WriteInt(1);
+    geo.WriteString("structured");
+    geo.WriteString("block iblanked");
+    const int dimensions[3] = { s, s, s };
+    geo.WriteInts(dimensions, 3);
+    std::vector<float> sValues(s * s * s);
+    for (int comp = 0; comp < 3; comp++)
+      {
+      float* value = &sValues[0];
+      for (int k = 0; k < s; k++)
+        {
+        for (int j = 0; j < s; j++)
+          {
+          for (int i = 0; i < s; i++)
+            {
+            *value++ = static_cast<float>(comp == 0 ? n + 1 + i :
+              (comp == 1 ? j : k));
+            }
+          }
+        }
+      geo.WriteMarker(sValues.size() * sizeof(float));
+      geo.Write(&sValues[0], sValues.size() * sizeof(float));
+      geo.WriteMarker(sValues.size() * sizeof(float));
+      }
+    std::vector<int> iblanks(s * s * s);
+    for (int k = 0; k < s; k++)
+      {
+      for (int j = 0; j < s; j++)
+        {
+        for (int i = 0; i < s; i++)
+          {
+          iblanks[i + s * (j + s * k)] = IsBlanked(i, j, k) ? 0 : 1;
+          }
+        }
+      }
+    geo.WriteInts(&iblanks[0], s * s * s);
+
+    geo.WriteString("part");
+    geo.WriteInt(2);
+    geo.WriteString("block");
+    geo.WriteString("coordinates");
+    geo.WriteInt(n * n * n);
+    std::vector<float> values(n);
+    const size_t coordinatesSize =
+      static_cast<size_t>(n) * n * n * sizeof(float);
+    for (int comp = 0; comp < 3; comp++)
+      {
+      geo.WriteMarker(coordinatesSize);
+      for (int k = 0; k < n; k++)
+        {
+        for (int j = 0; j < n; j++)
+          {
+          for (int i = 0; i < n; i++)
+            {
+            values[i] = static_cast<float>(comp == 0 ? i :
+              (comp == 1 ? j : k));
+            }
+          geo.Write(&values[0], n * sizeof(float));
+          }
+        }
+      geo.WriteMarker(coordinatesSize);
+      }
+
+    const int m = n - 1;
+    geo.WriteString("hexa8");
+    geo.WriteInt(m * m * m);
+    const size_t connectivitySize =
+      static_cast<size_t>(m) * m * m * 8 * sizeof(int);
+    geo.WriteMarker(connectivitySize);
+    std::vector<int> cells(8 * m);
+    for (int k = 0; k < m; k++)
+      {
+      for (int j = 0; j < m; j++)
+        {
+        for (int i = 0; i < m; i++)
+          {
+          // EnSight ids start at 1.
+          int p = 1 + i + n * (j + n * k);
+          int* cell = &cells[8 * i];
+          cell[0] = p;
+          cell[1] = p + 1;
+          cell[2] = p + 1 + n;
+          cell[3] = p + n;
+          cell[4] = p + n * n;
+          cell[5] = p + 1 + n * n;
+          cell[6] = p + 1 + n + n * n;
+          cell[7] = p + n + n * n;
+          }
+        geo.Write(&cells[0], cells.size() * sizeof(int));
+        }
+      }
+    geo.WriteMarker(connectivitySize);
+    return geo.Good();
+    }
+
+  // Every point of the local piece of the structured part is a node of its
+  // lattice, and is blanked if and only if it was written blanked.
+  bool CheckStructuredPart(vtkDataObject* block, int rank, int n,
+    vtkIdType* numCells)
+    {
+    vtkStructuredGrid* part = vtkStructuredGrid::SafeDownCast(block);
+    if (!part)
+      {
+      cerr << "ERROR: process " << rank << " has no structured part."
+        << endl;
+      return false;
+      }
+    int dims[3];
+    part->GetDimensions(dims);
+    vtkIdType numPts = part->GetNumberOfPoints();
+    if (static_cast<vtkIdType>(dims[0]) * dims[1] * dims[2] != numPts)
+      {
+      cerr << "ERROR: process " << rank << " read " << numPts
+        << " structured points for dimensions " << dims[0] << " x "
+        << dims[1] << " x " << dims[2] << "." << endl;
+      return false;
+      }
+    for (vtkIdType cc = 0; cc < numPts; cc++)
+      {
+      double pt[3];
+      part->GetPoint(cc, pt);
+      int ijk[3] = { static_cast<int>(pt[0]) - n - 1,
+        static_cast<int>(pt[1]), static_cast<int>(pt[2]) };
+      for (int comp = 0; comp < 3; comp++)
+        {
+        if (ijk[comp] < 0 || ijk[comp] >= STRUCTURED_SIDE ||
+          pt[comp] != static_cast<int>(pt[comp]))
+          {
+          cerr << "ERROR: process " << rank << " read structured point "
+            << cc << " at (" << pt[0] << ", " << pt[1] << ", " << pt[2]
+            << ")." << endl;
+          return false;
+          }
+        }
+      if ((part->IsPointVisible(cc) != 0) ==
+        IsBlanked(ijk[0], ijk[1], ijk[2]))
+        {
+        cerr << "ERROR: process " << rank << " has a wrong blanking for "
+          << "structured point " << cc << "." << endl;
+        return false;
+        }
+      }
+    *numCells = part->GetNumberOfCells();
+    return true;
+    }
+
+  bool CheckHexahedralPart(vtkDataObject* block, int rank, int n,
+    vtkIdType* numCells)
+    {
+    vtkPointSet* part = vtkPointSet::SafeDownCast(block);
+    if (!part)
+      {
+      cerr << "ERROR: process " << rank << " has no hexahedral part."
+        << endl;
+      return false;
+      }
+
+    // Every point is a node of the lattice and the first cell is a unit cube.
+    vtkPoints* points = part->GetPoints();
+    vtkIdType numPts = points ? points->GetNumberOfPoints() : 0;
+    for (vtkIdType cc = 0; cc < numPts; cc++)
+      {
+      double pt[3];
+      points->GetPoint(cc, pt);
+      for (int comp = 0; comp < 3; comp++)
+        {
+        if (pt[comp] < 0 || pt[comp] > n - 1 ||
+          pt[comp] != static_cast<int>(pt[comp]))
+          {
+          cerr << "ERROR: process " << rank << " read point " << cc << " at ("
+            << pt[0] << ", " << pt[1] << ", " << pt[2] << ")." << endl;
+          return false;
+          }
+        }
+      }
+    *numCells = part->GetNumberOfCells();
+    if (*numCells > 0)
+      {
+      double bounds[6];
+      part->GetCellBounds(0, bounds);
+      if (bounds[1] - bounds[0] != 1 || bounds[3] - bounds[2] != 1 ||
+        bounds[5] - bounds[4] != 1)
+        {
+        cerr << "ERROR: process " << rank << " read a wrong first cell."
+          << endl;
+        return false;
+        }
+      }
+    return true;
+    }
+
+  bool Run(vtkMultiProcessController* controller, const std::string& directory,
+    int n, bool fortran)
+    {
+    const int rank = controller->GetLocalProcessId();
+    const int numProcs = controller->GetNumberOfProcesses();
+    const std::string name = fortran ?
+      "TestPEnSightGoldBinaryReaderFortran" : "TestPEnSightGoldBinaryReader";
+
+    int written = 1;
+    if (rank == 0)
+      {
+      written = WriteCase(directory, name, fortran, n) ? 1 : 0;
+      }
+    controller->Broadcast(&written, 1, 0);
+    if (!written)
+      {
+      if (rank == 0)
+        {
+        cerr << "ERROR: could not write the case in " << directory << endl;
+        }
+      return false;
+      }
+
+    vtkNew<vtkPEnSightGoldBinaryReader> reader;
+    reader->SetCaseFileName((name + ".case").c_str());
+    reader->SetFilePath(directory.c_str());
+
+    controller->Barrier();
+    vtkNew<vtkTimerLog> timer;
+    timer->StartTimer();
+    reader->Update();
+    timer->StopTimer();
+    double localTime = timer->GetElapsedTime();
+    double time = 0.0;
+    controller->Reduce(&localTime, &time, 1, vtkCommunicator::MAX_OP, 0);
+
+    vtkMultiBlockDataSet* output = reader->GetOutput();
+    if (!output || output->GetNumberOfBlocks() != 2)
+      {
+      cerr << "ERROR: process " << rank << " did not read two parts."
+        << endl;
+      return false;
+      }
+    vtkIdType numCells[2] = { 0, 0 };
+    if (!CheckStructuredPart(output->GetBlock(0), rank, n, &numCells[0]) ||
+      !CheckHexahedralPart(output->GetBlock(1), rank, n, &numCells[1]))
+      {
+      return false;
+      }
+
+    vtkIdType totalCells[2] = { 0, 0 };
+    controller->Reduce(numCells, totalCells, 2, vtkCommunicator::SUM_OP, 0);
+    if (rank != 0)
+      {
+      return true;
+      }
+    const vtkIdType expectedCells[2] = {
+      static_cast<vtkIdType>(STRUCTURED_SIDE - 1) * (STRUCTURED_SIDE - 1) *
+      (STRUCTURED_SIDE - 1),
+      static_cast<vtkIdType>(n - 1) * (n - 1) * (n - 1) };
+    for (int cc = 0; cc < 2; cc++)
+      {
+      if (totalCells[cc] != expectedCells[cc])
+        {
+        cerr << "ERROR: read " << totalCells[cc] << " cells instead of "
+          << expectedCells[cc] << " in part " << cc + 1 << "." << endl;
+        return false;
+        }
+      }
+
+    const double size =
+      (12.0 * n * n * n + 32.0 * expectedCells[1]) / (1024.0 * 1024.0);
+    cout << (fortran ? "Fortran" : "C") << " binary"
+      << " processes: " << numProcs
+      << " points: " << static_cast<vtkIdType>(n) * n * n
+      << " cells: " << expectedCells[1]
+      << " size: " << size << " MB"
+      << " time: " << 1000.0 * time << " ms"
+      << " (" << size / time << " MB/s)" << endl;
+    return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  int n = 100;
+  for (int i = 1; i < argc - 1; i++)
+    {
+    if (strcmp(argv[i], "--points-per-side") == 0)
+      {
+      n = atoi(argv[i + 1]);
+      }
+    }
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+
+  int success = n > 1 && Run(controller, tempDir, n, false) &&
+    Run(controller, tempDir, n, true) ? 1 : 0;
+  delete [] tempDir;
+  int allSuccess = 0;
+  controller->AllReduce(&success, &allSuccess, 1, vtkCommunicator::MIN_OP);
+
+  controller->Finalize();
+  controller->Delete();
+  return allSuccess? 0 : 1;
+}
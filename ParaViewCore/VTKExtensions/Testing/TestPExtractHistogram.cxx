@@ -0,0 +1,149 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPExtractHistogram.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Computes a histogram with averages of a distributed dataset, checks the
+// result on the root node against the expected bins and reports the time it
+// takes for the number of processes it runs with. Running it with increasing
+// numbers of processes gives the scaling of vtkPExtractHistogram.
+
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkPExtractHistogram.h"
+#include "vtkPointData.h"
+#include "vtkTable.h"
+#include "vtkTimerLog.h"
+
+#include <math.h>
+#include <vector>
+
+namespace
+{
+  const int NUMBER_OF_VALUES = 1000000;
+  const int NUMBER_OF_BINS = 1000;
+  const int RANGE = 100000;
+
+  // Value of the i-th point of a process, spread over [0, RANGE - 1].
+  int GetValue(int rank, int i)
+    {
+    return static_cast<int>(
+      (static_cast<long long>(rank) * NUMBER_OF_VALUES + i) * 7919 % RANGE);
+    }
+
+  bool Run(vtkMultiProcessController* controller)
+    {
+    const int rank = controller->GetLocalProcessId();
+    const int numProcs = controller->GetNumberOfProcesses();
+
+    vtkNew<vtkImageData> image;
+    image->SetDimensions(NUMBER_OF_VALUES, 1, 1);
+    vtkNew<vtkIntArray> values;
+    values->SetName("values");
+    values->SetNumberOfTuples(NUMBER_OF_VALUES);
+    vtkNew<vtkDoubleArray> doubled;
+    doubled->SetName("doubled");
+    doubled->SetNumberOfTuples(NUMBER_OF_VALUES);
+    for (int i = 0; i < NUMBER_OF_VALUES; ++i)
+      {
+      values->SetValue(i, GetValue(rank, i));
+      doubled->SetValue(i, 2.0 * GetValue(rank, i));
+      }
+    image->GetPointData()->AddArray(values.GetPointer());
+    image->GetPointData()->AddArray(doubled.GetPointer());
+
+    vtkNew<vtkPExtractHistogram> histogram;
+    histogram->SetController(controller);
+    histogram->SetInputData(image.GetPointer());
+    histogram->SetInputArrayToProcess(0, 0, 0,
+      vtkDataObject::FIELD_ASSOCIATION_POINTS, "values");
+    histogram->SetBinCount(NUMBER_OF_BINS);
+    histogram->SetCalculateAverages(1);
+
+    controller->Barrier();
+    vtkNew<vtkTimerLog> timer;
+    timer->StartTimer();
+    histogram->Update();
+    timer->StopTimer();
+    double localTime = timer->GetElapsedTime();
+    double time = 0.0;
+    controller->Reduce(&localTime, &time, 1, vtkCommunicator::MAX_OP, 0);
+    if (rank != 0)
+      {
+      return true;
+      }
+
+    // Expected bins over all processes.
+    const double binDelta = (RANGE - 1.0) / NUMBER_OF_BINS;
+    std::vector<int> counts(NUMBER_OF_BINS, 0);
+    std::vector<double> totals(NUMBER_OF_BINS, 0.0);
+    for (int proc = 0; proc < numProcs; ++proc)
+      {
+      for (int i = 0; i < NUMBER_OF_VALUES; ++i)
+        {
+        int value = GetValue(proc, i);
+        int bin = static_cast<int>(value / binDelta);
+        bin = bin < NUMBER_OF_BINS? bin : NUMBER_OF_BINS - 1;
+        counts[bin]++;
+        totals[bin] += 2.0 * value;
+        }
+      }
+
+    vtkTable* output = histogram->GetOutput();
+    vtkIntArray* binValues = vtkIntArray::SafeDownCast(
+      output->GetRowData()->GetArray("bin_values"));
+    vtkDataArray* averages =
+      output->GetRowData()->GetArray("doubled_average");
+    if (!binValues || !averages)
+      {
+      cerr << "ERROR: missing histogram arrays." << endl;
+      return false;
+      }
+    for (int bin = 0; bin < NUMBER_OF_BINS; ++bin)
+      {
+      double expected = counts[bin]? totals[bin] / counts[bin] : 0.0;
+      if (binValues->GetValue(bin) != counts[bin] ||
+        fabs(averages->GetTuple1(bin) - expected) > 1e-6 * (1 + expected))
+        {
+        cerr << "ERROR: unexpected values for bin " << bin << ": "
+          << binValues->GetValue(bin) << " (expected " << counts[bin]
+          << "), average " << averages->GetTuple1(bin) << " (expected "
+          << expected << ")" << endl;
+        return false;
+        }
+      }
+
+    cout << "Processes: " << numProcs
+      << " values per process: " << NUMBER_OF_VALUES
+      << " bins: " << NUMBER_OF_BINS
+      << " time: " << 1000.0 * time << " ms" << endl;
+    return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  int success = Run(controller)? 1 : 0;
+  int allSuccess = 0;
+  controller->AllReduce(&success, &allSuccess, 1, vtkCommunicator::MIN_OP);
+
+  controller->Finalize();
+  controller->Delete();
+  return allSuccess? 0 : 1;
+}
@@ -0,0 +1,278 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPFileSeriesReaderTimeIndex.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Opens a file series with vtkFileSeriesReader on all processes, sharing the
+// discovery of the time values among them and saving them to a time index,
+// and checks the time steps reported and the number of files whose time was
+// read: all of them the first time, only the first file of the series when
+// the index is reused and, in addition, the files that changed since.
+
+#include "vtkClientServerInterpreter.h"
+#include "vtkClientServerInterpreterInitializer.h"
+#include "vtkClientServerStream.h"
+#include "vtkFileSeriesReader.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTestUtilities.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <string.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const int NUMBER_OF_FILES = 8;
+
+  // Reports the single time value written in its file.
+  class vtkTestTimeReader : public vtkPolyDataAlgorithm
+    {
+  public:
+    static vtkTestTimeReader* New();
+    vtkTypeMacro(vtkTestTimeReader, vtkPolyDataAlgorithm);
+
+    vtkSetStringMacro(FileName);
+    vtkGetStringMacro(FileName);
+
+    // Number of files whose time was read by all the readers of the process.
+    static int NumberOfReads;
+
+  protected:
+    vtkTestTimeReader() : FileName(NULL)
+      {
+      this->SetNumberOfInputPorts(0);
+      }
+    ~vtkTestTimeReader()
+      {
+      this->SetFileName(NULL);
+      }
+
+    virtual int RequestInformation(vtkInformation*, vtkInformationVector**,
+      vtkInformationVector* outputVector)
+      {
+      if (!this->FileName)
+        {
+        return 1;
+        }
+      double time = 0.0;
+      std::ifstream file(this->FileName);
+      if (!(file >> time))
+        {
+        vtkErrorMacro("Cannot read " << this->FileName);
+        return 0;
+        }
+      vtkInformation* outInfo = outputVector->GetInformationObject(0);
+      outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), &time, 1);
+      NumberOfReads++;
+      return 1;
+      }
+
+    virtual int RequestData(vtkInformation*, vtkInformationVector**,
+      vtkInformationVector*)
+      {
+      return 1;
+      }
+
+    char* FileName;
+
+  private:
+    vtkTestTimeReader(const vtkTestTimeReader&); // Not implemented
+    void operator=(const vtkTestTimeReader&); // Not implemented
+    };
+  vtkStandardNewMacro(vtkTestTimeReader);
+  int vtkTestTimeReader::NumberOfReads = 0;
+
+  // Lets vtkFileSeriesReader set the file name of the reader through the
+  // interpreter, as it does for the wrapped readers.
+  int vtkTestTimeReaderCommand(vtkClientServerInterpreter*,
+    vtkObjectBase* ob, const char* method, const vtkClientServerStream& msg,
+    vtkClientServerStream&, void*)
+    {
+    vtkTestTimeReader* reader = vtkTestTimeReader::SafeDownCast(ob);
+    const char* fname = NULL;
+    if (reader && !strcmp(method, "SetFileName") &&
+      msg.GetNumberOfArguments(0) == 3 && msg.GetArgument(0, 2, &fname))
+      {
+      reader->SetFileName(fname);
+      return 1;
+      }
+    return 0;
+    }
+
+  std::string GetFileName(const std::string& directory, int index)
+    {
+    std::ostringstream fname;
+    fname << directory << "/TestPFileSeriesReaderTimeIndex_" << index
+      << ".txt";
+    return fname.str();
+    }
+
+  void WriteFile(const std::string& fname, const std::string& time)
+    {
+    std::ofstream file(fname.c_str());
+    file << time << "\n";
+    }
+
+  // Opens the series and checks the time steps reported. Returns the number
+  // of files whose time was read by all the processes.
+  int Open(vtkMultiProcessController* controller,
+    const std::string& directory, bool useTimeIndex,
+    const std::vector<double>& expected)
+    {
+    vtkNew<vtkTestTimeReader> timeReader;
+    vtkNew<vtkFileSeriesReader> reader;
+    reader->SetReader(timeReader.GetPointer());
+    reader->SetFileNameMethod("SetFileName");
+    for (int i = 0; i < NUMBER_OF_FILES; i++)
+      {
+      reader->AddFileName(GetFileName(directory, i).c_str());
+      }
+    reader->SetUseTimeIndex(useTimeIndex? 1 : 0);
+    reader->DistributeTimeDiscoveryOn();
+
+    vtkTestTimeReader::NumberOfReads = 0;
+    reader->UpdateInformation();
+    int numReads = 0;
+    controller->AllReduce(&vtkTestTimeReader::NumberOfReads, &numReads, 1,
+      vtkCommunicator::SUM_OP);
+
+    vtkInformation* outInfo = reader->GetOutputInformation(0);
+    int numTimeSteps =
+      outInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    double* timeSteps =
+      outInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    if (numTimeSteps != static_cast<int>(expected.size()))
+      {
+      cerr << "Got " << numTimeSteps << " time steps, expected "
+        << expected.size() << endl;
+      return -1;
+      }
+    for (int i = 0; i < numTimeSteps; i++)
+      {
+      if (timeSteps[i] != expected[i])
+        {
+        cerr << "Time step " << i << " is " << timeSteps[i] << ", expected "
+          << expected[i] << endl;
+        return -1;
+        }
+      }
+    return numReads;
+    }
+
+  bool Run(vtkMultiProcessController* controller, const std::string& directory)
+    {
+    const int numProcs = controller->GetNumberOfProcesses();
+    const std::string indexName =
+      directory + "/.TestPFileSeriesReaderTimeIndex_0.txt.timeindex";
+    std::vector<double> expected;
+    if (controller->GetLocalProcessId() == 0)
+      {
+      for (int i = 0; i < NUMBER_OF_FILES; i++)
+        {
+        std::ostringstream time;
+        time << 0.5 * i;
+        WriteFile(GetFileName(directory, i), time.str());
+        }
+      vtksys::SystemTools::RemoveFile(indexName.c_str());
+      }
+    for (int i = 0; i < NUMBER_OF_FILES; i++)
+      {
+      expected.push_back(0.5 * i);
+      }
+    controller->Barrier();
+
+    // Every process reads the first file, the others are split among them.
+    int numReads = Open(controller, directory, false, expected);
+    if (numReads != numProcs + NUMBER_OF_FILES - 1)
+      {
+      cerr << "Failed at " << __LINE__ << ": " << numReads << " reads" << endl;
+      return false;
+      }
+    if (vtksys::SystemTools::FileExists(indexName.c_str()))
+      {
+      cerr << "The time index was written while not in use." << endl;
+      return false;
+      }
+
+    // The first open with the index reads everything and saves it, the next
+    // one only reads the first file.
+    numReads = Open(controller, directory, true, expected);
+    controller->Barrier();
+    if (numReads != numProcs + NUMBER_OF_FILES - 1 ||
+      !vtksys::SystemTools::FileExists(indexName.c_str()))
+      {
+      cerr << "Failed at " << __LINE__ << ": " << numReads << " reads" << endl;
+      return false;
+      }
+    numReads = Open(controller, directory, true, expected);
+    controller->Barrier();
+    if (numReads != numProcs)
+      {
+      cerr << "Failed at " << __LINE__ << ": " << numReads << " reads" << endl;
+      return false;
+      }
+
+    // A file whose size changed is read again.
+    if (controller->GetLocalProcessId() == 0)
+      {
+      WriteFile(GetFileName(directory, 3), "1.75");
+      }
+    expected[3] = 1.75;
+    controller->Barrier();
+    numReads = Open(controller, directory, true, expected);
+    controller->Barrier();
+    if (numReads != numProcs + 1)
+      {
+      cerr << "Failed at " << __LINE__ << ": " << numReads << " reads" << endl;
+      return false;
+      }
+    numReads = Open(controller, directory, true, expected);
+    if (numReads != numProcs)
+      {
+      cerr << "Failed at " << __LINE__ << ": " << numReads << " reads" << endl;
+      return false;
+      }
+    return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  vtkClientServerInterpreterInitializer::GetGlobalInterpreter()->
+    AddCommandFunction("vtkTestTimeReader", vtkTestTimeReaderCommand);
+
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  int success = Run(controller, tempDir)? 1 : 0;
+  delete [] tempDir;
+  int allSuccess = 0;
+  controller->AllReduce(&success, &allSuccess, 1, vtkCommunicator::MIN_OP);
+
+  controller->Finalize();
+  controller->Delete();
+  return allSuccess? 0 : 1;
+}
@@ -0,0 +1,201 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPIntegrateAttributes.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Integrates a multiblock dataset distributed over all processes, its cells
+// integrated in parallel on each process, and checks the result against the
+// blocks of all processes integrated one cell at a time on the first
+// process. The processes 1, 4, 7... only have surfaces, whose integrals
+// are discarded, and the processes 2, 5, 8... have no data.
+
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkDataArray.h"
+#include "vtkElevationFilter.h"
+#include "vtkExtractCells.h"
+#include "vtkImageData.h"
+#include "vtkIntegrateAttributes.h"
+#include "vtkMPIController.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPointDataToCellData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+
+namespace
+{
+  // The blocks of process pid, with point and cell attributes.
+  vtkSmartPointer<vtkDataObject> CreateInput(int pid)
+    {
+    vtkNew<vtkMultiBlockDataSet> blocks;
+    if (pid % 3 == 0)
+      {
+      vtkNew<vtkImageData> image;
+      image->SetDimensions(10 + pid, 12, 8);
+      image->SetOrigin(0, 0, 10 * pid);
+      blocks->SetBlock(0, image.GetPointer());
+      vtkNew<vtkSphereSource> sphere;
+      sphere->SetCenter(0, 0, 10 * pid);
+      sphere->Update();
+      blocks->SetBlock(1, sphere->GetOutput());
+      }
+    else if (pid % 3 == 1)
+      {
+      vtkNew<vtkSphereSource> sphere;
+      sphere->SetThetaResolution(30);
+      sphere->SetCenter(pid, 0, 0);
+      sphere->Update();
+      blocks->SetBlock(0, sphere->GetOutput());
+      }
+
+    vtkNew<vtkElevationFilter> elevation;
+    elevation->SetInputData(blocks.GetPointer());
+    elevation->SetLowPoint(0, 0, -1);
+    elevation->SetHighPoint(1, 2, 10);
+    vtkNew<vtkPointDataToCellData> cellData;
+    cellData->SetInputConnection(elevation->GetOutputPort());
+    cellData->PassPointDataOn();
+    cellData->Update();
+    return cellData->GetOutputDataObject(0);
+    }
+
+  // Moves every cell of every process to a block of its own: each block is
+  // then integrated by a single thread whatever the vtkSMPTools backend.
+  vtkSmartPointer<vtkMultiBlockDataSet> SplitCells(int numProcs)
+    {
+    vtkSmartPointer<vtkMultiBlockDataSet> output =
+      vtkSmartPointer<vtkMultiBlockDataSet>::New();
+    for (int pid = 0; pid < numProcs; ++pid)
+      {
+      vtkSmartPointer<vtkDataObject> input = CreateInput(pid);
+      vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(input);
+      vtkSmartPointer<vtkCompositeDataIterator> iter;
+      iter.TakeReference(cd->NewIterator());
+      for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+        iter->GoToNextItem())
+        {
+        vtkDataSet* ds =
+          vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+        for (vtkIdType cc = 0; cc < ds->GetNumberOfCells(); ++cc)
+          {
+          vtkNew<vtkExtractCells> extract;
+          extract->SetInputData(ds);
+          extract->AddCellRange(cc, cc);
+          extract->Update();
+          output->SetBlock(output->GetNumberOfBlocks(), extract->GetOutput());
+          }
+        }
+      }
+    return output;
+    }
+
+  bool SameValues(vtkDataArray* array, vtkDataArray* expected)
+    {
+    if (!expected ||
+      expected->GetNumberOfComponents() != array->GetNumberOfComponents())
+      {
+      cerr << "Unexpected array " << array->GetName() << endl;
+      return false;
+      }
+    for (int cc = 0; cc < array->GetNumberOfComponents(); ++cc)
+      {
+      double value = array->GetComponent(0, cc);
+      double reference = expected->GetComponent(0, cc);
+      if (fabs(value - reference) > 1e-9 * (1.0 + fabs(reference)))
+        {
+        cerr << array->GetName() << "[" << cc << "] is " << value
+          << ", expected " << reference << endl;
+        return false;
+        }
+      }
+    return true;
+    }
+
+  bool CheckIntegration(vtkMultiProcessController* controller)
+    {
+    const int numProcs = controller->GetNumberOfProcesses();
+    const int myId = controller->GetLocalProcessId();
+
+    vtkSmartPointer<vtkDataObject> input = CreateInput(myId);
+    vtkNew<vtkIntegrateAttributes> integrate;
+    integrate->SetController(controller);
+    integrate->SetInputData(input);
+    integrate->Update();
+    vtkUnstructuredGrid* result = integrate->GetOutput();
+    if (myId > 0)
+      {
+      if (result->GetNumberOfPoints() != 0)
+        {
+        cerr << "Process " << myId << " has a result." << endl;
+        return false;
+        }
+      return true;
+      }
+
+    vtkNew<vtkIntegrateAttributes> reference;
+    reference->SetController(NULL);
+    reference->SetInputData(SplitCells(numProcs));
+    reference->Update();
+    vtkUnstructuredGrid* expected = reference->GetOutput();
+    if (result->GetNumberOfPoints() != 1 ||
+      !result->GetCellData()->GetArray("Volume") ||
+      !SameValues(result->GetPoints()->GetData(),
+        expected->GetPoints()->GetData()))
+      {
+      cerr << "Wrong volume or center." << endl;
+      return false;
+      }
+    vtkDataSetAttributes* attributes[2] =
+      { result->GetPointData(), result->GetCellData() };
+    vtkDataSetAttributes* expectedAttributes[2] =
+      { expected->GetPointData(), expected->GetCellData() };
+    for (int a = 0; a < 2; ++a)
+      {
+      if (attributes[a]->GetNumberOfArrays() == 0)
+        {
+        cerr << "No attributes integrated." << endl;
+        return false;
+        }
+      for (int cc = 0; cc < attributes[a]->GetNumberOfArrays(); ++cc)
+        {
+        vtkDataArray* array = attributes[a]->GetArray(cc);
+        if (!SameValues(array,
+            expectedAttributes[a]->GetArray(array->GetName())))
+          {
+          return false;
+          }
+        }
+      }
+    return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  int success = CheckIntegration(controller)? 1 : 0;
+  int allSuccess = 0;
+  controller->AllReduce(&success, &allSuccess, 1, vtkCommunicator::MIN_OP);
+
+  controller->Finalize();
+  controller->Delete();
+  return allSuccess? 0 : 1;
+}
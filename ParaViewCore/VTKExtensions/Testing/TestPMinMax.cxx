@@ -0,0 +1,222 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPMinMax.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Runs vtkMinMax with DistributedReduction on all processes and checks that
+// every process gets the min, max and sum of the tuples of all processes.
+// The processes 0, 4, 8... have no data, so that the arrays to reduce come
+// from another process. The processes 3, 7, 11... have arrays that do not
+// match the others: their values are ignored and a mismatch is reported.
+
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIntArray.h"
+#include "vtkMinMax.h"
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
+
+namespace
+{
+  // Large enough for the arrays to be split among threads.
+  const vtkIdType NUMBER_OF_TUPLES = 100000;
+
+  bool HasData(int pid)
+    {
+    return pid % 4 != 0;
+    }
+
+  bool HasMatchingArrays(int pid)
+    {
+    return pid % 4 == 1 || pid % 4 == 2;
+    }
+
+  // Every tenth tuple is a duplicate with values no other tuple has.
+  bool IsGhost(vtkIdType i)
+    {
+    return i % 10 == 3;
+    }
+
+  double ScalarValue(int pid, vtkIdType i)
+    {
+    return ((i * 7919 + 131 * pid) % 100003) - 50000.0;
+    }
+
+  int IdValue(int pid, vtkIdType i)
+    {
+    return static_cast<int>((i + 17 * pid) % 1000);
+    }
+
+  // The point data of process pid. The scalars of the processes whose
+  // arrays do not match are floats, with values out of the others' range.
+  vtkSmartPointer<vtkPolyData> CreateInput(int pid)
+    {
+    vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+    if (!HasData(pid))
+      {
+      return input;
+      }
+    vtkSmartPointer<vtkDataArray> scalars;
+    if (HasMatchingArrays(pid))
+      {
+      scalars.TakeReference(vtkDoubleArray::New());
+      }
+    else
+      {
+      scalars.TakeReference(vtkFloatArray::New());
+      }
+    scalars->SetName("scalars");
+    scalars->SetNumberOfTuples(NUMBER_OF_TUPLES);
+    vtkNew<vtkIntArray> ids;
+    ids->SetName("ids");
+    ids->SetNumberOfTuples(NUMBER_OF_TUPLES);
+    vtkNew<vtkUnsignedCharArray> ghosts;
+    ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+    ghosts->SetNumberOfTuples(NUMBER_OF_TUPLES);
+    for (vtkIdType i = 0; i < NUMBER_OF_TUPLES; i++)
+      {
+      bool ghost = IsGhost(i);
+      if (HasMatchingArrays(pid))
+        {
+        scalars->SetTuple1(i, ghost ? 1.0e9 : ScalarValue(pid, i));
+        ids->SetValue(i, ghost ? -1000 : IdValue(pid, i));
+        }
+      else
+        {
+        scalars->SetTuple1(i, i % 2 ? 1.0e6 : -1.0e6);
+        ids->SetValue(i, i % 2 ? 100000 : -100000);
+        }
+      ghosts->SetValue(i, ghost ? vtkDataSetAttributes::DUPLICATEPOINT : 0);
+      }
+    input->GetPointData()->AddArray(scalars);
+    input->GetPointData()->AddArray(ids.GetPointer());
+    input->GetPointData()->AddArray(ghosts.GetPointer());
+    return input;
+    }
+
+  double Apply(int operation, double result, double value)
+    {
+    switch (operation)
+      {
+      case vtkMinMax::MIN:
+        return value < result ? value : result;
+      case vtkMinMax::MAX:
+        return value > result ? value : result;
+      default:
+        return result + value;
+      }
+    }
+
+  // The scalars and ids reduced tuple by tuple over the processes whose
+  // arrays match. The values are integers, so that sums are exact.
+  void ComputeExpected(int operation, int numProcs, double expected[2])
+    {
+    bool first = true;
+    for (int pid = 0; pid < numProcs; pid++)
+      {
+      if (!HasMatchingArrays(pid))
+        {
+        continue;
+        }
+      for (vtkIdType i = 0; i < NUMBER_OF_TUPLES; i++)
+        {
+        if (IsGhost(i))
+          {
+          continue;
+          }
+        double values[2] = { ScalarValue(pid, i), IdValue(pid, i) };
+        for (int a = 0; a < 2; a++)
+          {
+          expected[a] = first ? values[a] :
+            Apply(operation, expected[a], values[a]);
+          }
+        first = false;
+        }
+      }
+    }
+
+  bool Check(vtkMultiProcessController* controller, int operation)
+    {
+    const int numProcs = controller->GetNumberOfProcesses();
+    const int myId = controller->GetLocalProcessId();
+
+    vtkNew<vtkMinMax> filter;
+    filter->SetController(controller);
+    filter->DistributedReductionOn();
+    filter->SetOperation(operation);
+    filter->AddInputData(CreateInput(myId));
+    filter->Update();
+
+    vtkPolyData* output = filter->GetOutput();
+    const int expectedMismatch = numProcs > 3 ? 1 : 0;
+    if (output->GetNumberOfPoints() != 1 ||
+      filter->GetMismatchOccurred() != expectedMismatch)
+      {
+      cerr << "Process " << myId << " has an unexpected output or mismatch "
+        << "for operation " << operation << "." << endl;
+      return false;
+      }
+
+    double expected[2];
+    ComputeExpected(operation, numProcs, expected);
+    const char* names[2] = { "scalars", "ids" };
+    const int types[2] = { VTK_DOUBLE, VTK_INT };
+    for (int a = 0; a < 2; a++)
+      {
+      vtkDataArray* result = output->GetPointData()->GetArray(names[a]);
+      if (!result || result->GetDataType() != types[a] ||
+        result->GetNumberOfTuples() != 1)
+        {
+        cerr << "Process " << myId << " has no result for " << names[a]
+          << "." << endl;
+        return false;
+        }
+      if (result->GetComponent(0, 0) != expected[a])
+        {
+        cerr << "Process " << myId << ": operation " << operation << " on "
+          << names[a] << " gave " << result->GetComponent(0, 0)
+          << " instead of " << expected[a] << "." << endl;
+        return false;
+        }
+      }
+    return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  // Every process runs every operation, they all take part in the same
+  // collective operations.
+  int success = 1;
+  const int operations[3] = { vtkMinMax::MIN, vtkMinMax::MAX, vtkMinMax::SUM };
+  for (int cc = 0; cc < 3; cc++)
+    {
+    if (!Check(controller, operations[cc]))
+      {
+      success = 0;
+      }
+    }
+  int allSuccess = 0;
+  controller->AllReduce(&success, &allSuccess, 1, vtkCommunicator::MIN_OP);
+
+  controller->Finalize();
+  controller->Delete();
+  return allSuccess? 0 : 1;
+}
@@ -0,0 +1,152 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPSortingTable.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Sorts a table distributed over all processes with vtkSortedTableStreamer,
+// block by block, in both orders, and checks every block against the table
+// gathered and sorted on one process: equal values are expected in process
+// order, then in the order of the rows of each process. The first process
+// holds many equal values, more than a bucket of the sort, so that they are
+// split between buckets.
+
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkSortedTableStreamer.h"
+#include "vtkTable.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+  const vtkIdType ROWS_PER_PROCESS = 40000;
+  const vtkIdType BLOCK_SIZE = 1024;
+
+  double GetValue(int pid, vtkIdType row)
+    {
+    return pid == 0? 7.0 : static_cast<double>((row * 7919 + pid * 13) % 500);
+    }
+
+  // Orders the global row ids by value only, std::stable_sort keeping equal
+  // values in process order then in row order.
+  class ValueOrder
+    {
+  public:
+    ValueOrder(bool invert) : Invert(invert) {}
+    bool operator()(vtkIdType a, vtkIdType b) const
+      {
+      double va = GetValue(static_cast<int>(a / ROWS_PER_PROCESS),
+        a % ROWS_PER_PROCESS);
+      double vb = GetValue(static_cast<int>(b / ROWS_PER_PROCESS),
+        b % ROWS_PER_PROCESS);
+      return this->Invert? va > vb : va < vb;
+      }
+  private:
+    bool Invert;
+    };
+
+  bool SortAllBlocks(vtkMultiProcessController* controller, bool invert)
+    {
+    const int numProcs = controller->GetNumberOfProcesses();
+    const int myId = controller->GetLocalProcessId();
+
+    vtkNew<vtkDoubleArray> data;
+    data->SetName("data");
+    vtkNew<vtkIdTypeArray> ids;
+    ids->SetName("ids");
+    for (vtkIdType row = 0; row < ROWS_PER_PROCESS; row++)
+      {
+      data->InsertNextValue(GetValue(myId, row));
+      ids->InsertNextValue(myId * ROWS_PER_PROCESS + row);
+      }
+    vtkNew<vtkTable> input;
+    input->AddColumn(data.GetPointer());
+    input->AddColumn(ids.GetPointer());
+
+    const vtkIdType size = numProcs * ROWS_PER_PROCESS;
+    std::vector<vtkIdType> expected(size);
+    for (vtkIdType cc = 0; cc < size; cc++)
+      {
+      expected[cc] = cc;
+      }
+    std::stable_sort(expected.begin(), expected.end(), ValueOrder(invert));
+
+    vtkNew<vtkSortedTableStreamer> sorter;
+    sorter->SetInputData(input.GetPointer());
+    sorter->SetSelectedComponent(0);
+    sorter->SetColumnNameToSort("data");
+    sorter->SetInvertOrder(invert? 1 : 0);
+    sorter->SetBlockSize(BLOCK_SIZE);
+    for (vtkIdType block = 0; block * BLOCK_SIZE < size; block++)
+      {
+      sorter->SetBlock(block);
+      sorter->Update();
+
+      // Only the merging process gets the rows of the block.
+      vtkTable* output = sorter->GetOutput();
+      vtkIdType numRows = output->GetNumberOfRows();
+      vtkIdType totalRows = 0;
+      controller->AllReduce(&numRows, &totalRows, 1, vtkCommunicator::SUM_OP);
+      const vtkIdType begin = block * BLOCK_SIZE;
+      const vtkIdType end = std::min(begin + BLOCK_SIZE, size);
+      if (totalRows != end - begin)
+        {
+        cerr << "Block " << block << " has " << totalRows << " rows." << endl;
+        return false;
+        }
+      if (numRows == 0)
+        {
+        continue;
+        }
+      vtkIdTypeArray* outIds =
+        vtkIdTypeArray::SafeDownCast(output->GetColumnByName("ids"));
+      vtkIdTypeArray* outPids = vtkIdTypeArray::SafeDownCast(
+        output->GetColumnByName("vtkOriginalProcessIds"));
+      if (!outIds || (numProcs > 1 && !outPids))
+        {
+        cerr << "Block " << block << " misses a column." << endl;
+        return false;
+        }
+      for (vtkIdType cc = 0; cc < numRows; cc++)
+        {
+        vtkIdType id = expected[begin + cc];
+        if (outIds->GetValue(cc) != id ||
+          (outPids && outPids->GetValue(cc) != id / ROWS_PER_PROCESS))
+          {
+          cerr << "Row " << begin + cc << " is " << outIds->GetValue(cc)
+            << ", expected " << id << endl;
+          return false;
+          }
+        }
+      }
+    return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  int success = SortAllBlocks(controller, false) &&
+    SortAllBlocks(controller, true)? 1 : 0;
+  int allSuccess = 0;
+  controller->AllReduce(&success, &allSuccess, 1, vtkCommunicator::MIN_OP);
+
+  controller->Finalize();
+  controller->Delete();
+  return allSuccess? 0 : 1;
+}
@@ -0,0 +1,157 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVGeometryFilterBlocks.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Extracts the surface of a multiblock dataset with many blocks one block
+// after the other and with the blocks extracted in parallel, checks that both
+// outputs match and reports the time each one takes. The unstructured blocks
+// share a point array, and share their points two by two.
+
+#include "vtkAppendFilter.h"
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkPVGeometryFilter.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <iostream>
+
+namespace
+{
+  const unsigned int NUMBER_OF_BLOCKS = 2000;
+
+  double Extract(vtkMultiBlockDataSet* input, bool threaded,
+    vtkSmartPointer<vtkMultiBlockDataSet>& output)
+    {
+    vtkNew<vtkPVGeometryFilter> filter;
+    filter->SetUseOutline(0);
+    filter->SetGenerateProcessIds(false);
+    filter->SetUseThreadedBlockExecution(threaded);
+    filter->SetInputData(input);
+
+    vtkNew<vtkTimerLog> timer;
+    timer->StartTimer();
+    filter->Update();
+    timer->StopTimer();
+    output = vtkMultiBlockDataSet::SafeDownCast(filter->GetOutputDataObject(0));
+    return timer->GetElapsedTime();
+    }
+}
+
+int TestPVGeometryFilterBlocks(int, char*[])
+{
+  // Every other block is unstructured, the others are images.
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("scalars");
+  scalars->SetNumberOfTuples(12 * 12 * 12);
+  for (vtkIdType cc = 0; cc < scalars->GetNumberOfTuples(); cc++)
+    {
+    scalars->SetValue(cc, static_cast<float>(cc % 97));
+    }
+  vtkSmartPointer<vtkUnstructuredGrid> previous;
+  vtkNew<vtkMultiBlockDataSet> input;
+  input->SetNumberOfBlocks(NUMBER_OF_BLOCKS);
+  for (unsigned int cc = 0; cc < NUMBER_OF_BLOCKS; cc++)
+    {
+    vtkNew<vtkImageData> image;
+    image->SetDimensions(12, 12, 12);
+    image->SetOrigin(12 * (cc % 50), 12 * (cc / 50), 0);
+    if (cc % 2 == 0)
+      {
+      vtkNew<vtkAppendFilter> append;
+      append->AddInputData(image.GetPointer());
+      append->Update();
+      vtkSmartPointer<vtkUnstructuredGrid> grid =
+        vtkSmartPointer<vtkUnstructuredGrid>::New();
+      grid->ShallowCopy(append->GetOutput());
+      if (cc % 4 == 2)
+        {
+        grid->SetPoints(previous->GetPoints());
+        }
+      grid->GetPointData()->AddArray(scalars.GetPointer());
+      input->SetBlock(cc, grid);
+      previous = grid;
+      }
+    else
+      {
+      input->SetBlock(cc, image.GetPointer());
+      }
+    }
+
+  vtkSmartPointer<vtkMultiBlockDataSet> serial;
+  vtkSmartPointer<vtkMultiBlockDataSet> threaded;
+  double serialTime = Extract(input.GetPointer(), false, serial);
+  double threadedTime = Extract(input.GetPointer(), true, threaded);
+  if (!serial || !threaded)
+    {
+    std::cerr << "ERROR: missing output." << std::endl;
+    return 1;
+    }
+
+  vtkSmartPointer<vtkCompositeDataIterator> serialIter;
+  serialIter.TakeReference(serial->NewIterator());
+  vtkSmartPointer<vtkCompositeDataIterator> threadedIter;
+  threadedIter.TakeReference(threaded->NewIterator());
+  unsigned int numBlocks = 0;
+  for (serialIter->InitTraversal(), threadedIter->InitTraversal();
+    !serialIter->IsDoneWithTraversal();
+    serialIter->GoToNextItem(), threadedIter->GoToNextItem(), numBlocks++)
+    {
+    vtkPolyData* a = vtkPolyData::SafeDownCast(
+      serialIter->GetCurrentDataObject());
+    vtkPolyData* b = vtkPolyData::SafeDownCast(
+      threadedIter->GetCurrentDataObject());
+    if (threadedIter->IsDoneWithTraversal() || !a || !b ||
+      serialIter->GetCurrentFlatIndex() != threadedIter->GetCurrentFlatIndex() ||
+      a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells() ||
+      a->GetPointData()->GetNumberOfArrays() !=
+      b->GetPointData()->GetNumberOfArrays() ||
+      a->GetCellData()->GetNumberOfArrays() !=
+      b->GetCellData()->GetNumberOfArrays())
+      {
+      std::cerr << "ERROR: block " << numBlocks << " differs." << std::endl;
+      return 1;
+      }
+    double boundsA[6], boundsB[6];
+    a->GetBounds(boundsA);
+    b->GetBounds(boundsB);
+    for (int i = 0; i < 6; i++)
+      {
+      if (boundsA[i] != boundsB[i])
+        {
+        std::cerr << "ERROR: bounds of block " << numBlocks << " differ."
+          << std::endl;
+        return 1;
+        }
+      }
+    }
+  if (numBlocks != NUMBER_OF_BLOCKS || !threadedIter->IsDoneWithTraversal())
+    {
+    std::cerr << "ERROR: unexpected number of blocks " << numBlocks
+      << std::endl;
+    return 1;
+    }
+
+  std::cout << "Blocks: " << NUMBER_OF_BLOCKS
+    << " serial: " << 1000.0 * serialTime << " ms"
+    << " threaded: " << 1000.0 * threadedTime << " ms" << std::endl;
+  return 0;
+}
@@ -0,0 +1,224 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVGeometryFilterSurfaceCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Extracts the surface of an unstructured grid whose points and attributes
+// change over a few timesteps while its topology does not, with and without
+// reusing the surface extracted for the previous timesteps, and checks that
+// both outputs match. Also checks that a polyhedron whose faces change while
+// its points do not gets a new surface.
+
+#include "vtkAppendFilter.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVGeometryFilter.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <iostream>
+#include <math.h>
+
+namespace
+{
+  const int NUMBER_OF_TIMESTEPS = 4;
+
+  // Moves the points of the grid and updates its attributes for a timestep.
+  void SetTimestep(vtkUnstructuredGrid* grid, vtkPoints* original, int step)
+    {
+    vtkNew<vtkPoints> points;
+    points->SetNumberOfPoints(original->GetNumberOfPoints());
+    vtkNew<vtkDoubleArray> pointValues;
+    pointValues->SetName("pointValues");
+    pointValues->SetNumberOfTuples(original->GetNumberOfPoints());
+    for (vtkIdType cc = 0; cc < original->GetNumberOfPoints(); cc++)
+      {
+      double pt[3];
+      original->GetPoint(cc, pt);
+      pt[2] += 0.1 * step * sin(pt[0]);
+      points->SetPoint(cc, pt);
+      pointValues->SetValue(cc, step * 1000.0 + cc);
+      }
+    vtkNew<vtkDoubleArray> cellValues;
+    cellValues->SetName("cellValues");
+    cellValues->SetNumberOfTuples(grid->GetNumberOfCells());
+    for (vtkIdType cc = 0; cc < grid->GetNumberOfCells(); cc++)
+      {
+      cellValues->SetValue(cc, step * 1000.0 - cc);
+      }
+    grid->SetPoints(points.GetPointer());
+    grid->GetPointData()->AddArray(pointValues.GetPointer());
+    grid->GetCellData()->AddArray(cellValues.GetPointer());
+    }
+
+  // A cube made of a single polyhedron, its top face split in two triangles
+  // when splitTop is set. The connectivity is the same either way.
+  void CreatePolyhedron(bool splitTop, vtkUnstructuredGrid* grid)
+    {
+    vtkNew<vtkPoints> points;
+    vtkIdType ptIds[8];
+    for (int cc = 0; cc < 8; cc++)
+      {
+      ptIds[cc] = points->InsertNextPoint(cc & 1, (cc >> 1) & 1, cc >> 2);
+      }
+    vtkIdType faces[] = {
+      4, 0, 2, 3, 1,
+      4, 0, 1, 5, 4,
+      4, 2, 6, 7, 3,
+      4, 0, 4, 6, 2,
+      4, 1, 3, 7, 5,
+      4, 4, 5, 7, 6 };
+    vtkIdType splitFaces[] = {
+      4, 0, 2, 3, 1,
+      4, 0, 1, 5, 4,
+      4, 2, 6, 7, 3,
+      4, 0, 4, 6, 2,
+      4, 1, 3, 7, 5,
+      3, 4, 5, 7,
+      3, 4, 7, 6 };
+    grid->Allocate(1);
+    if (splitTop)
+      {
+      grid->InsertNextCell(VTK_POLYHEDRON, 8, ptIds, 7, splitFaces);
+      }
+    else
+      {
+      grid->InsertNextCell(VTK_POLYHEDRON, 8, ptIds, 6, faces);
+      }
+    grid->SetPoints(points.GetPointer());
+    }
+
+  bool Compare(vtkPolyData* a, vtkPolyData* b, int step)
+    {
+    if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells() ||
+      a->GetNumberOfPolys() != b->GetNumberOfPolys())
+      {
+      std::cerr << "ERROR: sizes differ at timestep " << step << std::endl;
+      return false;
+      }
+    for (vtkIdType cc = 0; cc < a->GetNumberOfPoints(); cc++)
+      {
+      double ptA[3], ptB[3];
+      a->GetPoint(cc, ptA);
+      b->GetPoint(cc, ptB);
+      if (ptA[0] != ptB[0] || ptA[1] != ptB[1] || ptA[2] != ptB[2])
+        {
+        std::cerr << "ERROR: point " << cc << " differs at timestep " << step
+          << std::endl;
+        return false;
+        }
+      }
+    const char* names[2] = { "pointValues", "cellValues" };
+    for (int i = 0; i < 2; i++)
+      {
+      vtkDataSetAttributes* attrA = i == 0?
+        static_cast<vtkDataSetAttributes*>(a->GetPointData()) :
+        static_cast<vtkDataSetAttributes*>(a->GetCellData());
+      vtkDataSetAttributes* attrB = i == 0?
+        static_cast<vtkDataSetAttributes*>(b->GetPointData()) :
+        static_cast<vtkDataSetAttributes*>(b->GetCellData());
+      vtkDataArray* arrayA = attrA->GetArray(names[i]);
+      vtkDataArray* arrayB = attrB->GetArray(names[i]);
+      if (!arrayA || !arrayB ||
+        arrayA->GetNumberOfTuples() != arrayB->GetNumberOfTuples() ||
+        attrA->GetNumberOfArrays() != attrB->GetNumberOfArrays())
+        {
+        std::cerr << "ERROR: " << names[i] << " differ at timestep " << step
+          << std::endl;
+        return false;
+        }
+      for (vtkIdType cc = 0; cc < arrayA->GetNumberOfTuples(); cc++)
+        {
+        if (arrayA->GetTuple1(cc) != arrayB->GetTuple1(cc))
+          {
+          std::cerr << "ERROR: " << names[i] << " differ at timestep " << step
+            << std::endl;
+          return false;
+          }
+        }
+      }
+    return true;
+    }
+}
+
+int TestPVGeometryFilterSurfaceCache(int, char*[])
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(20, 20, 20);
+  vtkNew<vtkAppendFilter> append;
+  append->AddInputData(image.GetPointer());
+  append->Update();
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->ShallowCopy(append->GetOutput());
+  vtkNew<vtkPoints> original;
+  original->DeepCopy(grid->GetPoints());
+
+  vtkNew<vtkPVGeometryFilter> cached;
+  cached->SetUseOutline(0);
+  cached->SetGenerateProcessIds(false);
+  cached->SetInputData(grid.GetPointer());
+  vtkNew<vtkPVGeometryFilter> uncached;
+  uncached->SetUseOutline(0);
+  uncached->SetGenerateProcessIds(false);
+  uncached->SetUseSurfaceCache(false);
+  uncached->SetInputData(grid.GetPointer());
+
+  for (int step = 0; step < NUMBER_OF_TIMESTEPS; step++)
+    {
+    SetTimestep(grid.GetPointer(), original.GetPointer(), step);
+    // Alternate whether the original ids are requested, the surface must be
+    // reused either way.
+    cached->SetPassThroughPointIds(step % 2);
+    uncached->SetPassThroughPointIds(step % 2);
+    cached->Update();
+    uncached->Update();
+    vtkPolyData* a = vtkPolyData::SafeDownCast(cached->GetOutputDataObject(0));
+    vtkPolyData* b = vtkPolyData::SafeDownCast(uncached->GetOutputDataObject(0));
+    if (!a || !b || a->GetNumberOfCells() == 0 ||
+      !Compare(a, b, step))
+      {
+      return 1;
+      }
+    }
+
+  vtkNew<vtkUnstructuredGrid> cube;
+  CreatePolyhedron(false, cube.GetPointer());
+  vtkNew<vtkUnstructuredGrid> splitCube;
+  CreatePolyhedron(true, splitCube.GetPointer());
+  vtkNew<vtkPVGeometryFilter> polyhedra;
+  polyhedra->SetUseOutline(0);
+  polyhedra->SetGenerateProcessIds(false);
+  polyhedra->SetInputData(cube.GetPointer());
+  polyhedra->Update();
+  vtkPolyData* surface =
+    vtkPolyData::SafeDownCast(polyhedra->GetOutputDataObject(0));
+  if (!surface || surface->GetNumberOfPolys() != 6)
+    {
+    std::cerr << "ERROR: wrong surface of the polyhedron." << std::endl;
+    return 1;
+    }
+  polyhedra->SetInputData(splitCube.GetPointer());
+  polyhedra->Update();
+  surface = vtkPolyData::SafeDownCast(polyhedra->GetOutputDataObject(0));
+  if (!surface || surface->GetNumberOfPolys() != 7)
+    {
+    std::cerr << "ERROR: the surface of the previous faces was reused."
+      << std::endl;
+    return 1;
+    }
+  return 0;
+}
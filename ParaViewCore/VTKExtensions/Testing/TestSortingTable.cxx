@@ -24,6 +24,10 @@
 #include "vtkMultiProcessController.h"
 #include "vtkDummyController.h"
 
+#include <algorithm>
+#include <functional>
+#include <vector>
+
 #include <float.h>
 // ----------------------------------------------------------------------------
 void fillArray(vtkDoubleArray* array, double* dataPointer, int dataSize, const char* name)
@@ -156,6 +160,58 @@ int sortMagnitudeOnUnsignedCharVector()
   return EXIT_SUCCESS;
 }
 
+// ----------------------------------------------------------------------------
+// Requests every block of a table much larger than a block, with many equal
+// values, and checks that the blocks put together are the sorted table.
+int sortAllBlocks(bool invert, bool debug)
+{
+  const int size = 100000;
+  const int blockSize = 1024;
+  std::vector<double> dataArray(size);
+  for(int i=0;i<size;i++)
+    {
+    dataArray[i] = (i * 7919) % 1000;
+    }
+  std::vector<double> sortedArray(dataArray);
+  if(invert)
+    {
+    std::sort(sortedArray.begin(), sortedArray.end(), std::greater<double>());
+    }
+  else
+    {
+    std::sort(sortedArray.begin(), sortedArray.end());
+    }
+
+  vtkSmartPointer<vtkDoubleArray> dataToSort = vtkSmartPointer<vtkDoubleArray>::New();
+  fillArray(dataToSort.GetPointer(), &dataArray[0], size, "data");
+
+  vtkSmartPointer<vtkTable> input = vtkSmartPointer<vtkTable>::New();
+  input->AddColumn(dataToSort);
+  vtkSmartPointer<vtkSortedTableStreamer> sortingfilter = vtkSmartPointer<vtkSortedTableStreamer>::New();
+
+  sortingfilter->SetInputData(input.GetPointer());
+  sortingfilter->SetSelectedComponent(0);
+  sortingfilter->SetColumnNameToSort("data");
+  sortingfilter->SetInvertOrder(invert ? 1 : 0);
+  sortingfilter->SetBlockSize(blockSize);
+
+  for(int block=0; block * blockSize < size; block++)
+    {
+    sortingfilter->SetBlock(block);
+    sortingfilter->Update();
+    int blockEnd = std::min((block + 1) * blockSize, size);
+    if(!compareArray(sortingfilter->GetOutput(), "data",
+                     &sortedArray[block * blockSize],
+                     blockEnd - block * blockSize, debug))
+      {
+      cout << "Block " << block << " differs." << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
+
 // ----------------------------------------------------------------------------
 int TestSortingTable(int vtkNotUsed(argc), char **vtkNotUsed(argv))
 {
@@ -179,6 +235,13 @@ int TestSortingTable(int vtkNotUsed(argc), char **vtkNotUsed(argv))
            ? "FAILED" :  "SUCCESS")
        << endl;
   // --------------------------------------------------------------------------
+  cout << "Testing sorting of all the blocks: "
+       << ((result += sortAllBlocks(false, debug)) ? "FAILED" :  "SUCCESS")
+       << endl;
+  // --------------------------------------------------------------------------
+  cout << "Testing inverted sorting of all the blocks: "
+       << ((result += sortAllBlocks(true, debug)) ? "FAILED" :  "SUCCESS")
+       << endl;
   // --------------------------------------------------------------------------
 
   // Delete Fake MPI controller
@@ -0,0 +1,115 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestSpyPlotDecoding.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Reads every cell variable of every time step of a SpyPlot file with the
+// planes decoded concurrently and one after the other, and checks that the
+// arrays match. The volume fractions are read both as unsigned chars and as
+// floats.
+
+#include "vtkDataArray.h"
+#include "vtkDataArraySelection.h"
+#include "vtkNew.h"
+#include "vtkSpyPlotUniReader.h"
+#include "vtkTestUtilities.h"
+
+#include <string.h>
+
+namespace
+{
+  void SetupReader(vtkSpyPlotUniReader* reader, const char* fname,
+    int concurrent, int downConvert, vtkDataArraySelection* selection)
+    {
+    reader->SetFileName(fname);
+    reader->SetCellArraySelection(selection);
+    reader->SetConcurrentDecoding(concurrent);
+    reader->SetDownConvertVolumeFraction(downConvert);
+    reader->ReadInformation();
+    selection->EnableAllArrays();
+    }
+
+  bool SameArray(vtkDataArray* a, vtkDataArray* b)
+    {
+    if (!a || !b)
+      {
+      return a == b;
+      }
+    return a->GetDataType() == b->GetDataType() &&
+      a->GetNumberOfComponents() == b->GetNumberOfComponents() &&
+      a->GetNumberOfTuples() == b->GetNumberOfTuples() &&
+      memcmp(a->GetVoidPointer(0), b->GetVoidPointer(0),
+        a->GetNumberOfTuples() * a->GetNumberOfComponents() *
+        a->GetDataTypeSize()) == 0;
+    }
+
+  bool CheckDecoding(const char* fname, int downConvert)
+    {
+    vtkNew<vtkDataArraySelection> selection;
+    vtkNew<vtkSpyPlotUniReader> reader;
+    SetupReader(reader.GetPointer(), fname, 1, downConvert,
+      selection.GetPointer());
+    vtkNew<vtkDataArraySelection> serialSelection;
+    vtkNew<vtkSpyPlotUniReader> serialReader;
+    SetupReader(serialReader.GetPointer(), fname, 0, downConvert,
+      serialSelection.GetPointer());
+
+    int range[2];
+    reader->GetTimeStepRange(range);
+    int numberOfArrays = 0;
+    for (int step = range[0]; step <= range[1]; ++step)
+      {
+      if (!reader->SetCurrentTimeStep(step) ||
+        !serialReader->SetCurrentTimeStep(step) ||
+        !reader->MakeCurrent() || !serialReader->MakeCurrent())
+        {
+        cerr << "Cannot read time step " << step << endl;
+        return false;
+        }
+      for (int field = 0; field < reader->GetNumberOfCellFields(); ++field)
+        {
+        for (int block = 0; block < reader->GetNumberOfDataBlocks();
+          ++block)
+          {
+          int fixed;
+          vtkDataArray* array = reader->GetCellFieldData(block, field,
+            &fixed);
+          vtkDataArray* expected = serialReader->GetCellFieldData(block,
+            field, &fixed);
+          if (!SameArray(array, expected))
+            {
+            cerr << "Array " << reader->GetCellFieldName(field)
+              << " of block " << block << " at time step " << step
+              << " differs from the serial decoding." << endl;
+            return false;
+            }
+          numberOfArrays += array? 1 : 0;
+          }
+        }
+      }
+    if (numberOfArrays == 0)
+      {
+      cerr << "No array read." << endl;
+      return false;
+      }
+    return true;
+    }
+}
+
+int TestSpyPlotDecoding(int argc, char* argv[])
+{
+  char* fname = vtkTestUtilities::ExpandDataFileName(argc, argv,
+    "Data/SPCTH/ball_and_box.spcth");
+  bool success = CheckDecoding(fname, 1) && CheckDecoding(fname, 0);
+  delete [] fname;
+  return success? EXIT_SUCCESS : EXIT_FAILURE;
+}
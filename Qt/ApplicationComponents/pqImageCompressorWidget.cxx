@@ -40,6 +40,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 static const int NO_COMPRESSION=0;
 static const int SQUIRT_COMPRESSION=1;
 static const int ZLIB_COMPRESSION=2;
+static const int LZ4_COMPRESSION=3;
 //-----------------------------------------------------------------------------
 
 class pqImageCompressorWidget::pqInternals
@@ -80,6 +81,8 @@ pqImageCompressorWidget::pqImageCompressorWidget(
     SIGNAL(compressorConfigChanged()));
   this->connect(ui.zlibStripAlpha, SIGNAL(stateChanged(int)),
     SIGNAL(compressorConfigChanged()));
+  this->connect(ui.lz4DeltaMode, SIGNAL(stateChanged(int)),
+    SIGNAL(compressorConfigChanged()));
 
   this->addPropertyLink(
     this, "compressorConfig", SIGNAL(compressorConfigChanged()),
@@ -115,6 +118,12 @@ void pqImageCompressorWidget::setCompressorConfig(const QString& value)
                      "\\s+"
                      "([01])"   // strip alpha (0 or 1).
                      "$");
+  QRegExp lz4RegExp("^vtkLZ4ImageCompressor"
+                    "\\s+"
+                    "[01]"
+                    "\\s+"
+                    "([01])"   // delta mode (0 or 1).
+                    "$");
 
   if (squirtRegExp.exactMatch(value))
     {
@@ -132,6 +141,12 @@ void pqImageCompressorWidget::setCompressorConfig(const QString& value)
     ui.zlibColorSpace->setValue(numBits);
     ui.zlibStripAlpha->setCheckState(stripAlpha? Qt::Checked : Qt::Unchecked);
     }
+  else if (lz4RegExp.exactMatch(value))
+    {
+    bool deltaMode = (lz4RegExp.cap(1).toInt() == 1);
+    ui.compressionType->setCurrentIndex(LZ4_COMPRESSION);
+    ui.lz4DeltaMode->setCheckState(deltaMode? Qt::Checked : Qt::Unchecked);
+    }
   else
     {
     ui.compressionType->setCurrentIndex(NO_COMPRESSION);
@@ -152,6 +167,10 @@ QString pqImageCompressorWidget::compressorConfig() const
       .arg(ui.zlibLevel->value())
       .arg(ui.zlibColorSpace->value())
       .arg(ui.zlibStripAlpha->isChecked()? 1 : 0);
+
+  case 3: // lz4
+    return QString("vtkLZ4ImageCompressor 1 %1")
+      .arg(ui.lz4DeltaMode->isChecked()? 1 : 0);
     }
 
   return QString("");
@@ -169,6 +188,8 @@ void pqImageCompressorWidget::currentIndexChanged(int index)
   ui.zlibLevel->setVisible(index == ZLIB_COMPRESSION);
   ui.zlibColorSpace->setVisible(index == ZLIB_COMPRESSION);
   ui.zlibStripAlpha->setVisible(index == ZLIB_COMPRESSION);
+
+  ui.lz4DeltaMode->setVisible(index == LZ4_COMPRESSION);
 }
 
 //-----------------------------------------------------------------------------
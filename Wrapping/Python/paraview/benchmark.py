@@ -16,6 +16,10 @@ Do that like so:
 
       call parse_logs() to let the script identify and report on per frame and per filter execution times
 
+Third, you can record structured trace events on all processes and look at
+them on a timeline. Call enable_trace(), run your pipeline, then call
+save_trace(filename) and open the file in chrome://tracing or Perfetto.
+
 
 ::
 
@@ -283,6 +287,63 @@ def print_logs() :
         for i in logs:
             i.print_log(True)
 
+def enable_trace(max_events=None) :
+    """
+    Starts recording trace events on the client and on all the server
+    processes, discarding the events recorded so far. Trace events record
+    filter executions, client/server messages, data delivery and
+    compositing with their thread, time and size. Call save_trace() to get
+    them.
+    """
+    pxm = paraview.servermanager.ProxyManager()
+    recorder = pxm.NewProxy("misc", "TraceEventRecorder")
+    if max_events is not None:
+        recorder.GetProperty("MaxNumberOfEvents").SetElements1(max_events)
+    recorder.GetProperty("Enable").SetElements1(1)
+    recorder.UpdateVTKObjects()
+    recorder.InvokeCommand("ResetEvents")
+
+def get_trace(reset=False) :
+    """
+    Gathers the trace events of the client and of all the server processes
+    in a vtkPVTraceInformation. When reset is True, the gathered events are
+    removed from the processes. In symmetric mode, only the events of the
+    local process are gathered. The times of the events of the servers are
+    put in the clock of the client, see vtkPVTraceInformation.GetClockOffset.
+    """
+    pm = paraview.servermanager.vtkProcessModule.GetProcessModule()
+    session = paraview.servermanager.ActiveConnection.Session
+
+    if pm.GetProcessTypeAsInt() == pm.PROCESS_BATCH:
+        # collect information from all processes in one go.
+        components = [session.CLIENT_AND_SERVERS]
+    elif not session.IsA("vtkSMSessionClient"):
+        # builtin session: the servers are the client process.
+        components = [session.CLIENT]
+    elif session.GetRenderClientMode() == session.RENDERING_UNIFIED:
+        components = [session.CLIENT, session.SERVERS]
+    else:
+        components = [session.CLIENT, session.RENDER_SERVER, session.DATA_SERVER]
+
+    trace = paraview.servermanager.vtkPVTraceInformation()
+    for component in components:
+        traceInfo = paraview.servermanager.vtkPVTraceInformation()
+        traceInfo.SetResetEvents(reset)
+        session.GatherInformation(component, traceInfo, 0)
+        trace.AddInformation(traceInfo)
+    return trace
+
+def save_trace(filename, reset=False) :
+    """
+    Gathers the trace events of all processes, see get_trace(), and writes
+    them as a Chrome trace file that chrome://tracing or
+    https://ui.perfetto.dev can open.
+    """
+    trace = get_trace(reset)
+    if not trace.WriteChromeTrace(filename):
+        raise RuntimeError("Failed to write %s" % filename)
+    return trace
+
 def __process_frame() :
     global filters
     global current_frames_records
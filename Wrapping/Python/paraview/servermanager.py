@@ -1768,6 +1768,29 @@ class ProxyManager(object):
     def SaveState(self, filename):
         self.SMProxyManager.SaveXMLState(filename)
 
+    def PushTransaction(self):
+        """Returns a context manager that sends the properties pushed by all
+        the proxies in its with block to the server together instead of
+        one message per proxy. Example:
+            with ProxyManager().PushTransaction():
+                for source in sources:
+                    source.Radius = 2
+        """
+        return _PushTransaction(self.SMProxyManager)
+
+class _PushTransaction(object):
+    """Context manager returned by ProxyManager.PushTransaction()."""
+    def __init__(self, smproxymanager):
+        self.SMProxyManager = smproxymanager
+
+    def __enter__(self):
+        self.SMProxyManager.BeginPushTransaction()
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.SMProxyManager.EndPushTransaction()
+        return False
+
 class PropertyIterator(object):
     """Wrapper for a vtkSMPropertyIterator class to satisfy
        the python iterator protocol. Note that the list of
@@ -2237,7 +2260,7 @@ def LoadPlugin(filename,  remote=True, connection=None):
         updateModules(connection.Modules)
 
 
-def Fetch(input, arg1=None, arg2=None, idx=0):
+def Fetch(input, arg1=None, arg2=None, idx=0, distributed=False):
     """
     A convenience method that moves data from the server to the client,
     optionally performing some operation on the data as it moves.
@@ -2267,6 +2290,12 @@ def Fetch(input, arg1=None, arg2=None, idx=0):
 
     Optional argument idx is used to specify the output port number to fetch the
     data from. Default is port 0.
+
+    Optional argument distributed is only used when arg1 is an algorithm and
+    arg2 is None. Set it to True when arg1 already produces the global result
+    on every processor, for example vtkMinMax with DistributedReduction on.
+    The result of the root processor is then brought to the client and no
+    intermediate result is gathered. Default is False.
     """
 
     import types
@@ -2295,6 +2324,10 @@ def Fetch(input, arg1=None, arg2=None, idx=0):
     elif type(arg1) is types.IntType:
         reducer.PassThrough = arg1
 
+    elif arg2 == None and distributed:
+        reducer.PreGatherHelper = arg1
+        reducer.PassThrough = 0
+
     else:
         reducer.PreGatherHelper = arg1
         reducer.PostGatherHelper = arg2